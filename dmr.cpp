@@ -18,6 +18,7 @@
 #include <string.h>
 #include "dmr.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -111,6 +112,7 @@ DSDDMR::DSDDMR(DSDDecoder *dsdDecoder) :
         m_lcss(0),
         m_colorCode(0),
         m_dataType(DSDDMRDataUnknown),
+        m_slotTypeOK(false),
         m_voice1EmbSig_dibitsIndex(0),
         m_voice1EmbSig_OK(false),
         m_voice2EmbSig_dibitsIndex(0),
@@ -138,6 +140,129 @@ DSDDMR::~DSDDMR()
 {
 }
 
+void DSDDMR::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU16(m_symbolIndex);
+    buffer.writeInt(m_cachSymbolIndex);
+    buffer.writeU8(m_burstType);
+    buffer.writeU8(m_slot);
+    buffer.writeBool(m_continuation);
+    buffer.writeBool(m_cachOK);
+    buffer.writeU8(m_lcss);
+    buffer.writeU8(m_colorCode);
+    buffer.writeU8(m_dataType);
+    buffer.writeBool(m_slotTypeOK);
+    buffer.writeBool(m_slotText == m_dsdDecoder->m_state.slot1light);
+    buffer.writeDibits(m_slotTypePDU_dibits, 10);
+    buffer.writeBits(m_cachBits, 24);
+    buffer.writeDibits(m_emb_dibits, 8);
+    buffer.writeDibits(m_voiceEmbSig_dibits, 16);
+    buffer.writeBits(m_voice1EmbSigRawBits, 16*8);
+    buffer.writeU8(m_voice1EmbSig_dibitsIndex);
+    buffer.writeBool(m_voice1EmbSig_OK);
+    buffer.writeBool(m_slot1Addresses.m_group);
+    buffer.writeU32(m_slot1Addresses.m_target);
+    buffer.writeU32(m_slot1Addresses.m_source);
+    buffer.writeBits(m_voice2EmbSigRawBits, 16*8);
+    buffer.writeU8(m_voice2EmbSig_dibitsIndex);
+    buffer.writeBool(m_voice2EmbSig_OK);
+    buffer.writeBool(m_slot2Addresses.m_group);
+    buffer.writeU32(m_slot2Addresses.m_target);
+    buffer.writeU32(m_slot2Addresses.m_source);
+    buffer.writeDibits(m_syncDibits, 24);
+    buffer.writeU8(m_voice1FrameCount);
+    buffer.writeU8(m_voice2FrameCount);
+    buffer.writeBytes(m_mbeDVFrame, 9);
+    buffer.writeU8(w ? w - rW : 0xFF); // the four pointers move together in the AMBE frame interleave
+}
+
+void DSDDMR::restoreState(DSDStateBuffer& buffer)
+{
+    m_symbolIndex = buffer.readU16(144 - 1);
+    m_cachSymbolIndex = buffer.readInt();
+    m_burstType = (DSDDMRBurstType) buffer.readEnum(DSDDMRDirectSlot2);
+    m_slot = (DSDDMRSlot) buffer.readEnum(DSDDMRSlotUndefined);
+    m_continuation = buffer.readBool();
+    m_cachOK = buffer.readBool();
+    m_lcss = buffer.readU8();
+    m_colorCode = buffer.readU8();
+    m_dataType = (DSDDMRDataTYpe) buffer.readEnum(DSDDMRDataUnknown);
+    m_slotTypeOK = buffer.readBool();
+    m_slotText = buffer.readBool() ? m_dsdDecoder->m_state.slot1light : m_dsdDecoder->m_state.slot0light;
+    buffer.readDibits(m_slotTypePDU_dibits, 10);
+    buffer.readBits(m_cachBits, 24);
+    buffer.readDibits(m_emb_dibits, 8);
+    buffer.readDibits(m_voiceEmbSig_dibits, 16);
+    buffer.readBits(m_voice1EmbSigRawBits, 16*8);
+    m_voice1EmbSig_dibitsIndex = buffer.readU8(64);
+    m_voice1EmbSig_OK = buffer.readBool();
+    m_slot1Addresses.m_group = buffer.readBool();
+    m_slot1Addresses.m_target = buffer.readU32();
+    m_slot1Addresses.m_source = buffer.readU32();
+    buffer.readBits(m_voice2EmbSigRawBits, 16*8);
+    m_voice2EmbSig_dibitsIndex = buffer.readU8(64);
+    m_voice2EmbSig_OK = buffer.readBool();
+    m_slot2Addresses.m_group = buffer.readBool();
+    m_slot2Addresses.m_target = buffer.readU32();
+    m_slot2Addresses.m_source = buffer.readU32();
+    buffer.readDibits(m_syncDibits, 24);
+    m_voice1FrameCount = buffer.readU8();
+    m_voice2FrameCount = buffer.readU8();
+    buffer.readBytes(m_mbeDVFrame, 9);
+    int interleaveIndex = buffer.readU8();
+
+    if (interleaveIndex <= 36)
+    {
+        w = rW + interleaveIndex;
+        x = rX + interleaveIndex;
+        y = rY + interleaveIndex;
+        z = rZ + interleaveIndex;
+    }
+    else
+    {
+        w = 0;
+        x = 0;
+        y = 0;
+        z = 0;
+    }
+}
+
+void DSDDMR::reset()
+{
+    m_symbolIndex = 0;
+    m_cachSymbolIndex = 0;
+    m_burstType = DSDDMRBurstNone;
+    m_slot = DSDDMRSlotUndefined;
+    m_continuation = false;
+    m_cachOK = false;
+    m_lcss = 0;
+    m_colorCode = 0;
+    m_dataType = DSDDMRDataUnknown;
+    m_slotTypeOK = false;
+    m_voice1EmbSig_dibitsIndex = 0;
+    m_voice1EmbSig_OK = false;
+    m_voice2EmbSig_dibitsIndex = 0;
+    m_voice2EmbSig_OK = false;
+    m_voice1FrameCount = 6;
+    m_voice2FrameCount = 6;
+    m_slot1Addresses = DMRAddresses();
+    m_slot2Addresses = DMRAddresses();
+    m_slotText = m_dsdDecoder->m_state.slot0light;
+    w = 0;
+    x = 0;
+    y = 0;
+    z = 0;
+
+    memset(m_slotTypePDU_dibits, 0, 10);
+    memset(m_cachBits, 0, 24);
+    memset(m_emb_dibits, 0, 8);
+    memset(m_voiceEmbSig_dibits, 0, 16);
+    memset(m_voice1EmbSigRawBits, 0, 16*8);
+    memset(m_voice2EmbSigRawBits, 0, 16*8);
+    memset(m_syncDibits, 0, 24);
+    memset(m_mbeDVFrame, 0, 9);
+}
+
 void DSDDMR::initData()
 {
 //    std::cerr << "DSDDMR::initData" << std::endl;
@@ -186,7 +311,7 @@ void DSDDMR::processData()
         {
             if (m_voice1FrameCount < 6) // continuation expected on slot + 2
             {
-                std::cerr << "DSDDMR::processData: error: remaining voice in slot1" << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDDMR::processData: error: remaining voice in slot1\n");
 
                 if (m_voice2FrameCount < 6)
                 {
@@ -217,7 +342,7 @@ void DSDDMR::processData()
         {
             if (m_voice2FrameCount < 6) // continuation expected on slot + 2
             {
-                std::cerr << "DSDDMR::processData: error: remaining voice in slot2" << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDDMR::processData: error: remaining voice in slot2\n");
 
                 if (m_voice1FrameCount < 6)
                 {
@@ -556,7 +681,11 @@ void DSDDMR::processDataDibit(unsigned char dibit)
 
 	else if (m_symbolIndex < 12 + 49)
 	{
-		// TODO
+        if (m_dsdDecoder->m_capture)
+        {
+            m_dataBits[2*(m_symbolIndex - 12)]     = (dibit >> 1) & 1;
+            m_dataBits[2*(m_symbolIndex - 12) + 1] = dibit & 1;
+        }
 	}
 
 	// Slot Type first half
@@ -589,10 +718,33 @@ void DSDDMR::processDataDibit(unsigned char dibit)
 
     else if (m_symbolIndex < 90 + 5 + 49)
     {
-    	// TODO
+        if (m_dsdDecoder->m_capture)
+        {
+            m_dataBits[98 + 2*(m_symbolIndex - 95)]     = (dibit >> 1) & 1;
+            m_dataBits[98 + 2*(m_symbolIndex - 95) + 1] = dibit & 1;
+
+            if (m_symbolIndex == 90 + 5 + 49 - 1) {
+                captureData();
+            }
+        }
     }
 }
 
+void DSDDMR::captureData()
+{
+    unsigned char infoBits[196];
+    DSDCapture::Frame frame(DSDCapture::FrameDMRData, m_slot == DSDDMRSlotUndefined ? -1 : (int) m_slot);
+
+    for (int i = 0; i < 196; i++) {
+        infoBits[i] = m_dataBits[(i * 181) % 196]; // BPTC(196,96) interleaving
+    }
+
+    frame.setFEC(m_slotTypeOK, m_golay_20_8.getNbCorrected()); // slot type
+    frame.addField(m_colorCode);
+    frame.addField((uint32_t) m_dataType);
+    m_dsdDecoder->captureBits(frame, infoBits, 196);
+}
+
 void DSDDMR::processVoiceDibit(unsigned char dibit)
 {
 	// CACH
@@ -645,12 +797,15 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 	        }
 		}
 
-		m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-		m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-		w++;
-		x++;
-		y++;
-		z++;
+		if (w && (w < rW + 36)) // the interleave position restored from a state may not match the burst
+		{
+		    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+		    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+		    w++;
+		    x++;
+		    y++;
+		    z++;
+		}
 
         if (m_slot == DSDDMRSlot1) {
             storeSymbolDV(m_dsdDecoder->m_mbeDVFrame1, mbeIndex, dibit); // store dibit for DVSI hardware decoder
@@ -663,12 +818,12 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 		    if (m_slot == DSDDMRSlot1)
 		    {
 		        m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-		        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+		        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 		    }
 		    else if (m_slot == DSDDMRSlot2)
 		    {
 		        m_dsdDecoder->m_mbeDecoder2.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-		        m_dsdDecoder->m_mbeDVReady2 = true; // Indicate that a DVSI frame is available
+		        m_dsdDecoder->setMbeDVReady2(); // Indicate that a DVSI frame is available
 		    }
 		}
 	}
@@ -689,12 +844,15 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 			memset((void *) m_mbeDVFrame, 0, 9); // initialize DVSI frame
 		}
 
-		m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-		m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-		w++;
-		x++;
-		y++;
-		z++;
+		if (w && (w < rW + 36))
+		{
+		    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+		    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+		    w++;
+		    x++;
+		    y++;
+		    z++;
+		}
 
 		storeSymbolDV(m_mbeDVFrame, mbeIndex, dibit); // store dibit for DVSI hardware decoder
 	}
@@ -758,12 +916,15 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 	{
 		int mbeIndex = m_symbolIndex - (12 + 36 + 24);
 
-		m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-		m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-		w++;
-		x++;
-		y++;
-		z++;
+		if (w && (w < rW + 36))
+		{
+		    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+		    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+		    w++;
+		    x++;
+		    y++;
+		    z++;
+		}
 
 		storeSymbolDV(m_mbeDVFrame, mbeIndex, dibit); // store dibit for DVSI hardware decoder
 
@@ -773,13 +934,13 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 			{
 				m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
 				memcpy(m_dsdDecoder->m_mbeDVFrame1, m_mbeDVFrame, 9);
-				m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+				m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 			}
 			else if (m_slot == DSDDMRSlot2)
 			{
 				m_dsdDecoder->m_mbeDecoder2.processFrame(0, m_dsdDecoder->ambe_fr, 0);
 				memcpy(m_dsdDecoder->m_mbeDVFrame2, m_mbeDVFrame, 9);
-				m_dsdDecoder->m_mbeDVReady2 = true; // Indicate that a DVSI frame is available
+				m_dsdDecoder->setMbeDVReady2(); // Indicate that a DVSI frame is available
 			}
 		}
 	}
@@ -804,12 +965,15 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
             }
 		}
 
-		m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-		m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-		w++;
-		x++;
-		y++;
-		z++;
+		if (w && (w < rW + 36))
+		{
+		    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+		    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+		    w++;
+		    x++;
+		    y++;
+		    z++;
+		}
 
         if (m_slot == DSDDMRSlot1) {
             storeSymbolDV(m_dsdDecoder->m_mbeDVFrame1, mbeIndex, dibit); // store dibit for DVSI hardware decoder
@@ -822,12 +986,12 @@ void DSDDMR::processVoiceDibit(unsigned char dibit)
 		    if (m_slot == DSDDMRSlot1)
 		    {
 		        m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-		        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+		        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 		    }
 		    else if (m_slot == DSDDMRSlot2)
 		    {
 		        m_dsdDecoder->m_mbeDecoder2.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-		        m_dsdDecoder->m_mbeDVReady2 = true; // Indicate that a DVSI frame is available
+		        m_dsdDecoder->setMbeDVReady2(); // Indicate that a DVSI frame is available
 		    }
 		}
 	}
@@ -849,7 +1013,10 @@ void DSDDMR::decodeCACH(unsigned char *cachBits)
     else
     {
         // Hamming (7,4) decode and store results if successful
-        if (m_hamming_7_4.decode(cachBits)) // positive CACH information
+        bool cachOK = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHamming_7_4, m_hamming_7_4.decode(cachBits));
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHamming_7_4, cachOK, m_hamming_7_4.getNbCorrected());
+
+        if (cachOK) // positive CACH information
         {
             unsigned int slotIndex = cachBits[1] & 1;
             m_dsdDecoder->m_state.currentslot = slotIndex; // FIXME: remove this when done with new voice processing
@@ -891,7 +1058,10 @@ void DSDDMR::processSlotTypePDU()
         slotTypeBits[2*i + 1] = m_slotTypePDU_dibits[i] & 1;
     }
 
-    if (m_golay_20_8.decode(slotTypeBits))
+    m_slotTypeOK = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolay_20_8, m_golay_20_8.decode(slotTypeBits));
+    m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolay_20_8, m_slotTypeOK, m_golay_20_8.getNbCorrected());
+
+    if (m_slotTypeOK)
     {
         m_colorCode = (slotTypeBits[0] << 3) + (slotTypeBits[1] << 2) + (slotTypeBits[2] << 1) + slotTypeBits[3];
         sprintf(&m_slotText[1], "%02d ", m_colorCode);
@@ -909,6 +1079,18 @@ void DSDDMR::processSlotTypePDU()
             memcpy(&m_slotText[4], m_slotTypeText[dataType], 3);
         }
 
+        int slot = m_slot == DSDDMRSlot2 ? 1 : 0;
+
+        if (m_dataType == DSDDMRDataVoiceLCHeader)
+        {
+            (slot == 0 ? m_slot1Addresses : m_slot2Addresses) = DMRAddresses(); // those of the new call come with its embedded LC
+            m_dsdDecoder->startCall(slot, DSDStatus::ProtocolDMR);
+        }
+        else if (m_dataType == DSDDMRDataTerminatorWithLC)
+        {
+            m_dsdDecoder->endCall(slot, DSDDecoder::CallInfo::CallEndTerminator);
+        }
+
 //        std::cerr << "DSDDMR::processSlotTypePDU OK: CC: " << (int) m_colorCode << " DT: " << dataType << std::endl;
     }
     else
@@ -928,7 +1110,10 @@ bool DSDDMR::processEMB()
         embBits[2*i + 1] = m_emb_dibits[i] & 1;
     }
 
-    if (m_qr_16_7_6.decode(embBits))
+    bool embOK = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageQR_16_7_6, m_qr_16_7_6.decode(embBits));
+    m_dsdDecoder->m_stats.countFEC(DSDStats::FECQR_16_7_6, embOK, m_qr_16_7_6.getNbCorrected());
+
+    if (embOK)
     {
         m_colorCode = (embBits[0] << 3) + (embBits[1] << 2) + (embBits[2] << 1) + embBits[3];
         sprintf(&m_slotText[1], "%02d", m_colorCode);
@@ -984,7 +1169,10 @@ bool DSDDMR::processVoiceEmbeddedSignalling(int& voiceEmbSig_dibitsIndex,
 
         if (voiceEmbSig_dibitsIndex == 16*4) // BPTC matrix collected
         {
-            if (m_hamming_16_11_4.decode(voiceEmbSigRawBits, 0, 7)) // TODO: 5 bit checksum
+            bool embSigOK = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHamming_16_11_4, m_hamming_16_11_4.decode(voiceEmbSigRawBits, 0, 7));
+            m_dsdDecoder->m_stats.countFEC(DSDStats::FECHamming_16_11_4, embSigOK, m_hamming_16_11_4.getNbCorrected());
+
+            if (embSigOK) // TODO: 5 bit checksum
             {
                 unsigned char flco = (voiceEmbSigRawBits[2] << 5)
                         + (voiceEmbSigRawBits[3] << 4)
@@ -1042,12 +1230,20 @@ bool DSDDMR::processVoiceEmbeddedSignalling(int& voiceEmbSig_dibitsIndex,
                         + (voiceEmbSigRawBits[16*6 + 8] << 1)
                         + (voiceEmbSigRawBits[16*6 + 9]);      // (LC0)
 
+                if (m_dsdDecoder->m_capture) {
+                    captureVoiceLC(voiceEmbSigRawBits, true, addresses);
+                }
+
                 return true; // we have a result
             }
             else
             {
-                std::cerr << "DSDDMR::processVoiceEmbeddedSignalling: decode error" << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDDMR::processVoiceEmbeddedSignalling: decode error\n");
                 voiceEmbSig_OK = false;
+
+                if (m_dsdDecoder->m_capture) {
+                    captureVoiceLC(voiceEmbSigRawBits, false, addresses);
+                }
             }
         }
     }
@@ -1055,9 +1251,24 @@ bool DSDDMR::processVoiceEmbeddedSignalling(int& voiceEmbSig_dibitsIndex,
     return false; // no result yet or KO
 }
 
+void DSDDMR::captureVoiceLC(const unsigned char *voiceEmbSigRawBits, bool embSigOK, const DMRAddresses& addresses)
+{
+    DSDCapture::Frame frame(DSDCapture::FrameDMRVoiceLC, m_slot == DSDDMRSlotUndefined ? -1 : (int) m_slot);
+    frame.setFEC(embSigOK, m_hamming_16_11_4.getNbCorrected());
+
+    if (embSigOK)
+    {
+        frame.addField(addresses.m_group ? 1 : 0);
+        frame.addField(addresses.m_target);
+        frame.addField(addresses.m_source);
+    }
+
+    m_dsdDecoder->captureBits(frame, voiceEmbSigRawBits, 16*8);
+}
+
 void DSDDMR::storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned char dibit, bool invertDibit)
 {
-    if (m_dsdDecoder->m_mbelibEnable)
+    if (!m_dsdDecoder->mbeDVEnabled())
     {
         return;
     }
@@ -1070,6 +1281,18 @@ void DSDDMR::storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned cha
     mbeFrame[dibitindex/4] |= (dibit << (6 - 2*(dibitindex % 4)));
 }
 
+void DSDDMR::unpackDVFrame(const unsigned char *dvFrame, char ambe_fr[4][24])
+{
+    memset(ambe_fr, 0, 4*24);
+
+    for (int i = 0; i < 36; i++)
+    {
+        unsigned char dibit = (dvFrame[i/4] >> (6 - 2*(i % 4))) & 3;
+        ambe_fr[rW[i]][rX[i]] = (1 & (dibit >> 1)); // bit 1
+        ambe_fr[rY[i]][rZ[i]] = (1 & dibit);        // bit 0
+    }
+}
+
 void DSDDMR::textVoiceEmbeddedSignalling(DMRAddresses& addresses, char *slotText)
 {
     sprintf(&slotText[8],  "%08u", addresses.m_source);
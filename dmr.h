@@ -24,6 +24,7 @@ namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDDMR
 {
@@ -64,6 +65,9 @@ public:
 
     explicit DSDDMR(DSDDecoder *dsdDecoder);
     ~DSDDMR();
+    void reset(); //!< back to the state after construction keeping the FEC and interleaving tables
+    void saveState(DSDStateBuffer& buffer) const;    //!< burst in progress, color code and slots state
+    void restoreState(DSDStateBuffer& buffer);
 
     void initData();
     void initVoice();
@@ -80,6 +84,14 @@ public:
     const char *getSlot0Text() const;
     const char *getSlot1Text() const;
     unsigned char getColorCode() const;
+    unsigned char getLastColorCode() const { return m_colorCode; } //!< colour code of the last slot type or EMB decoded
+    /** Addresses of the last voice LC decoded in a slot (0 or 1) since the voice LC header. 0 if none */
+    unsigned int getSourceId(int slot) const { return slot == 0 ? m_slot1Addresses.m_source : m_slot2Addresses.m_source; }
+    unsigned int getTargetId(int slot) const { return slot == 0 ? m_slot1Addresses.m_target : m_slot2Addresses.m_target; }
+    bool isGroupCall(int slot) const { return slot == 0 ? m_slot1Addresses.m_group : m_slot2Addresses.m_group; }
+
+    /** AMBE 3600x2450 frame bits from a DVSI frame of dibits (also used by dPMR, NXDN and YSF V/D type 1) */
+    static void unpackDVFrame(const unsigned char *dvFrame, char ambe_fr[4][24]);
 
 private:
     struct DMRAddresses
@@ -104,6 +116,8 @@ private:
     bool processVoiceEmbeddedSignalling(int& voiceEmbSig_dibitsIndex, unsigned char *voiceEmbSigRawBits, bool& voiceEmbSig_OK, DMRAddresses& addresses);
     void processVoiceDibit(unsigned char dibit);
     void processDataDibit(unsigned char dibit);
+    void captureData();
+    void captureVoiceLC(const unsigned char *voiceEmbSigRawBits, bool embSigOK, const DMRAddresses& addresses);
     void storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned char dibit, bool invertDibit = false);
     static void textVoiceEmbeddedSignalling(DMRAddresses& addresses, char *slotText);
 
@@ -122,6 +136,8 @@ private:
     DSDDMRDataTYpe m_dataType;
     char *m_slotText;
     unsigned char m_slotTypePDU_dibits[10];
+    bool m_slotTypeOK;
+    unsigned char m_dataBits[196];        //!< data burst info bits as received (BPTC interleaved). Filled only when capturing
     unsigned char m_cachBits[24];
     unsigned char m_emb_dibits[8];
     unsigned char m_voiceEmbSig_dibits[16];
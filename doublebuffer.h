@@ -103,6 +103,16 @@ public:
         }
     }
 
+    const T *getOldest() const //!< the size items from the oldest to the latest
+    {
+        return &m_buffer[m_index];
+    }
+
+    unsigned int getSize() const
+    {
+        return m_size;
+    }
+
     T& getLatest()
     {
         return m_buffer[m_index + m_size - 1];
@@ -18,6 +18,7 @@
 #include <iostream>
 #include "dpmr.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -113,6 +114,95 @@ DSDdPMR::~DSDdPMR()
 {
 }
 
+void DSDdPMR::reset()
+{
+    m_frameIndex = 0;
+    m_calledIdHalf = false;
+    m_ownIdHalf = false;
+    w = 0;
+    x = 0;
+    y = 0;
+    z = 0;
+
+    memset(m_bitBuffer, 0, 80);
+    memset(m_bitBufferRx, 0, 120);
+    memset(m_bitWork, 0, 80);
+    m_calledIdWork = 0;
+    memset(m_colourBuffer, 0, 12);
+    m_ownIdWork = 0;
+    memset(m_syncDoubleBuffer, 0, 24);
+
+    // the scrambling sequence and interleave indexes do not change
+    init();
+}
+
+void DSDdPMR::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU8(m_state);
+    buffer.writeU8(m_frameType);
+    buffer.writeDibits(m_syncDoubleBuffer, 24);
+    buffer.writeDibits(m_colourBuffer, 12);
+    buffer.writeInt(m_syncCycle);
+    buffer.writeU16(m_symbolIndex);
+    buffer.writeU32(m_frameIndex);
+    buffer.writeInt(m_colourCode);
+    buffer.writeBits(m_bitBufferRx, 120);
+    buffer.writeBits(m_bitBuffer, 80);
+    buffer.writeBits(m_bitWork, 80);
+    buffer.writeU8(m_headerType);
+    buffer.writeU8(m_commMode);
+    buffer.writeU8(m_commFormat);
+    buffer.writeU32(m_calledId);
+    buffer.writeU32(m_ownId);
+    buffer.writeU32(m_calledIdWork);
+    buffer.writeU32(m_ownIdWork);
+    buffer.writeBool(m_calledIdHalf);
+    buffer.writeBool(m_ownIdHalf);
+    buffer.writeU8(m_frameNumber);
+    buffer.writeU8(w ? w - rW : 0xFF); // the four pointers move together in the AMBE frame interleave
+}
+
+void DSDdPMR::restoreState(DSDStateBuffer& buffer)
+{
+    m_state = (DPMRState) buffer.readEnum(DPMREnd);
+    m_frameType = (DPMRFrameType) buffer.readEnum(DPMREndFrame);
+    buffer.readDibits(m_syncDoubleBuffer, 24);
+    buffer.readDibits(m_colourBuffer, 12);
+    m_syncCycle = buffer.readInt(0, 15);
+    m_symbolIndex = buffer.readU16(36 + 144 + 12 + 36 + 144 + 12 + 36 + 144 + 12 + 36 + 144); // super frame
+    m_frameIndex = buffer.readU32();
+    m_colourCode = buffer.readInt();
+    buffer.readBits(m_bitBufferRx, 120);
+    buffer.readBits(m_bitBuffer, 80);
+    buffer.readBits(m_bitWork, 80);
+    m_headerType = (DPMRHeaderType) buffer.readEnum(DPMRUndefinedHeader);
+    m_commMode = (DPMRCommMode) buffer.readEnum(DPMRUndefinedMode);
+    m_commFormat = (DPMRCommFormat) buffer.readEnum(DPMRUndefinedFormat);
+    m_calledId = buffer.readU32();
+    m_ownId = buffer.readU32();
+    m_calledIdWork = buffer.readU32();
+    m_ownIdWork = buffer.readU32();
+    m_calledIdHalf = buffer.readBool();
+    m_ownIdHalf = buffer.readBool();
+    m_frameNumber = buffer.readU8();
+    int interleaveIndex = buffer.readU8();
+
+    if (interleaveIndex <= 36)
+    {
+        w = rW + interleaveIndex;
+        x = rX + interleaveIndex;
+        y = rY + interleaveIndex;
+        z = rZ + interleaveIndex;
+    }
+    else
+    {
+        w = 0;
+        x = 0;
+        y = 0;
+        z = 0;
+    }
+}
+
 void DSDdPMR::init()
 {
     m_syncCycle = 0;
@@ -159,7 +249,7 @@ void DSDdPMR::processHeader()
     if (m_symbolIndex == 0)
     {
         m_frameType = DPMRHeaderFrame;
-        m_dsdDecoder->getLogger().log("DSDdPMR::processHeader: start\n"); // DEBUG
+        m_dsdDecoder->getLogger().debug("DSDdPMR::processHeader: start\n"); // DEBUG
     }
 
     if (m_symbolIndex < 60) // HI0: TODO just pass for now
@@ -179,6 +269,7 @@ void DSDdPMR::processHeader()
 
         if (m_symbolIndex == 60 + 12 + 60) // header complete
         {
+            m_dsdDecoder->startCall(0, DSDStatus::ProtocolDPMR);
             m_state = DPMRPostFrame;
             m_symbolIndex = 0;
         }
@@ -197,9 +288,12 @@ void DSDdPMR::processHIn(int symbolIndex, int dibit) // FIXME
 
     if (symbolIndex == 59)
     {
-        bool hammingStatus = m_hamming.decode(m_bitBufferRx, m_bitBuffer, 10);
+        bool hammingStatus = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHamming_12_8, m_hamming.decode(m_bitBufferRx, m_bitBuffer, 10));
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHamming_12_8, hammingStatus, m_hamming.getNbCorrected());
+
+        bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCDPMR, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCRC, checkCRC8(m_bitBuffer, 72)));
 
-        if (checkCRC8(m_bitBuffer, 72)) // CRC8 check OK
+        if (crcOK) // CRC8 check OK
         {
             // collect data
             int ht     = (m_bitBuffer[0]<<3) + (m_bitBuffer[1]<<2) + (m_bitBuffer[2]<<1) + m_bitBuffer[3];
@@ -213,7 +307,7 @@ void DSDdPMR::processHIn(int symbolIndex, int dibit) // FIXME
                 ownId    += (m_bitBuffer[28+23-i]) << i;
             }
 
-            m_dsdDecoder->getLogger().log("DSDdPMR::processHIn: HT: %d CID: %06X OID: %06X M: %d F: %02d\n",
+            m_dsdDecoder->getLogger().debug("DSDdPMR::processHIn: HT: %d CID: %06X OID: %06X M: %d F: %02d\n",
                     ht, calledId, ownId, mode, format); // DEBUG
 //            std::cerr << "DSDdPMR::processHIn:"
 //                    << " HT: " << ht
@@ -250,10 +344,40 @@ void DSDdPMR::processHIn(int symbolIndex, int dibit) // FIXME
         }
         else
         {
-            m_dsdDecoder->getLogger().log("DSDdPMR::processHIn: invalid CRC8 - Hamming: %d\n", hammingStatus); // DEBUG
+            m_dsdDecoder->getLogger().debug("DSDdPMR::processHIn: invalid CRC8 - Hamming: %d\n", hammingStatus); // DEBUG
             //std::cerr << "DSDdPMR::processHIn: invalid CRC8 - Hamming: "  << hammingStatus << std::endl; // DEBUG
         }
+
+        if (m_dsdDecoder->m_capture) {
+            captureFrame(DSDCapture::FrameDPMRHeader, hammingStatus, crcOK, 80);
+        }
+    }
+}
+
+void DSDdPMR::captureFrame(DSDCapture::FrameType frameType, bool hammingStatus, bool crcOK, unsigned int nbBits)
+{
+    DSDCapture::Frame frame(frameType);
+    frame.setFEC(hammingStatus, m_hamming.getNbCorrected());
+    frame.setCRC(crcOK);
+
+    if (crcOK) // fields as updated from this frame
+    {
+        if (frameType == DSDCapture::FrameDPMRHeader)
+        {
+            frame.addField((uint32_t) m_headerType);
+            frame.addField(m_calledId);
+            frame.addField(m_ownId);
+        }
+        else
+        {
+            frame.addField(m_frameNumber);
+        }
+
+        frame.addField((uint32_t) m_commMode);
+        frame.addField((uint32_t) m_commFormat);
     }
+
+    m_dsdDecoder->captureBits(frame, m_bitBuffer, nbBits);
 }
 
 void DSDdPMR::processPostFrame()
@@ -262,7 +386,7 @@ void DSDdPMR::processPostFrame()
 
     if (m_symbolIndex == 0)
     {
-        m_dsdDecoder->getLogger().log("DSDdPMR::processPostFrame: start\n"); // DEBUG
+        m_dsdDecoder->getLogger().debug("DSDdPMR::processPostFrame: start\n"); // DEBUG
     }
 
     if (m_symbolIndex < 12) // look for a sync
@@ -280,7 +404,7 @@ void DSDdPMR::processPostFrame()
 
         if (m_symbolIndex == 12) // sync complete
         {
-            m_dsdDecoder->getLogger().log("DSDdPMR::processPostFrame\n"); // DEBUG
+            m_dsdDecoder->getLogger().debug("DSDdPMR::processPostFrame\n"); // DEBUG
 
             if (memcmp((const void *) m_syncDoubleBuffer, (const void *) DSDDecoder::m_syncDPMRFS2, 12) == 0) // start of superframes
             {
@@ -348,7 +472,7 @@ void DSDdPMR::processExtSearch()
     {
         if (memcmp((const void *) &m_syncDoubleBuffer[m_symbolIndex], (const void *) DSDDecoder::m_syncDPMRFS2, 12) == 0)
         {
-            m_dsdDecoder->getLogger().log("DSDdPMR::processExtSearch: stop extensive sync search (sync found)\n"); // DEBUG
+            m_dsdDecoder->getLogger().debug("DSDdPMR::processExtSearch: stop extensive sync search (sync found)\n"); // DEBUG
             m_state = DPMRSuperFrame;
             m_symbolIndex = 0;
             processSuperFrame();
@@ -378,7 +502,7 @@ void DSDdPMR::processSuperFrame()
     {
         m_frameType = DPMRPayloadFrame;
         m_frameIndex = 0;
-        m_dsdDecoder->getLogger().log("DSDdPMR::processSuperFrame: start\n"); // DEBUG
+        m_dsdDecoder->getLogger().debug("DSDdPMR::processSuperFrame: start\n"); // DEBUG
     }
 
     if (m_symbolIndex < 36) // Start of frame 0 - CCH0
@@ -457,7 +581,7 @@ void DSDdPMR::processEndFrame()
     if (m_symbolIndex == 0)
     {
     	m_frameType = DPMREndFrame;
-        m_dsdDecoder->getLogger().log("DSDdPMR::processEndFrame: start\n"); // DEBUG
+        m_dsdDecoder->getLogger().debug("DSDdPMR::processEndFrame: start\n"); // DEBUG
     }
 
     if (m_symbolIndex < 18) // END0: TODO: just pass for now
@@ -471,6 +595,7 @@ void DSDdPMR::processEndFrame()
     else // terminated
     {
     	m_frameType = DPMRNoFrame;
+        m_dsdDecoder->endCall(0, DSDDecoder::CallInfo::CallEndTerminator);
         m_dsdDecoder->m_voice1On = false;
         m_dsdDecoder->resetFrameSync(); // end
     }
@@ -492,7 +617,7 @@ void DSDdPMR::processColourCode(int symbolIndex, int dibit)
             }
         }
 
-        m_dsdDecoder->getLogger().log("DSDdPMR::processColourCode: %d\n", m_colourCode); // DEBUG
+        m_dsdDecoder->getLogger().debug("DSDdPMR::processColourCode: %d\n", m_colourCode); // DEBUG
     }
 }
 
@@ -521,7 +646,7 @@ void DSDdPMR::processFS2(int symbolIndex, int dibit)
         }
         else
         {
-            m_dsdDecoder->getLogger().log("DSDdPMR::processFS2: start extensive sync search\n"); // DEBUG
+            m_dsdDecoder->getLogger().debug("DSDdPMR::processFS2: start extensive sync search\n"); // DEBUG
             m_frameType = DPMRExtSearchFrame;
             m_state = DPMRExtSearch;
             m_symbolIndex = 0;
@@ -537,9 +662,12 @@ void DSDdPMR::processCCH(int symbolIndex, int dibit)
 
     if (symbolIndex == 35)
     {
-        m_hamming.decode(m_bitBufferRx, m_bitBuffer, 6);
+        bool hammingStatus = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHamming_12_8, m_hamming.decode(m_bitBufferRx, m_bitBuffer, 6));
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHamming_12_8, hammingStatus, m_hamming.getNbCorrected());
 
-        if (checkCRC7(m_bitBuffer, 41)) // CRC7 check OK
+        bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCDPMR, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCRC, checkCRC7(m_bitBuffer, 41)));
+
+        if (crcOK) // CRC7 check OK
         {
 //            std::cerr << "DSDdPMR::processCCH: success" << std::endl;
 
@@ -548,7 +676,7 @@ void DSDdPMR::processCCH(int symbolIndex, int dibit)
             int format = (m_bitBuffer[17]<<3) + (m_bitBuffer[18]<<2) + (m_bitBuffer[19]<<1) + m_bitBuffer[20];
 
             if ((m_frameIndex % 4) != m_frameNumber) { // DEBUG
-                std::cerr << "DSDdPMR::processCCH: frame resync: count: " << m_frameIndex << " frame: " << (int) m_frameNumber << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDdPMR::processCCH: frame resync: count: %u frame: %d\n", m_frameIndex, (int) m_frameNumber);
             }
 
             m_frameIndex = m_frameNumber; // re-sync frame index
@@ -648,6 +776,10 @@ void DSDdPMR::processCCH(int symbolIndex, int dibit)
             m_frameNumber = 0xFF; // invalid
         }
 
+        if (m_dsdDecoder->m_capture) {
+            captureFrame(DSDCapture::FrameDPMRCCH, hammingStatus, crcOK, 48);
+        }
+
         switch (m_commMode)
         {
         case DPMRVoiceMode:
@@ -712,19 +844,22 @@ void DSDdPMR::processVoiceFrame(int symbolIndex, int dibit)
         memset((void *) m_dsdDecoder->m_mbeDVFrame1, 0, 9); // initialize DVSI frame
     }
 
-    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-    w++;
-    x++;
-    y++;
-    z++;
+    if (w && (w < rW + 36)) // a restored interleave position may be out of step with the frame
+    {
+        m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+        m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+        w++;
+        x++;
+        y++;
+        z++;
+    }
 
     storeSymbolDV(symbolIndex % 36, dibit); // store dibit for DVSI hardware decoder
 
     if (symbolIndex % 36 == 35)
     {
         m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 
         if (m_dsdDecoder->m_opts.errorbars == 1)
         {
@@ -735,7 +870,7 @@ void DSDdPMR::processVoiceFrame(int symbolIndex, int dibit)
 
 void DSDdPMR::storeSymbolDV(int dibitindex, unsigned char dibit, bool invertDibit)
 {
-    if (m_dsdDecoder->m_mbelibEnable)
+    if (!m_dsdDecoder->mbeDVEnabled())
     {
         return;
     }
@@ -18,12 +18,14 @@
 #define DPMR_H_
 
 #include "fec.h"
+#include "dsd_capture.h"
 #include "export.h"
 
 namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDdPMR
 {
@@ -78,6 +80,9 @@ public:
 
     explicit DSDdPMR(DSDDecoder *dsdDecoder);
     ~DSDdPMR();
+    void reset(); //!< back to the state after construction keeping the FEC and interleaving tables
+    void saveState(DSDStateBuffer& buffer) const;    //!< frame in progress, colour code and identifiers
+    void restoreState(DSDStateBuffer& buffer);
 
     void init();
     void process();
@@ -114,6 +119,7 @@ private:
 
     void processHeader();
     void processHIn(int symbolIndex, int dibit);
+    void captureFrame(DSDCapture::FrameType frameType, bool hammingStatus, bool crcOK, unsigned int nbBits);
     void processSuperFrame(); // process super frame
     void processEndFrame();
     void processPostFrame();
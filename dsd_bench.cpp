@@ -0,0 +1,514 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "dsd_decoder.h"
+#include "dsd_decoderpool.h"
+#include "dsd_resampler.h"
+#include "timeutil.h"
+
+#ifndef DSDCC_SAMPLES_DIR
+#define DSDCC_SAMPLES_DIR "samples"
+#endif
+
+#ifndef DSDCC_VERSION
+#define DSDCC_VERSION "unknown"
+#endif
+
+/** A discriminator samples file decoded with fixed options deduced from its name */
+struct BenchFile
+{
+    std::string m_name;
+    const char *m_modeName;
+    DSDcc::DSDDecoder::DSDDecodeMode m_mode;
+    std::vector<short> m_samples;
+};
+
+/** Decoder configurations timed to isolate the processing stages */
+typedef enum
+{
+    BenchFrontEnd, //!< symbol recovery and sync search only (no frame type enabled)
+    BenchNoVocoder, //!< frame decoding without mbelib synthesis
+    BenchFull       //!< full decoding
+} BenchConfig;
+
+/** Result of decoding the samples of a file in a configuration */
+struct BenchRun
+{
+    BenchRun() : m_bestNsPerSample(0.0), m_nbFrames(0), m_nbVoiceSyncs(0), m_nbDataSyncs(0), m_footprint(0) {}
+    double m_bestNsPerSample;  //!< best of the iterations in CPU ns per input sample
+    unsigned int m_nbFrames;
+    unsigned int m_nbVoiceSyncs;
+    unsigned int m_nbDataSyncs;
+    size_t m_footprint;
+};
+
+/** CPU time in microseconds to get a decoder for a new channel: construction of a warm decoder or reset of a pooled one */
+static void runDecoderSetup(int nbIterations, double& constructUs, double& resetUs)
+{
+    static const int nbChannels = 200;
+    std::vector<DSDcc::DSDDecoder*> decoders(nbChannels);
+    constructUs = 0.0;
+    resetUs = 0.0;
+
+    for (int i = 0; i < nbIterations; i++)
+    {
+        DSDcc::DSDDecoderPool pool;
+        uint64_t startUs = DSDcc::TimeUtil::threadCpuUs();
+
+        for (int c = 0; c < nbChannels; c++) {
+            decoders[c] = DSDcc::DSDDecoderPool::createWarm();
+        }
+
+        double us = (DSDcc::TimeUtil::threadCpuUs() - startUs) / (double) nbChannels;
+        constructUs = (i == 0) ? us : std::min(constructUs, us);
+
+        // retune all channels: each decoder goes back to the pool and a fresh one is taken
+        startUs = DSDcc::TimeUtil::threadCpuUs();
+
+        for (int c = 0; c < nbChannels; c++)
+        {
+            pool.release(decoders[c]);
+            decoders[c] = pool.acquire();
+        }
+
+        us = (DSDcc::TimeUtil::threadCpuUs() - startUs) / (double) nbChannels;
+        resetUs = (i == 0) ? us : std::min(resetUs, us);
+
+        for (int c = 0; c < nbChannels; c++) {
+            pool.release(decoders[c]);
+        }
+    }
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc_bench [options]\n");
+    fprintf(stderr, "Decodes each .dis file of the samples directory several times and reports the decoding speed\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -d <dir>      Samples directory (default %s)\n", DSDCC_SAMPLES_DIR);
+    fprintf(stderr, "  -f <text>     Only files which name contains this text\n");
+    fprintf(stderr, "  -n <num>      Number of iterations of each measurement, the best is kept (default 3)\n");
+    fprintf(stderr, "  -r <rates>    Comma separated input rates in S/s to time with resampling (default 24000,44100,96000)\n");
+    fprintf(stderr, "                0 to skip\n");
+    fprintf(stderr, "  -j <file>     Write the results as JSON to this file (- for stdout)\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "The frame type is deduced from the file name prefix: dmr, dpmr, dstar, ysf, nxdn48, nxdn96, p25\n");
+    fprintf(stderr, "else auto detection is used.\n");
+}
+
+static void setFileMode(BenchFile& file)
+{
+    static const struct { const char *m_prefix; const char *m_name; DSDcc::DSDDecoder::DSDDecodeMode m_mode; } modes[] = {
+        {"dpmr",   "dPMR",   DSDcc::DSDDecoder::DSDDecodeDPMR},
+        {"dmr",    "DMR",    DSDcc::DSDDecoder::DSDDecodeDMR},
+        {"dstar",  "D-Star", DSDcc::DSDDecoder::DSDDecodeDStar},
+        {"ysf",    "YSF",    DSDcc::DSDDecoder::DSDDecodeYSF},
+        {"nxdn48", "NXDN48", DSDcc::DSDDecoder::DSDDecodeNXDN48},
+        {"nxdn96", "NXDN96", DSDcc::DSDDecoder::DSDDecodeNXDN96},
+        {"p25",    "P25",    DSDcc::DSDDecoder::DSDDecodeP25P1}
+    };
+
+    for (unsigned int i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        if (file.m_name.compare(0, strlen(modes[i].m_prefix), modes[i].m_prefix) == 0)
+        {
+            file.m_modeName = modes[i].m_name;
+            file.m_mode = modes[i].m_mode;
+            return;
+        }
+    }
+
+    file.m_modeName = "auto";
+    file.m_mode = DSDcc::DSDDecoder::DSDDecodeAuto;
+}
+
+static bool loadFile(const std::string& path, std::vector<short>& samples)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+
+    if (!fp) {
+        return false;
+    }
+
+    short buffer[4096];
+    size_t nbRead;
+
+    while ((nbRead = fread(buffer, sizeof(short), 4096, fp)) > 0) {
+        samples.insert(samples.end(), buffer, buffer + nbRead);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static bool isDataSync(DSDcc::DSDDecoder::DSDSyncType syncType)
+{
+    switch (syncType)
+    {
+    case DSDcc::DSDDecoder::DSDSyncX2TDMADataP:
+    case DSDcc::DSDDecoder::DSDSyncX2TDMADataN:
+    case DSDcc::DSDDecoder::DSDSyncDMRDataP:
+    case DSDcc::DSDDecoder::DSDSyncDMRDataMS:
+    case DSDcc::DSDDecoder::DSDSyncNXDNDataP:
+    case DSDcc::DSDDecoder::DSDSyncNXDNDataN:
+    case DSDcc::DSDDecoder::DSDSyncDStarHeaderP:
+    case DSDcc::DSDDecoder::DSDSyncDStarHeaderN:
+    case DSDcc::DSDDecoder::DSDSyncDPMRPacket:
+    case DSDcc::DSDDecoder::DSDSyncDPMREnd:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Decode the samples at the given input rate in a configuration. Keeps the best CPU time of the iterations */
+static BenchRun runDecoder(const BenchFile& file, const std::vector<short>& samples, int inputRate, BenchConfig config, int nbIterations)
+{
+    BenchRun run;
+
+    for (int iteration = 0; iteration < nbIterations; iteration++)
+    {
+        DSDcc::DSDDecoder dsdDecoder;
+        dsdDecoder.setQuiet();
+        dsdDecoder.setLogVerbosity(0);
+        dsdDecoder.setInputSampleRate(inputRate);
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
+        dsdDecoder.setDecodeMode(file.m_mode, true);
+        dsdDecoder.enableMbelib(config == BenchFull);
+
+        if (config == BenchFrontEnd) { // keeps the data rate of the frame type
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
+        }
+
+        uint64_t startUs = DSDcc::TimeUtil::threadCpuUs();
+
+        for (std::vector<short>::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+            dsdDecoder.run(*it);
+        }
+
+        double nsPerSample = ((DSDcc::TimeUtil::threadCpuUs() - startUs) * 1000.0) / samples.size();
+
+        if ((iteration == 0) || (nsPerSample < run.m_bestNsPerSample)) {
+            run.m_bestNsPerSample = nsPerSample;
+        }
+
+        DSDcc::DSDStats::Snapshot stats;
+        dsdDecoder.getStats().getSnapshot(stats);
+        run.m_nbFrames = stats.m_mbeFrames; // counted whether or not the frames are stored
+        run.m_nbVoiceSyncs = 0;
+        run.m_nbDataSyncs = 0;
+
+        for (int i = 0; i < (int) DSDcc::DSDDecoder::DSDSyncNone; i++)
+        {
+            DSDcc::DSDDecoder::DSDSyncType syncType = (DSDcc::DSDDecoder::DSDSyncType) i;
+
+            if (isDataSync(syncType)) {
+                run.m_nbDataSyncs += dsdDecoder.getSyncCount(syncType);
+            } else {
+                run.m_nbVoiceSyncs += dsdDecoder.getSyncCount(syncType);
+            }
+        }
+
+        run.m_footprint = dsdDecoder.getMemoryFootprint();
+        dsdDecoder.setAudioSink(0);
+    }
+
+    return run;
+}
+
+static volatile float resamplerSink; //!< keeps the resampler output alive
+
+/** Time the conversion of samples at inputRate back to 48 kS/s as done in DSDDecoder::run */
+static double runResampler(const std::vector<short>& samples, int inputRate, int nbIterations)
+{
+    double best = 0.0;
+    float out[64];
+    float sum = 0.0f;
+
+    for (int iteration = 0; iteration < nbIterations; iteration++)
+    {
+        DSDcc::DSDResampler resampler;
+        resampler.configure(inputRate, 48000);
+        uint64_t startUs = DSDcc::TimeUtil::threadCpuUs();
+
+        for (std::vector<short>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+        {
+            int nbOut = resampler.push(*it, out);
+
+            for (int i = 0; i < nbOut; i++) {
+                sum += out[i];
+            }
+        }
+
+        double nsPerSample = ((DSDcc::TimeUtil::threadCpuUs() - startUs) * 1000.0) / samples.size();
+
+        if ((iteration == 0) || (nsPerSample < best)) {
+            best = nsPerSample;
+        }
+    }
+
+    resamplerSink = sum;
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    std::string samplesDir = DSDCC_SAMPLES_DIR;
+    std::string filter;
+    std::string jsonFileName;
+    std::vector<int> rates;
+    int nbIterations = 3;
+
+    rates.push_back(24000);
+    rates.push_back(44100);
+    rates.push_back(96000);
+
+    while ((c = getopt(argc, argv, "hd:f:n:r:j:")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'd':
+            samplesDir = optarg;
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'n':
+            nbIterations = atoi(optarg);
+            nbIterations = nbIterations < 1 ? 1 : nbIterations;
+            break;
+        case 'r':
+        {
+            rates.clear();
+            char *token = strtok(optarg, ",");
+
+            while (token)
+            {
+                int rate = atoi(token);
+
+                if (rate >= 8000) {
+                    rates.push_back(rate);
+                }
+
+                token = strtok(0, ",");
+            }
+
+            break;
+        }
+        case 'j':
+            jsonFileName = optarg;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    // collect the sample files in name order
+    std::vector<std::string> names;
+    DIR *dir = opendir(samplesDir.c_str());
+
+    if (!dir)
+    {
+        fprintf(stderr, "Cannot open samples directory %s\n", samplesDir.c_str());
+        return 1;
+    }
+
+    struct dirent *entry;
+
+    while ((entry = readdir(dir)) != 0)
+    {
+        std::string name = entry->d_name;
+
+        if ((name.size() > 4) && (name.compare(name.size() - 4, 4, ".dis") == 0)
+            && ((filter.size() == 0) || (name.find(filter) != std::string::npos)))
+        {
+            names.push_back(name);
+        }
+    }
+
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    if (names.size() == 0)
+    {
+        fprintf(stderr, "No .dis file in %s\n", samplesDir.c_str());
+        return 1;
+    }
+
+    std::vector<BenchFile> files(names.size());
+
+    for (unsigned int i = 0; i < names.size(); i++)
+    {
+        files[i].m_name = names[i];
+        setFileMode(files[i]);
+
+        if (!loadFile(samplesDir + "/" + names[i], files[i].m_samples))
+        {
+            fprintf(stderr, "Cannot read %s\n", names[i].c_str());
+            return 1;
+        }
+    }
+
+    FILE *json = 0;
+
+    if (jsonFileName.size() > 0)
+    {
+        json = (jsonFileName == "-") ? stdout : fopen(jsonFileName.c_str(), "w");
+
+        if (!json)
+        {
+            fprintf(stderr, "Cannot open %s for output\n", jsonFileName.c_str());
+            return 1;
+        }
+    }
+
+    FILE *text = (json == stdout) ? stderr : stdout;
+    fprintf(text, "DSDcc %s benchmark: %d iterations, sizeof(DSDDecoder) %lu bytes\n", DSDCC_VERSION, nbIterations, (unsigned long) sizeof(DSDcc::DSDDecoder));
+    fprintf(text, "file                   mode      samples  front(ns) proto(ns) voc(ns) total(ns)   Msamples/s  x realtime  voice  vsync  dsync  footprint\n");
+
+    if (json)
+    {
+        fprintf(json, "{\n  \"version\": \"%s\",\n  \"iterations\": %d,\n  \"sizeof_decoder\": %lu,\n  \"files\": [\n",
+            DSDCC_VERSION, nbIterations, (unsigned long) sizeof(DSDcc::DSDDecoder));
+    }
+
+    uint64_t totalSamples = 0;
+    double totalNs = 0.0;
+    unsigned int totalFrames = 0;
+
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+        const BenchFile& file = files[i];
+        BenchRun frontEnd = runDecoder(file, file.m_samples, 48000, BenchFrontEnd, nbIterations);
+        BenchRun noVocoder = runDecoder(file, file.m_samples, 48000, BenchNoVocoder, nbIterations);
+        BenchRun full = runDecoder(file, file.m_samples, 48000, BenchFull, nbIterations);
+        double protocolNs = std::max(0.0, noVocoder.m_bestNsPerSample - frontEnd.m_bestNsPerSample);
+        double vocoderNs = std::max(0.0, full.m_bestNsPerSample - noVocoder.m_bestNsPerSample);
+        double samplesPerSecond = 1e9 / full.m_bestNsPerSample;
+        double realtimeFactor = samplesPerSecond / 48000.0;
+
+        totalSamples += file.m_samples.size();
+        totalNs += full.m_bestNsPerSample * file.m_samples.size();
+        totalFrames += full.m_nbFrames;
+
+        fprintf(text, "%-22s %-6s %10lu %10.1f %9.1f %7.1f %9.1f %12.3f %11.1f %6u %6u %6u %10lu\n",
+            file.m_name.c_str(),
+            file.m_modeName,
+            (unsigned long) file.m_samples.size(),
+            frontEnd.m_bestNsPerSample,
+            protocolNs,
+            vocoderNs,
+            full.m_bestNsPerSample,
+            samplesPerSecond / 1e6,
+            realtimeFactor,
+            full.m_nbFrames,
+            full.m_nbVoiceSyncs,
+            full.m_nbDataSyncs,
+            (unsigned long) full.m_footprint);
+
+        if (json)
+        {
+            fprintf(json, "    {\n      \"file\": \"%s\",\n      \"mode\": \"%s\",\n      \"samples\": %lu,\n      \"duration_s\": %.3f,\n",
+                file.m_name.c_str(), file.m_modeName, (unsigned long) file.m_samples.size(), file.m_samples.size() / 48000.0);
+            fprintf(json, "      \"ns_per_sample\": {\"frontend\": %.2f, \"protocol\": %.2f, \"vocoder\": %.2f, \"total\": %.2f},\n",
+                frontEnd.m_bestNsPerSample, protocolNs, vocoderNs, full.m_bestNsPerSample);
+            fprintf(json, "      \"samples_per_s\": %.0f,\n      \"realtime_factor\": %.2f,\n", samplesPerSecond, realtimeFactor);
+            fprintf(json, "      \"voice_frames\": %u,\n      \"voice_syncs\": %u,\n      \"data_syncs\": %u,\n      \"memory_footprint\": %lu,\n",
+                full.m_nbFrames, full.m_nbVoiceSyncs, full.m_nbDataSyncs, (unsigned long) full.m_footprint);
+            fprintf(json, "      \"rates\": [");
+        }
+
+        // cost of non nominal input rates: the file is converted to the rate then decoded back through the input resampler
+        for (unsigned int r = 0; r < rates.size(); r++)
+        {
+            DSDcc::DSDResampler resampler;
+            resampler.configure(48000, rates[r]);
+            std::vector<short> resampled(resampler.getMaxOutput(file.m_samples.size()));
+            resampled.resize(resampler.process(file.m_samples.data(), file.m_samples.size(), resampled.data()));
+
+            BenchRun rateRun = runDecoder(file, resampled, rates[r], BenchFull, nbIterations);
+            double resamplerNs = runResampler(resampled, rates[r], nbIterations);
+
+            fprintf(text, "  input at %6d S/s: %7.1f ns/input sample of which resampling %5.1f, x realtime %.1f, voice %u\n",
+                rates[r],
+                rateRun.m_bestNsPerSample,
+                resamplerNs,
+                1e9 / (rateRun.m_bestNsPerSample * rates[r]),
+                rateRun.m_nbFrames);
+
+            if (json)
+            {
+                fprintf(json, "%s\n        {\"input_rate\": %d, \"ns_per_input_sample\": %.2f, \"resampler_ns_per_input_sample\": %.2f, \"realtime_factor\": %.2f, \"voice_frames\": %u}",
+                    r == 0 ? "" : ",",
+                    rates[r],
+                    rateRun.m_bestNsPerSample,
+                    resamplerNs,
+                    1e9 / (rateRun.m_bestNsPerSample * rates[r]),
+                    rateRun.m_nbFrames);
+            }
+        }
+
+        if (json) {
+            fprintf(json, "%s]\n    }%s\n", rates.size() > 0 ? "\n      " : "", i + 1 < files.size() ? "," : "");
+        }
+    }
+
+    double constructUs, resetUs;
+    runDecoderSetup(nbIterations, constructUs, resetUs);
+    fprintf(text, "decoder setup: construction %.1f us reset from pool %.1f us\n", constructUs, resetUs);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double totalSamplesPerSecond = totalNs > 0.0 ? (totalSamples * 1e9) / totalNs : 0.0;
+
+    fprintf(text, "total: %lu samples %.3f Msamples/s x realtime %.1f voice frames %u max RSS %ld kB\n",
+        (unsigned long) totalSamples,
+        totalSamplesPerSecond / 1e6,
+        totalSamplesPerSecond / 48000.0,
+        totalFrames,
+        usage.ru_maxrss);
+
+    if (json)
+    {
+        fprintf(json, "  ],\n  \"total\": {\"samples\": %lu, \"samples_per_s\": %.0f, \"realtime_factor\": %.2f, \"voice_frames\": %u},\n",
+            (unsigned long) totalSamples, totalSamplesPerSecond, totalSamplesPerSecond / 48000.0, totalFrames);
+        fprintf(json, "  \"decoder_setup_us\": {\"construction\": %.2f, \"reset\": %.2f},\n", constructUs, resetUs);
+        fprintf(json, "  \"max_rss_kb\": %ld\n}\n", usage.ru_maxrss);
+
+        if (json != stdout) {
+            fclose(json);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+#include "dsd_capture.h"
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc-capdump [options] <capture file>\n");
+    fprintf(stderr, "Converts a frame capture file written by dsdccx -C to CSV or JSON\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -j            JSON output: one object per line (default is CSV)\n");
+    fprintf(stderr, "  -t <text>     Only frame types which name contains this text (ex: DMR, YSFFICH)\n");
+    fprintf(stderr, "  -o <file>     Output file (default stdout)\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Sample is the input sample count at 48 kS/s, sync the DSDDecoder::DSDSyncType, slot -1 if not\n");
+    fprintf(stderr, "applicable. Bits are in hexadecimal MSB first, the last byte padded with zeros.\n");
+}
+
+static void formatBits(const DSDcc::DSDCapture::Record& record, std::string& hex)
+{
+    static const char digits[] = "0123456789abcdef";
+    hex.clear();
+
+    for (unsigned int i = 0; i < (record.m_nbBits + 7) / 8; i++)
+    {
+        hex.push_back(digits[record.m_bytes[i] >> 4]);
+        hex.push_back(digits[record.m_bytes[i] & 0xf]);
+    }
+}
+
+static void writeCSV(FILE *out, const DSDcc::DSDCapture::Record& record, const std::string& hex)
+{
+    const DSDcc::DSDCapture::Frame& frame = record.m_frame;
+
+    fprintf(out, "%llu,%s,%d,%d,%s,%s,",
+            (unsigned long long) record.m_sampleCount,
+            DSDcc::DSDCapture::getFrameTypeName(frame.m_type),
+            record.m_syncType,
+            frame.m_slot,
+            DSDcc::DSDCapture::getStatusName(frame.m_fecStatus),
+            DSDcc::DSDCapture::getStatusName(frame.m_crcStatus));
+
+    for (unsigned int f = 0; f < frame.m_nbFields; f++)
+    {
+        const char *name = DSDcc::DSDCapture::getFieldName(frame.m_type, f);
+        fprintf(out, "%s%s=%u", f ? ";" : "", name ? name : "field", frame.m_fields[f]);
+    }
+
+    fprintf(out, ",%u,%s\n", record.m_nbBits, hex.c_str());
+}
+
+static void writeJSON(FILE *out, const DSDcc::DSDCapture::Record& record, const std::string& hex)
+{
+    const DSDcc::DSDCapture::Frame& frame = record.m_frame;
+
+    fprintf(out, "{\"sample\": %llu, \"frame\": \"%s\", \"sync\": %d, \"slot\": %d, \"fec\": \"%s\", \"crc\": \"%s\", \"fields\": {",
+            (unsigned long long) record.m_sampleCount,
+            DSDcc::DSDCapture::getFrameTypeName(frame.m_type),
+            record.m_syncType,
+            frame.m_slot,
+            DSDcc::DSDCapture::getStatusName(frame.m_fecStatus),
+            DSDcc::DSDCapture::getStatusName(frame.m_crcStatus));
+
+    for (unsigned int f = 0; f < frame.m_nbFields; f++)
+    {
+        const char *name = DSDcc::DSDCapture::getFieldName(frame.m_type, f);
+        fprintf(out, "%s\"%s\": %u", f ? ", " : "", name ? name : "field", frame.m_fields[f]);
+    }
+
+    fprintf(out, "}, \"nbBits\": %u, \"bits\": \"%s\"}\n", record.m_nbBits, hex.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    extern int optind;
+    bool json = false;
+    std::string filter;
+    std::string outFileName;
+
+    while ((c = getopt(argc, argv, "hjt:o:")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'j':
+            json = true;
+            break;
+        case 't':
+            filter = optarg;
+            break;
+        case 'o':
+            outFileName = optarg;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        usage();
+        return 1;
+    }
+
+    DSDcc::DSDCapture::Reader reader;
+
+    if (!reader.open(argv[optind]))
+    {
+        fprintf(stderr, "Cannot open %s as a capture file\n", argv[optind]);
+        return 1;
+    }
+
+    FILE *out = stdout;
+
+    if (outFileName.size() > 0)
+    {
+        out = fopen(outFileName.c_str(), "w");
+
+        if (!out)
+        {
+            fprintf(stderr, "Cannot open %s for output\n", outFileName.c_str());
+            return 1;
+        }
+    }
+
+    if (!json) {
+        fprintf(out, "sample,frame,sync,slot,fec,crc,fields,nbBits,bits\n");
+    }
+
+    DSDcc::DSDCapture::Record record;
+    std::string hex;
+    unsigned int nbRecords = 0;
+
+    while (reader.next(record))
+    {
+        if ((filter.size() > 0) && !strstr(DSDcc::DSDCapture::getFrameTypeName(record.m_frame.m_type), filter.c_str())) {
+            continue;
+        }
+
+        formatBits(record, hex);
+
+        if (json) {
+            writeJSON(out, record, hex);
+        } else {
+            writeCSV(out, record, hex);
+        }
+
+        nbRecords++;
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    fprintf(stderr, "%u records\n", nbRecords);
+    return 0;
+}
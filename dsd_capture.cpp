@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "dsd_capture.h"
+
+namespace DSDcc
+{
+
+const char *DSDCapture::m_frameTypeNames[DSDCapture::FrameTypeCount] = {
+    "None",
+    "DMRData",
+    "DMRVoiceLC",
+    "DStarHeader",
+    "DStarSlowHeader",
+    "DPMRHeader",
+    "DPMRCCH",
+    "YSFFICH",
+    "YSFDCH",
+    "NXDNSACCH",
+    "NXDNCACOutbound",
+    "NXDNCACLong",
+    "NXDNCACShort",
+    "NXDNFACCH1",
+    "NXDNUDCH"
+};
+
+const char *DSDCapture::m_fieldNames[DSDCapture::FrameTypeCount][DSDCapture::m_maxFields] = {
+    {0},
+    {"colorCode", "dataType"},
+    {"group", "target", "source"},
+    {0},
+    {0},
+    {"headerType", "calledId", "ownId", "mode", "format"},
+    {"frameNumber", "mode", "format"},
+    {"frameInformation", "callMode", "blockNumber", "blockTotal", "frameNumber", "frameTotal", "dataType"},
+    {"frameNumber"},
+    {"ran"},
+    {"ran"},
+    {"ran"},
+    {"ran"},
+    {0},
+    {"ran"}
+};
+
+const char *DSDCapture::m_statusNames[4] = {
+    "none",
+    "ok",
+    "corrected",
+    "failed"
+};
+
+DSDCapture::DSDCapture() :
+    m_file(0),
+    m_batchIndex(0),
+    m_batchFill(0),
+    m_pendingBatch(-1),
+    m_pendingSize(0),
+    m_stop(false),
+    m_recordCount(0),
+    m_dropped(0)
+{
+    m_batches[0] = new unsigned char[m_batchSize];
+    m_batches[1] = new unsigned char[m_batchSize];
+}
+
+DSDCapture::~DSDCapture()
+{
+    close();
+    delete[] m_batches[1];
+    delete[] m_batches[0];
+}
+
+bool DSDCapture::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "wb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    static const unsigned char magic[8] = {'D', 'S', 'D', 'C', 'C', 'A', 'P', 1};
+    fwrite(magic, 1, 8, m_file);
+
+    m_batchIndex = 0;
+    m_batchFill = 0;
+    m_pendingBatch = -1;
+    m_stop = false;
+    m_recordCount.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_thread = std::thread(&DSDCapture::run, this);
+    return true;
+}
+
+void DSDCapture::close()
+{
+    if (!m_file) {
+        return;
+    }
+
+    submit();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]{ return m_pendingBatch < 0; }); // last batch may have been dropped if the writer was busy
+        m_stop = true;
+        m_condition.notify_all();
+    }
+
+    m_thread.join();
+
+    if (m_batchFill > 0) { // write what could not be submitted
+        fwrite(m_batches[m_batchIndex], 1, m_batchFill, m_file);
+        m_batchFill = 0;
+    }
+
+    fclose(m_file);
+    m_file = 0;
+}
+
+void DSDCapture::writeBits(const Frame& frame, uint64_t sampleCount, int syncType, const unsigned char *bits, unsigned int nbBits)
+{
+    unsigned char *p = appendHeader(frame, sampleCount, syncType, nbBits);
+
+    if (!p) {
+        return;
+    }
+
+    nbBits = nbBits > m_maxBits ? m_maxBits : nbBits;
+    memset(p, 0, (nbBits + 7) / 8);
+
+    for (unsigned int i = 0; i < nbBits; i++) {
+        p[i/8] |= (bits[i] & 1) << (7 - (i%8));
+    }
+}
+
+void DSDCapture::writeBytes(const Frame& frame, uint64_t sampleCount, int syncType, const unsigned char *bytes, unsigned int nbBits)
+{
+    unsigned char *p = appendHeader(frame, sampleCount, syncType, nbBits);
+
+    if (!p) {
+        return;
+    }
+
+    nbBits = nbBits > m_maxBits ? m_maxBits : nbBits;
+    unsigned int nbBytes = (nbBits + 7) / 8;
+    memcpy(p, bytes, nbBytes);
+
+    if (nbBits % 8) {
+        p[nbBytes - 1] &= 0xff << (8 - (nbBits % 8)); // clear the bits past the end
+    }
+}
+
+unsigned char *DSDCapture::appendHeader(const Frame& frame, uint64_t sampleCount, int syncType, unsigned int nbBits)
+{
+    if (!m_file) {
+        return 0;
+    }
+
+    nbBits = nbBits > m_maxBits ? m_maxBits : nbBits;
+    unsigned int size = m_headerSize + 4*frame.m_nbFields + (nbBits + 7) / 8;
+
+    if (m_batchFill + size > m_batchSize)
+    {
+        submit();
+
+        if (m_batchFill + size > m_batchSize) // writer still busy with the previous batch
+        {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+
+    unsigned char *p = &m_batches[m_batchIndex][m_batchFill];
+    m_batchFill += size;
+
+    p[0] = size & 0xff;
+    p[1] = (size >> 8) & 0xff;
+    p[2] = (unsigned char) frame.m_type;
+    p[3] = (unsigned char) syncType;
+
+    for (int i = 0; i < 8; i++) {
+        p[4+i] = (sampleCount >> (8*i)) & 0xff;
+    }
+
+    p[12] = frame.m_slot < 0 ? 255 : frame.m_slot;
+    p[13] = ((int) frame.m_fecStatus) + (((int) frame.m_crcStatus) << 2);
+    p[14] = nbBits & 0xff;
+    p[15] = (nbBits >> 8) & 0xff;
+    p[16] = frame.m_nbFields;
+    p += m_headerSize;
+
+    for (unsigned int f = 0; f < frame.m_nbFields; f++, p += 4)
+    {
+        p[0] = frame.m_fields[f] & 0xff;
+        p[1] = (frame.m_fields[f] >> 8) & 0xff;
+        p[2] = (frame.m_fields[f] >> 16) & 0xff;
+        p[3] = (frame.m_fields[f] >> 24) & 0xff;
+    }
+
+    m_recordCount.store(m_recordCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return p;
+}
+
+void DSDCapture::submit()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ((m_pendingBatch >= 0) || (m_batchFill == 0)) {
+        return;
+    }
+
+    m_pendingBatch = m_batchIndex;
+    m_pendingSize = m_batchFill;
+    m_batchIndex ^= 1;
+    m_batchFill = 0;
+    m_condition.notify_all();
+}
+
+void DSDCapture::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_condition.wait(lock, [this]{ return m_stop || (m_pendingBatch >= 0); });
+
+        if (m_pendingBatch >= 0)
+        {
+            unsigned char *batch = m_batches[m_pendingBatch];
+            unsigned int size = m_pendingSize;
+            lock.unlock();
+            fwrite(batch, 1, size, m_file);
+            lock.lock();
+            m_pendingBatch = -1;
+            m_condition.notify_all();
+        }
+        else if (m_stop)
+        {
+            break;
+        }
+    }
+}
+
+const char *DSDCapture::getFrameTypeName(FrameType frameType)
+{
+    return (frameType < FrameTypeCount) ? m_frameTypeNames[frameType] : "Unknown";
+}
+
+const char *DSDCapture::getFieldName(FrameType frameType, unsigned int index)
+{
+    if ((frameType >= FrameTypeCount) || (index >= m_maxFields)) {
+        return 0;
+    }
+
+    return m_fieldNames[frameType][index];
+}
+
+const char *DSDCapture::getStatusName(Status status)
+{
+    return m_statusNames[status & 3];
+}
+
+DSDCapture::Reader::Reader() :
+    m_file(0)
+{}
+
+DSDCapture::Reader::~Reader()
+{
+    close();
+}
+
+bool DSDCapture::Reader::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "rb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    unsigned char magic[8];
+
+    if ((fread(magic, 1, 8, m_file) != 8) || (memcmp(magic, "DSDCCAP", 7) != 0) || (magic[7] != 1))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void DSDCapture::Reader::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+}
+
+bool DSDCapture::Reader::next(Record& record)
+{
+    unsigned char buffer[m_maxRecordSize];
+
+    if (!m_file || (fread(buffer, 1, m_headerSize, m_file) != m_headerSize)) {
+        return false;
+    }
+
+    unsigned int size = buffer[0] + (buffer[1] << 8);
+    unsigned int nbFields = buffer[16];
+    unsigned int nbBits = buffer[14] + (buffer[15] << 8);
+
+    if ((size > m_maxRecordSize) || (nbFields > m_maxFields) || (nbBits > m_maxBits)
+     || (size != m_headerSize + 4*nbFields + (nbBits + 7) / 8)) {
+        return false; // corrupted
+    }
+
+    if (fread(&buffer[m_headerSize], 1, size - m_headerSize, m_file) != size - m_headerSize) {
+        return false;
+    }
+
+    record.m_frame = Frame((FrameType) buffer[2], buffer[12] == 255 ? -1 : buffer[12]);
+    record.m_syncType = buffer[3];
+    record.m_sampleCount = 0;
+
+    for (int i = 0; i < 8; i++) {
+        record.m_sampleCount += ((uint64_t) buffer[4+i]) << (8*i);
+    }
+
+    record.m_frame.m_fecStatus = (Status) (buffer[13] & 3);
+    record.m_frame.m_crcStatus = (Status) ((buffer[13] >> 2) & 3);
+    const unsigned char *p = &buffer[m_headerSize];
+
+    for (unsigned int f = 0; f < nbFields; f++, p += 4) {
+        record.m_frame.addField(p[0] + (p[1] << 8) + (p[2] << 16) + ((uint32_t) p[3] << 24));
+    }
+
+    record.m_nbBits = nbBits;
+    memcpy(record.m_bytes, p, (nbBits + 7) / 8);
+    return true;
+}
+
+} // namespace DSDcc
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_CAPTURE_H_
+#define DSDCC_DSD_CAPTURE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Binary capture of the decoded frames (see DSDDecoder::setCapture).
+ *
+ * The file starts with the 8 bytes "DSDCCAP" followed by the format version. Then there is
+ * one record per frame decoded by a protocol decoder. Integers are little endian:
+ *
+ *   - uint16 record size in bytes including this field
+ *   - uint8  frame type (FrameType)
+ *   - uint8  sync type (DSDDecoder::DSDSyncType)
+ *   - uint64 input sample count at 48 kS/s when the frame was decoded
+ *   - uint8  TDMA slot (0 or 1) or 255 if not applicable
+ *   - uint8  FEC status (bits 0..1) and CRC status (bits 2..3) (Status)
+ *   - uint16 number of frame bits
+ *   - uint8  number of fields
+ *   - uint32 fields parsed by the decoder, meaning depends on the frame type (getFieldName)
+ *   - frame bits packed MSB first after deinterleaving and FEC decoding
+ *
+ * Records are appended to one of two batch buffers on the decoding thread and each full
+ * buffer is written to the file by a background thread. If the writer is still busy with
+ * the previous batch when the current one is full the record is dropped and counted.
+ */
+class DSDCC_API DSDCapture
+{
+public:
+    typedef enum
+    {
+        FrameNone,
+        FrameDMRData,           //!< DMR data burst: BPTC(196,96) info bits deinterleaved
+        FrameDMRVoiceLC,        //!< DMR voice embedded link control: 128 bits BPTC matrix
+        FrameDStarHeader,       //!< D-Star radio header after Viterbi decoding: 328 bits
+        FrameDStarSlowHeader,   //!< D-Star radio header from slow data: 41 bytes
+        FrameDPMRHeader,        //!< dPMR header: 72 bits with CRC8
+        FrameDPMRCCH,           //!< dPMR control channel: 48 bits with CRC7
+        FrameYSFFICH,           //!< YSF FICH: 48 bits with CRC16
+        FrameYSFDCH,            //!< YSF data channel after Viterbi decoding with CRC16
+        FrameNXDNSACCH,         //!< NXDN channels after depuncturing and convolutional decoding
+        FrameNXDNCACOutbound,
+        FrameNXDNCACLong,
+        FrameNXDNCACShort,
+        FrameNXDNFACCH1,
+        FrameNXDNUDCH,
+        FrameTypeCount
+    } FrameType;
+
+    typedef enum
+    {
+        StatusNone,             //!< not checked
+        StatusOK,
+        StatusCorrected,        //!< FEC corrected errors
+        StatusFailed
+    } Status;
+
+    static const unsigned int m_maxFields = 8;
+    static const unsigned int m_maxBits = 512;
+    static const unsigned int m_headerSize = 17;
+    static const unsigned int m_maxRecordSize = m_headerSize + 4*m_maxFields + m_maxBits/8;
+    static const unsigned int m_batchSize = 1<<16;  //!< bytes
+
+    /** Frame description filled by the protocol decoder */
+    struct Frame
+    {
+        FrameType m_type;
+        int m_slot;             //!< -1 if not applicable
+        Status m_fecStatus;
+        Status m_crcStatus;
+        unsigned int m_nbFields;
+        uint32_t m_fields[m_maxFields];
+
+        explicit Frame(FrameType type, int slot = -1) :
+            m_type(type),
+            m_slot(slot),
+            m_fecStatus(StatusNone),
+            m_crcStatus(StatusNone),
+            m_nbFields(0)
+        {}
+
+        void setFEC(bool ok, unsigned int nbCorrected) { m_fecStatus = ok ? (nbCorrected ? StatusCorrected : StatusOK) : StatusFailed; }
+        void setCRC(bool ok) { m_crcStatus = ok ? StatusOK : StatusFailed; }
+        void addField(uint32_t value) { if (m_nbFields < m_maxFields) { m_fields[m_nbFields++] = value; } }
+    };
+
+    /** Record as read back from a capture file */
+    struct Record
+    {
+        Frame m_frame;
+        int m_syncType;
+        uint64_t m_sampleCount;
+        unsigned int m_nbBits;
+        unsigned char m_bytes[m_maxBits/8];
+
+        Record() : m_frame(FrameNone), m_syncType(0), m_sampleCount(0), m_nbBits(0) {}
+        unsigned char getBit(unsigned int index) const { return (m_bytes[index/8] >> (7 - (index%8))) & 1; }
+    };
+
+    DSDCapture();
+    ~DSDCapture();
+
+    bool open(const char *filename);
+    void close(); //!< writes the last batch and closes the file
+    bool isOpen() const { return m_file != 0; }
+
+    /** Appends a frame given as one bit per byte */
+    void writeBits(const Frame& frame, uint64_t sampleCount, int syncType, const unsigned char *bits, unsigned int nbBits);
+    /** Appends a frame given as bytes packed MSB first */
+    void writeBytes(const Frame& frame, uint64_t sampleCount, int syncType, const unsigned char *bytes, unsigned int nbBits);
+
+    uint64_t getRecordCount() const { return m_recordCount.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    static const char *getFrameTypeName(FrameType frameType);
+    static const char *getFieldName(FrameType frameType, unsigned int index);
+    static const char *getStatusName(Status status);
+
+    /** Sequential reader of a capture file */
+    class DSDCC_API Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+        bool open(const char *filename); //!< false if the file cannot be opened or is not a capture
+        void close();
+        bool next(Record& record); //!< false at the end of the file or on a truncated record
+
+    private:
+        FILE *m_file;
+    };
+
+private:
+    unsigned char *appendHeader(const Frame& frame, uint64_t sampleCount, int syncType, unsigned int nbBits);
+    void submit(); //!< hands the current batch over to the writer thread
+    void run();
+
+    FILE *m_file;
+    unsigned char *m_batches[2];
+    unsigned int m_batchIndex;      //!< batch being filled by the decoding thread
+    unsigned int m_batchFill;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    int m_pendingBatch;             //!< batch being written by the writer thread or -1
+    unsigned int m_pendingSize;
+    bool m_stop;
+    std::atomic<uint64_t> m_recordCount;
+    std::atomic<uint64_t> m_dropped;
+
+    static const char *m_frameTypeNames[FrameTypeCount];
+    static const char *m_fieldNames[FrameTypeCount][m_maxFields];
+    static const char *m_statusNames[4];
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_CAPTURE_H_ */
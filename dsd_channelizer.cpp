@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "dsd_channelizer.h"
+#include "dsd_filters.h"
+#include "dsd_iqfrontend.h"
+
+namespace DSDcc
+{
+
+DSDChannelizer::DSDChannelizer() :
+        m_sampleRate(0),
+        m_channelSpacing(0),
+        m_nbChannels(0),
+        m_tapsPerPhase(0),
+        m_historySize(0),
+        m_historyIndex(0),
+        m_inputCount(0),
+        m_discriminatorGain(0.0f)
+{
+}
+
+DSDChannelizer::~DSDChannelizer()
+{
+}
+
+bool DSDChannelizer::configure(int sampleRate, int channelSpacing, int tapsPerPhase)
+{
+    if ((channelSpacing <= 0) || (sampleRate % channelSpacing != 0) || (sampleRate / channelSpacing < 2)) {
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_channelSpacing = channelSpacing;
+    m_nbChannels = sampleRate / channelSpacing;
+    m_tapsPerPhase = tapsPerPhase;
+
+    m_historySize = m_nbChannels * m_tapsPerPhase;
+    m_prototype.resize(m_historySize);
+    DSDFilters::designLowpass(m_prototype.data(), m_historySize, 0.5f / m_nbChannels, 1.0f);
+    m_history.assign(2 * m_historySize, std::complex<float>(0.0f, 0.0f));
+    m_historyIndex = 0;
+    m_inputCount = 0;
+
+    m_fft.configure(m_nbChannels);
+    m_fftBuffer.resize(m_nbChannels);
+    m_channels.assign(m_nbChannels, Channel());
+    m_discriminatorGain = 32767.0f * m_channelSpacing / (2.0f * M_PI * DSDIQFrontEnd::m_deviationFullScale);
+
+    return true;
+}
+
+int DSDChannelizer::getChannelIndex(int frequencyOffset) const
+{
+    if (m_nbChannels == 0) {
+        return -1;
+    }
+
+    int k = (int) floor((double) frequencyOffset / m_channelSpacing + 0.5);
+
+    if ((k < -m_nbChannels / 2) || (k > (m_nbChannels - 1) / 2)) {
+        return -1;
+    }
+
+    return (k + m_nbChannels) % m_nbChannels;
+}
+
+void DSDChannelizer::enableChannel(int channel, bool enable)
+{
+    Channel& c = m_channels[channel];
+
+    if (enable && !c.m_enabled) {
+        c.m_resampler.configure(m_channelSpacing, m_outputRate);
+        c.m_resampled.resize(c.m_resampler.getMaxOutput(1));
+    }
+
+    c.m_enabled = enable;
+}
+
+void DSDChannelizer::process(const float *iq, int nbSamples)
+{
+    beginProcess();
+
+    for (int i = 0; i < nbSamples; i++) {
+        pushSample(std::complex<float>(iq[2*i], iq[2*i+1]));
+    }
+
+    endProcess();
+}
+
+void DSDChannelizer::process(const short *iq, int nbSamples)
+{
+    const float scale = 1.0f / 32768.0f;
+    beginProcess();
+
+    for (int i = 0; i < nbSamples; i++) {
+        pushSample(std::complex<float>(iq[2*i] * scale, iq[2*i+1] * scale));
+    }
+
+    endProcess();
+}
+
+void DSDChannelizer::beginProcess()
+{
+    for (std::vector<Channel>::iterator it = m_channels.begin(); it != m_channels.end(); ++it) {
+        it->m_output.clear();
+    }
+}
+
+void DSDChannelizer::endProcess()
+{
+    for (std::vector<Channel>::iterator it = m_channels.begin(); it != m_channels.end(); ++it)
+    {
+        if (it->m_powerCount > 0)
+        {
+            it->m_power = it->m_powerSum / it->m_powerCount;
+            it->m_powerSum = 0.0f;
+            it->m_powerCount = 0;
+        }
+    }
+}
+
+void DSDChannelizer::processBlock()
+{
+    // polyphase branches: u[p] = sum over q of h[p + qN] x[n - p - qN]
+    const std::complex<float> *x = &m_history[m_historyIndex];
+
+    for (int p = 0; p < m_nbChannels; p++) {
+        m_fftBuffer[p] = m_prototype[p] * x[p];
+    }
+
+    for (int q = 1; q < m_tapsPerPhase; q++)
+    {
+        const float *h = &m_prototype[q * m_nbChannels];
+        const std::complex<float> *xq = &x[q * m_nbChannels];
+
+        for (int p = 0; p < m_nbChannels; p++) {
+            m_fftBuffer[p] += h[p] * xq[p];
+        }
+    }
+
+    m_fft.transform(m_fftBuffer.data(), true);
+
+    for (int k = 0; k < m_nbChannels; k++)
+    {
+        Channel& c = m_channels[k];
+
+        if (!c.m_enabled) {
+            continue;
+        }
+
+        const std::complex<float>& y = m_fftBuffer[k];
+        c.m_powerSum += std::norm(y);
+        c.m_powerCount++;
+
+        // FM discriminator
+        std::complex<float> product = y * std::conj(c.m_last);
+        float phase = DSDIQFrontEnd::fastAtan2(product.imag(), product.real());
+        c.m_last = y;
+
+        float *out = c.m_resampled.data();
+        int nbOut = c.m_resampler.push(phase * m_discriminatorGain, out);
+
+        for (int i = 0; i < nbOut; i++) {
+            c.m_output.push_back(out[i] > 32767.0f ? 32767 : out[i] < -32768.0f ? -32768 : (short) out[i]);
+        }
+    }
+}
+
+} // namespace DSDcc
@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_CHANNELIZER_H_
+#define DSDCC_DSD_CHANNELIZER_H_
+
+#include <complex>
+#include <vector>
+
+#include "dsd_fft.h"
+#include "dsd_resampler.h"
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Critically sampled polyphase FFT filterbank splitting a wideband complex signal into channels
+ * at the channel spacing (sample rate / number of channels). The enabled channels are FM demodulated
+ * and resampled to 48 kS/s discriminator samples ready to be fed to a DSDDecoder.
+ *
+ * Channel k is centered at k * spacing from the center frequency for k < N/2 and at (k - N) * spacing
+ * for k >= N/2.
+ */
+class DSDCC_API DSDChannelizer
+{
+public:
+    DSDChannelizer();
+    ~DSDChannelizer();
+
+    /** The sample rate must be a multiple of the channel spacing. Returns false if not */
+    bool configure(int sampleRate, int channelSpacing, int tapsPerPhase = 24);
+    int getNbChannels() const { return m_nbChannels; }
+    int getChannelRate() const { return m_channelSpacing; }
+    /** Index of the channel at the given offset in Hz from the center frequency or -1 if out of band */
+    int getChannelIndex(int frequencyOffset) const;
+    /** Enable or disable the demodulation of a channel */
+    void enableChannel(int channel, bool enable);
+    bool isChannelEnabled(int channel) const { return m_channels[channel].m_enabled; }
+
+    /** Process complex samples given as interleaved I/Q. nbSamples is the number of complex samples */
+    void process(const float *iq, int nbSamples);
+    void process(const short *iq, int nbSamples);
+
+    /** Discriminator samples at 48 kS/s produced for a channel by the last process() call */
+    const std::vector<short>& getChannelOutput(int channel) const { return m_channels[channel].m_output; }
+    /** Average power of the channel in the last process() call (full scale is 1.0) */
+    float getChannelPower(int channel) const { return m_channels[channel].m_power; }
+
+    static const int m_outputRate = 48000;
+
+private:
+    struct Channel
+    {
+        Channel() : m_enabled(false), m_last(1.0f, 0.0f), m_power(0.0f), m_powerSum(0.0f), m_powerCount(0) {}
+
+        bool m_enabled;
+        std::complex<float> m_last; //!< previous sample for the discriminator
+        DSDResampler m_resampler;   //!< channel rate to 48 kS/s
+        std::vector<float> m_resampled;
+        std::vector<short> m_output;
+        float m_power;
+        float m_powerSum;
+        int m_powerCount;
+    };
+
+    void pushSample(const std::complex<float>& sample)
+    {
+        m_historyIndex = (m_historyIndex + m_historySize - 1) % m_historySize;
+        m_history[m_historyIndex] = sample;
+        m_history[m_historyIndex + m_historySize] = sample;
+
+        if (++m_inputCount == m_nbChannels)
+        {
+            m_inputCount = 0;
+            processBlock();
+        }
+    }
+
+    void beginProcess();
+    void endProcess();
+    void processBlock();
+
+    int m_sampleRate;
+    int m_channelSpacing;
+    int m_nbChannels;
+    int m_tapsPerPhase;
+    std::vector<float> m_prototype;                 //!< tapsPerPhase * nbChannels prototype lowpass
+    std::vector<std::complex<float> > m_history;    //!< newest first from m_historyIndex, stored twice
+    int m_historySize;
+    int m_historyIndex;
+    int m_inputCount;
+    std::vector<std::complex<float> > m_fftBuffer;
+    DSDFFT m_fft;
+    std::vector<Channel> m_channels;
+    float m_discriminatorGain;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_CHANNELIZER_H_ */
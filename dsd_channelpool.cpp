@@ -0,0 +1,325 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "dsd_channelpool.h"
+#include "dsd_decoder.h"
+#include "timeutil.h"
+
+namespace DSDcc
+{
+
+DSDChannelPool::Channel::Channel() :
+        m_decoder(new DSDDecoder()),
+        m_scheduled(false),
+        m_nbSamples(0),
+        m_cpuUs(0)
+{
+}
+
+DSDChannelPool::Channel::~Channel()
+{
+    delete m_decoder;
+}
+
+DSDChannelPool::DSDChannelPool(int nbWorkers, bool pinWorkers) :
+        m_nbWorkers(nbWorkers),
+        m_pinWorkers(pinWorkers),
+        m_maxQueuedBlocks(64),
+        m_running(false),
+        m_stopping(false),
+        m_nbQueuedTasks(0),
+        m_nbPendingBlocks(0)
+{
+    if (m_nbWorkers <= 0)
+    {
+        m_nbWorkers = std::thread::hardware_concurrency();
+
+        if (m_nbWorkers <= 0) {
+            m_nbWorkers = 1;
+        }
+    }
+
+    for (int i = 0; i < m_nbWorkers; i++) {
+        m_workers.push_back(new Worker());
+    }
+}
+
+DSDChannelPool::~DSDChannelPool()
+{
+    stop();
+
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it) {
+        delete *it;
+    }
+
+    for (std::vector<Channel*>::iterator it = m_channels.begin(); it != m_channels.end(); ++it) {
+        delete *it;
+    }
+}
+
+int DSDChannelPool::addChannel()
+{
+    m_channels.push_back(new Channel());
+    return m_channels.size() - 1;
+}
+
+void DSDChannelPool::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_stopping = false;
+    m_running = true;
+
+    for (int i = 0; i < m_nbWorkers; i++)
+    {
+        m_workers[i]->m_thread = std::thread(&DSDChannelPool::work, this, i);
+
+#ifdef __linux__
+        if (m_pinWorkers)
+        {
+            int nbCPUs = std::thread::hardware_concurrency();
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(i % (nbCPUs > 0 ? nbCPUs : 1), &cpuSet);
+            pthread_setaffinity_np(m_workers[i]->m_thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+        }
+#endif
+    }
+}
+
+void DSDChannelPool::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_taskAvailable.notify_all();
+
+    for (int i = 0; i < m_nbWorkers; i++) {
+        m_workers[i]->m_thread.join();
+    }
+
+    m_running = false;
+}
+
+void DSDChannelPool::push(int channel, const short *samples, int nbSamples)
+{
+    Channel& c = *m_channels[channel];
+    bool doSchedule;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nbPendingBlocks++;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(c.m_mutex);
+
+        while (m_running && ((int) c.m_blocks.size() >= m_maxQueuedBlocks)) {
+            c.m_spaceAvailable.wait(lock);
+        }
+
+        c.m_blocks.push_back(std::vector<short>());
+        std::vector<short>& block = c.m_blocks.back();
+
+        if (!c.m_freeBlocks.empty())
+        {
+            block.swap(c.m_freeBlocks.back());
+            c.m_freeBlocks.pop_back();
+        }
+
+        block.assign(samples, samples + nbSamples); // no allocation if the buffer is large enough
+        doSchedule = !c.m_scheduled;
+        c.m_scheduled = true;
+    }
+
+    if (doSchedule) {
+        schedule(channel % m_nbWorkers, channel);
+    }
+}
+
+void DSDChannelPool::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_nbPendingBlocks > 0) {
+        m_idle.wait(lock);
+    }
+}
+
+void DSDChannelPool::schedule(int workerIndex, int channel)
+{
+    Worker& w = *m_workers[workerIndex];
+
+    {
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+        w.m_tasks.push_back(channel);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nbQueuedTasks++;
+    }
+
+    m_taskAvailable.notify_one();
+}
+
+bool DSDChannelPool::popTask(int workerIndex, int& channel)
+{
+    bool found = false;
+
+    {
+        Worker& w = *m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+
+        if (!w.m_tasks.empty())
+        {
+            channel = w.m_tasks.front();
+            w.m_tasks.pop_front();
+            found = true;
+        }
+    }
+
+    // steal from the back of the other workers queues
+    for (int i = 1; !found && (i < m_nbWorkers); i++)
+    {
+        Worker& victim = *m_workers[(workerIndex + i) % m_nbWorkers];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+
+        if (!victim.m_tasks.empty())
+        {
+            channel = victim.m_tasks.back();
+            victim.m_tasks.pop_back();
+            m_workers[workerIndex]->m_nbSteals++;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nbQueuedTasks--;
+    }
+
+    return found;
+}
+
+void DSDChannelPool::work(int workerIndex)
+{
+    int channel;
+
+    while (true)
+    {
+        if (popTask(workerIndex, channel))
+        {
+            m_workers[workerIndex]->m_nbTasks++;
+            processChannel(channel);
+
+            bool more;
+            Channel& c = *m_channels[channel];
+
+            {
+                std::lock_guard<std::mutex> lock(c.m_mutex);
+                more = !c.m_blocks.empty();
+                c.m_scheduled = more;
+            }
+
+            if (more) { // yield to other channels in this worker queue
+                schedule(workerIndex, channel);
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while ((m_nbQueuedTasks <= 0) && !m_stopping) {
+            m_taskAvailable.wait(lock);
+        }
+
+        if (m_stopping && (m_nbQueuedTasks <= 0)) {
+            break;
+        }
+    }
+}
+
+void DSDChannelPool::processChannel(int channel)
+{
+    Channel& c = *m_channels[channel];
+    uint64_t startUs = TimeUtil::threadCpuUs();
+    int nbBlocks = 0;
+    std::vector<short> block;
+
+    for (; nbBlocks < m_maxBlocksPerTask; nbBlocks++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(c.m_mutex);
+
+            if (c.m_blocks.empty()) {
+                break;
+            }
+
+            block.swap(c.m_blocks.front());
+            c.m_blocks.pop_front();
+        }
+
+        c.m_spaceAvailable.notify_one();
+
+        for (std::vector<short>::const_iterator it = block.begin(); it != block.end(); ++it) {
+            c.m_decoder->run(*it);
+        }
+
+        c.m_nbSamples += block.size();
+
+        {
+            std::lock_guard<std::mutex> lock(c.m_mutex);
+
+            if ((int) c.m_freeBlocks.size() < m_maxQueuedBlocks)
+            {
+                c.m_freeBlocks.push_back(std::vector<short>());
+                c.m_freeBlocks.back().swap(block);
+            }
+        }
+    }
+
+    c.m_cpuUs += TimeUtil::threadCpuUs() - startUs;
+
+    if (nbBlocks > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nbPendingBlocks -= nbBlocks;
+
+        if (m_nbPendingBlocks == 0) {
+            m_idle.notify_all();
+        }
+    }
+}
+
+} // namespace DSDcc
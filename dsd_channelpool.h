@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_CHANNELPOOL_H_
+#define DSDCC_DSD_CHANNELPOOL_H_
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+class DSDDecoder;
+
+/**
+ * Hosts many DSDDecoder instances (channels) and runs them on a fixed pool of worker threads.
+ *
+ * Blocks of samples are pushed per channel and queued in the channel. A channel with pending
+ * blocks is scheduled as a task on the deque of the worker it is affine to. Idle workers steal
+ * tasks from the other workers deques. A channel is processed by one worker at a time so
+ * decoders and their sinks need not be thread safe.
+ */
+class DSDCC_API DSDChannelPool
+{
+public:
+    /** nbWorkers = 0 uses the number of hardware threads. pinWorkers pins worker #i to CPU #i (Linux only) */
+    explicit DSDChannelPool(int nbWorkers = 0, bool pinWorkers = false);
+    ~DSDChannelPool();
+
+    /** Create a new channel with its decoder owned by the pool. Channels must be added before start(). Returns its index */
+    int addChannel();
+    int getNbChannels() const { return m_channels.size(); }
+    int getNbWorkers() const { return m_nbWorkers; }
+    DSDDecoder& getDecoder(int channel) { return *m_channels[channel]->m_decoder; }
+    /** Maximum number of blocks queued in a channel before push() blocks once started */
+    void setMaxQueuedBlocks(int maxQueuedBlocks) { m_maxQueuedBlocks = maxQueuedBlocks; }
+
+    void start();
+    /** Process all pending blocks then stop the workers */
+    void stop();
+    /**
+     * Push a block of samples to a channel. The samples are copied into a buffer reused from
+     * the channel free list. Once started it blocks while the channel queue is full. Before
+     * start() it does not block and the blocks are queued without limit until the workers run.
+     * Must not be called concurrently with start() or stop().
+     */
+    void push(int channel, const short *samples, int nbSamples);
+    /** Wait until all pushed blocks have been processed */
+    void waitIdle();
+
+    uint64_t getChannelSamples(int channel) const { return m_channels[channel]->m_nbSamples; }
+    uint64_t getChannelCpuUs(int channel) const { return m_channels[channel]->m_cpuUs; } //!< CPU time used to process the channel in microseconds
+    uint64_t getWorkerTasks(int worker) const { return m_workers[worker]->m_nbTasks; }
+    uint64_t getWorkerSteals(int worker) const { return m_workers[worker]->m_nbSteals; }
+
+private:
+    struct Channel
+    {
+        Channel();
+        ~Channel();
+
+        DSDDecoder *m_decoder;
+        std::mutex m_mutex;
+        std::condition_variable m_spaceAvailable;
+        std::deque<std::vector<short> > m_blocks;
+        std::vector<std::vector<short> > m_freeBlocks; //!< processed block buffers reused by push()
+        bool m_scheduled;        //!< channel is in a worker queue or being processed
+        std::atomic<uint64_t> m_nbSamples;
+        std::atomic<uint64_t> m_cpuUs;
+    };
+
+    struct Worker
+    {
+        Worker() : m_nbTasks(0), m_nbSteals(0) {}
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::deque<int> m_tasks; //!< indexes of channels to process
+        std::atomic<uint64_t> m_nbTasks;
+        std::atomic<uint64_t> m_nbSteals;
+    };
+
+    void work(int workerIndex);
+    bool popTask(int workerIndex, int& channel);
+    void schedule(int workerIndex, int channel);
+    void processChannel(int channel);
+
+    static const int m_maxBlocksPerTask = 4; //!< blocks processed before the channel yields to others
+
+    int m_nbWorkers;
+    bool m_pinWorkers;
+    int m_maxQueuedBlocks;
+    std::vector<Channel*> m_channels;
+    std::vector<Worker*> m_workers;
+    bool m_running;
+    bool m_stopping;
+    std::mutex m_mutex;                 //!< protects the sleep/wake up and idle conditions below
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    int64_t m_nbQueuedTasks;            //!< tasks in workers queues (transiently negative when a task is popped before being counted)
+    uint64_t m_nbPendingBlocks;         //!< blocks pushed and not processed yet
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_CHANNELPOOL_H_ */
@@ -15,13 +15,19 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include <limits.h>
+#include <algorithm>
 #include "timeutil.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
 
+static_assert(DSDStats::NbSyncTypes == DSDDecoder::DSDSyncNone, "DSDStats sync counters do not match DSDSyncType");
+
 // Sync wods - Symbol mapping: 01(1):+3, 00(0):+1, 10(2):-1, 11(3):-3
 const unsigned char DSDDecoder::m_syncDMRDataBS[24]       = {3, 1, 3, 3, 3, 3, 1, 1, 1, 3, 3, 1, 1, 3, 1, 1, 3, 1, 3, 3, 1, 1, 3, 1}; // DF F5 7D 75 DF 5D
 const unsigned char DSDDecoder::m_syncDMRVoiceBS[24]      = {1, 3, 1, 1, 1, 1, 3, 3, 3, 1, 1, 3, 3, 1, 3, 3, 1, 3, 1, 1, 3, 3, 1, 3}; // 75 5F D7 DF 75 F7
@@ -58,28 +64,464 @@ DSDDecoder::DSDDecoder() :
         m_fsmState(DSDLookForSync),
         m_dsdSymbol(this),
         m_mbelibEnable(true),
+        m_mbeDVEnable(false),
         m_mbeRate(DSDMBERateNone),
-        m_mbeDecoder1(this),
-        m_mbeDecoder2(this),
+        m_mbeDecoder1(this, 0),
+        m_mbeDecoder2(this, 1),
         m_mbeDVReady1(false),
-        m_dsdDMR(this),
-        m_dsdDstar(this),
-        m_dsdYSF(this),
-        m_dsdDPMR(this),
-		m_dsdNXDN(this),
+        m_mbeDVReady2(false),
+        m_audioSink(0),
+        m_capture(0),
+        m_sampleCount(0),
+        m_symbolCapture(0),
+        m_symbolCaptureRate(-1),
+        m_symbolCaptureRateSwitch(false),
+        m_symbolCaptureSquelch(false),
+        m_inputSampleRate(48000),
+        m_inputResampler(0),
+        m_resampledSamples(0),
+        m_rateReplay(false),
+        m_callTimeout(DSD_CALL_TIMEOUT_SAMPLES),
+        m_callTimeoutSampleCount(UINT64_MAX),
+        m_dsdDMR(0),
+        m_dsdDstar(0),
+        m_dsdYSF(0),
+        m_dsdDPMR(0),
+        m_dsdNXDN(0),
         m_dataRate(DSDRate4800),
         m_syncType(DSDSyncNone),
         m_lastSyncType(DSDSyncNone),
+        m_statusPeriod(480),
+        m_statusSampleCount(0),
         m_signalFormat(signalFormatNone)
 {
+    allocateFrameDecoders();
+    initFrameSync();
+    noCarrier();
+    m_squelchTimeoutCount = 0;
+    m_nxdnInterSyncCount = -1; // reset to quiet state
+    m_callActive[0] = false;
+    m_callActive[1] = false;
+    memset(ambe_fr, 0, sizeof(ambe_fr)); // saved with the state
+    memset(imbe_fr, 0, sizeof(imbe_fr));
+    memset(m_mbeDVFrame1, 0, sizeof(m_mbeDVFrame1));
+    memset(m_mbeDVFrame2, 0, sizeof(m_mbeDVFrame2));
+
+    m_status.m_syncType = (int) DSDSyncNone;
+    m_statusLock.write(m_status);
+
+    addRateSyncPatterns(m_rateDetector);
+}
+
+void DSDDecoder::reset()
+{
+    m_opts = DSDOpts();
+    m_state = DSDState();
+    m_dsdLogger.setVerbosity(1);
+    m_fsmState = DSDLookForSync;
+    m_dsdSymbol.reset();
+    m_mbelibEnable = true;
+    m_mbeDVEnable = false;
+    m_mbeRate = DSDMBERateNone;
+    m_mbeDecoder1.reset();
+    m_mbeDecoder2.reset();
+    m_mbeDVReady1 = false;
+    m_mbeDVReady2 = false;
+    m_sampleCount = 0;
+    m_symbolCaptureRate = -1;
+    m_symbolCaptureRateSwitch = false;
+    m_symbolCaptureSquelch = false;
+
+    if (m_inputSampleRate != 48000) {
+        setInputSampleRate(48000);
+    }
+
+    m_idleGate.reset();
+    m_rateDetector.reset();
+    m_rateReplay = false;
+    m_callActive[0] = false;
+    m_callActive[1] = false;
+    m_callTimeout = DSD_CALL_TIMEOUT_SAMPLES;
+    m_callTimeoutSampleCount = UINT64_MAX;
+
+    resetFrameDecoders();
+
+    m_dataRate = DSDRate4800;
+    m_syncType = DSDSyncNone;
+    m_lastSyncType = DSDSyncNone;
+    m_stats.reset();
+    m_profile.reset();
+    m_myPoint = LocPoint();
+    m_status = DSDStatus();
+    m_statusPeriod = 480;
+    m_statusSampleCount = 0;
+    m_signalFormat = signalFormatNone;
+
+    allocateFrameDecoders();
     resetFrameSync();
     noCarrier();
     m_squelchTimeoutCount = 0;
     m_nxdnInterSyncCount = -1; // reset to quiet state
+
+    m_status.m_syncType = (int) DSDSyncNone;
+    m_statusLock.write(m_status);
+}
+
+void DSDDecoder::resetFrameDecoders()
+{
+    // frame decoders already created are kept with their tables
+    if (m_dsdDMR) {
+        m_dsdDMR.load()->reset();
+    }
+
+    if (m_dsdDstar) {
+        m_dsdDstar.load()->reset();
+    }
+
+    if (m_dsdYSF) {
+        m_dsdYSF.load()->reset();
+    }
+
+    if (m_dsdDPMR) {
+        m_dsdDPMR.load()->reset();
+    }
+
+    if (m_dsdNXDN) {
+        m_dsdNXDN.load()->reset();
+    }
+}
+
+void DSDDecoder::saveState(std::vector<unsigned char>& buffer) const
+{
+    static const unsigned char magic[8] = {'D', 'S', 'D', 'C', 'S', 'T', 'A', 1};
+    buffer.clear();
+    DSDStateBuffer state(buffer);
+    state.writeBytes(magic, 8);
+
+    // the decoder section comes first as it sets the data rate and so the symbol front end
+    unsigned int section = state.beginSection(DSDStateBuffer::SectionDecoder);
+    saveDecoderState(state);
+    state.endSection(section);
+
+    section = state.beginSection(DSDStateBuffer::SectionSymbol);
+    m_dsdSymbol.saveState(state);
+    state.endSection(section);
+
+    section = state.beginSection(DSDStateBuffer::SectionMBE1);
+    m_mbeDecoder1.saveState(state);
+    state.endSection(section);
+
+    section = state.beginSection(DSDStateBuffer::SectionMBE2);
+    m_mbeDecoder2.saveState(state);
+    state.endSection(section);
+
+    if (m_dsdDMR)
+    {
+        section = state.beginSection(DSDStateBuffer::SectionDMR);
+        m_dsdDMR.load()->saveState(state);
+        state.endSection(section);
+    }
+
+    if (m_dsdDstar)
+    {
+        section = state.beginSection(DSDStateBuffer::SectionDStar);
+        m_dsdDstar.load()->saveState(state);
+        state.endSection(section);
+    }
+
+    if (m_dsdYSF)
+    {
+        section = state.beginSection(DSDStateBuffer::SectionYSF);
+        m_dsdYSF.load()->saveState(state);
+        state.endSection(section);
+    }
+
+    if (m_dsdDPMR)
+    {
+        section = state.beginSection(DSDStateBuffer::SectionDPMR);
+        m_dsdDPMR.load()->saveState(state);
+        state.endSection(section);
+    }
+
+    if (m_dsdNXDN)
+    {
+        section = state.beginSection(DSDStateBuffer::SectionNXDN);
+        m_dsdNXDN.load()->saveState(state);
+        state.endSection(section);
+    }
+
+    section = state.beginSection(DSDStateBuffer::SectionCalls);
+    saveCallState(state);
+    state.endSection(section);
+
+    state.writeEnd();
+}
+
+bool DSDDecoder::restoreState(const unsigned char *data, unsigned int size)
+{
+    DSDStateBuffer state(data, size);
+    unsigned char magic[8];
+    state.readBytes(magic, 8);
+
+    if (!state.isValid() || (memcmp(magic, "DSDCSTA", 7) != 0) || (magic[7] != 1) || !state.checkEnd())
+    {
+        m_dsdLogger.log("DSDDecoder::restoreState: not a decoder state or damaged\n");
+        noCarrier();
+        resetFrameSync();
+        return false;
+    }
+
+    std::vector<unsigned char> previousState;
+    saveState(previousState); // put back if a value turns out to be out of range
+    restoreSections(state);
+
+    if (!state.isValid())
+    {
+        m_dsdLogger.log("DSDDecoder::restoreState: section shorter than expected or value out of range\n");
+        DSDStateBuffer previous(previousState.data(), previousState.size());
+        previous.readBytes(magic, 8);
+        restoreSections(previous); // saved by this decoder so always valid
+        noCarrier();
+        resetFrameSync();
+        return false;
+    }
+
+    return true;
+}
+
+void DSDDecoder::restoreSections(DSDStateBuffer& state)
+{
+    resetFrameDecoders(); // those not in the state are as in the saved decoder
+    m_callActive[0] = false;
+    m_callActive[1] = false;
+    m_callTimeoutSampleCount = UINT64_MAX;
+
+    int tag;
+
+    while (state.nextSection(tag))
+    {
+        switch (tag)
+        {
+        case DSDStateBuffer::SectionDecoder:
+            restoreDecoderState(state);
+            break;
+        case DSDStateBuffer::SectionSymbol:
+            m_dsdSymbol.restoreState(state);
+            break;
+        case DSDStateBuffer::SectionMBE1:
+            m_mbeDecoder1.restoreState(state);
+            break;
+        case DSDStateBuffer::SectionMBE2:
+            m_mbeDecoder2.restoreState(state);
+            break;
+        case DSDStateBuffer::SectionDMR:
+            dmrDecoder().restoreState(state);
+            break;
+        case DSDStateBuffer::SectionDStar:
+            dstarDecoder().restoreState(state);
+            break;
+        case DSDStateBuffer::SectionYSF:
+            ysfDecoder().restoreState(state);
+            break;
+        case DSDStateBuffer::SectionDPMR:
+            dpmrDecoder().restoreState(state);
+            break;
+        case DSDStateBuffer::SectionNXDN:
+            nxdnDecoder().restoreState(state);
+            break;
+        case DSDStateBuffer::SectionCalls:
+            restoreCallState(state);
+            break;
+        default: // section of a later version
+            break;
+        }
+    }
+}
+
+void DSDDecoder::saveDecoderState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU64(m_sampleCount);
+    buffer.writeU8(m_dataRate);
+    buffer.writeU8(m_syncType);
+    buffer.writeU8(m_lastSyncType);
+    buffer.writeU8(m_fsmState);
+    buffer.writeU8(m_stationType);
+    buffer.writeU8(m_dmrBurstType);
+    buffer.writeInt(m_sync);
+    buffer.writeInt(m_synctest_pos);
+    buffer.writeInt(m_t);
+    buffer.writeInt(m_squelchTimeoutCount);
+    buffer.writeInt(m_nxdnInterSyncCount);
+    buffer.writeU8(m_mbeRate);
+    buffer.writeBool(m_voice1On);
+    buffer.writeBool(m_voice2On);
+    buffer.writeBits((const unsigned char *) ambe_fr, 4*24);
+    buffer.writeBits((const unsigned char *) imbe_fr, 8*23);
+    buffer.writeBytes(m_mbeDVFrame1, 18);
+    buffer.writeBytes(m_mbeDVFrame2, 9);
+    // DSDState
+    buffer.writeInt(m_state.repeat);
+    buffer.writeString(m_state.fsubtype);
+    buffer.writeString(m_state.ftype);
+    buffer.writeInt(m_state.symbolcnt);
+    buffer.writeInt(m_state.lastp25type);
+    buffer.writeInt(m_state.offset);
+    buffer.writeInt(m_state.carrier);
+    buffer.writeInt(m_state.lasttg);
+    buffer.writeInt(m_state.lastsrc);
+    buffer.writeInt(m_state.nac);
+    buffer.writeInt(m_state.numtdulc);
+    buffer.writeInt(m_state.firstframe);
+    buffer.writeString(m_state.slot0light);
+    buffer.writeString(m_state.slot1light);
+    buffer.writeU8(m_state.ccnum);
+    buffer.writeString(m_state.algid);
+    buffer.writeString(m_state.keyid);
+    buffer.writeInt(m_state.currentslot);
+}
+
+void DSDDecoder::restoreDecoderState(DSDStateBuffer& buffer)
+{
+    setSampleCount(buffer.readU64());
+    DSDRate dataRate = (DSDRate) buffer.readEnum(DSDRate9600);
+
+    if (buffer.isValid() && (dataRate != m_dataRate)) {
+        setDataRate(dataRate);
+    }
+
+    m_syncType = (DSDSyncType) buffer.readEnum(DSDSyncNone);
+    m_lastSyncType = (DSDSyncType) buffer.readEnum(DSDSyncNone);
+    m_fsmState = (DSDFSMState) buffer.readEnum(DSDprocessUnknown);
+    m_stationType = (DSDStationType) buffer.readEnum(DSDMobileStation);
+    m_dmrBurstType = (DSDDMR::DSDDMRBurstType) buffer.readEnum(DSDDMR::DSDDMRDirectSlot2);
+    m_sync = buffer.readInt(-2, DSDSyncNone);
+    m_synctest_pos = buffer.readInt(0, 1800);
+    m_t = buffer.readInt(0, 18);
+    m_squelchTimeoutCount = buffer.readInt(0, DSD_SQUELCH_TIMEOUT_SAMPLES);
+    m_nxdnInterSyncCount = buffer.readInt(-1, INT_MAX);
+    m_mbeRate = (DSDMBERate) buffer.readEnum(DSDMBERate4400);
+    m_voice1On = buffer.readBool();
+    m_voice2On = buffer.readBool();
+    buffer.readBits((unsigned char *) ambe_fr, 4*24);
+    buffer.readBits((unsigned char *) imbe_fr, 8*23);
+    buffer.readBytes(m_mbeDVFrame1, 18);
+    buffer.readBytes(m_mbeDVFrame2, 9);
+    m_state.repeat = buffer.readInt();
+    buffer.readString(m_state.fsubtype, sizeof(m_state.fsubtype));
+    buffer.readString(m_state.ftype, sizeof(m_state.ftype));
+    m_state.symbolcnt = buffer.readInt();
+    m_state.lastp25type = buffer.readInt();
+    m_state.offset = buffer.readInt();
+    m_state.carrier = buffer.readInt();
+    m_state.lasttg = buffer.readInt();
+    m_state.lastsrc = buffer.readInt();
+    m_state.nac = buffer.readInt();
+    m_state.numtdulc = buffer.readInt();
+    m_state.firstframe = buffer.readInt();
+    buffer.readString(m_state.slot0light, sizeof(m_state.slot0light));
+    buffer.readString(m_state.slot1light, sizeof(m_state.slot1light));
+    m_state.ccnum = buffer.readU8();
+    buffer.readString(m_state.algid, sizeof(m_state.algid));
+    buffer.readString(m_state.keyid, sizeof(m_state.keyid));
+    m_state.currentslot = buffer.readInt(0, 1);
+}
+
+void DSDDecoder::saveCallState(DSDStateBuffer& buffer) const
+{
+    for (int slot = 0; slot < 2; slot++)
+    {
+        const CallInfo& call = m_calls[slot];
+        buffer.writeBool(m_callActive[slot]);
+
+        if (!m_callActive[slot]) {
+            continue;
+        }
+
+        buffer.writeBool(m_callVoice[slot]);
+        buffer.writeU8(call.m_protocol);
+        buffer.writeBool(call.m_header);
+        buffer.writeU64(call.m_start);
+        buffer.writeU64(call.m_end);
+        buffer.writeU32(call.m_nbVoiceFrames);
+        buffer.writeU32(call.m_sourceId);
+        buffer.writeU32(call.m_destinationId);
+        buffer.writeBool(call.m_group);
+        buffer.writeInt(call.m_colorCode);
+        buffer.writeString(call.m_source);
+        buffer.writeString(call.m_destination);
+    }
+}
+
+void DSDDecoder::restoreCallState(DSDStateBuffer& buffer)
+{
+    for (int slot = 0; slot < 2; slot++)
+    {
+        m_callActive[slot] = buffer.readBool();
+
+        if (!m_callActive[slot]) {
+            continue;
+        }
+
+        CallInfo& call = m_calls[slot];
+        m_callVoice[slot] = buffer.readBool();
+        call.m_protocol = (DSDStatus::Protocol) buffer.readEnum(DSDStatus::ProtocolNXDN);
+        call.m_slot = slot;
+        call.m_header = buffer.readBool();
+        call.m_start = buffer.readU64();
+        call.m_end = buffer.readU64();
+        call.m_nbVoiceFrames = buffer.readU32();
+        call.m_callEnd = CallInfo::CallEndNone;
+        call.m_sourceId = buffer.readU32();
+        call.m_destinationId = buffer.readU32();
+        call.m_group = buffer.readBool();
+        call.m_colorCode = buffer.readInt();
+        buffer.readString(call.m_source, sizeof(call.m_source));
+        buffer.readString(call.m_destination, sizeof(call.m_destination));
+
+        if (call.m_end + m_callTimeout < m_callTimeoutSampleCount) {
+            m_callTimeoutSampleCount = call.m_end + m_callTimeout;
+        }
+    }
+}
+
+void DSDDecoder::addRateSyncPatterns(DSDRateDetector& rateDetector)
+{
+    // sync words looked for at each rate by getFrameSync in auto mode. NXDN short FSW is too short to be scanned.
+    rateDetector.addSyncPattern(DSDRate2400, m_syncDPMRFS1, 24, DSDSyncDPMR);
+    rateDetector.addSyncPattern(DSDRate2400, m_syncNXDNRDCHFull, 19, DSDSyncNXDNP);
+    rateDetector.addSyncPattern(DSDRate2400, m_syncNXDNRDCHFullInv, 19, DSDSyncNXDNN);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDMRDataBS, 24, DSDSyncDMRDataP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDMRVoiceBS, 24, DSDSyncDMRVoiceP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDMRDataMS, 24, DSDSyncDMRDataMS);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDMRVoiceMS, 24, DSDSyncDMRVoiceMS);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDStar, 24, DSDSyncDStarP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDStarInv, 24, DSDSyncDStarN);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDStarHeader, 24, DSDSyncDStarHeaderP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncDStarHeaderInv, 24, DSDSyncDStarHeaderN);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncP25P1, 24, DSDSyncP25p1P);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncP25P1Inv, 24, DSDSyncP25p1N);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncX2TDMADataBS, 24, DSDSyncX2TDMADataP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncX2TDMAVoiceBS, 24, DSDSyncX2TDMAVoiceP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncX2TDMADataMS, 24, DSDSyncX2TDMADataN);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncX2TDMAVoiceMS, 24, DSDSyncX2TDMAVoiceN);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncYSF, 20, DSDSyncYSF);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncNXDNRDCHFull, 19, DSDSyncNXDNP);
+    rateDetector.addSyncPattern(DSDRate4800, m_syncNXDNRDCHFullInv, 19, DSDSyncNXDNN);
+    rateDetector.addSyncPattern(DSDRate9600, m_syncProVoice, 32, DSDSyncProVoiceP);
+    rateDetector.addSyncPattern(DSDRate9600, m_syncProVoiceInv, 32, DSDSyncProVoiceN);
+    rateDetector.addSyncPattern(DSDRate9600, m_syncProVoiceEA, 32, DSDSyncProVoiceP);
+    rateDetector.addSyncPattern(DSDRate9600, m_syncProVoiceEAInv, 32, DSDSyncProVoiceN);
 }
 
 DSDDecoder::~DSDDecoder()
 {
+    delete m_dsdNXDN.load();
+    delete m_dsdDPMR.load();
+    delete m_dsdYSF.load();
+    delete m_dsdDstar.load();
+    delete m_dsdDMR.load();
+    delete[] m_resampledSamples;
+    delete m_inputResampler;
 }
 
 void DSDDecoder::setQuiet()
@@ -237,12 +679,67 @@ void DSDDecoder::setDecodeMode(DSDDecodeMode mode, bool on)
         break;
     }
 
+    allocateFrameDecoders();
     resetFrameSync();
     noCarrier();
     m_squelchTimeoutCount = 0;
     m_nxdnInterSyncCount = -1; // reset to quiet state
 }
 
+void DSDDecoder::allocateFrameDecoders()
+{
+    if (m_opts.frame_dmr) {
+        dmrDecoder();
+    }
+    if (m_opts.frame_dstar) {
+        dstarDecoder();
+    }
+    if (m_opts.frame_ysf) {
+        ysfDecoder();
+    }
+    if (m_opts.frame_dpmr) {
+        dpmrDecoder();
+    }
+    if (m_opts.frame_nxdn48 || m_opts.frame_nxdn96) {
+        nxdnDecoder();
+    }
+}
+
+DSDDecoder& DSDDecoder::emptyDecoder()
+{
+    static DSDDecoder *decoder = createEmptyDecoder(); // created once even with concurrent callers and never freed
+    return *decoder;
+}
+
+DSDDecoder *DSDDecoder::createEmptyDecoder()
+{
+    DSDDecoder *decoder = new DSDDecoder();
+    decoder->dmrDecoder();
+    decoder->dstarDecoder();
+    decoder->ysfDecoder();
+    decoder->dpmrDecoder();
+    decoder->nxdnDecoder();
+    return decoder;
+}
+
+size_t DSDDecoder::getMemoryFootprint() const
+{
+    size_t size = sizeof(DSDDecoder);
+
+    size += m_mbeDecoder1.getAllocatedSize();
+    size += m_mbeDecoder2.getAllocatedSize();
+    size += m_inputResampler ? sizeof(DSDResampler) + m_inputResampler->getAllocatedSize() : 0;
+    size += m_dsdDMR ? sizeof(DSDDMR) : 0;
+    size += m_dsdDstar ? sizeof(DSDDstar) : 0;
+    size += m_dsdYSF ? sizeof(DSDYSF) : 0;
+    size += m_dsdDPMR ? sizeof(DSDdPMR) : 0;
+    size += m_dsdNXDN ? sizeof(DSDNXDN) : 0;
+    size += m_rateDetector.getAllocatedSize();
+    size += m_dsdLogger.getAllocatedSize();
+
+    return size;
+}
+
 void DSDDecoder::setAudioGain(float gain)
 {
     m_opts.audio_gain = gain;
@@ -331,9 +828,30 @@ void DSDDecoder::enableScanResumeAfterTDULCFrames(int nbFrames)
     m_dsdLogger.log("Enabling scan resume after %i TDULC frames\n", m_opts.resume);
 }
 
+void DSDDecoder::enableIdleGate(bool enable)
+{
+    m_idleGate.setEnabled(enable);
+}
+
+void DSDDecoder::enableMultiRateAuto(bool enable)
+{
+    m_rateDetector.setEnabled(enable);
+
+    if (enable) {
+        setDecodeMode(DSDDecodeAuto, true);
+    }
+}
+
+void DSDDecoder::setAudioBufferSize(int nbSamples)
+{
+    m_mbeDecoder1.setAudioBufferSize(nbSamples);
+    m_mbeDecoder2.setAudioBufferSize(nbSamples);
+}
+
 void DSDDecoder::setDataRate(DSDRate dataRate)
 {
     m_dataRate = dataRate;
+    m_symbolCaptureRate = (int) dataRate;
 
     switch(dataRate)
     {
@@ -356,7 +874,492 @@ void DSDDecoder::setDataRate(DSDRate dataRate)
     }
 }
 
+void DSDDecoder::setAudioSink(AudioSink *audioSink)
+{
+    m_audioSink = audioSink;
+    m_mbeDecoder1.resetAudio();
+    m_mbeDecoder2.resetAudio();
+}
+
+void DSDDecoder::setMbeDVReady1()
+{
+    m_mbeDVReady1 = true;
+    m_stats.countMbeFrame();
+    voiceFrame(0);
+    m_calls[0].m_nbVoiceFrames++;
+
+    if (m_audioSink && mbeDVStored()) {
+        m_audioSink->mbeFrame(0, m_mbeDVFrame1, getMbeDVFrameSize(), m_mbeRate, m_sampleCount);
+    }
+}
+
+void DSDDecoder::setMbeDVReady2()
+{
+    m_mbeDVReady2 = true;
+    m_stats.countMbeFrame();
+    voiceFrame(1);
+    m_calls[1].m_nbVoiceFrames++;
+
+    if (m_audioSink && mbeDVStored()) {
+        m_audioSink->mbeFrame(1, m_mbeDVFrame2, getMbeDVFrameSize(), m_mbeRate, m_sampleCount);
+    }
+}
+
+void DSDDecoder::openCall(int slot, DSDStatus::Protocol protocol, bool header)
+{
+    CallInfo& call = m_calls[slot];
+    call.m_protocol = protocol;
+    call.m_slot = slot;
+    call.m_header = header;
+    call.m_start = m_sampleCount;
+    call.m_end = m_sampleCount;
+    call.m_nbVoiceFrames = 0;
+    call.m_callEnd = CallInfo::CallEndNone;
+    call.m_sourceId = 0;
+    call.m_destinationId = 0;
+    call.m_group = false;
+    call.m_colorCode = -1;
+    call.m_source[0] = '\0';
+    call.m_destination[0] = '\0';
+    updateCallIdentity(call);
+    m_callActive[slot] = true;
+    m_callVoice[slot] = false;
+
+    if (m_sampleCount + m_callTimeout < m_callTimeoutSampleCount) {
+        m_callTimeoutSampleCount = m_sampleCount + m_callTimeout;
+    }
+}
+
+void DSDDecoder::startCall(int slot, DSDStatus::Protocol protocol)
+{
+    if (m_callActive[slot])
+    {
+        CallInfo& call = m_calls[slot];
+
+        if ((call.m_protocol == protocol) && !m_callVoice[slot]) // repeated header
+        {
+            call.m_end = m_sampleCount;
+            updateCallIdentity(call);
+            return;
+        }
+
+        endCall(slot, CallInfo::CallEndNewCall);
+    }
+
+    openCall(slot, protocol, true);
+}
+
+void DSDDecoder::endCall(int slot, CallInfo::CallEnd callEnd)
+{
+    if (!m_callActive[slot]) {
+        return;
+    }
+
+    CallInfo& call = m_calls[slot];
+
+    if (callEnd != CallInfo::CallEndTimeout) {
+        call.m_end = m_sampleCount;
+    }
+
+    // the identities decoded may be those of the new call or of another protocol
+    if ((callEnd != CallInfo::CallEndNewCall) && (call.m_protocol == getCallProtocol())) {
+        updateCallIdentity(call);
+    }
+
+    call.m_callEnd = callEnd;
+    m_callActive[slot] = false;
+
+    if (m_audioSink && m_callVoice[slot]) { // a header without voice is not a call
+        m_audioSink->callEnd(call);
+    }
+}
+
+void DSDDecoder::endCalls()
+{
+    endCall(0, CallInfo::CallEndFlush);
+    endCall(1, CallInfo::CallEndFlush);
+    m_callTimeoutSampleCount = UINT64_MAX;
+}
+
+void DSDDecoder::voiceFrame(int slot)
+{
+    DSDStatus::Protocol protocol = getCallProtocol();
+
+    if (protocol == DSDStatus::ProtocolNone) { // not decoding (vocodeDVFrame)
+        return;
+    }
+
+    if (m_callActive[slot] && (m_calls[slot].m_protocol != protocol)) {
+        endCall(slot, CallInfo::CallEndNewCall);
+    }
+
+    if (!m_callActive[slot]) {
+        openCall(slot, protocol, false);
+    }
+
+    CallInfo& call = m_calls[slot];
+    call.m_end = m_sampleCount;
+    updateCallIdentity(call);
+
+    if (!m_callVoice[slot])
+    {
+        m_callVoice[slot] = true;
+
+        if (m_audioSink) {
+            m_audioSink->callStart(call);
+        }
+    }
+
+    if (m_callActive[1 - slot]) {
+        m_callTimeoutSampleCount = std::min(m_calls[1 - slot].m_end, m_sampleCount) + m_callTimeout;
+    } else {
+        m_callTimeoutSampleCount = m_sampleCount + m_callTimeout;
+    }
+}
+
+void DSDDecoder::endTimedOutCalls()
+{
+    m_callTimeoutSampleCount = UINT64_MAX;
+
+    for (int slot = 0; slot < 2; slot++)
+    {
+        if (!m_callActive[slot]) {
+            continue;
+        }
+
+        if (m_sampleCount >= m_calls[slot].m_end + m_callTimeout) {
+            endCall(slot, CallInfo::CallEndTimeout);
+        } else {
+            m_callTimeoutSampleCount = std::min(m_callTimeoutSampleCount, m_calls[slot].m_end + m_callTimeout);
+        }
+    }
+}
+
+DSDStatus::Protocol DSDDecoder::getCallProtocol() const
+{
+    switch (m_lastSyncType)
+    {
+    case DSDSyncDMRDataMS:
+    case DSDSyncDMRDataP:
+    case DSDSyncDMRVoiceMS:
+    case DSDSyncDMRVoiceP:
+        return DSDStatus::ProtocolDMR;
+    case DSDSyncDStarHeaderN:
+    case DSDSyncDStarHeaderP:
+    case DSDSyncDStarN:
+    case DSDSyncDStarP:
+        return DSDStatus::ProtocolDStar;
+    case DSDSyncDPMR:
+        return DSDStatus::ProtocolDPMR;
+    case DSDSyncYSF:
+        return DSDStatus::ProtocolYSF;
+    case DSDSyncNXDNN:
+    case DSDSyncNXDNP:
+        return DSDStatus::ProtocolNXDN;
+    default:
+        return DSDStatus::ProtocolNone;
+    }
+}
+
+void DSDDecoder::updateCallIdentity(CallInfo& call) const
+{
+    // identities decoded so far replace those of the call, unknown ones do not erase them
+    switch (call.m_protocol)
+    {
+    case DSDStatus::ProtocolDMR:
+    {
+        const DSDDMR& dmr = getDMRDecoder();
+
+        if (dmr.getSourceId(call.m_slot) != 0)
+        {
+            call.m_sourceId = dmr.getSourceId(call.m_slot);
+            call.m_destinationId = dmr.getTargetId(call.m_slot);
+            call.m_group = dmr.isGroupCall(call.m_slot);
+        }
+
+        call.m_colorCode = dmr.getLastColorCode();
+    }
+        break;
+    case DSDStatus::ProtocolDStar:
+    {
+        const DSDDstar& dstar = getDStarDecoder();
+
+        if (!dstar.getMySign().empty()) {
+            DSDStatus::copyText(call.m_source, sizeof(call.m_source), dstar.getMySign().c_str());
+        }
+
+        if (!dstar.getYourSign().empty()) {
+            DSDStatus::copyText(call.m_destination, sizeof(call.m_destination), dstar.getYourSign().c_str());
+        }
+    }
+        break;
+    case DSDStatus::ProtocolDPMR:
+    {
+        const DSDdPMR& dpmr = getDPMRDecoder();
+
+        if (dpmr.getOwnId() != 0)
+        {
+            call.m_sourceId = dpmr.getOwnId();
+            call.m_destinationId = dpmr.getCalledId();
+        }
+
+        call.m_colorCode = dpmr.getColorCode();
+    }
+        break;
+    case DSDStatus::ProtocolYSF:
+    {
+        const DSDYSF& ysf = getYSFDecoder();
+
+        if (ysf.getSrc()[0]) {
+            DSDStatus::copyText(call.m_source, sizeof(call.m_source), ysf.getSrc());
+        }
+
+        if (ysf.getDest()[0]) {
+            DSDStatus::copyText(call.m_destination, sizeof(call.m_destination), ysf.getDest());
+        }
+    }
+        break;
+    case DSDStatus::ProtocolNXDN:
+    {
+        const DSDNXDN& nxdn = getNXDNDecoder();
+
+        if (nxdn.getSourceId() != 0)
+        {
+            call.m_sourceId = nxdn.getSourceId();
+            call.m_destinationId = nxdn.getDestinationId();
+            call.m_group = nxdn.isGroupCall();
+        }
+
+        call.m_colorCode = nxdn.getRAN();
+    }
+        break;
+    default:
+        break;
+    }
+}
+
+int DSDDecoder::getMbeDVFrameSize() const
+{
+    switch (m_mbeRate)
+    {
+    case DSDMBERate7200x4400:
+    case DSDMBERate7100x4400:
+        return 18; // 144 bits
+    case DSDMBERate4400:
+        return 11; // 88 bits
+    default:
+        return 9;  // 72 bits
+    }
+}
+
+bool DSDDecoder::vocodeDVFrame(int slot, const unsigned char *dvFrame, DSDMBERate mbeRate, uint64_t timestamp)
+{
+    DSDMBEDecoder& mbeDecoder = slot == 1 ? m_mbeDecoder2 : m_mbeDecoder1;
+    m_mbeRate = mbeRate;
+    m_sampleCount = timestamp;
+
+    switch (mbeRate)
+    {
+    case DSDMBERate3600x2450:
+        DSDDMR::unpackDVFrame(dvFrame, ambe_fr);
+        mbeDecoder.processFrame(0, ambe_fr, 0);
+        return true;
+    case DSDMBERate3600x2400:
+        DSDDstar::unpackDVFrame(dvFrame, ambe_fr);
+        mbeDecoder.processFrame(0, ambe_fr, 0);
+        return true;
+    case DSDMBERate2450:
+    {
+        char ambe_d[49];
+        DSDYSF::unpackVD2DVFrame(dvFrame, ambe_d);
+        mbeDecoder.processData(0, ambe_d);
+        return true;
+    }
+    case DSDMBERate4400:
+    {
+        char imbe_d[88];
+        DSDYSF::unpackVFRDVFrame(dvFrame, imbe_d);
+        mbeDecoder.processData(imbe_d, 0);
+        return true;
+    }
+    default: // IMBE with FEC (NXDN EFR) is not decoded by mbelib here either
+        return false;
+    }
+}
+
+void DSDDecoder::setInputSampleRate(int sampleRate)
+{
+    delete[] m_resampledSamples;
+    delete m_inputResampler;
+    m_resampledSamples = 0;
+    m_inputResampler = 0;
+    m_inputSampleRate = sampleRate;
+
+    if (sampleRate != 48000)
+    {
+        m_inputResampler = new DSDResampler();
+        m_inputResampler->configure(sampleRate, 48000);
+        m_resampledSamples = new float[m_inputResampler->getMaxOutput(1)];
+    }
+}
+
+void DSDDecoder::setSampleCount(uint64_t sampleCount)
+{
+    m_sampleCount = sampleCount;
+    m_statusSampleCount = sampleCount;
+}
+
 void DSDDecoder::run(short sample)
+{
+    DSD_PROFILE_SCOPE(m_profile, StageRun);
+
+    if (m_inputResampler)
+    {
+        int nbSamples = m_inputResampler->push(sample, m_resampledSamples);
+
+        for (int i = 0; i < nbSamples; i++)
+        {
+            float v = m_resampledSamples[i];
+            runNominalRate(v > 32767.0f ? 32767 : v < -32768.0f ? -32768 : (short) v);
+        }
+    }
+    else
+    {
+        runNominalRate(sample);
+    }
+}
+
+void DSDDecoder::runNominalRate(short sample)
+{
+    m_sampleCount++;
+    checkCallTimeout();
+
+    if (m_idleGate.isEnabled())
+    {
+        switch (m_idleGate.push(sample, m_fsmState == DSDLookForSync))
+        {
+        case DSDIdleGate::GateParked:
+            return;
+        case DSDIdleGate::GateWake:
+        {
+            // feed the decoder with the history of the parked period including this sample
+            uint64_t sampleCount = m_sampleCount;
+            int replaySize = m_idleGate.getReplaySize();
+            m_dsdLogger.debug("DSDDecoder::run: idle gate wake up replay %d samples\n", replaySize);
+
+            for (int i = 0; i < replaySize; i++)
+            {
+                m_sampleCount = sampleCount - replaySize + i + 1;
+                runSample(m_idleGate.getReplaySample(i));
+            }
+
+            return;
+        }
+        default:
+            break;
+        }
+    }
+
+    runSample(sample);
+}
+
+void DSDDecoder::runSample(short sample)
+{
+    // look for sync at the other data rates while searching
+    if (m_rateDetector.isEnabled() && !m_rateReplay)
+    {
+        int rateIndex = m_rateDetector.push(sample, m_fsmState == DSDLookForSync ? (int) m_dataRate : -1);
+
+        if (rateIndex >= 0)
+        {
+            switchDataRate((DSDRate) rateIndex);
+            return;
+        }
+    }
+
+    checkSquelchTimeout(sample);
+
+    if (m_dsdSymbol.pushSample(sample)) // a symbol is retrieved
+    {
+        if (m_symbolCapture) {
+            captureSymbol();
+        }
+
+        processSymbol();
+    }
+}
+
+void DSDDecoder::runFrontEndOutput(short sample, short filteredSample, short ringingSample, short pllSample)
+{
+    m_sampleCount++;
+    checkCallTimeout();
+    checkSquelchTimeout(sample);
+
+    if (m_dsdSymbol.pushFrontEndOutput(filteredSample, ringingSample, pllSample)) // a symbol is retrieved
+    {
+        if (m_symbolCapture) {
+            captureSymbol();
+        }
+
+        processSymbol();
+    }
+}
+
+void DSDDecoder::setSymbolCapture(DSDSymbolCapture *symbolCapture)
+{
+    m_symbolCapture = symbolCapture;
+    m_symbolCaptureRate = (int) m_dataRate; // the first symbol carries the current rate
+    m_symbolCaptureRateSwitch = false;
+    m_symbolCaptureSquelch = false;
+}
+
+void DSDDecoder::captureSymbol()
+{
+    DSDSymbolCapture::Symbol symbol;
+    int sampleMin, sampleMax;
+
+    symbol.m_sampleCount = m_sampleCount;
+    int value = m_dsdSymbol.getSymbol();
+    symbol.m_value = value > 32767 ? 32767 : value < -32768 ? -32768 : value;
+    symbol.m_dibit = m_dsdSymbol.getDibit();
+    symbol.m_levelsSnap = m_dsdSymbol.getLevelsSnap(sampleMin, sampleMax);
+    symbol.m_sampleMin = sampleMin;
+    symbol.m_sampleMax = sampleMax;
+    symbol.m_squelchReset = m_symbolCaptureSquelch;
+    symbol.m_dataRate = m_symbolCaptureRate;
+    symbol.m_rateSwitch = m_symbolCaptureRateSwitch;
+    m_symbolCapture->write(symbol);
+
+    m_symbolCaptureRate = -1;
+    m_symbolCaptureRateSwitch = false;
+    m_symbolCaptureSquelch = false;
+}
+
+void DSDDecoder::runSymbol(const DSDSymbolCapture::Symbol& symbol)
+{
+    m_sampleCount = symbol.m_sampleCount;
+    checkCallTimeout();
+
+    if (symbol.m_dataRate >= 0)
+    {
+        setDataRate((DSDRate) symbol.m_dataRate);
+
+        if (symbol.m_rateSwitch) {
+            setDecodeMode(DSDDecodeAuto, true);
+        }
+    }
+
+    if (symbol.m_squelchReset)
+    {
+        m_dsdLogger.debug("DSDDecoder::runSymbol: squelch time out go back to sync search\n");
+        resetFrameSync();
+    }
+
+    m_dsdSymbol.pushSymbol(symbol.m_value, symbol.m_levelsSnap, symbol.m_sampleMin, symbol.m_sampleMax);
+    processSymbol();
+}
+
+void DSDDecoder::checkSquelchTimeout(short sample)
 {
     // mode time out if squelch has been closed for a number of samples
     if (m_fsmState != DSDLookForSync)
@@ -369,9 +1372,10 @@ void DSDDecoder::run(short sample)
             }
             else
             {
-                m_dsdLogger.log("DSDDecoder::run: squelch time out go back to sync search\n");
+                m_dsdLogger.debug("DSDDecoder::run: squelch time out go back to sync search\n");
                 resetFrameSync();
                 m_squelchTimeoutCount = 0;
+                m_symbolCaptureSquelch = true;
             }
         }
         else
@@ -379,72 +1383,101 @@ void DSDDecoder::run(short sample)
             m_squelchTimeoutCount = 0;
         }
     }
+}
 
-    if (m_dsdSymbol.pushSample(sample)) // a symbol is retrieved
+void DSDDecoder::processSymbol()
+{
+    if (m_sampleCount >= m_statusSampleCount) {
+        publishStatus();
+    }
+
+    switch (m_fsmState)
     {
-        switch (m_fsmState)
+    case DSDLookForSync:
+        m_sync = DSD_PROFILE_CALL(m_profile, StageSyncSearch, getFrameSync()); // -> -2: still looking, -1 not found after 1800 symbols, 0 and above: sync found
+
+        if (m_sync == -2) // -2 means no sync has been found at all
         {
-        case DSDLookForSync:
-            m_sync = getFrameSync(); // -> -2: still looking, -1 not found, 0 and above: sync found
+            break; // still searching -> no change in FSM state
+        }
+        else if (m_sync == -1) // -1 means no sync was found within the search window
+        {
+            m_dsdLogger.debug("DSDDecoder::run: sync search timeout: %d symbol %d (%d)\n", m_sync, m_state.symbolcnt, m_dsdSymbol.getSymbol());
+            m_stats.countSyncTimeout();
+            resetFrameSync(); // go back searching
+        }
+        else // good sync found
+        {
+            m_dsdLogger.debug("DSDDecoder::run: good sync found: %d symbol %d (%d)\n", m_sync, m_state.symbolcnt, m_dsdSymbol.getSymbol());
+            m_fsmState = DSDSyncFound; // go to processing state next time
+            m_stats.countSync(m_sync);
+        }
 
-            if (m_sync == -2) // -2 means no sync has been found at all
-            {
-                break; // still searching -> no change in FSM state
-            }
-            else if (m_sync == -1) // -1 means sync has been found but is invalid
-            {
-                m_dsdLogger.log("DSDDecoder::run: invalid sync found: %d symbol %d (%d)\n", m_sync, m_state.symbolcnt, m_dsdSymbol.getSymbol());
-                resetFrameSync(); // go back searching
-            }
-            else // good sync found
-            {
-                m_dsdLogger.log("DSDDecoder::run: good sync found: %d symbol %d (%d)\n", m_sync, m_state.symbolcnt, m_dsdSymbol.getSymbol());
-                m_fsmState = DSDSyncFound; // go to processing state next time
-            }
+        break; // next
+    case DSDSyncFound:
+        m_syncType  = (DSDSyncType) m_sync;
+        m_dsdLogger.debug("DSDDecoder::run: before processFrameInit: symbol %d (%d)\n", m_state.symbolcnt, m_dsdSymbol.getSymbol());
+        processFrameInit();   // initiate the process of the frame which sync has been found. This will change FSM state
+        publishStatus();
+        break;
+    case DSDprocessDMRvoice:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processVoice());
+        break;
+    case DSDprocessDMRvoiceMS:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processVoiceMS());
+        break;
+    case DSDprocessDMRdata:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processData());
+        break;
+    case DSDprocessDMRdataMS:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processDataMS());
+        break;
+    case DSDprocessDMRsyncOrSkip:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processSyncOrSkip());
+        break;
+    case DSDprocessDMRSkipMS:
+        DSD_PROFILE_CALL(m_profile, StageDMR, dmrDecoder().processSkipMS());
+        break;
+    case DSDprocessDSTAR:
+        DSD_PROFILE_CALL(m_profile, StageDStar, dstarDecoder().process());
+        break;
+    case DSDprocessDSTAR_HD:
+        DSD_PROFILE_CALL(m_profile, StageDStar, dstarDecoder().processHD());
+        break;
+    case DSDprocessYSF:
+        DSD_PROFILE_CALL(m_profile, StageYSF, ysfDecoder().process());
+        break;
+    case DSDprocessDPMR:
+        DSD_PROFILE_CALL(m_profile, StageDPMR, dpmrDecoder().process());
+        break;
+    case DSDprocessNXDN:
+        DSD_PROFILE_CALL(m_profile, StageNXDN, nxdnDecoder().process());
+        break;
+    default:
+        break;
+    }
+}
 
-            break; // next
-        case DSDSyncFound:
-            m_syncType  = (DSDSyncType) m_sync;
-            m_dsdLogger.log("DSDDecoder::run: before processFrameInit: symbol %d (%d)\n", m_state.symbolcnt, m_dsdSymbol.getSymbol());
-            processFrameInit();   // initiate the process of the frame which sync has been found. This will change FSM state
-            break;
-        case DSDprocessDMRvoice:
-            m_dsdDMR.processVoice();
-            break;
-        case DSDprocessDMRvoiceMS:
-            m_dsdDMR.processVoiceMS();
-            break;
-        case DSDprocessDMRdata:
-            m_dsdDMR.processData();
-            break;
-        case DSDprocessDMRdataMS:
-            m_dsdDMR.processDataMS();
-            break;
-        case DSDprocessDMRsyncOrSkip:
-            m_dsdDMR.processSyncOrSkip();
-            break;
-        case DSDprocessDMRSkipMS:
-            m_dsdDMR.processSkipMS();
-            break;
-        case DSDprocessDSTAR:
-            m_dsdDstar.process();
-            break;
-        case DSDprocessDSTAR_HD:
-            m_dsdDstar.processHD();
-            break;
-        case DSDprocessYSF:
-            m_dsdYSF.process();
-            break;
-        case DSDprocessDPMR:
-            m_dsdDPMR.process();
-            break;
-        case DSDprocessNXDN:
-            m_dsdNXDN.process();
-            break;
-        default:
-            break;
-        }
+void DSDDecoder::switchDataRate(DSDRate dataRate)
+{
+    // commit the full decode chain to the new rate and feed it with the history including the current sample
+    uint64_t sampleCount = m_sampleCount;
+    int replaySize = m_rateDetector.getReplaySize((int) dataRate);
+    m_dsdLogger.debug("DSDDecoder::switchDataRate: sync found at rate %d replay %d samples\n", (int) dataRate, replaySize);
+
+    setDataRate(dataRate);
+    setDecodeMode(DSDDecodeAuto, true);
+    m_symbolCaptureRate = (int) dataRate;
+    m_symbolCaptureRateSwitch = true;
+    m_rateReplay = true;
+
+    for (int i = 0; i < replaySize; i++)
+    {
+        m_sampleCount = sampleCount - replaySize + i + 1;
+        runSample(m_rateDetector.getReplaySample((int) dataRate, i));
     }
+
+    m_rateReplay = false;
 }
 
 void DSDDecoder::processFrameInit()
@@ -468,14 +1501,14 @@ void DSDDecoder::processFrameInit()
         if (m_syncType == DSDSyncDMRVoiceP)
         {
             sprintf(m_state.fsubtype, " VOICE        ");
-            m_dsdDMR.initVoice();    // initializations not consuming a live symbol
-            m_dsdDMR.processVoice(); // process current symbol first
+            dmrDecoder().initVoice();    // initializations not consuming a live symbol
+            dmrDecoder().processVoice(); // process current symbol first
             m_fsmState = DSDprocessDMRvoice;
         }
         else
         {
-            m_dsdDMR.initData();    // initializations not consuming a live symbol
-            m_dsdDMR.processData(); // process current symbol first
+            dmrDecoder().initData();    // initializations not consuming a live symbol
+            dmrDecoder().processData(); // process current symbol first
             m_fsmState = DSDprocessDMRdata;
         }
     }
@@ -497,14 +1530,14 @@ void DSDDecoder::processFrameInit()
         if (m_syncType == DSDSyncDMRVoiceMS)
         {
             sprintf(m_state.fsubtype, " VOICE        ");
-            m_dsdDMR.initVoiceMS();    // initializations not consuming a live symbol
-            m_dsdDMR.processVoiceMS(); // process current symbol first
+            dmrDecoder().initVoiceMS();    // initializations not consuming a live symbol
+            dmrDecoder().processVoiceMS(); // process current symbol first
             m_fsmState = DSDprocessDMRvoiceMS;
         }
         else
         {
-            m_dsdDMR.initDataMS();    // initializations not consuming a live symbol
-            m_dsdDMR.processDataMS(); // process current symbol first
+            dmrDecoder().initDataMS();    // initializations not consuming a live symbol
+            dmrDecoder().processDataMS(); // process current symbol first
             m_fsmState = DSDprocessDMRdataMS;
         }
 
@@ -520,14 +1553,14 @@ void DSDDecoder::processFrameInit()
             if (m_opts.verbose > 0)
             {
                 int level = m_dsdSymbol.getLevel();
-                printf("inlvl: %2i%% ", level);
+                m_dsdLogger.log("inlvl: %2i%% ", level);
             }
         }
 
         m_state.nac = 0;
         sprintf(m_state.fsubtype, " VOICE        ");
-        m_dsdDstar.init();
-        m_dsdDstar.process(); // process current symbol first
+        dstarDecoder().init();
+        dstarDecoder().process(); // process current symbol first
         m_fsmState = DSDprocessDSTAR;
     }
     else if ((m_syncType == DSDSyncDStarHeaderP) || (m_syncType == DSDSyncDStarHeaderN)) // D-Star header
@@ -547,8 +1580,8 @@ void DSDDecoder::processFrameInit()
 
         m_state.nac = 0;
         sprintf(m_state.fsubtype, " DATA         ");
-        m_dsdDstar.init(true);
-        m_dsdDstar.processHD(); // process current symbol first
+        dstarDecoder().init(true);
+        dstarDecoder().processHD(); // process current symbol first
         m_fsmState = DSDprocessDSTAR_HD;
     }
     else if ((m_syncType == DSDSyncNXDNP) || (m_syncType == DSDSyncNXDNN)) // NXDN full sync with preamble
@@ -562,14 +1595,14 @@ void DSDDecoder::processFrameInit()
             if (m_opts.verbose > 0)
             {
                 int level = m_dsdSymbol.getLevel();
-                printf("inlvl: %2i%% ", level);
+                m_dsdLogger.log("inlvl: %2i%% ", level);
             }
         }
 
         m_state.nac = 0;
         sprintf(m_state.fsubtype, " RDCH         ");
-        m_dsdNXDN.init();
-        m_dsdNXDN.process(); // process current symbol first
+        nxdnDecoder().init();
+        nxdnDecoder().process(); // process current symbol first
         m_fsmState = DSDprocessNXDN;
     }
     else if (m_syncType == DSDSyncDPMR) // dPMR classic (not packet)
@@ -589,8 +1622,8 @@ void DSDDecoder::processFrameInit()
 
         m_state.nac = 0;
         sprintf(m_state.fsubtype, " ANY          ");
-        m_dsdDPMR.init();
-        m_dsdDPMR.process();
+        dpmrDecoder().init();
+        dpmrDecoder().process();
         m_fsmState = DSDprocessDPMR;
     }
     else if (m_syncType == DSDSyncYSF) // YSF
@@ -610,8 +1643,8 @@ void DSDDecoder::processFrameInit()
 
         m_state.nac = 0;
         sprintf(m_state.fsubtype, " ANY          ");
-        m_dsdYSF.init();
-        m_dsdYSF.process();
+        ysfDecoder().init();
+        ysfDecoder().process();
         m_fsmState = DSDprocessYSF;
     }
     else
@@ -1156,19 +2189,23 @@ int DSDDecoder::getFrameSync()
 
 void DSDDecoder::resetFrameSync()
 {
-    m_dsdLogger.log("DSDDecoder::resetFrameSync: symbol %d (%d)\n", m_state.symbolcnt, m_dsdSymbol.getSymbol());
-
-    // reset detect frame sync engine
-    m_t = 0;
-    m_synctest_pos = 0;
-
-    m_sync = -2;   // mark in progress
+    m_dsdLogger.debug("DSDDecoder::resetFrameSync: symbol %d (%d)\n", m_state.symbolcnt, m_dsdSymbol.getSymbol());
 
     if ((m_opts.symboltiming == 1) && (m_state.carrier == 1))
     {
         m_dsdLogger.log("\nSymbol Timing:\n");
     }
 
+    initFrameSync();
+}
+
+void DSDDecoder::initFrameSync()
+{
+    // reset detect frame sync engine
+    m_t = 0;
+    m_synctest_pos = 0;
+
+    m_sync = -2;   // mark in progress
 
     m_nxdnInterSyncCount = -1;   // reset to quiet state
     m_fsmState = DSDLookForSync;
@@ -1256,20 +2293,126 @@ void DSDDecoder::printFrameInfo()
     m_dsdLogger.log("tg: %5i ", m_state.lasttg);
 }
 
+void DSDDecoder::publishStatus()
+{
+    m_status.m_version++;
+    m_status.m_sampleCount = m_sampleCount;
+    m_status.m_syncType = (int) m_lastSyncType;
+    m_status.m_stationType = (int) m_stationType;
+    m_status.m_inLevel = getInLevel();
+    m_status.m_symbolSyncQuality = getSymbolSyncQuality();
+    m_status.m_pllLocked = getSymbolPLLLocked();
+    m_status.m_voice1On = m_voice1On;
+    m_status.m_voice2On = m_voice2On;
+
+    // only the section of the current protocol is gathered
+    switch (m_lastSyncType)
+    {
+    case DSDSyncDMRDataMS:
+    case DSDSyncDMRDataP:
+    case DSDSyncDMRVoiceMS:
+    case DSDSyncDMRVoiceP:
+    {
+        DSDStatus::DMR& dmr = m_status.m_dmr;
+        m_status.m_protocol = DSDStatus::ProtocolDMR;
+        memcpy(dmr.m_slot0Text, dmrDecoder().getSlot0Text(), 26);
+        memcpy(dmr.m_slot1Text, dmrDecoder().getSlot1Text(), 26);
+        dmr.m_colorCode = dmrDecoder().getColorCode();
+    }
+        break;
+    case DSDSyncDStarHeaderN:
+    case DSDSyncDStarHeaderP:
+    case DSDSyncDStarN:
+    case DSDSyncDStarP:
+    {
+        DSDStatus::DStar& dstar = m_status.m_dstar;
+        m_status.m_protocol = DSDStatus::ProtocolDStar;
+        DSDStatus::copyText(dstar.m_mySign, sizeof(dstar.m_mySign), dstarDecoder().getMySign().c_str());
+        DSDStatus::copyText(dstar.m_yourSign, sizeof(dstar.m_yourSign), dstarDecoder().getYourSign().c_str());
+        DSDStatus::copyText(dstar.m_rpt1, sizeof(dstar.m_rpt1), dstarDecoder().getRpt1().c_str());
+        DSDStatus::copyText(dstar.m_rpt2, sizeof(dstar.m_rpt2), dstarDecoder().getRpt2().c_str());
+        memcpy(dstar.m_infoText, dstarDecoder().getInfoText(), 20);
+        memcpy(dstar.m_locator, dstarDecoder().getLocator(), 6);
+        dstar.m_bearing = dstarDecoder().getBearing();
+        dstar.m_distance = dstarDecoder().getDistance();
+    }
+        break;
+    case DSDSyncDPMR:
+    {
+        DSDStatus::DPMR& dpmr = m_status.m_dpmr;
+        m_status.m_protocol = DSDStatus::ProtocolDPMR;
+        dpmr.m_frameType = (int) dpmrDecoder().getFrameType();
+        dpmr.m_colorCode = dpmrDecoder().getColorCode();
+        dpmr.m_ownId = dpmrDecoder().getOwnId();
+        dpmr.m_calledId = dpmrDecoder().getCalledId();
+    }
+        break;
+    case DSDSyncYSF:
+    {
+        DSDStatus::YSF& ysf = m_status.m_ysf;
+        const DSDYSF::FICH& fich = ysfDecoder().getFICH();
+        m_status.m_protocol = DSDStatus::ProtocolYSF;
+        ysf.m_fichError = (int) ysfDecoder().getFICHError();
+        ysf.m_frameInformation = (int) fich.getFrameInformation();
+        ysf.m_dataType = (int) fich.getDataType();
+        ysf.m_callMode = (int) fich.getCallMode();
+        ysf.m_blockTotal = fich.getBlockTotal();
+        ysf.m_frameTotal = fich.getFrameTotal();
+        ysf.m_narrowMode = fich.isNarrowMode();
+        ysf.m_internetPath = fich.isInternetPath();
+        ysf.m_squelchCodeEnabled = fich.isSquelchCodeEnabled();
+        ysf.m_squelchCode = fich.getSquelchCode();
+        ysf.m_radioIdMode = ysfDecoder().radioIdMode();
+        DSDStatus::copyText(ysf.m_dest, sizeof(ysf.m_dest), ysfDecoder().getDest());
+        DSDStatus::copyText(ysf.m_src, sizeof(ysf.m_src), ysfDecoder().getSrc());
+        DSDStatus::copyText(ysf.m_downlink, sizeof(ysf.m_downlink), ysfDecoder().getDownlink());
+        DSDStatus::copyText(ysf.m_uplink, sizeof(ysf.m_uplink), ysfDecoder().getUplink());
+        DSDStatus::copyText(ysf.m_rem4, sizeof(ysf.m_rem4), ysfDecoder().getRem4());
+        DSDStatus::copyText(ysf.m_destId, sizeof(ysf.m_destId), ysfDecoder().getDestId());
+        DSDStatus::copyText(ysf.m_srcId, sizeof(ysf.m_srcId), ysfDecoder().getSrcId());
+    }
+        break;
+    case DSDSyncNXDNN:
+    case DSDSyncNXDNP:
+    {
+        DSDStatus::NXDN& nxdn = m_status.m_nxdn;
+        m_status.m_protocol = DSDStatus::ProtocolNXDN;
+        nxdn.m_rfChannel = (int) nxdnDecoder().getRFChannel();
+        DSDStatus::copyText(nxdn.m_rfChannelStr, sizeof(nxdn.m_rfChannelStr), nxdnDecoder().getRFChannelStr());
+        nxdn.m_fullRate = nxdnDecoder().isFullRate();
+        nxdn.m_idle = nxdnDecoder().isIdle();
+        nxdn.m_ran = nxdnDecoder().getRAN();
+        nxdn.m_messageType = nxdnDecoder().getMessageType();
+        nxdn.m_sourceId = nxdnDecoder().getSourceId();
+        nxdn.m_destinationId = nxdnDecoder().getDestinationId();
+        nxdn.m_groupCall = nxdnDecoder().isGroupCall();
+        nxdn.m_locationId = nxdnDecoder().getLocationId();
+        nxdn.m_servicesFlag = nxdnDecoder().getServicesFlag();
+    }
+        break;
+    default:
+        m_status.m_protocol = DSDStatus::ProtocolNone;
+        break;
+    }
+
+    m_statusLock.write(m_status);
+    m_statusSampleCount = m_sampleCount + m_statusPeriod;
+}
+
 void DSDDecoder::formatStatusText(char *statusText)
 {
+    DSDStatus status;
+    getStatus(status);
+
     uint64_t tv_sec, tv_msec;
     uint64_t nowms = TimeUtil::nowms();
     tv_sec = nowms / 1000;
     tv_msec = nowms % 1000;
     sprintf(statusText, "%d.%03d:", (uint32_t) tv_sec, (uint32_t) tv_msec);
 
-    switch (getSyncType())
+    switch (status.m_protocol)
     {
-    case DSDcc::DSDDecoder::DSDSyncDMRDataMS:
-    case DSDcc::DSDDecoder::DSDSyncDMRDataP:
-    case DSDcc::DSDDecoder::DSDSyncDMRVoiceMS:
-    case DSDcc::DSDDecoder::DSDSyncDMRVoiceP:
+    case DSDStatus::ProtocolDMR:
         if (m_signalFormat != signalFormatDMR)
         {
             strcpy(&statusText[15], "DMR>Sta: __ S1: __________________________ S2: __________________________");
@@ -1279,7 +2422,7 @@ void DSDDecoder::formatStatusText(char *statusText)
         	memcpy(&statusText[15], "DMR", 3);
         }
 
-        switch (getStationType())
+        switch (status.m_stationType)
         {
         case DSDcc::DSDDecoder::DSDBaseStation:
             memcpy(&statusText[24], "BS ", 3);
@@ -1292,14 +2435,11 @@ void DSDDecoder::formatStatusText(char *statusText)
             break;
         }
 
-        memcpy(&statusText[31], getDMRDecoder().getSlot0Text(), 26);
-        memcpy(&statusText[62], getDMRDecoder().getSlot1Text(), 26);
+        memcpy(&statusText[31], status.m_dmr.m_slot0Text, 26);
+        memcpy(&statusText[62], status.m_dmr.m_slot1Text, 26);
         m_signalFormat = signalFormatDMR;
         break;
-    case DSDcc::DSDDecoder::DSDSyncDStarHeaderN:
-    case DSDcc::DSDDecoder::DSDSyncDStarHeaderP:
-    case DSDcc::DSDDecoder::DSDSyncDStarN:
-    case DSDcc::DSDDecoder::DSDSyncDStarP:
+    case DSDStatus::ProtocolDStar:
         if (m_signalFormat != signalFormatDStar)
         {
                                   // 1    2    2    3    3    4    4    5    5    6    6    7    7    8    8    9    9
@@ -1313,65 +2453,64 @@ void DSDDecoder::formatStatusText(char *statusText)
         }
 
         {
-            const std::string& rpt1 = getDStarDecoder().getRpt1();
-            const std::string& rpt2 = getDStarDecoder().getRpt2();
-            const std::string& mySign = getDStarDecoder().getMySign();
-            const std::string& yrSign = getDStarDecoder().getYourSign();
+            const DSDStatus::DStar& dstar = status.m_dstar;
 
-            if (rpt1.length() > 0) { // 0 or 8
-                memcpy(&statusText[42], rpt1.c_str(), 8);
+            if (dstar.m_rpt1[0]) { // 0 or 8
+                memcpy(&statusText[42], dstar.m_rpt1, 8);
             }
-            if (rpt2.length() > 0) { // 0 or 8
-                memcpy(&statusText[51], rpt2.c_str(), 8);
+            if (dstar.m_rpt2[0]) { // 0 or 8
+                memcpy(&statusText[51], dstar.m_rpt2, 8);
             }
-            if (yrSign.length() > 0) { // 0 or 8
-                memcpy(&statusText[33], yrSign.c_str(), 8);
+            if (dstar.m_yourSign[0]) { // 0 or 8
+                memcpy(&statusText[33], dstar.m_yourSign, 8);
             }
-            if (mySign.length() > 0) { // 0 or 13
-                memcpy(&statusText[19], mySign.c_str(), 13);
+            if (dstar.m_mySign[0]) { // 0 or 13
+                memcpy(&statusText[19], dstar.m_mySign, 13);
             }
-            memcpy(&statusText[60], getDStarDecoder().getInfoText(), 20);
-            memcpy(&statusText[81], getDStarDecoder().getLocator(), 6);
+            memcpy(&statusText[60], dstar.m_infoText, 20);
+            memcpy(&statusText[81], dstar.m_locator, 6);
             sprintf(&statusText[88], "%03d/%07.1f",
-                    getDStarDecoder().getBearing(),
-                    getDStarDecoder().getDistance());
+                    dstar.m_bearing,
+                    dstar.m_distance);
         }
 
         statusText[101] = '\0';
         m_signalFormat = signalFormatDStar;
         break;
-    case DSDcc::DSDDecoder::DSDSyncDPMR:
+    case DSDStatus::ProtocolDPMR:
         sprintf(&statusText[15], "DPM>%s CC: %04d OI: %08d CI: %08d",
-                DSDcc::DSDdPMR::dpmrFrameTypes[(int) getDPMRDecoder().getFrameType()],
-                getDPMRDecoder().getColorCode(),
-                getDPMRDecoder().getOwnId(),
-                getDPMRDecoder().getCalledId());
+                DSDcc::DSDdPMR::dpmrFrameTypes[status.m_dpmr.m_frameType],
+                status.m_dpmr.m_colorCode,
+                status.m_dpmr.m_ownId,
+                status.m_dpmr.m_calledId);
         m_signalFormat = signalFormatDPMR;
         break;
-    case DSDcc::DSDDecoder::DSDSyncYSF:
+    case DSDStatus::ProtocolYSF:
+    {
+        const DSDStatus::YSF& ysf = status.m_ysf;
         //           1    1    2    2    3    3    4    4    5    5    6    6    7    7    8
         // 0....5....0....5....0....5....0....5....0....5....0....5....0....5....0....5....0..
         // C V2 RI 0:7 WL000|ssssssssss>dddddddddd |UUUUUUUUUU>DDDDDDDDDD|44444
-        if (getYSFDecoder().getFICHError() == DSDcc::DSDYSF::FICHNoError)
+        if (ysf.m_fichError == (int) DSDcc::DSDYSF::FICHNoError)
         {
-            sprintf(&statusText[15], "YSF>%s ", DSDcc::DSDYSF::ysfChannelTypeText[(int) getYSFDecoder().getFICH().getFrameInformation()]);
+            sprintf(&statusText[15], "YSF>%s ", DSDcc::DSDYSF::ysfChannelTypeText[ysf.m_frameInformation]);
         }
         else
         {
-            sprintf(&statusText[15], "YSF>%d ", (int) getYSFDecoder().getFICHError());
+            sprintf(&statusText[15], "YSF>%d ", ysf.m_fichError);
         }
 
         sprintf(&statusText[21], "%s %s %d:%d %c%c",
-                DSDcc::DSDYSF::ysfDataTypeText[(int) getYSFDecoder().getFICH().getDataType()],
-                DSDcc::DSDYSF::ysfCallModeText[(int) getYSFDecoder().getFICH().getCallMode()],
-                getYSFDecoder().getFICH().getBlockTotal(),
-                getYSFDecoder().getFICH().getFrameTotal(),
-                (getYSFDecoder().getFICH().isNarrowMode() ? 'N' : 'W'),
-                (getYSFDecoder().getFICH().isInternetPath() ? 'I' : 'L'));
-
-        if (getYSFDecoder().getFICH().isSquelchCodeEnabled())
+                DSDcc::DSDYSF::ysfDataTypeText[ysf.m_dataType],
+                DSDcc::DSDYSF::ysfCallModeText[ysf.m_callMode],
+                ysf.m_blockTotal,
+                ysf.m_frameTotal,
+                (ysf.m_narrowMode ? 'N' : 'W'),
+                (ysf.m_internetPath ? 'I' : 'L'));
+
+        if (ysf.m_squelchCodeEnabled)
         {
-            sprintf(&statusText[33], "%03d", getYSFDecoder().getFICH().getSquelchCode());
+            sprintf(&statusText[33], "%03d", ysf.m_squelchCode);
         }
         else
         {
@@ -1380,45 +2519,48 @@ void DSDDecoder::formatStatusText(char *statusText)
 
         char dest[11+1];
 
-        if ( getYSFDecoder().radioIdMode())
+        if (ysf.m_radioIdMode)
         {
             sprintf(dest, "%-5s:%-5s",
-                    getYSFDecoder().getDestId(),
-                    getYSFDecoder().getSrcId());
+                    ysf.m_destId,
+                    ysf.m_srcId);
         }
         else
         {
-            sprintf(dest, "%-10s", getYSFDecoder().getDest());
+            sprintf(dest, "%-10s", ysf.m_dest);
         }
 
         sprintf(&statusText[36], "|%-10s>%s|%-10s>%-10s|%-5s",
-                getYSFDecoder().getSrc(),
+                ysf.m_src,
                 dest,
-                getYSFDecoder().getUplink(),
-                getYSFDecoder().getDownlink(),
-                getYSFDecoder().getRem4());
+                ysf.m_uplink,
+                ysf.m_downlink,
+                ysf.m_rem4);
 
         m_signalFormat = signalFormatYSF;
+    }
         break;
-    case DSDcc::DSDDecoder::DSDSyncNXDNN:
-    case DSDcc::DSDDecoder::DSDSyncNXDNP:
-        if (getNXDNDecoder().getRFChannel() == DSDNXDN::NXDNRCCH)
+    case DSDStatus::ProtocolNXDN:
+    {
+        const DSDStatus::NXDN& nxdn = status.m_nxdn;
+
+        if (nxdn.m_rfChannel == (int) DSDNXDN::NXDNRCCH)
         {
             // 1    2    2    3    3    4    4    5    5    6    6    7    7    8
             // 5....0....5....0....5....0....5....0....5....0....5....0....5....0..
             // NXD>RC r cc mm llllll ssss
             sprintf(&statusText[15], "NXD>RC %s %02d %02X %06X %02X",
-                getNXDNDecoder().isFullRate() ? "F" : "H",
-                getNXDNDecoder().getRAN(),
-                getNXDNDecoder().getMessageType(),
-                getNXDNDecoder().getLocationId(),
-                getNXDNDecoder().getServicesFlag());
-        }
-        else if ((getNXDNDecoder().getRFChannel() == DSDNXDN::NXDNRTCH)
-            || (getNXDNDecoder().getRFChannel() == DSDNXDN::NXDNRDCH))
+                nxdn.m_fullRate ? "F" : "H",
+                nxdn.m_ran,
+                nxdn.m_messageType,
+                nxdn.m_locationId,
+                nxdn.m_servicesFlag);
+        }
+        else if ((nxdn.m_rfChannel == (int) DSDNXDN::NXDNRTCH)
+            || (nxdn.m_rfChannel == (int) DSDNXDN::NXDNRDCH))
         {
-            if (getNXDNDecoder().isIdle()) {
-                snprintf(&statusText[15], 82, "NXD>%s IDLE", getNXDNDecoder().getRFChannelStr());
+            if (nxdn.m_idle) {
+                snprintf(&statusText[15], 82, "NXD>%s IDLE", nxdn.m_rfChannelStr);
             }
             else
             {
@@ -1426,13 +2568,13 @@ void DSDDecoder::formatStatusText(char *statusText)
                 // 5....0....5....0....5....0....5....0....5....0....5....0....5....0..
                 // NXD>Rx r cc mm sssss>gddddd
                 snprintf(&statusText[15], 82, "NXD>%s %s %02d %02X %05d>%c%05d",
-                        getNXDNDecoder().isFullRate() ? "F" : "H",
-                        getNXDNDecoder().getRFChannelStr(),
-                        getNXDNDecoder().getRAN(),
-                        getNXDNDecoder().getMessageType(),
-                        getNXDNDecoder().getSourceId(),
-                        getNXDNDecoder().isGroupCall() ? 'G' : 'I',
-                        getNXDNDecoder().getDestinationId());
+                        nxdn.m_fullRate ? "F" : "H",
+                        nxdn.m_rfChannelStr,
+                        nxdn.m_ran,
+                        nxdn.m_messageType,
+                        nxdn.m_sourceId,
+                        nxdn.m_groupCall ? 'G' : 'I',
+                        nxdn.m_destinationId);
             }
         }
         else
@@ -1443,6 +2585,7 @@ void DSDDecoder::formatStatusText(char *statusText)
             snprintf(&statusText[15], 82, "NXD>RU");
         }
         m_signalFormat = signalFormatNXDN;
+    }
         break;
     default:
     	strcpy(&statusText[15], "XXX>");
@@ -21,7 +21,15 @@
 #include "dsd_state.h"
 #include "dsd_logger.h"
 #include "dsd_symbol.h"
+#include "dsd_profile.h"
+#include "dsd_stats.h"
+#include "dsd_status.h"
+#include "dsd_capture.h"
+#include "dsd_symbolcapture.h"
 #include "dsd_mbe.h"
+#include "dsd_idlegate.h"
+#include "dsd_ratedetector.h"
+#include "dsd_resampler.h"
 #include "dmr.h"
 #include "ysf.h"
 #include "dpmr.h"
@@ -30,11 +38,18 @@
 #include "locator.h"
 #include "export.h"
 
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+
 #define DSD_SQUELCH_TIMEOUT_SAMPLES 960 // 200ms timeout after return to sync search
+#define DSD_CALL_TIMEOUT_SAMPLES 48000  // 1s without voice frame ends a call
 
 namespace DSDcc
 {
 
+class DSDStateBuffer;
+
 class DSDCC_API DSDDecoder
 {
     friend class DSDSymbol;
@@ -45,6 +60,8 @@ class DSDCC_API DSDDecoder
     friend class DSDYSF;
     friend class DSDdPMR;
     friend class DSDNXDN;
+    friend class DSDSymbolBatch;
+    friend class DSDDecoderPool;
 public:
     typedef enum
     {
@@ -149,10 +166,92 @@ public:
         DSDMBERate4400
     } DSDMBERate;
 
+    /**
+     * A voice call on a slot from its header (or first voice frame if the header was missed) to
+     * its terminator. Identities are those decoded so far in the call: they may be completed by
+     * the end of the call (e.g. DMR embedded LC). Strings are null terminated and empty if unknown.
+     */
+    struct CallInfo
+    {
+        typedef enum
+        {
+            CallEndNone,       //!< call in progress
+            CallEndTerminator, //!< terminator or end of transmission decoded
+            CallEndTimeout,    //!< no voice frame for the call timeout (see setCallTimeout)
+            CallEndNewCall,    //!< header of another call on the same slot
+            CallEndFlush       //!< ended by endCalls e.g. at the end of the input
+        } CallEnd;
+
+        DSDStatus::Protocol m_protocol;
+        int m_slot;                  //!< TDMA slot 0 or 1, 0 for the FDMA protocols
+        bool m_header;               //!< started by a header else by a voice frame (late entry)
+        uint64_t m_start;            //!< sample count at the header or first voice frame
+        uint64_t m_end;              //!< sample count at the last voice frame or at the terminator
+        unsigned int m_nbVoiceFrames;
+        CallEnd m_callEnd;
+        unsigned int m_sourceId;     //!< DMR, dPMR and NXDN source unit (0 if unknown)
+        unsigned int m_destinationId;
+        bool m_group;                //!< destination is a talk group (DMR and NXDN)
+        int m_colorCode;             //!< DMR or dPMR colour code, NXDN RAN, -1 if unknown
+        char m_source[13+1];         //!< D-Star my callsign, YSF source
+        char m_destination[10+1];    //!< D-Star your callsign, YSF destination
+    };
+
+    /**
+     * Receives the decoder output as soon as a complete 20 ms frame is available.
+     * Methods are called from within run() so implementations must not block.
+     * Pointers refer to decoder owned memory that is valid only for the duration of the call.
+     * The timestamp is the value of the input sample counter (at 48 kS/s) when the frame was completed.
+     */
+    class AudioSink
+    {
+    public:
+        virtual ~AudioSink() {}
+        /** nbSamples is the number of sample instants. With stereo output samples are interleaved L+R. */
+        virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp) = 0;
+        /**
+         * Packed AMBE/IMBE frame as used by DVSI AMBE3000 devices (see getMbeDVFrame1/2).
+         * The DMR, dPMR, YSF and NXDN decoders store these frames only without mbelib or after
+         * enableMbeDV(true) so this is not called for them otherwise. D-Star frames are always given.
+         * Use getStats() to count the voice frames whatever the configuration.
+         */
+        virtual void mbeFrame(int /* slot */, const unsigned char * /* frame */, int /* nbBytes */,
+                DSDMBERate /* mbeRate */, uint64_t /* timestamp */) {}
+        /** A call starts on call.m_slot. Given before its first voice frame. Its audio and AMBE/IMBE frames follow until callEnd */
+        virtual void callStart(const CallInfo& /* call */) {}
+        /** The call ends. call.m_callEnd tells why */
+        virtual void callEnd(const CallInfo& /* call */) {}
+    };
+
     DSDDecoder();
     ~DSDDecoder();
 
+    /**
+     * Returns the decoder to the state of a newly constructed decoder (options, decoding state,
+     * statistics and status) so that it can be reused for another channel or recording.
+     * Buffers and FEC, interleaving and Viterbi tables of the frame decoders already created
+     * are kept so this is much cheaper than constructing a decoder.
+     * The audio sink, the frame and symbol captures and the log file stay attached. Calls in
+     * progress are dropped without callEnd (see endCalls).
+     */
+    void reset();
+    /**
+     * Writes the tracking state into buffer replacing its content: sample count, data rate, sync
+     * search or frame in progress, input filters memory, symbol levels, timing and history, PLL,
+     * the frame decoders in use and the vocoder parameters history. A decoder configured with the
+     * same options that restores it and is given the samples that follow decodes as the saved one
+     * would have. Options, statistics, the input resampler, idle gate and rate auto detection
+     * history are not part of the state. The format is described in DSDStateBuffer and starts
+     * with "DSDCSTA" and a version number.
+     */
+    void saveState(std::vector<unsigned char>& buffer) const;
+    /** Restores a state saved by saveState. If the data is not a valid state, is damaged or holds a value out of range returns false, keeps the decoder state and looks for sync afresh */
+    bool restoreState(const unsigned char *data, unsigned int size);
+    bool restoreState(const std::vector<unsigned char>& buffer) { return restoreState(buffer.data(), buffer.size()); }
     void run(short sample);
+    uint64_t getSampleCount() const { return m_sampleCount; } //!< number of input samples processed so far at 48 kS/s
+    /** Starts the sample clock at the given position e.g. to decode a part of a recording with absolute timestamps */
+    void setSampleCount(uint64_t sampleCount);
     short getFilteredSample() const { return m_dsdSymbol.getFilteredSample(); }
     short getSymbolSyncSample() const { return m_dsdSymbol.getSymbolSyncSample(); }
 
@@ -182,6 +281,23 @@ public:
         m_mbeDVReady2 = false;
     }
 
+    /** Push style output (replaces polling of the MBE and audio getters) */
+
+    void setAudioSink(AudioSink *audioSink);
+    AudioSink *getAudioSink() const { return m_audioSink; }
+    /** Samples at 48 kS/s without voice frame after which a call without terminator ends (default DSD_CALL_TIMEOUT_SAMPLES) */
+    void setCallTimeout(unsigned int nbSamples) { m_callTimeout = nbSamples; }
+    /** Ends the calls in progress with CallEndFlush e.g. at the end of the input */
+    void endCalls();
+
+    /** Binary capture of the decoded frames. The capture is not owned by the decoder. 0 to stop */
+    void setCapture(DSDCapture *capture) { m_capture = capture; }
+
+    /** Capture of the symbol stream to replay it later with runSymbol. The capture is not owned by the decoder. 0 to stop */
+    void setSymbolCapture(DSDSymbolCapture *symbolCapture);
+    /** Runs the decoder from a captured symbol instead of the samples (the decode mode options should be those of the capture) */
+    void runSymbol(const DSDSymbolCapture::Symbol& symbol);
+
     /** MBElib support */
 
     short *getAudio1(int& nbSamples)
@@ -216,6 +332,8 @@ public:
         return m_lastSyncType;
     }
 
+    unsigned int getSyncCount(DSDSyncType syncType) const { return (unsigned int) m_stats.getSyncCount(syncType); } //!< frame syncs found by sync search for a type
+
     DSDStationType getStationType() const { return m_stationType; }
     const char *getFrameTypeText() const { return m_state.ftype; }
     const char *getFrameSubtypeText() const { return m_state.fsubtype; }
@@ -228,15 +346,37 @@ public:
     bool getVoice1On() const { return m_voice1On; }
     bool getVoice2On() const { return m_voice2On; }
     void setTDMAStereo(bool tdmaStereo);
-    void formatStatusText(char *statusText);
+    void formatStatusText(char *statusText); //!< formats the last published status (see getStatus)
+    /** Copies the last published status. Can be called from any thread */
+    void getStatus(DSDStatus& status) const { m_statusLock.read(status); }
+    void setStatusPeriod(unsigned int nbSamples) { m_statusPeriod = nbSamples; } //!< status publication period in samples at 48 kS/s (default 480)
     bool getSymbolPLLLocked() const { return m_dsdSymbol.getPLLLocked(); }
+    DSDSymbol::TimingRecovery getSymbolTimingRecovery() const { return m_dsdSymbol.getTimingRecovery(); }
 
-    const DSDDMR& getDMRDecoder() const { return m_dsdDMR; }
-    const DSDDstar& getDStarDecoder() const { return m_dsdDstar; }
-    const DSDdPMR& getDPMRDecoder() const { return m_dsdDPMR; }
-    const DSDYSF& getYSFDecoder() const { return m_dsdYSF; }
-    const DSDNXDN& getNXDNDecoder() const { return m_dsdNXDN; }
+    /**
+     * Frame decoders for status displays. These can be called from any thread and never create a
+     * decoder: a protocol that is not decoded yet gives an empty decoder shared by all instances.
+     */
+    const DSDDMR& getDMRDecoder() const { return publishedDecoder(m_dsdDMR, &DSDDecoder::dmrDecoder); }
+    const DSDDstar& getDStarDecoder() const { return publishedDecoder(m_dsdDstar, &DSDDecoder::dstarDecoder); }
+    const DSDdPMR& getDPMRDecoder() const { return publishedDecoder(m_dsdDPMR, &DSDDecoder::dpmrDecoder); }
+    const DSDYSF& getYSFDecoder() const { return publishedDecoder(m_dsdYSF, &DSDDecoder::ysfDecoder); }
+    const DSDNXDN& getNXDNDecoder() const { return publishedDecoder(m_dsdNXDN, &DSDDecoder::nxdnDecoder); }
+    /** Time spent in the processing stages. Counts only with DSD_USE_PROFILE (see DSDProfile) */
+    const DSDProfile& getProfile() const { return m_profile; }
+    void resetProfile() { m_profile.reset(); }
+    const DSDStats& getStats() const { return m_stats; } //!< snapshot may be taken from any thread
+    void resetStats() { m_stats.reset(); }
+    /** Memory used by this decoder including the parts allocated on demand */
+    size_t getMemoryFootprint() const;
     void enableMbelib(bool enable) { m_mbelibEnable = enable; }
+    /** Fill the DVSI frames also when mbelib decodes the audio (e.g. to record them) */
+    void enableMbeDV(bool enable) { m_mbeDVEnable = enable; }
+    /**
+     * Synthesizes a DVSI frame recorded from the audio sink (see AudioSink::mbeFrame) with mbelib.
+     * Audio is given to the audio sink with this timestamp. Returns false if the rate is not supported.
+     */
+    bool vocodeDVFrame(int slot, const unsigned char *dvFrame, DSDMBERate mbeRate, uint64_t timestamp);
 
     // Initializations:
     void setQuiet();
@@ -255,8 +395,25 @@ public:
     void enableAudioOut(bool on);
     void enableScanResumeAfterTDULCFrames(int nbFrames);
     void setDataRate(DSDRate dataRate);
+    void setAudioBufferSize(int nbSamples);
+    /** Sample rate of the samples given to run(). They are resampled to the nominal 48 kS/s if different */
+    void setInputSampleRate(int sampleRate);
+    int getInputSampleRate() const { return m_inputSampleRate; }
+    /** Skip symbol recovery and sync search on idle channels (see DSDIdleGate) */
+    void enableIdleGate(bool enable);
+    void setIdleGateNoiseRatio(float noiseRatio) { m_idleGate.setNoiseRatio(noiseRatio); }
+    void setIdleGateMinLevel(float minLevel) { m_idleGate.setMinLevel(minLevel); }
+    bool isIdleGateParked() const { return m_idleGate.isParked(); }
+    const DSDIdleGate& getIdleGate() const { return m_idleGate; }
+    /** Auto frame decoding looking for sync at all data rates and switching to the rate which sync fires (see DSDRateDetector) */
+    void enableMultiRateAuto(bool enable);
+    /** Registers the sync words of each rate with their sync type as used by the multi-rate auto detection */
+    static void addRateSyncPatterns(DSDRateDetector& rateDetector);
+    bool isMultiRateAuto() const { return m_rateDetector.isEnabled(); }
+    const DSDRateDetector& getRateDetector() const { return m_rateDetector; }
     void setMyPoint(float lat, float lon) { m_myPoint.setLatLon(lat, lon); }
     void setSymbolPLLLock(bool pllLock) { m_dsdSymbol.setPLLLock(pllLock); }
+    void setSymbolTimingRecovery(DSDSymbol::TimingRecovery timingRecovery) { m_dsdSymbol.setTimingRecovery(timingRecovery); }
 
     // parameter getters:
 
@@ -314,10 +471,76 @@ private:
 
     int getFrameSync();
     void resetFrameSync();
+    void initFrameSync(); //!< resetFrameSync without messages (constructor)
     void printFrameSync(const char *frametype, int offset);
     void noCarrier();
     void printFrameInfo();
     void processFrameInit();
+    void setMbeDVReady1();
+    void setMbeDVReady2();
+    void startCall(int slot, DSDStatus::Protocol protocol); //!< header of a call. Repeated headers before voice do not start another call. The sink sees it at the first voice frame
+    void endCall(int slot, CallInfo::CallEnd callEnd);
+    void openCall(int slot, DSDStatus::Protocol protocol, bool header);
+    void voiceFrame(int slot); //!< starts a call if none (late entry) and postpones its timeout
+    void updateCallIdentity(CallInfo& call) const; //!< completes the identities from the frame decoder
+    DSDStatus::Protocol getCallProtocol() const; //!< protocol of the last sync
+    void checkCallTimeout() { if (m_sampleCount >= m_callTimeoutSampleCount) { endTimedOutCalls(); } }
+    void endTimedOutCalls();
+    void saveCallState(DSDStateBuffer& buffer) const;
+    void restoreCallState(DSDStateBuffer& buffer);
+    int getMbeDVFrameSize() const;
+    bool mbeDVEnabled() const { return !m_mbelibEnable || m_mbeDVEnable; } //!< protocol decoders store the DVSI frames
+    /** The DVSI frame just made ready was stored: D-Star stores them always */
+    bool mbeDVStored() const { return mbeDVEnabled() || (getCallProtocol() == DSDStatus::ProtocolDStar); }
+    void runNominalRate(short sample);
+    void runSample(short sample);
+    void runFrontEndOutput(short sample, short filteredSample, short ringingSample, short pllSample); //!< nominal rate sample with its front end already processed (DSDSymbolBatch)
+    void checkSquelchTimeout(short sample);
+    void processSymbol(); //!< run the FSM on a new symbol
+    void switchDataRate(DSDRate dataRate);
+    void allocateFrameDecoders();
+    void resetFrameDecoders();
+    void saveDecoderState(DSDStateBuffer& buffer) const;
+    void restoreDecoderState(DSDStateBuffer& buffer);
+    void restoreSections(DSDStateBuffer& state); //!< applies the sections in turn: the caller checks the state is still valid afterwards
+
+    // Frame decoders are created on first use by the decoding thread so that unused protocols cost only a pointer
+    template<typename T>
+    T& frameDecoder(std::atomic<T*>& decoder)
+    {
+        T *frameDecoder = decoder.load(std::memory_order_relaxed); // only this thread writes it
+
+        if (!frameDecoder)
+        {
+            frameDecoder = new T(this);
+            decoder.store(frameDecoder, std::memory_order_release);
+        }
+
+        return *frameDecoder;
+    }
+
+    template<typename T>
+    static const T& publishedDecoder(const std::atomic<T*>& decoder, T& (DSDDecoder::*accessor)())
+    {
+        const T *frameDecoder = decoder.load(std::memory_order_acquire);
+        return frameDecoder ? *frameDecoder : (emptyDecoder().*accessor)();
+    }
+
+    static DSDDecoder& emptyDecoder(); //!< decoder with all frame decoders created and never run
+    static DSDDecoder *createEmptyDecoder();
+    DSDDMR& dmrDecoder() { return frameDecoder(m_dsdDMR); }
+    DSDDstar& dstarDecoder() { return frameDecoder(m_dsdDstar); }
+    DSDYSF& ysfDecoder() { return frameDecoder(m_dsdYSF); }
+    DSDdPMR& dpmrDecoder() { return frameDecoder(m_dsdDPMR); }
+    DSDNXDN& nxdnDecoder() { return frameDecoder(m_dsdNXDN); }
+    void captureBits(const DSDCapture::Frame& frame, const unsigned char *bits, unsigned int nbBits) {
+        m_capture->writeBits(frame, m_sampleCount, (int) m_syncType, bits, nbBits);
+    }
+    void captureBytes(const DSDCapture::Frame& frame, const unsigned char *bytes, unsigned int nbBits) {
+        m_capture->writeBytes(frame, m_sampleCount, (int) m_syncType, bytes, nbBits);
+    }
+    void captureSymbol(); //!< writes the symbol just concluded to the symbol capture
+    void publishStatus(); //!< gathers the status of the current protocol and publishes it
     static int comp(const void *a, const void *b);
 
     DSDOpts m_opts;
@@ -340,6 +563,7 @@ private:
     char ambe_fr[4][24];
     char imbe_fr[8][23];
     bool m_mbelibEnable;
+    bool m_mbeDVEnable;
     DSDMBERate m_mbeRate;
     DSDMBEDecoder m_mbeDecoder1; //!< AMBE decoder for TDMA unique or first slot
     DSDMBEDecoder m_mbeDecoder2; //!< AMBE decoder for TDMA second slot
@@ -348,21 +572,50 @@ private:
     bool m_mbeDVReady1;              //!< AMBE/IMBE encoded frame ready status for TDMA unique or first slot
     unsigned char m_mbeDVFrame2[9];  //!< AMBE encoded frame for TDMA second slot
     bool m_mbeDVReady2;              //!< AMBE encoded frame ready status for TDMA second slot
+    // Push style output
+    AudioSink *m_audioSink;
+    DSDCapture *m_capture;           //!< frame capture or 0 (protocol decoders test it before capturing)
+    uint64_t m_sampleCount;          //!< sample clock at the nominal 48 kS/s rate
+    DSDSymbolCapture *m_symbolCapture; //!< symbol capture or 0
+    int m_symbolCaptureRate;         //!< data rate set since the last captured symbol or -1
+    bool m_symbolCaptureRateSwitch;  //!< the data rate was switched by the rate detection since the last captured symbol
+    bool m_symbolCaptureSquelch;     //!< the squelch time out reset the sync search since the last captured symbol
+    // Input rate conversion (allocated if rate is not 48 kS/s)
+    int m_inputSampleRate;
+    DSDResampler *m_inputResampler;
+    float *m_resampledSamples;
+    // Idle channel detection
+    DSDIdleGate m_idleGate;
+    // Multi-rate auto detection
+    DSDRateDetector m_rateDetector;
+    bool m_rateReplay;               //!< replaying history after a rate switch
     // Voice announcements
     bool m_voice1On;
     bool m_voice2On;
-    // Frame decoders
-    DSDDMR m_dsdDMR;
-    DSDDstar m_dsdDstar;
-    DSDYSF m_dsdYSF;
-    DSDdPMR m_dsdDPMR;
-    DSDNXDN m_dsdNXDN;
+    // Calls
+    CallInfo m_calls[2];
+    bool m_callActive[2];
+    bool m_callVoice[2];               //!< the call had voice and was given to the audio sink
+    unsigned int m_callTimeout;
+    uint64_t m_callTimeoutSampleCount; //!< sample count at which the first active call times out
+    // Frame decoders (allocated on demand)
+    std::atomic<DSDDMR*> m_dsdDMR;     //!< frame decoders are read by the status getters from other threads
+    std::atomic<DSDDstar*> m_dsdDstar;
+    std::atomic<DSDYSF*> m_dsdYSF;
+    std::atomic<DSDdPMR*> m_dsdDPMR;
+    std::atomic<DSDNXDN*> m_dsdNXDN;
     DSDRate m_dataRate;
     DSDSyncType m_syncType;
     DSDSyncType m_lastSyncType;
+    DSDStats m_stats;
+    DSDProfile m_profile;
     LocPoint m_myPoint;
-    // status text
-    SignalFormat m_signalFormat;
+    // status
+    DSDStatus m_status;              //!< status being gathered by the decoding thread
+    DSDSeqLock<DSDStatus> m_statusLock;
+    unsigned int m_statusPeriod;
+    uint64_t m_statusSampleCount;    //!< sample count of the next periodic publication
+    SignalFormat m_signalFormat;     //!< format of the previous status text
 };
 
 } // namespace dsdcc
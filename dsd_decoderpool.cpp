@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsd_decoderpool.h"
+#include "dsd_decoder.h"
+
+namespace DSDcc
+{
+
+DSDDecoderPool::DSDDecoderPool(unsigned int nbDecoders) :
+        m_nbCreated(0)
+{
+    reserve(nbDecoders);
+}
+
+DSDDecoderPool::~DSDDecoderPool()
+{
+    for (std::vector<DSDDecoder*>::iterator it = m_free.begin(); it != m_free.end(); ++it) {
+        delete *it;
+    }
+}
+
+DSDDecoder *DSDDecoderPool::createWarm()
+{
+    DSDDecoder *decoder = new DSDDecoder();
+
+    // the accessors create the frame decoders that are not there yet
+    decoder->dmrDecoder();
+    decoder->dstarDecoder();
+    decoder->dpmrDecoder();
+    decoder->ysfDecoder();
+    decoder->nxdnDecoder();
+
+    return decoder;
+}
+
+void DSDDecoderPool::reserve(unsigned int nbDecoders)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    while (m_free.size() < nbDecoders)
+    {
+        m_free.push_back(createWarm());
+        m_nbCreated++;
+    }
+}
+
+DSDDecoder *DSDDecoderPool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_free.size() > 0)
+        {
+            DSDDecoder *decoder = m_free.back();
+            m_free.pop_back();
+            return decoder;
+        }
+
+        m_nbCreated++;
+    }
+
+    return createWarm(); // outside of the lock: this is the slow path
+}
+
+void DSDDecoderPool::release(DSDDecoder *decoder)
+{
+    if (!decoder) {
+        return;
+    }
+
+    decoder->setAudioSink(0);
+    decoder->setCapture(0);
+    decoder->setSymbolCapture(0);
+    decoder->reset();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(decoder);
+}
+
+unsigned int DSDDecoderPool::getNbFree() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_free.size();
+}
+
+unsigned int DSDDecoderPool::getNbCreated() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbCreated;
+}
+
+} // namespace DSDcc
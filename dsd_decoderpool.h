@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_DECODERPOOL_H_
+#define DSDCC_DSD_DECODERPOOL_H_
+
+#include <vector>
+#include <mutex>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+class DSDDecoder;
+
+/**
+ * Keeps decoders that are not in use so that a channel can be retuned or opened without
+ * constructing a decoder. Decoders are created warm: all frame decoders and their tables
+ * are built. A released decoder is detached from its audio sink and captures and reset
+ * with DSDDecoder::reset() so that acquire() hands out a decoder in the state of a newly
+ * constructed one. The log file of a decoder is not changed. Methods are thread safe.
+ */
+class DSDCC_API DSDDecoderPool
+{
+public:
+    /** Creates nbDecoders warm decoders */
+    explicit DSDDecoderPool(unsigned int nbDecoders = 0);
+    ~DSDDecoderPool();
+
+    /** Creates warm decoders until at least nbDecoders are free */
+    void reserve(unsigned int nbDecoders);
+    /** Takes a free decoder or creates a warm one if none is left. The caller owns it until release() */
+    DSDDecoder *acquire();
+    /** Returns a decoder obtained with acquire() */
+    void release(DSDDecoder *decoder);
+
+    unsigned int getNbFree() const;
+    unsigned int getNbCreated() const; //!< decoders created by the pool since construction
+
+    /** Constructs a decoder with all its frame decoders */
+    static DSDDecoder *createWarm();
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<DSDDecoder*> m_free;
+    unsigned int m_nbCreated;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_DECODERPOOL_H_ */
@@ -0,0 +1,666 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include <random>
+
+#include "fec.h"
+#include "mbefec.h"
+#include "crc.h"
+#include "nxdncrc.h"
+#include "viterbi3.h"
+#include "viterbi5.h"
+#include "nxdnconvolution.h"
+#include "descramble.h"
+#include "timeutil.h"
+
+#ifndef DSDCC_VERSION
+#define DSDCC_VERSION "unknown"
+#endif
+
+typedef std::mt19937 Random;
+
+static void randomBits(unsigned char *bits, int nbBits, Random& random)
+{
+    for (int i = 0; i < nbBits; i++) {
+        bits[i] = random() & 1;
+    }
+}
+
+static void randomBytes(unsigned char *bytes, int nbBytes, Random& random)
+{
+    for (int i = 0; i < nbBytes; i++) {
+        bytes[i] = random() & 0xff;
+    }
+}
+
+/**
+ * A FEC or CRC kernel under test. Codewords are produced from random data and the
+ * decoder output is compared with this data. For CRC kernels the output is the
+ * check result that should be true for the transmitted codeword.
+ */
+class FECKernel
+{
+public:
+    FECKernel(const char *name, int codewordBits, int codewordSize, int dataSize) :
+        m_name(name),
+        m_codewordBits(codewordBits),
+        m_codewordSize(codewordSize),
+        m_dataSize(dataSize)
+    {}
+    virtual ~FECKernel() {}
+
+    /** Fill data with random content and codeword with its encoded form */
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random) = 0;
+    /** Decode codeword (possibly in place) into data. Returns false if the decoder reports a failure */
+    virtual bool decode(unsigned char *codeword, unsigned char *data) = 0;
+    /** Invert a bit of the codeword as transmitted on the channel */
+    virtual void flipBit(unsigned char *codeword, int bitIndex) { codeword[bitIndex] ^= 1; }
+
+    const char *m_name;
+    int m_codewordBits; //!< number of channel bits where errors can be inserted
+    int m_codewordSize; //!< codeword storage size in bytes
+    int m_dataSize;     //!< decoded data storage size in bytes
+};
+
+/** Codes of fec.h that correct the codeword in place with data in the first bits */
+template<class Code>
+class InPlaceKernel : public FECKernel
+{
+public:
+    InPlaceKernel(const char *name, int n, int k) : FECKernel(name, n, n, k) {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, m_dataSize, random);
+        m_code.encode(data, codeword);
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        bool correctable = m_code.decode(codeword);
+        memcpy(data, codeword, m_dataSize);
+        return correctable;
+    }
+
+private:
+    Code m_code;
+};
+
+/** Codes of fec.h that decode a series of codewords to a separate data buffer */
+template<class Code>
+class BlockKernel : public FECKernel
+{
+public:
+    BlockKernel(const char *name, int n, int k) : FECKernel(name, n, n, k) {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, m_dataSize, random);
+        m_code.encode(data, codeword);
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        return m_code.decode(codeword, data, 1);
+    }
+
+private:
+    Code m_code;
+};
+
+/** AMBE Golay(23,12): data in bits 22..11 with the MSB in bit 22 */
+class GolayMBEKernel : public FECKernel
+{
+public:
+    GolayMBEKernel() : FECKernel("GolayMBE::mbe_golay2312", 23, 23, 12) {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, 12, random);
+        unsigned int reg = 0;
+
+        for (int i = 0; i < 12; i++)
+        {
+            codeword[11 + i] = data[i];
+            reg |= data[i] << (11 + i);
+        }
+
+        for (int i = 22; i >= 11; i--) // remainder by the generator polynomial x^11+x^10+x^6+x^5+x^4+x^2+1
+        {
+            if (reg & (1 << i)) {
+                reg ^= 0xc75 << (i - 11);
+            }
+        }
+
+        for (int i = 0; i < 11; i++) {
+            codeword[i] = (reg >> i) & 1;
+        }
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        DSDcc::GolayMBE::mbe_golay2312(codeword, m_out);
+        memcpy(data, &m_out[11], 12);
+
+        return true;
+    }
+
+private:
+    unsigned char m_out[23];
+};
+
+/** AMBE Hamming(15,11) variants: data in bits 14..4 */
+class HammingMBEKernel : public FECKernel
+{
+public:
+    typedef int (*Decoder)(unsigned char *in, unsigned char *out);
+
+    HammingMBEKernel(const char *name, Decoder decoder) :
+        FECKernel(name, 15, 15, 11),
+        m_decoder(decoder)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, 11, random);
+        memcpy(&codeword[4], data, 11);
+
+        for (int parity = 0; parity < 16; parity++) // search the parity bits giving a null syndrome
+        {
+            for (int i = 0; i < 4; i++) {
+                codeword[i] = (parity >> i) & 1;
+            }
+
+            if (m_decoder(codeword, m_out) == 0) {
+                break;
+            }
+        }
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        m_decoder(codeword, m_out);
+        memcpy(data, &m_out[4], 11);
+
+        return true;
+    }
+
+private:
+    Decoder m_decoder;
+    unsigned char m_out[15];
+};
+
+/** Kernels working on packed bits MSB first */
+class PackedKernel : public FECKernel
+{
+public:
+    PackedKernel(const char *name, int codewordBits, int dataSize) :
+        FECKernel(name, codewordBits, (codewordBits + 7) / 8, dataSize)
+    {}
+
+    virtual void flipBit(unsigned char *codeword, int bitIndex) { codeword[bitIndex >> 3] ^= 0x80 >> (bitIndex & 7); }
+};
+
+/** CCITT16 CRC as used by YSF over the 4 bytes of the FICH */
+class CRCKernel : public PackedKernel
+{
+public:
+    typedef unsigned long (DSDcc::CRC::*Algorithm)(unsigned char *p, unsigned long len);
+
+    CRCKernel(const char *name, Algorithm algorithm) :
+        PackedKernel(name, 48, 1),
+        m_crc(DSDcc::CRC::PolyCCITT16, 16, 0x0, 0xffff),
+        m_algorithm(algorithm)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBytes(codeword, 4, random);
+        unsigned long crc = m_crc.crctablefast(codeword, 4);
+        codeword[4] = (crc >> 8) & 0xff;
+        codeword[5] = crc & 0xff;
+        data[0] = 1;
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        data[0] = (m_crc.*m_algorithm)(codeword, 4) == (unsigned long) ((codeword[4] << 8) + codeword[5]) ? 1 : 0;
+        return true;
+    }
+
+private:
+    DSDcc::CRC m_crc;
+    Algorithm m_algorithm;
+};
+
+/** D-Star radio header CRC: 39 bytes and the CRC LSB first */
+class DStarCRCKernel : public PackedKernel
+{
+public:
+    DStarCRCKernel() :
+        PackedKernel("DStarCRC::check_crc", 41*8, 1),
+        m_crcX25(DSDcc::CRC::PolyCCITT16, 16, 0xffff, 0xffff, 1, 1, 1)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBytes(codeword, 39, random);
+        unsigned long crc = m_crcX25.crctablefast(codeword, 39);
+        codeword[39] = crc & 0xff;
+        codeword[40] = (crc >> 8) & 0xff;
+        data[0] = 1;
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        data[0] = m_crcDStar.check_crc(codeword, 41) ? 1 : 0;
+        return true;
+    }
+
+private:
+    DSDcc::CRC m_crcX25; //!< same CRC computed by the generic implementation
+    DSDcc::DStarCRC m_crcDStar;
+};
+
+/** NXDN CRCs appended to a message of the size found in the NXDN channels */
+class NXDNCRCKernel : public PackedKernel
+{
+public:
+    typedef bool (*Check)(const unsigned char* in, unsigned int length);
+    typedef void (*Encode)(unsigned char* in, unsigned int length);
+
+    NXDNCRCKernel(const char *name, int length, int crcBits, Check check, Encode encode) :
+        PackedKernel(name, length + crcBits, 1),
+        m_length(length),
+        m_check(check),
+        m_encode(encode)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBytes(codeword, m_codewordSize, random);
+        m_encode(codeword, m_length);
+        data[0] = 1;
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        data[0] = m_check(codeword, m_length) ? 1 : 0;
+        return true;
+    }
+
+private:
+    unsigned int m_length;
+    Check m_check;
+    Encode m_encode;
+};
+
+/** D-Star radio header convolutional code: 330 bits (328 data bits and 2 tail bits) to 660 bits */
+class DStarViterbiKernel : public FECKernel
+{
+public:
+    DStarViterbiKernel(const char *name, bool descramble) :
+        FECKernel(name, 660, 660, 330),
+        m_viterbi(2, DSDcc::Viterbi::Poly23a, false),
+        m_descramble(descramble)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, 328, random);
+        data[328] = 0;
+        data[329] = 0;
+        m_viterbi.encodeToBits(codeword, data, 330, 0);
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        if (m_descramble) {
+            DSDcc::Descramble::FECdecoder(codeword, data);
+        } else {
+            m_viterbi.decodeFromBits(data, codeword, 660, 0);
+        }
+
+        return true;
+    }
+
+private:
+    DSDcc::Viterbi3 m_viterbi;
+    bool m_descramble; //!< use the legacy decoder of Descramble instead
+};
+
+/** YSF FICH convolutional code: 100 bits (96 data bits and 4 tail bits) to 100 2 bit symbols */
+class YSFViterbiKernel : public FECKernel
+{
+public:
+    YSFViterbiKernel() :
+        FECKernel("Viterbi5 (YSF FICH)", 200, 100, 100),
+        m_viterbi(2, DSDcc::Viterbi::Poly25y, true)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        randomBits(data, 96, random);
+        memset(&data[96], 0, 4);
+        m_viterbi.encodeToSymbols(codeword, data, 100, 0);
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        m_viterbi.decodeFromSymbols(data, codeword, 100, 0);
+
+        return true;
+    }
+
+    virtual void flipBit(unsigned char *codeword, int bitIndex) { codeword[bitIndex >> 1] ^= 1 << (bitIndex & 1); }
+
+private:
+    DSDcc::Viterbi5 m_viterbi;
+};
+
+/**
+ * NXDN convolutional code with the FACCH1 size: 96 bits (92 data bits and 4 tail bits)
+ * followed by 4 flush bits to 200 bits. Received bits are given as 0 or 2 like in DSDNXDN
+ * and there is no puncturing.
+ */
+class NXDNConvolutionKernel : public FECKernel
+{
+public:
+    NXDNConvolutionKernel() :
+        FECKernel("CNXDNConvolution (NXDN FACCH1)", 200, 200, 12)
+    {}
+
+    virtual void encode(unsigned char *codeword, unsigned char *data, Random& random)
+    {
+        unsigned char in[13], out[25];
+        randomBytes(data, 12, random);
+        data[11] &= 0xf0;
+        memcpy(in, data, 12);
+        in[12] = 0;
+        m_convolution.encode(in, out, 100);
+
+        for (int i = 0; i < 200; i++) {
+            codeword[i] = ((out[i >> 3] >> (7 - (i & 7))) & 1) << 1;
+        }
+    }
+
+    virtual bool decode(unsigned char *codeword, unsigned char *data)
+    {
+        m_convolution.start();
+
+        for (int i = 0; i < 100; i++) {
+            m_convolution.decode(codeword[2*i], codeword[2*i + 1]);
+        }
+
+        m_convolution.chainback(data, 96);
+
+        return true;
+    }
+
+    virtual void flipBit(unsigned char *codeword, int bitIndex) { codeword[bitIndex] ^= 2; }
+
+private:
+    DSDcc::CNXDNConvolution m_convolution;
+};
+
+/** Decoding speed and success with a given number of bit errors per codeword */
+struct FECResult
+{
+    FECResult() : m_codewordsPerSecond(0.0), m_okRatio(0.0) {}
+    double m_codewordsPerSecond;
+    double m_okRatio; //!< ratio of codewords decoded without failure to the transmitted data
+};
+
+static FECResult runKernel(FECKernel& kernel, int nbErrors, int poolSize, uint64_t minTimeUs, Random& random)
+{
+    FECResult result;
+    std::vector<unsigned char> data(poolSize * kernel.m_dataSize);
+    std::vector<unsigned char> received(poolSize * kernel.m_codewordSize);
+    std::vector<unsigned char> work(poolSize * kernel.m_codewordSize);
+    std::vector<unsigned char> decoded(poolSize * kernel.m_dataSize);
+    std::vector<int> positions(kernel.m_codewordBits);
+
+    for (int ic = 0; ic < poolSize; ic++)
+    {
+        unsigned char *codeword = &received[ic * kernel.m_codewordSize];
+        kernel.encode(codeword, &data[ic * kernel.m_dataSize], random);
+
+        for (int i = 0; i < kernel.m_codewordBits; i++) {
+            positions[i] = i;
+        }
+
+        for (int i = 0; (i < nbErrors) && (i < kernel.m_codewordBits); i++) // distinct random positions
+        {
+            int j = i + random() % (kernel.m_codewordBits - i);
+            std::swap(positions[i], positions[j]);
+            kernel.flipBit(codeword, positions[i]);
+        }
+    }
+
+    // check pass
+    work = received;
+    int nbOK = 0;
+
+    for (int ic = 0; ic < poolSize; ic++)
+    {
+        if (kernel.decode(&work[ic * kernel.m_codewordSize], &decoded[ic * kernel.m_dataSize])
+            && (memcmp(&decoded[ic * kernel.m_dataSize], &data[ic * kernel.m_dataSize], kernel.m_dataSize) == 0)) {
+            nbOK++;
+        }
+    }
+
+    result.m_okRatio = (double) nbOK / poolSize;
+
+    // timed passes on fresh copies of the received codewords as some decoders work in place
+    uint64_t totalUs = 0;
+    uint64_t nbCodewords = 0;
+
+    while ((totalUs < minTimeUs) || (nbCodewords == 0))
+    {
+        work = received;
+        uint64_t startUs = DSDcc::TimeUtil::threadCpuUs();
+
+        for (int ic = 0; ic < poolSize; ic++) {
+            kernel.decode(&work[ic * kernel.m_codewordSize], &decoded[ic * kernel.m_dataSize]);
+        }
+
+        totalUs += DSDcc::TimeUtil::threadCpuUs() - startUs;
+        nbCodewords += poolSize;
+    }
+
+    result.m_codewordsPerSecond = totalUs == 0 ? 0.0 : (nbCodewords * 1e6) / totalUs;
+    return result;
+}
+
+static void createKernels(std::vector<FECKernel*>& kernels)
+{
+    kernels.push_back(new InPlaceKernel<DSDcc::Hamming_7_4>("Hamming_7_4", 7, 4));
+    kernels.push_back(new BlockKernel<DSDcc::Hamming_12_8>("Hamming_12_8", 12, 8));
+    kernels.push_back(new BlockKernel<DSDcc::Hamming_15_11>("Hamming_15_11", 15, 11));
+    kernels.push_back(new BlockKernel<DSDcc::Hamming_16_11_4>("Hamming_16_11_4", 16, 11));
+    kernels.push_back(new InPlaceKernel<DSDcc::Golay_20_8>("Golay_20_8", 20, 8));
+    kernels.push_back(new InPlaceKernel<DSDcc::Golay_23_12>("Golay_23_12", 23, 12));
+    kernels.push_back(new InPlaceKernel<DSDcc::Golay_24_12>("Golay_24_12", 24, 12));
+    kernels.push_back(new InPlaceKernel<DSDcc::QR_16_7_6>("QR_16_7_6", 16, 7));
+    kernels.push_back(new GolayMBEKernel());
+    kernels.push_back(new HammingMBEKernel("HammingMBE::mbe_hamming1511", DSDcc::HammingMBE::mbe_hamming1511));
+    kernels.push_back(new HammingMBEKernel("HammingMBE::mbe_7100x4400hamming1511", DSDcc::HammingMBE::mbe_7100x4400hamming1511));
+    kernels.push_back(new CRCKernel("CRC::crctablefast (YSF)", &DSDcc::CRC::crctablefast));
+    kernels.push_back(new CRCKernel("CRC::crcbitbybitfast (YSF)", &DSDcc::CRC::crcbitbybitfast));
+    kernels.push_back(new DStarCRCKernel());
+    kernels.push_back(new NXDNCRCKernel("CNXDNCRC::checkCRC6", 26, 6, DSDcc::CNXDNCRC::checkCRC6, DSDcc::CNXDNCRC::encodeCRC6));
+    kernels.push_back(new NXDNCRCKernel("CNXDNCRC::checkCRC12", 80, 12, DSDcc::CNXDNCRC::checkCRC12, DSDcc::CNXDNCRC::encodeCRC12));
+    kernels.push_back(new NXDNCRCKernel("CNXDNCRC::checkCRC15", 184, 15, DSDcc::CNXDNCRC::checkCRC15, DSDcc::CNXDNCRC::encodeCRC15));
+    kernels.push_back(new NXDNCRCKernel("CNXDNCRC::checkCRC16", 155, 16, DSDcc::CNXDNCRC::checkCRC16, DSDcc::CNXDNCRC::encodeCRC16));
+    kernels.push_back(new DStarViterbiKernel("Viterbi3 (D-Star header)", false));
+    kernels.push_back(new DStarViterbiKernel("Descramble::FECdecoder (D-Star header)", true));
+    kernels.push_back(new YSFViterbiKernel());
+    kernels.push_back(new NXDNConvolutionKernel());
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc_fecbench [options]\n");
+    fprintf(stderr, "Times the FEC, CRC and Viterbi decoders on random codewords with 0 to n bit errors\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -f <text>     Only kernels which name contains this text\n");
+    fprintf(stderr, "  -e <num>      Maximum number of bit errors per codeword (default 4)\n");
+    fprintf(stderr, "  -n <num>      Number of different codewords for each error count (default 1024)\n");
+    fprintf(stderr, "  -t <ms>       Minimum CPU time of each measurement in milliseconds (default 100)\n");
+    fprintf(stderr, "  -s <seed>     Random generator seed (default 1)\n");
+    fprintf(stderr, "  -j <file>     Write the results as JSON to this file (- for stdout)\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Errors are spread over all the bits of the codeword. \"ok\" is the percentage of codewords decoded\n");
+    fprintf(stderr, "without reported failure to the transmitted data. For CRC kernels it is the percentage of codewords\n");
+    fprintf(stderr, "passing the check thus of undetected errors.\n");
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    std::string filter;
+    std::string jsonFileName;
+    int maxErrors = 4;
+    int poolSize = 1024;
+    int minTimeMs = 100;
+    unsigned int seed = 1;
+
+    while ((c = getopt(argc, argv, "hf:e:n:t:s:j:")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'e':
+            maxErrors = atoi(optarg);
+            maxErrors = maxErrors < 0 ? 0 : maxErrors;
+            break;
+        case 'n':
+            poolSize = atoi(optarg);
+            poolSize = poolSize < 1 ? 1 : poolSize;
+            break;
+        case 't':
+            minTimeMs = atoi(optarg);
+            minTimeMs = minTimeMs < 0 ? 0 : minTimeMs;
+            break;
+        case 's':
+            seed = strtoul(optarg, 0, 10);
+            break;
+        case 'j':
+            jsonFileName = optarg;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    FILE *json = 0;
+
+    if (jsonFileName.size() > 0)
+    {
+        json = (jsonFileName == "-") ? stdout : fopen(jsonFileName.c_str(), "w");
+
+        if (!json)
+        {
+            fprintf(stderr, "Cannot open %s for output\n", jsonFileName.c_str());
+            return 1;
+        }
+    }
+
+    FILE *text = (json == stdout) ? stderr : stdout;
+    std::vector<FECKernel*> kernels;
+    createKernels(kernels);
+
+    fprintf(text, "DSDcc %s FEC kernels: codewords per second and ok %% by number of bit errors (seed %u, %d codewords)\n",
+        DSDCC_VERSION, seed, poolSize);
+    fprintf(text, "%-40s %4s", "kernel", "bits");
+
+    for (int e = 0; e <= maxErrors; e++) {
+        fprintf(text, " %11d err    ok", e);
+    }
+
+    fprintf(text, "\n");
+
+    if (json) {
+        fprintf(json, "{\n  \"version\": \"%s\",\n  \"seed\": %u,\n  \"codewords\": %d,\n  \"kernels\": [", DSDCC_VERSION, seed, poolSize);
+    }
+
+    bool first = true;
+
+    for (std::vector<FECKernel*>::iterator it = kernels.begin(); it != kernels.end(); ++it)
+    {
+        FECKernel& kernel = **it;
+
+        if ((filter.size() > 0) && (std::string(kernel.m_name).find(filter) == std::string::npos)) {
+            continue;
+        }
+
+        fprintf(text, "%-40s %4d", kernel.m_name, kernel.m_codewordBits);
+
+        if (json)
+        {
+            fprintf(json, "%s\n    {\"kernel\": \"%s\", \"codeword_bits\": %d, \"errors\": [", first ? "" : ",", kernel.m_name, kernel.m_codewordBits);
+            first = false;
+        }
+
+        for (int e = 0; e <= maxErrors; e++)
+        {
+            Random random(seed + e); // same codewords whatever the kernels selected
+            FECResult result = runKernel(kernel, e, poolSize, minTimeMs * 1000ULL, random);
+            fprintf(text, " %15.0f %5.1f", result.m_codewordsPerSecond, result.m_okRatio * 100.0);
+            fflush(text);
+
+            if (json) {
+                fprintf(json, "%s\n      {\"bit_errors\": %d, \"codewords_per_s\": %.0f, \"ok_ratio\": %.4f}",
+                    e == 0 ? "" : ",", e, result.m_codewordsPerSecond, result.m_okRatio);
+            }
+        }
+
+        fprintf(text, "\n");
+
+        if (json) {
+            fprintf(json, "\n    ]}");
+        }
+    }
+
+    if (json)
+    {
+        fprintf(json, "\n  ]\n}\n");
+
+        if (json != stdout) {
+            fclose(json);
+        }
+    }
+
+    for (std::vector<FECKernel*>::iterator it = kernels.begin(); it != kernels.end(); ++it) {
+        delete *it;
+    }
+
+    return 0;
+}
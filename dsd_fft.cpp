@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "dsd_fft.h"
+
+namespace DSDcc
+{
+
+DSDFFT::DSDFFT(int size) :
+        m_size(0),
+        m_radix2(true)
+{
+    configure(size);
+}
+
+DSDFFT::~DSDFFT()
+{
+}
+
+void DSDFFT::configure(int size)
+{
+    m_size = size < 1 ? 1 : size;
+    m_radix2 = (m_size & (m_size - 1)) == 0;
+    m_twiddles.resize(m_size);
+
+    for (int k = 0; k < m_size; k++) {
+        m_twiddles[k] = std::polar(1.0f, (float) (-2.0 * M_PI * k / m_size));
+    }
+
+    if (m_radix2)
+    {
+        int nbBits = 0;
+
+        while ((1 << nbBits) < m_size) {
+            nbBits++;
+        }
+
+        m_bitReverse.resize(m_size);
+
+        for (int i = 0; i < m_size; i++)
+        {
+            int r = 0;
+
+            for (int b = 0; b < nbBits; b++) {
+                r |= ((i >> b) & 1) << (nbBits - 1 - b);
+            }
+
+            m_bitReverse[i] = r;
+        }
+
+        m_work.clear();
+    }
+    else
+    {
+        m_bitReverse.clear();
+        m_work.resize(m_size);
+    }
+}
+
+void DSDFFT::transform(std::complex<float> *data, bool inverse)
+{
+    if (!m_radix2)
+    {
+        for (int k = 0; k < m_size; k++)
+        {
+            std::complex<float> sum(0.0f, 0.0f);
+
+            for (int n = 0; n < m_size; n++)
+            {
+                const std::complex<float>& w = m_twiddles[((long) k * n) % m_size];
+                sum += data[n] * (inverse ? std::conj(w) : w);
+            }
+
+            m_work[k] = sum;
+        }
+
+        std::copy(m_work.begin(), m_work.end(), data);
+        return;
+    }
+
+    for (int i = 0; i < m_size; i++)
+    {
+        int j = m_bitReverse[i];
+
+        if (j > i) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (int half = 1; half < m_size; half *= 2)
+    {
+        int step = m_size / (2 * half);
+
+        for (int start = 0; start < m_size; start += 2 * half)
+        {
+            for (int k = 0; k < half; k++)
+            {
+                std::complex<float> w = inverse ? std::conj(m_twiddles[k * step]) : m_twiddles[k * step];
+                std::complex<float> t = w * data[start + k + half];
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+} // namespace DSDcc
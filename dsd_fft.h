@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_FFT_H_
+#define DSDCC_DSD_FFT_H_
+
+#include <complex>
+#include <vector>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * In place complex FFT. Radix-2 for power of two sizes else plain DFT with precomputed twiddles.
+ * Transforms are not normalized.
+ */
+class DSDCC_API DSDFFT
+{
+public:
+    explicit DSDFFT(int size = 1);
+    ~DSDFFT();
+
+    void configure(int size);
+    int getSize() const { return m_size; }
+    /** Forward transform uses exp(-j2pi.kn/N) and inverse exp(+j2pi.kn/N) */
+    void transform(std::complex<float> *data, bool inverse);
+
+private:
+    int m_size;
+    bool m_radix2;
+    std::vector<std::complex<float> > m_twiddles; //!< exp(-j2pi.k/N) for k in [0,N[
+    std::vector<int> m_bitReverse;
+    std::vector<std::complex<float> > m_work;     //!< DFT output for non radix-2 sizes
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_FFT_H_ */
@@ -17,6 +17,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "dsd_filters.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -124,6 +125,11 @@ const float DSDFilters::dpmrcoeffs[] =
         0.0058388841, -0.0000983004};
 
 DSDFilters::DSDFilters()
+{
+    reset();
+}
+
+void DSDFilters::reset()
 {
     for (int i=0; i < NZEROS+1; i++) {
         xv[i] = 0.0f;
@@ -138,6 +144,28 @@ DSDFilters::~DSDFilters()
 {
 }
 
+void DSDFilters::saveState(DSDStateBuffer& buffer) const
+{
+    for (int i=0; i < NZEROS+1; i++) {
+        buffer.writeFloat(xv[i]);
+    }
+
+    for (int i=0; i < NXZEROS+1; i++) {
+        buffer.writeFloat(nxv[i]);
+    }
+}
+
+void DSDFilters::restoreState(DSDStateBuffer& buffer)
+{
+    for (int i=0; i < NZEROS+1; i++) {
+        xv[i] = buffer.readFloat();
+    }
+
+    for (int i=0; i < NXZEROS+1; i++) {
+        nxv[i] = buffer.readFloat();
+    }
+}
+
 short DSDFilters::dmr_filter(short sample) // all 4800 baud filters for now
 {
     return dsd_input_filter(sample, 3);
@@ -203,6 +231,103 @@ short DSDFilters::dsd_input_filter(short sample, int mode)
 
 // ====================================================================
 
+DSDMatchedFilter::DSDMatchedFilter() :
+        m_nbTaps(0),
+        m_index(0),
+        m_gain(1.0f)
+{
+    setMode(3);
+}
+
+DSDMatchedFilter::~DSDMatchedFilter()
+{
+}
+
+void DSDMatchedFilter::setMode(int mode)
+{
+    const float *coeffs;
+
+    if (mode == 4)
+    {
+        coeffs = DSDFilters::dpmrcoeffs;
+        m_gain = DSDFilters::dpmrgain;
+        m_nbTaps = NXZEROS+1;
+    }
+    else
+    {
+        coeffs = DSDFilters::dmrcoeffs;
+        m_gain = DSDFilters::dmrgain;
+        m_nbTaps = NZEROS+1;
+    }
+
+    for (int i = 0; i < m_nbTaps; i++) {
+        m_coeffs[i] = coeffs[m_nbTaps - 1 - i];
+    }
+
+    reset();
+}
+
+void DSDMatchedFilter::reset()
+{
+    for (int i = 0; i < 2*(NXZEROS+1); i++) {
+        m_delay[i] = 0.0f;
+    }
+
+    m_index = 0;
+}
+
+void DSDMatchedFilter::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU16(m_nbTaps);
+    buffer.writeU16(m_index);
+
+    for (int i = 0; i < m_nbTaps; i++) {
+        buffer.writeFloat(m_delay[i]);
+    }
+}
+
+void DSDMatchedFilter::restoreState(DSDStateBuffer& buffer)
+{
+    int nbTaps = buffer.readU16();
+    int index = buffer.readU16();
+
+    if ((nbTaps != m_nbTaps) || (index >= m_nbTaps)) // different mode: start with a clear delay line
+    {
+        reset();
+        return;
+    }
+
+    m_index = index;
+
+    for (int i = 0; i < m_nbTaps; i++)
+    {
+        m_delay[i] = buffer.readFloat();
+        m_delay[i + m_nbTaps] = m_delay[i];
+    }
+}
+
+// ====================================================================
+
+void DSDFilters::designLowpass(float *taps, int nbTaps, float cutoff, float gain)
+{
+    double sum = 0.0;
+    double center = (nbTaps - 1) / 2.0;
+
+    for (int i = 0; i < nbTaps; i++)
+    {
+        double t = i - center;
+        double sinc = (t == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double x = (nbTaps > 1) ? (double) i / (nbTaps - 1) : 0.5;
+        double window = 0.42 - 0.5 * cos(2.0 * M_PI * x) + 0.08 * cos(4.0 * M_PI * x);
+        taps[i] = sinc * window;
+        sum += taps[i];
+    }
+
+    for (int i = 0; i < nbTaps; i++) {
+        taps[i] *= gain / sum;
+    }
+}
+
 DSDSecondOrderRecursiveFilter::DSDSecondOrderRecursiveFilter(float samplingFrequency, float centerFrequency, float r) :
 		m_r(r),
 		m_frequencyRatio(centerFrequency/samplingFrequency)
@@ -235,6 +360,20 @@ short DSDSecondOrderRecursiveFilter::run(short sample)
 	return (short) y;
 }
 
+void DSDSecondOrderRecursiveFilter::saveState(DSDStateBuffer& buffer) const
+{
+    for (int i = 0; i < 3; i++) {
+        buffer.writeFloat(m_v[i]);
+    }
+}
+
+void DSDSecondOrderRecursiveFilter::restoreState(DSDStateBuffer& buffer)
+{
+    for (int i = 0; i < 3; i++) {
+        m_v[i] = buffer.readFloat();
+    }
+}
+
 void DSDSecondOrderRecursiveFilter::init()
 {
 	for (int i = 0; i < 3; i++)
@@ -261,6 +400,13 @@ DSDMBEAudioInterpolatorFilter::DSDMBEAudioInterpolatorFilter() :
 DSDMBEAudioInterpolatorFilter::~DSDMBEAudioInterpolatorFilter()
 {}
 
+void DSDMBEAudioInterpolatorFilter::reset()
+{
+    m_filterLP.reset();
+    m_filterHP.reset();
+    m_useHP = false;
+}
+
 float DSDMBEAudioInterpolatorFilter::run(const float& sample)
 {
     return m_useHP ? m_filterLP.run(m_filterHP.run(sample)) : m_filterLP.run(sample);
@@ -26,12 +26,18 @@
 namespace DSDcc
 {
 
+class DSDStateBuffer;
+
 class DSDCC_API DSDFilters
 {
 public:
     DSDFilters();
     ~DSDFilters();
 
+    void reset(); //!< clears the filters memory
+    void saveState(DSDStateBuffer& buffer) const;    //!< filters memory
+    void restoreState(DSDStateBuffer& buffer);
+
     static const float ngain;
     static const float xcoeffs[];
     static const float nxgain;
@@ -45,11 +51,60 @@ public:
     short dmr_filter(short sample);
     short nxdn_filter(short sample);
 
+    /**
+     * Design a windowed sinc (Blackman) lowpass filter.
+     * cutoff is relative to the sample rate (0.5 is Nyquist). The DC gain is set to gain.
+     */
+    static void designLowpass(float *taps, int nbTaps, float cutoff, float gain);
+
 private:
     float xv[NZEROS+1];
     float nxv[NXZEROS+1];
 };
 
+/**
+ * \Brief: Matched filter using the same coefficients as DSDFilters but with a circular delay line
+ * so that samples can be pushed at the input rate while the output is only computed when needed
+ * (decimating symbol recovery). mode is 3 for 4800/9600 baud and 4 for 2400 baud like dsd_input_filter.
+ */
+class DSDCC_API DSDMatchedFilter
+{
+public:
+    DSDMatchedFilter();
+    ~DSDMatchedFilter();
+
+    void setMode(int mode);
+    void reset();
+    void saveState(DSDStateBuffer& buffer) const;    //!< delay line of the current mode
+    void restoreState(DSDStateBuffer& buffer);
+
+    void push(short sample)
+    {
+        m_index = (m_index == 0 ? m_nbTaps : m_index) - 1;
+        m_delay[m_index] = sample;
+        m_delay[m_index + m_nbTaps] = sample;
+    }
+
+    short filter() const //!< filtered value of the last pushed sample
+    {
+        const float *v = &m_delay[m_index];
+        float sum = 0.0f;
+
+        for (int i = 0; i < m_nbTaps; i++) {
+            sum += m_coeffs[i] * v[i];
+        }
+
+        return (short) (sum / m_gain);
+    }
+
+private:
+    float m_coeffs[NXZEROS+1];  //!< reversed so that the newest sample meets the last original coefficient
+    float m_delay[2*(NXZEROS+1)]; //!< doubled newest first delay line
+    int m_nbTaps;
+    int m_index;
+    float m_gain;
+};
+
 /**
  * \Brief: This is a second order bandpass filter using recursive method. r is in range ]0..1[ the higher the steeper the filter.
  * inspired by:http://www.ece.umd.edu/~tretter/commlab/c6713slides/FSKSlides.pdf
@@ -62,6 +117,9 @@ public:
 
     void setFrequencies(float samplingFrequency, float centerFrequency);
     void setR(float r);
+    void reset() { init(); } //!< clears the filter memory
+    void saveState(DSDStateBuffer& buffer) const;
+    void restoreState(DSDStateBuffer& buffer);
     short run(short sample);
 
 private:
@@ -98,6 +156,7 @@ public:
 
     void useHP(bool useHP) { m_useHP = useHP; }
     bool usesHP() const { return m_useHP; }
+    void reset(); //!< clears the filters memory and disables the high-pass filter
     float run(const float& sample);
     float runHP(const float& sample);
     float runLP(const float& sample);
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "dsd_idlegate.h"
+
+namespace DSDcc
+{
+
+DSDIdleGate::DSDIdleGate() :
+        m_enabled(false),
+        m_parked(false),
+        m_noiseRatio(0.4f),
+        m_minEnergy(100.0f * 100.0f * m_blockSize),
+        m_energy(0.0f),
+        m_diffEnergy(0.0f),
+        m_lastSample(0.0f),
+        m_blockCount(0),
+        m_idleBlocks(0),
+        m_parkedCount(0),
+        m_history(0),
+        m_historyIndex(0),
+        m_parkedBlocks(0),
+        m_totalBlocks(0)
+{
+}
+
+DSDIdleGate::~DSDIdleGate()
+{
+    delete[] m_history;
+}
+
+void DSDIdleGate::setEnabled(bool enabled)
+{
+    if (enabled && !m_history)
+    {
+        m_history = new short[m_historySize];
+        memset(m_history, 0, m_historySize * sizeof(short));
+    }
+
+    m_enabled = enabled;
+    m_parked = false;
+    m_parkedCount = 0;
+    m_idleBlocks = 0;
+}
+
+void DSDIdleGate::reset()
+{
+    m_enabled = false;
+    m_parked = false;
+    m_noiseRatio = 0.4f;
+    m_minEnergy = 100.0f * 100.0f * m_blockSize;
+    m_energy = 0.0f;
+    m_diffEnergy = 0.0f;
+    m_lastSample = 0.0f;
+    m_blockCount = 0;
+    m_idleBlocks = 0;
+    m_parkedCount = 0;
+    m_historyIndex = 0;
+    m_parkedBlocks = 0;
+    m_totalBlocks = 0;
+
+    if (m_history) {
+        memset(m_history, 0, m_historySize * sizeof(short));
+    }
+}
+
+DSDIdleGate::GateStatus DSDIdleGate::processBlock(bool canPark)
+{
+    bool idle = (m_energy < m_minEnergy) || (m_diffEnergy > m_noiseRatio * m_energy);
+    GateStatus status;
+
+    m_totalBlocks++;
+    m_blockCount = 0;
+    m_energy = 0.0f;
+    m_diffEnergy = 0.0f;
+
+    if (idle)
+    {
+        if (m_idleBlocks < m_hangBlocks) {
+            m_idleBlocks++;
+        }
+
+        if (!m_parked && canPark && (m_idleBlocks == m_hangBlocks))
+        {
+            m_parked = true;
+            m_parkedCount = 1; // this sample is skipped already
+        }
+
+        status = m_parked ? GateParked : GateActive;
+    }
+    else
+    {
+        m_idleBlocks = 0;
+        status = m_parked ? GateWake : GateActive;
+        m_parked = false;
+    }
+
+    if (m_parked) {
+        m_parkedBlocks++;
+    }
+
+    return status;
+}
+
+} // namespace DSDcc
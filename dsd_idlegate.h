@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_IDLEGATE_H_
+#define DSDCC_DSD_IDLEGATE_H_
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Block level gate detecting idle channels ahead of the symbol recovery.
+ *
+ * For each block of samples the energy E = sum(x^2) and the first difference energy
+ * D = sum((x[n]-x[n-1])^2) are computed. A digital modulation at 48 kS/s concentrates
+ * its energy below the symbol rate and gives a low D/E ratio (typically < 0.1) whereas
+ * the discriminator output of an unmodulated channel is wideband noise with D/E close
+ * to 1 or more. Silent (squelched) blocks are idle as well.
+ *
+ * The last samples are kept in a history ring so that the decoder can be fed again with
+ * the samples preceding the wake up and still catch the first sync.
+ */
+class DSDCC_API DSDIdleGate
+{
+public:
+    typedef enum
+    {
+        GateActive, //!< process the sample normally
+        GateParked, //!< skip the sample
+        GateWake    //!< replay the history (including this sample) then resume
+    } GateStatus;
+
+    DSDIdleGate();
+    ~DSDIdleGate();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+    /** Returns to the disabled state of construction keeping the history buffer if allocated */
+    void reset();
+    /** Maximum D/E ratio of an active block */
+    void setNoiseRatio(float noiseRatio) { m_noiseRatio = noiseRatio; }
+    /** Minimum RMS level of an active block */
+    void setMinLevel(float minLevel) { m_minEnergy = minLevel * minLevel * m_blockSize; }
+    bool isParked() const { return m_parked; }
+
+    /**
+     * Push a new sample.
+     * canPark tells if the decoder is in a state where it can be parked (sync search)
+     */
+    GateStatus push(short sample, bool canPark)
+    {
+        m_history[m_historyIndex] = sample;
+        m_historyIndex = (m_historyIndex + 1) % m_historySize;
+
+        float x = sample;
+        float d = x - m_lastSample;
+        m_lastSample = x;
+        m_energy += x * x;
+        m_diffEnergy += d * d;
+
+        if (m_parked && (m_parkedCount < m_historySize)) {
+            m_parkedCount++;
+        }
+
+        if (++m_blockCount == m_blockSize) {
+            return processBlock(canPark);
+        } else {
+            return m_parked ? GateParked : GateActive;
+        }
+    }
+
+    /** Number of history samples to replay on wake up and oldest first access to them */
+    int getReplaySize() const { return m_parkedCount; }
+    short getReplaySample(int i) const
+    {
+        return m_history[(m_historyIndex - m_parkedCount + i + m_historySize) % m_historySize];
+    }
+
+    unsigned long getParkedBlocks() const { return m_parkedBlocks; }
+    unsigned long getTotalBlocks() const { return m_totalBlocks; }
+
+private:
+    GateStatus processBlock(bool canPark);
+
+    static const int m_blockSize = 480;      //!< 10 ms at 48 kS/s
+    static const int m_historySize = 4*480;  //!< 40 ms of history replayed on wake up
+    static const int m_hangBlocks = 10;      //!< idle blocks before parking
+
+    bool m_enabled;
+    bool m_parked;
+    float m_noiseRatio;
+    float m_minEnergy;
+    float m_energy;
+    float m_diffEnergy;
+    float m_lastSample;
+    int m_blockCount;
+    int m_idleBlocks;
+    int m_parkedCount;   //!< number of samples skipped while parked up to history size
+    short *m_history;
+    int m_historyIndex;
+    unsigned long m_parkedBlocks;
+    unsigned long m_totalBlocks;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_IDLEGATE_H_ */
@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "dsd_iqfrontend.h"
+#include "dsd_filters.h"
+
+namespace DSDcc
+{
+
+const float DSDIQFrontEnd::m_deviationFullScale = 6250.0f;
+
+DSDIQFrontEnd::DSDIQFrontEnd() :
+        m_inputRate(0),
+        m_decimation(1),
+        m_nextOutput(0),
+        m_lastI(1.0f),
+        m_lastQ(0.0f),
+        m_discriminatorGain(0.0f)
+{
+    configure(48000);
+}
+
+DSDIQFrontEnd::~DSDIQFrontEnd()
+{
+}
+
+void DSDIQFrontEnd::configure(int inputRate, int channelBandwidth)
+{
+    m_inputRate = inputRate;
+
+    // largest integer decimation keeping at least twice the channel bandwidth
+    m_decimation = inputRate / (2 * channelBandwidth);
+    m_decimation = m_decimation < 1 ? 1 : m_decimation;
+
+    while (inputRate % m_decimation != 0) {
+        m_decimation--;
+    }
+
+    // transition band of about 1/8 of the channel bandwidth
+    int nbTaps = (44 * inputRate) / channelBandwidth;
+    nbTaps = nbTaps < 16 ? 16 : nbTaps > 2048 ? 2048 : nbTaps;
+    m_taps.resize(nbTaps);
+    DSDFilters::designLowpass(m_taps.data(), nbTaps, (0.5f * channelBandwidth) / inputRate, 1.0f);
+
+    m_i.assign(nbTaps - 1, 0.0f);
+    m_q.assign(nbTaps - 1, 0.0f);
+    m_nextOutput = 0;
+    m_lastI = 1.0f;
+    m_lastQ = 0.0f;
+
+    int discriminatorRate = inputRate / m_decimation;
+    m_discriminatorGain = 32767.0f * discriminatorRate / (2.0f * M_PI * m_deviationFullScale);
+    m_resampler.configure(discriminatorRate, m_outputRate);
+}
+
+void DSDIQFrontEnd::process(const short *iq, int nbSamples, std::vector<short>& out)
+{
+    const float scale = 1.0f / 32768.0f;
+    int start = m_i.size();
+    m_i.resize(start + nbSamples);
+    m_q.resize(start + nbSamples);
+    float *pi = &m_i[start];
+    float *pq = &m_q[start];
+
+    for (int n = 0; n < nbSamples; n++)
+    {
+        pi[n] = iq[2*n] * scale;
+        pq[n] = iq[2*n+1] * scale;
+    }
+
+    processBlock(nbSamples, out);
+}
+
+void DSDIQFrontEnd::process(const float *iq, int nbSamples, std::vector<short>& out)
+{
+    int start = m_i.size();
+    m_i.resize(start + nbSamples);
+    m_q.resize(start + nbSamples);
+    float *pi = &m_i[start];
+    float *pq = &m_q[start];
+
+    for (int n = 0; n < nbSamples; n++)
+    {
+        pi[n] = iq[2*n];
+        pq[n] = iq[2*n+1];
+    }
+
+    processBlock(nbSamples, out);
+}
+
+void DSDIQFrontEnd::processBlock(int nbSamples __attribute__((unused)), std::vector<short>& out)
+{
+    int nbTaps = m_taps.size();
+    int total = m_i.size();
+    int nbFiltered = 0;
+
+    // channel filter evaluated at the decimated rate only
+    if (m_nextOutput + nbTaps <= total) {
+        nbFiltered = (total - nbTaps - m_nextOutput) / m_decimation + 1;
+    }
+
+    m_filteredI.resize(nbFiltered);
+    m_filteredQ.resize(nbFiltered);
+    const float *taps = m_taps.data();
+
+    for (int k = 0; k < nbFiltered; k++)
+    {
+        const float *wi = &m_i[m_nextOutput + k * m_decimation];
+        const float *wq = &m_q[m_nextOutput + k * m_decimation];
+        float accI = 0.0f, accQ = 0.0f;
+
+        for (int t = 0; t < nbTaps; t++)
+        {
+            accI += taps[t] * wi[t];
+            accQ += taps[t] * wq[t];
+        }
+
+        m_filteredI[k] = accI;
+        m_filteredQ[k] = accQ;
+    }
+
+    // keep the last nbTaps - 1 samples as history
+    int shift = total - (nbTaps - 1);
+    m_nextOutput += nbFiltered * m_decimation - shift;
+    m_i.erase(m_i.begin(), m_i.begin() + shift);
+    m_q.erase(m_q.begin(), m_q.begin() + shift);
+
+    // discriminator on the conjugate product of consecutive samples
+    m_phase.resize(nbFiltered);
+
+    if (nbFiltered > 0)
+    {
+        const float *fi = m_filteredI.data();
+        const float *fq = m_filteredQ.data();
+        float *phase = m_phase.data();
+
+        phase[0] = fastAtan2(fq[0] * m_lastI - fi[0] * m_lastQ, fi[0] * m_lastI + fq[0] * m_lastQ) * m_discriminatorGain;
+
+        for (int k = 1; k < nbFiltered; k++)
+        {
+            float re = fi[k] * fi[k-1] + fq[k] * fq[k-1];
+            float im = fq[k] * fi[k-1] - fi[k] * fq[k-1];
+            phase[k] = fastAtan2(im, re) * m_discriminatorGain;
+        }
+
+        m_lastI = fi[nbFiltered - 1];
+        m_lastQ = fq[nbFiltered - 1];
+    }
+
+    // resample to 48 kS/s
+    m_resampled.resize(m_resampler.getMaxOutput(nbFiltered));
+    int nbOut = m_resampler.process(m_phase.data(), nbFiltered, m_resampled.data());
+    out.resize(nbOut);
+
+    for (int k = 0; k < nbOut; k++)
+    {
+        float v = m_resampled[k];
+        out[k] = v > 32767.0f ? 32767 : v < -32768.0f ? -32768 : (short) v;
+    }
+}
+
+} // namespace DSDcc
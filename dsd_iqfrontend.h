@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_IQFRONTEND_H_
+#define DSDCC_DSD_IQFRONTEND_H_
+
+#include <vector>
+
+#include "dsd_resampler.h"
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Single channel complex baseband front end. It produces the 48 kS/s discriminator samples
+ * expected by DSDDecoder::run from cs16 or cf32 samples at any rate:
+ *   - channel lowpass filter with decimation to the discriminator rate (about twice the channel bandwidth)
+ *   - conjugate product FM discriminator with a polynomial atan2
+ *   - rational resampling to 48 kS/s
+ *
+ * Each stage works on blocks of samples with I and Q in separate arrays so that the loops
+ * are vectorized by the compiler.
+ */
+class DSDCC_API DSDIQFrontEnd
+{
+public:
+    DSDIQFrontEnd();
+    ~DSDIQFrontEnd();
+
+    /** channelBandwidth is the full bandwidth of the channel filter in Hz */
+    void configure(int inputRate, int channelBandwidth = 12500);
+    int getInputRate() const { return m_inputRate; }
+    int getDiscriminatorRate() const { return m_inputRate / m_decimation; }
+
+    /** Process nbSamples complex samples given as interleaved I/Q. The 48 kS/s samples replace the content of out */
+    void process(const short *iq, int nbSamples, std::vector<short>& out);
+    void process(const float *iq, int nbSamples, std::vector<short>& out);
+
+    /** atan2 with a 7th order polynomial. Maximum error is about 2e-4 rad (0.012 degree) */
+    static inline float fastAtan2(float y, float x)
+    {
+        float ax = x < 0.0f ? -x : x;
+        float ay = y < 0.0f ? -y : y;
+        float mx = ax > ay ? ax : ay;
+        float mn = ax > ay ? ay : ax;
+        float a = mn / (mx + 1e-30f);
+        float s = a * a;
+        float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+        r = ay > ax ? 1.57079637f - r : r;
+        r = x < 0.0f ? 3.14159274f - r : r;
+        return y < 0.0f ? -r : r;
+    }
+
+    static const int m_outputRate = 48000;
+    static const float m_deviationFullScale; //!< frequency deviation in Hz giving a full scale discriminator output
+
+private:
+    void processBlock(int nbSamples, std::vector<short>& out);
+
+    int m_inputRate;
+    int m_decimation;
+    std::vector<float> m_taps;
+    std::vector<float> m_i;          //!< filter history followed by the new samples
+    std::vector<float> m_q;
+    int m_nextOutput;                //!< index in m_i/m_q of the start of the next filter window
+    std::vector<float> m_filteredI;  //!< decimated channel samples
+    std::vector<float> m_filteredQ;
+    std::vector<float> m_phase;      //!< discriminator output
+    std::vector<float> m_resampled;
+    float m_lastI;
+    float m_lastQ;
+    float m_discriminatorGain;
+    DSDResampler m_resampler;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_IQFRONTEND_H_ */
@@ -14,20 +14,109 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
 #include "dsd_logger.h"
 
 namespace DSDcc
 {
 
-DSDLogger::DSDLogger()
+/**
+ * Background thread formatting the records of all loggers. It runs while at least one
+ * logger has a ring. The instance is never destroyed so that loggers with static storage
+ * duration can still unregister at exit.
+ */
+class DSDLogWriter
+{
+public:
+    static DSDLogWriter& instance()
+    {
+        static DSDLogWriter *writer = new DSDLogWriter();
+        return *writer;
+    }
+
+    std::mutex& getMutex() { return m_mutex; }
+
+    void add(const DSDLogger *logger) //!< called with the mutex held
+    {
+        m_loggers.push_back(logger);
+
+        if (m_loggers.size() == 1)
+        {
+            m_generation++;
+            m_thread = std::thread(&DSDLogWriter::run, this, m_generation);
+        }
+    }
+
+    void remove(const DSDLogger *logger)
+    {
+        std::thread thread;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            logger->drain();
+            m_loggers.erase(std::remove(m_loggers.begin(), m_loggers.end(), logger), m_loggers.end());
+
+            if (m_loggers.empty())
+            {
+                m_generation++; // stops the current thread
+                m_wakeUp.notify_all();
+                thread = std::move(m_thread);
+            }
+        }
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+private:
+    DSDLogWriter() : m_generation(0) {}
+
+    void run(unsigned int generation)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (generation == m_generation)
+        {
+            for (std::vector<const DSDLogger*>::const_iterator it = m_loggers.begin(); it != m_loggers.end(); ++it) {
+                (*it)->drain();
+            }
+
+            m_wakeUp.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::vector<const DSDLogger*> m_loggers;
+    std::thread m_thread;
+    unsigned int m_generation;
+};
+
+DSDLogger::DSDLogger() :
+    m_logfp(stderr),
+    m_verbosity(1),
+    m_ring(0),
+    m_writeIndex(0),
+    m_readIndex(0),
+    m_dropped(0)
 {
-    m_verbosity = 1;
-    m_logfp = stderr;
 }
 
-DSDLogger::DSDLogger(const char *filename)
+DSDLogger::DSDLogger(const char *filename) :
+    m_logfp(0),
+    m_verbosity(1),
+    m_ring(0),
+    m_writeIndex(0),
+    m_readIndex(0),
+    m_dropped(0)
 {
-    m_verbosity = 1;
     m_logfp = fopen(filename, "w");
 
     if (!m_logfp) {
@@ -37,6 +126,14 @@ DSDLogger::DSDLogger(const char *filename)
 
 DSDLogger::~DSDLogger()
 {
+    Record *ring = m_ring.load(std::memory_order_acquire);
+
+    if (ring)
+    {
+        DSDLogWriter::instance().remove(this);
+        delete[] ring;
+    }
+
     if (m_logfp != stderr) {
         fclose(m_logfp);
     }
@@ -44,6 +141,9 @@ DSDLogger::~DSDLogger()
 
 void DSDLogger::setFile(const char *filename)
 {
+    std::lock_guard<std::mutex> lock(DSDLogWriter::instance().getMutex());
+    drain(); // pending messages go to the previous file
+
     if (m_logfp != stderr) {
         fclose(m_logfp);
     }
@@ -55,4 +155,101 @@ void DSDLogger::setFile(const char *filename)
     }
 }
 
+void DSDLogger::flush() const
+{
+    if (m_ring.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(DSDLogWriter::instance().getMutex());
+        drain();
+    }
+}
+
+DSDLogger::Record *DSDLogger::allocate() const
+{
+    Record *ring = m_ring.load(std::memory_order_acquire);
+
+    if (!ring) {
+        ring = createRing();
+    }
+
+    uint64_t index = m_writeIndex.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        Record *record = &ring[index % m_ringSize];
+        uint64_t sequence = record->m_sequence.load(std::memory_order_acquire);
+
+        if (sequence == index) // free slot
+        {
+            if (m_writeIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                return record;
+            }
+        }
+        else if (sequence < index) // not yet read by the writer: full
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        else // claimed by another thread in the meantime
+        {
+            index = m_writeIndex.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void DSDLogger::commit(Record *record) const
+{
+    record->m_sequence.store(record->m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+DSDLogger::Record *DSDLogger::createRing() const
+{
+    DSDLogWriter& writer = DSDLogWriter::instance();
+    std::lock_guard<std::mutex> lock(writer.getMutex());
+    Record *ring = m_ring.load(std::memory_order_acquire);
+
+    if (!ring)
+    {
+        ring = new Record[m_ringSize];
+
+        for (unsigned int i = 0; i < m_ringSize; i++) {
+            ring[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_ring.store(ring, std::memory_order_release);
+        writer.add(this);
+    }
+
+    return ring;
+}
+
+void DSDLogger::drain() const
+{
+    Record *ring = m_ring.load(std::memory_order_acquire);
+
+    if (!ring) {
+        return;
+    }
+
+    bool written = false;
+
+    while (true)
+    {
+        Record *record = &ring[m_readIndex % m_ringSize];
+
+        if (record->m_sequence.load(std::memory_order_acquire) != m_readIndex + 1) { // not committed yet
+            break;
+        }
+
+        record->m_format(m_logfp, record->m_fmt, record->m_args);
+        record->m_sequence.store(m_readIndex + m_ringSize, std::memory_order_release);
+        m_readIndex++;
+        written = true;
+    }
+
+    if (written) {
+        fflush(m_logfp);
+    }
+}
+
 } // namespace DSDcc
@@ -18,37 +18,226 @@
 #define DSD_LOGGER_H_
 
 #include <stdio.h>
-#include <cstdarg>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
 
 #include "export.h"
 
+/** Highest level of the messages compiled in: 0 none, 1 info, 2 info and debug (CMake LOG_LEVEL) */
+#ifndef DSD_LOG_LEVEL
+#define DSD_LOG_LEVEL 2
+#endif
+
 namespace DSDcc
 {
 
+/** Binary encoding of a log argument: scalars are copied as is */
+template<typename T>
+struct DSDLogArg
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+            "log arguments must be scalars or C strings");
+    static const unsigned int minSize = sizeof(T);
+
+    static unsigned char *encode(unsigned char *p, unsigned char *, T value)
+    {
+        memcpy(p, &value, sizeof(T));
+        return p + sizeof(T);
+    }
+
+    static const unsigned char *decode(const unsigned char *p, T& value)
+    {
+        memcpy(&value, p, sizeof(T));
+        return p + sizeof(T);
+    }
+};
+
+/** C strings are copied into the record and truncated to the room left */
+template<>
+struct DSDLogArg<const char *>
+{
+    static const unsigned int minSize = 1;
+
+    static unsigned char *encode(unsigned char *p, unsigned char *end, const char *value)
+    {
+        unsigned int n = 0;
+
+        if (value)
+        {
+            unsigned int maxLength = end - p - 1;
+
+            for (; (n < maxLength) && value[n]; n++) {
+                p[n] = value[n];
+            }
+        }
+
+        p[n] = 0;
+        return p + n + 1;
+    }
+
+    static const unsigned char *decode(const unsigned char *p, const char *& value)
+    {
+        value = (const char *) p;
+        return p + strlen(value) + 1;
+    }
+};
+
+template<>
+struct DSDLogArg<char *>
+{
+    static const unsigned int minSize = 1;
+
+    static unsigned char *encode(unsigned char *p, unsigned char *end, char *value)
+    {
+        return DSDLogArg<const char *>::encode(p, end, value);
+    }
+
+    static const unsigned char *decode(const unsigned char *p, char *& value)
+    {
+        value = (char *) p;
+        return p + strlen(value) + 1;
+    }
+};
+
+/** Encoding of a list of log arguments and formatting of the record on the writer side */
+template<typename... Args>
+struct DSDLogArgs;
+
+template<>
+struct DSDLogArgs<>
+{
+    static const unsigned int minSize = 0;
+
+    static void encode(unsigned char *, unsigned char *) {}
+
+    static void format(FILE *file, const char *fmt, const unsigned char *)
+    {
+        fputs(fmt, file);
+    }
+
+    template<typename V, typename... Vs>
+    static void format(FILE *file, const char *fmt, const unsigned char *, V value, Vs... values)
+    {
+        fprintf(file, fmt, value, values...);
+    }
+};
+
+template<typename T, typename... Rest>
+struct DSDLogArgs<T, Rest...>
+{
+    static const unsigned int minSize = DSDLogArg<T>::minSize + DSDLogArgs<Rest...>::minSize;
+
+    static void encode(unsigned char *p, unsigned char *end, T value, Rest... rest)
+    {
+        p = DSDLogArg<T>::encode(p, end - DSDLogArgs<Rest...>::minSize, value); // keep room for the next arguments
+        DSDLogArgs<Rest...>::encode(p, end, rest...);
+    }
+
+    template<typename... Vs>
+    static void format(FILE *file, const char *fmt, const unsigned char *p, Vs... values)
+    {
+        T value;
+        p = DSDLogArg<T>::decode(p, value);
+        DSDLogArgs<Rest...>::format(file, fmt, p, values..., value);
+    }
+};
+
+/**
+ * Decoder messages logger.
+ *
+ * The caller does not format the message: it writes a binary record made of the format
+ * string address, the formatting function for the argument types and the arguments into
+ * a lock-free ring of the logger. Records are formatted and written to the file by a
+ * background thread shared by all loggers that is started when the first record is written
+ * and stopped when the last logger is destroyed. If the ring is full the record is dropped
+ * and counted (see getDropped). Format strings must be literals or have static storage.
+ *
+ * Messages are tagged info (log) or debug (debug). Calls above DSD_LOG_LEVEL are compiled
+ * out. At run time a message is logged only if the verbosity is at least its level: 0 logs
+ * nothing, 1 (the default of the decoder) info and 2 info and debug. The ring is allocated
+ * by the first message logged.
+ */
 class DSDCC_API DSDLogger
 {
 public:
+    typedef enum
+    {
+        LevelInfo = 1,
+        LevelDebug = 2
+    } Level;
+
     DSDLogger();
     explicit DSDLogger(const char *filename);
     ~DSDLogger();
 
     void setFile(const char *filename);
     void setVerbosity(int verbosity) { m_verbosity = verbosity; }
+    /** Waits until the records written so far are in the file */
+    void flush() const;
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    /** Size of the ring once allocated */
+    size_t getAllocatedSize() const { return m_ring.load(std::memory_order_acquire) ? m_ringSize * sizeof(Record) : 0; }
 
-    void log(const char* fmt, ...) const
+    template<typename... Args>
+    void log(const char *fmt, Args... args) const
     {
-        if (m_verbosity > 0)
+        write<LevelInfo>(fmt, args...);
+    }
+
+    template<typename... Args>
+    void debug(const char *fmt, Args... args) const
+    {
+        write<LevelDebug>(fmt, args...);
+    }
+
+    typedef void (*FormatFunction)(FILE *file, const char *fmt, const unsigned char *args);
+
+    struct Record
+    {
+        std::atomic<uint64_t> m_sequence; //!< ring slot state
+        FormatFunction m_format;
+        const char *m_fmt;
+        unsigned char m_args[128 - 8 - 2*sizeof(void*)];
+    };
+
+    static const unsigned int m_ringSize = 256; //!< records
+
+private:
+    template<int MessageLevel, typename... Args>
+    void write(const char *fmt, Args... args) const
+    {
+        static_assert(DSDLogArgs<Args...>::minSize <= sizeof(Record::m_args), "too many log arguments");
+
+        if ((MessageLevel > DSD_LOG_LEVEL) || (m_verbosity < MessageLevel)) {
+            return;
+        }
+
+        Record *record = allocate();
+
+        if (record)
         {
-            va_list argptr;
-            va_start(argptr, fmt);
-            vfprintf(m_logfp, fmt, argptr);
-            va_end(argptr);
+            record->m_format = &DSDLogArgs<Args...>::format;
+            record->m_fmt = fmt;
+            DSDLogArgs<Args...>::encode(record->m_args, record->m_args + sizeof(record->m_args), args...);
+            commit(record);
         }
     }
 
-private:
+    Record *allocate() const; //!< claims the next free slot or returns 0 if the ring is full
+    void commit(Record *record) const;
+    Record *createRing() const;
+    void drain() const; //!< formats the committed records. Called with the writer lock held
+
     FILE *m_logfp;
     int  m_verbosity;
+    mutable std::atomic<Record*> m_ring;
+    mutable std::atomic<uint64_t> m_writeIndex;
+    mutable uint64_t m_readIndex;
+    mutable std::atomic<uint64_t> m_dropped;
+
+    friend class DSDLogWriter;
 };
 
 } // namespace DSDcc
@@ -20,73 +20,906 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <math.h>
+#include <time.h>
+#include <glob.h>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "dsd_decoder.h"
 #include "dsd_upsample.h"
+#include "dsd_iqfrontend.h"
+#include "dsd_mbefile.h"
+#include "dsd_syncindex.h"
 
 #ifdef DSD_USE_SERIALDV
 #include "dvcontroller.h"
 #endif
 int exitflag;
 
-class Mixer
+typedef enum
+{
+    IQNone,   //!< real FM discriminator samples
+    IQInt16,  //!< cs16 complex baseband
+    IQFloat32 //!< cf32 complex baseband
+} IQFormat;
+
+/**
+ * Mixes the audio of both TDMA slots (-T 3) into one stream. The frames of each slot are queued
+ * and the samples present in both queues are mixed at half level. While a slot has not had a
+ * frame for 100 ms of input the other one is output alone at full level.
+ */
+class SlotMixer
 {
 public:
-    Mixer() : m_mix(0), m_mixSize(0), m_mixSizeMax(0) {}
-    ~Mixer() {
-        if (m_mix != 0) {
-            delete[] m_mix;
+    SlotMixer() { clear(); }
+
+    void clear();
+    /** Queues a frame of a slot and appends the audio that can be mixed to output */
+    void push(int slot, const short *samples, int nbSamples, uint64_t timestamp, std::vector<short>& output);
+    /** Appends all the queued audio to output at the end of the input */
+    void flush(std::vector<short>& output) { mix(std::max(m_queue[0].size(), m_queue[1].size()), output); }
+
+private:
+    static const uint64_t m_idleSamples = 4800; //!< input samples at 48 kS/s without frame after which a slot is silent
+
+    void mix(size_t nbSamples, std::vector<short>& output);
+
+    std::vector<short> m_queue[2];
+    uint64_t m_lastTimestamp[2];
+    bool m_heard[2]; //!< the slot has had a frame
+};
+
+void SlotMixer::clear()
+{
+    for (int slot = 0; slot < 2; slot++)
+    {
+        m_queue[slot].clear();
+        m_lastTimestamp[slot] = 0;
+        m_heard[slot] = false;
+    }
+}
+
+void SlotMixer::push(int slot, const short *samples, int nbSamples, uint64_t timestamp, std::vector<short>& output)
+{
+    m_queue[slot].insert(m_queue[slot].end(), samples, samples + nbSamples);
+    m_lastTimestamp[slot] = timestamp;
+    m_heard[slot] = true;
+    int other = 1 - slot;
+    bool otherActive = m_heard[other] && (timestamp < m_lastTimestamp[other] + m_idleSamples);
+
+    if (otherActive) {
+        mix(std::min(m_queue[0].size(), m_queue[1].size()), output);
+    } else {
+        mix(std::max(m_queue[0].size(), m_queue[1].size()), output);
+    }
+}
+
+void SlotMixer::mix(size_t nbSamples, std::vector<short>& output)
+{
+    for (size_t i = 0; i < nbSamples; i++)
+    {
+        if ((i < m_queue[0].size()) && (i < m_queue[1].size())) {
+            output.push_back((m_queue[0][i] / 2) + (m_queue[1][i] / 2));
+        } else {
+            output.push_back(i < m_queue[0].size() ? m_queue[0][i] : m_queue[1][i]);
         }
     }
-    void mix(unsigned int size1, unsigned int size2, short *channel1, short *channel2);
-    short *getMix(int &mixSize) { mixSize = m_mixSize; return m_mix; }
+
+    for (int slot = 0; slot < 2; slot++) {
+        m_queue[slot].erase(m_queue[slot].begin(), m_queue[slot].begin() + std::min(nbSamples, m_queue[slot].size()));
+    }
+}
+
+/** Writes the decoded audio frames of the selected slots to the output file. Both slots are mixed */
+class AudioWriter : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    AudioWriter() : m_fd(-1), m_slots(1), m_mbeFile(0) {}
+    virtual ~AudioWriter() {}
+
+    void setOutput(int fd) { m_fd = fd; }
+    void setSlots(int slots) { m_slots = slots; }
+    void setMBEFile(DSDcc::DSDMBEFile *mbeFile) { m_mbeFile = mbeFile; }
+    void flush(); //!< writes the audio still queued by the slot mixer
+
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp);
+    virtual void mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp);
 
 private:
-    short *m_mix;
-    unsigned int m_mixSize;
-    unsigned int m_mixSizeMax;
+    void writeAudio(const short *samples, int nbSamples);
+
+    int m_fd;
+    int m_slots; //!< bit mask of the slots to output
+    DSDcc::DSDMBEFile *m_mbeFile; //!< records the AMBE/IMBE frames if not 0
+    SlotMixer m_mixer;
+    std::vector<short> m_mix;
 };
 
-void Mixer::mix(unsigned int size1, unsigned int size2, short *channel1, short *channel2)
+void AudioWriter::audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp)
 {
-    unsigned int m_mixSize = std::max(size1, size2);
+    if (((m_slots >> slot) & 1) == 0) {
+        return;
+    }
 
-    if (m_mixSize > m_mixSizeMax)
+    if (m_slots != 3)
     {
-        if (m_mix != 0)
-        {
-            delete[] m_mix;
-        }
+        writeAudio(samples, nbSamples);
+        return;
+    }
+
+    m_mixer.push(slot, samples, nbSamples, timestamp, m_mix);
+
+    if (!m_mix.empty())
+    {
+        writeAudio(m_mix.data(), m_mix.size());
+        m_mix.clear();
+    }
+}
+
+void AudioWriter::flush()
+{
+    m_mixer.flush(m_mix);
+
+    if (!m_mix.empty())
+    {
+        writeAudio(m_mix.data(), m_mix.size());
+        m_mix.clear();
+    }
+}
+
+void AudioWriter::writeAudio(const short *samples, int nbSamples)
+{
+    unsigned int nbBytes = sizeof(short) * nbSamples;
+    int result = write(m_fd, (const void *) samples, nbBytes);
+
+    if (result < 0)
+    {
+        fprintf(stderr, "Error writing to output\n");
+    }
+    else if ((unsigned int) result != nbBytes)
+    {
+        fprintf(stderr, "Written %d out of %d audio samples\n", result/2, nbBytes/2);
+    }
+}
 
-        m_mix = new short[m_mixSizeMax];
-        m_mixSizeMax = m_mixSize;
+void AudioWriter::mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp)
+{
+    if (m_mbeFile && ((m_slots >> slot) & 1)) {
+        m_mbeFile->write(slot, frame, nbBytes, (int) mbeRate, timestamp);
     }
+}
+
+typedef std::pair<int, std::string> DecoderOption; //!< option letter and argument of a decoder option (see configureDecoder)
+
+/** Audio and AMBE/IMBE frames decoded from a part of the recording kept until the previous parts are written */
+class PartOutput : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    PartOutput() : m_start(0), m_end(0), m_warmup(0), m_done(false) {}
+    virtual ~PartOutput() {}
 
-    for (unsigned int i = 0; i < m_mixSize; i++)
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp);
+    virtual void mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp);
+    /** Passes the frames to the sink in decoding order */
+    void replay(DSDcc::DSDDecoder::AudioSink& sink) const;
+    void clear();
+
+    uint64_t m_start;  //!< first sample of the part
+    uint64_t m_end;    //!< sample following the part
+    uint64_t m_warmup; //!< samples before the part decoded to settle the decoder. Their frames are dropped
+    bool m_done;       //!< set by the worker with the lock held
+    DSDcc::DSDStats m_stats;
+
+private:
+    struct Frame
     {
-        if (i < size1) {
-            m_mix[i] = channel1[i];
+        bool m_mbe;             //!< AMBE/IMBE frame else audio
+        int m_slot;
+        int m_mbeRate;
+        uint64_t m_timestamp;
+        unsigned int m_offset;  //!< in m_audio or m_mbe
+        int m_size;
+    };
+
+    std::vector<Frame> m_frames;
+    std::vector<short> m_audio;
+    std::vector<unsigned char> m_mbe;
+};
+
+void PartOutput::audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp)
+{
+    if (timestamp <= m_start) { // sample n of the recording is at timestamp n+1
+        return;
+    }
+
+    Frame frame = {false, slot, 0, timestamp, (unsigned int) m_audio.size(), nbSamples};
+    m_frames.push_back(frame);
+    m_audio.insert(m_audio.end(), samples, samples + nbSamples);
+}
+
+void PartOutput::mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp)
+{
+    if (timestamp <= m_start) {
+        return;
+    }
+
+    Frame mbeFrame = {true, slot, (int) mbeRate, timestamp, (unsigned int) m_mbe.size(), nbBytes};
+    m_frames.push_back(mbeFrame);
+    m_mbe.insert(m_mbe.end(), frame, frame + nbBytes);
+}
+
+void PartOutput::replay(DSDcc::DSDDecoder::AudioSink& sink) const
+{
+    for (std::vector<Frame>::const_iterator it = m_frames.begin(); it != m_frames.end(); ++it)
+    {
+        if (it->m_mbe) {
+            sink.mbeFrame(it->m_slot, &m_mbe[it->m_offset], it->m_size, (DSDcc::DSDDecoder::DSDMBERate) it->m_mbeRate, it->m_timestamp);
         } else {
-            m_mix[i] = 0;
+            sink.audioFrame(it->m_slot, &m_audio[it->m_offset], it->m_size, it->m_timestamp);
         }
+    }
+}
 
-        if (i < size2) {
-            m_mix[i] = (m_mix[i]/2) + (channel2[i]/2);
-        } else {
-            m_mix[i] /= 2;
+void PartOutput::clear()
+{
+    std::vector<Frame>().swap(m_frames);
+    std::vector<short>().swap(m_audio);
+    std::vector<unsigned char>().swap(m_mbe);
+}
+
+/**
+ * Parallel decoding of a recording split at the gaps between transmissions (-j).
+ * Each part is decoded by a fresh decoder configured with the same options.
+ */
+struct ParallelDecode
+{
+    static const uint64_t m_warmup = 12000; //!< 0.25s decoded before each part
+    static const uint64_t m_minGap = 2 * m_warmup; //!< the warm-up is in the silence before the part
+    static const uint64_t m_minPartSize = 48000 * 30; //!< parts do not depend on the number of threads
+
+    ParallelDecode() : m_samples(0), m_nextPart(0), m_lat(0.0f), m_lon(0.0f), m_mbeDV(false), m_mbelib(true) {}
+    void work(); //!< worker thread
+
+    const short *m_samples;
+    std::vector<PartOutput> m_parts;
+    std::atomic<unsigned int> m_nextPart;
+    std::vector<DecoderOption> m_options;
+    float m_lat;
+    float m_lon;
+    bool m_mbeDV;
+    bool m_mbelib;
+    std::mutex m_mutex;
+    std::condition_variable m_partDone;
+    DSDcc::DSDStats m_stats; //!< sum of the parts
+};
+
+/** Writes buffers to files on a background thread so that the decoding threads do not wait for the disk */
+class AsyncFileWriter
+{
+public:
+    AsyncFileWriter() : m_pendingBytes(0), m_stop(false) {}
+    ~AsyncFileWriter() { stop(); }
+
+    void start();
+    void stop(); //!< writes the pending buffers and stops the thread
+    /** Queues the data for a file. data is swapped with an empty buffer. Blocks while too much data is pending */
+    void write(int fd, std::vector<char>& data);
+    void close(int fd); //!< closes the file after its pending writes
+    /**
+     * Queues the data for the file at path that the writer thread creates or appends to so that
+     * opening the file does not wait for the disk either. If too much data is pending waits when
+     * wait is true else drops the data and returns false.
+     */
+    bool writeFile(const std::string& path, std::vector<char>& data, bool append, bool wait);
+
+private:
+    struct Job
+    {
+        int m_fd;
+        std::string m_path; //!< file opened by the writer thread if not empty
+        std::vector<char> m_data;
+        bool m_close;
+        bool m_append;
+    };
+
+    bool push(Job& job, bool wait);
+    void run();
+    void writeJob(int fd, const std::vector<char>& data);
+
+    static const size_t m_maxPendingBytes = 64 << 20;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_spaceAvailable;
+    std::deque<Job> m_jobs;
+    size_t m_pendingBytes;
+    bool m_stop;
+};
+
+void AsyncFileWriter::start()
+{
+    m_stop = false;
+    m_thread = std::thread(&AsyncFileWriter::run, this);
+}
+
+void AsyncFileWriter::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_jobAvailable.notify_one();
+    m_thread.join();
+}
+
+void AsyncFileWriter::write(int fd, std::vector<char>& data)
+{
+    Job job;
+    job.m_fd = fd;
+    job.m_data.swap(data);
+    job.m_close = false;
+    job.m_append = false;
+    push(job, true);
+}
+
+void AsyncFileWriter::close(int fd)
+{
+    Job job;
+    job.m_fd = fd;
+    job.m_close = true;
+    job.m_append = false;
+    push(job, true);
+}
+
+bool AsyncFileWriter::writeFile(const std::string& path, std::vector<char>& data, bool append, bool wait)
+{
+    Job job;
+    job.m_fd = -1;
+    job.m_path = path;
+    job.m_data.swap(data);
+    job.m_close = true;
+    job.m_append = append;
+    return push(job, wait);
+}
+
+bool AsyncFileWriter::push(Job& job, bool wait)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (wait) {
+        m_spaceAvailable.wait(lock, [this]() { return m_pendingBytes < m_maxPendingBytes; });
+    } else if (m_pendingBytes >= m_maxPendingBytes) {
+        return false;
+    }
+
+    m_jobs.push_back(Job());
+    m_jobs.back().m_fd = job.m_fd;
+    m_jobs.back().m_path.swap(job.m_path);
+    m_jobs.back().m_data.swap(job.m_data);
+    m_jobs.back().m_close = job.m_close;
+    m_jobs.back().m_append = job.m_append;
+    m_pendingBytes += m_jobs.back().m_data.size();
+    lock.unlock();
+    m_jobAvailable.notify_one();
+    return true;
+}
+
+void AsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_jobAvailable.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+
+        if (m_jobs.empty()) { // stopping
+            break;
+        }
+
+        Job job;
+        job.m_fd = m_jobs.front().m_fd;
+        job.m_path.swap(m_jobs.front().m_path);
+        job.m_data.swap(m_jobs.front().m_data);
+        job.m_close = m_jobs.front().m_close;
+        job.m_append = m_jobs.front().m_append;
+        m_jobs.pop_front();
+        lock.unlock();
+
+        if (!job.m_path.empty())
+        {
+            job.m_fd = open(job.m_path.c_str(), O_WRONLY | O_CREAT | (job.m_append ? O_APPEND : O_TRUNC), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+
+            if (job.m_fd < 0) {
+                fprintf(stderr, "Cannot open %s for output\n", job.m_path.c_str());
+            }
+        }
+
+        if (job.m_fd >= 0)
+        {
+            writeJob(job.m_fd, job.m_data);
+
+            if (job.m_close) {
+                ::close(job.m_fd);
+            }
         }
+
+        lock.lock();
+        m_pendingBytes -= job.m_data.size();
+        m_spaceAvailable.notify_all();
+    }
+}
+
+void AsyncFileWriter::writeJob(int fd, const std::vector<char>& data)
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        ssize_t result = ::write(fd, &data[written], data.size() - written);
+
+        if (result <= 0)
+        {
+            fprintf(stderr, "Error writing to output\n");
+            break;
+        }
+
+        written += result;
+    }
+}
+
+/** Buffers the audio of the selected slots of the file decoded by a batch worker */
+class BatchOutput : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    explicit BatchOutput(AsyncFileWriter& writer) : m_writer(writer), m_fd(-1), m_slots(1) {}
+    virtual ~BatchOutput() {}
+
+    void open(int fd, int slots);
+    void close(); //!< queues the remaining audio then the closing of the file
+
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp);
+
+private:
+    static const size_t m_bufferSize = 1 << 18; //!< bytes queued at once to the writer
+
+    void append(const short *samples, int nbSamples);
+
+    AsyncFileWriter& m_writer;
+    int m_fd;
+    int m_slots; //!< bit mask of the slots to output
+    std::vector<char> m_buffer;
+    SlotMixer m_mixer; //!< with both slots
+    std::vector<short> m_mix;
+};
+
+void BatchOutput::open(int fd, int slots)
+{
+    m_fd = fd;
+    m_slots = slots;
+    m_buffer.reserve(m_bufferSize);
+    m_mixer.clear();
+}
+
+void BatchOutput::close()
+{
+    if (m_fd < 0) {
+        return;
+    }
+
+    m_mixer.flush(m_mix);
+    append(m_mix.data(), m_mix.size());
+    m_mix.clear();
+    m_writer.write(m_fd, m_buffer);
+    m_writer.close(m_fd);
+    m_fd = -1;
+}
+
+void BatchOutput::audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp)
+{
+    if ((m_fd < 0) || (((m_slots >> slot) & 1) == 0)) {
+        return;
+    }
+
+    if (m_slots != 3)
+    {
+        append(samples, nbSamples);
+        return;
+    }
+
+    m_mixer.push(slot, samples, nbSamples, timestamp, m_mix);
+    append(m_mix.data(), m_mix.size());
+    m_mix.clear();
+}
+
+void BatchOutput::append(const short *samples, int nbSamples)
+{
+    const char *bytes = (const char *) samples;
+    m_buffer.insert(m_buffer.end(), bytes, bytes + nbSamples * sizeof(short));
+
+    if (m_buffer.size() >= m_bufferSize)
+    {
+        m_writer.write(m_fd, m_buffer);
+        m_buffer.reserve(m_bufferSize);
+    }
+}
+
+/**
+ * Writes each call to its own files in a directory (-W) besides the output of the decoder:
+ * <dir>/<date>-<time>_<number>_<protocol>_s<slot>.raw audio like -o and a .txt metadata file written at the
+ * end of the call. Files are opened and written by the writer thread so the decoding does not
+ * wait for the disk. With a live input audio is dropped rather than waited for if the disk
+ * does not keep up.
+ */
+class CallRecorder : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    CallRecorder(AsyncFileWriter& writer, DSDcc::DSDDecoder::AudioSink& output) :
+        m_writer(writer), m_output(output), m_slots(1), m_audioRate(8000), m_live(false), m_nbCalls(0), m_droppedBytes(0)
+    {}
+    virtual ~CallRecorder() {}
+
+    void open(const std::string& dir, int slots, int audioRate, bool live);
+    unsigned int getCallCount() const { return m_nbCalls; }
+    uint64_t getDroppedBytes() const { return m_droppedBytes; }
+
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp);
+    virtual void mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp);
+    virtual void callStart(const DSDcc::DSDDecoder::CallInfo& call);
+    virtual void callEnd(const DSDcc::DSDDecoder::CallInfo& call);
+
+private:
+    struct Call
+    {
+        Call() : m_open(false), m_bytes(0), m_startTime(0) {}
+        bool m_open;
+        std::string m_path;          //!< without extension
+        std::vector<char> m_buffer;
+        uint64_t m_bytes;            //!< audio bytes of the call
+        time_t m_startTime;
+    };
+
+    void write(const std::string& path, std::vector<char>& data, bool append);
+
+    static const size_t m_bufferSize = 1 << 18; //!< bytes queued at once to the writer
+
+    AsyncFileWriter& m_writer;
+    DSDcc::DSDDecoder::AudioSink& m_output; //!< continuous output (-o)
+    std::string m_dir;
+    int m_slots;                 //!< bit mask of the slots to record
+    int m_audioRate;
+    bool m_live;
+    Call m_calls[2];
+    unsigned int m_nbCalls;
+    uint64_t m_droppedBytes;
+};
+
+void CallRecorder::open(const std::string& dir, int slots, int audioRate, bool live)
+{
+    m_dir = dir;
+    m_slots = slots;
+    m_audioRate = audioRate;
+    m_live = live;
+}
+
+void CallRecorder::write(const std::string& path, std::vector<char>& data, bool append)
+{
+    size_t size = data.size();
+
+    if (!m_writer.writeFile(path, data, append, !m_live)) {
+        m_droppedBytes += size;
+    }
+}
+
+void CallRecorder::audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp)
+{
+    m_output.audioFrame(slot, samples, nbSamples, timestamp);
+    Call& call = m_calls[slot];
+
+    if (!call.m_open) {
+        return;
+    }
+
+    const char *bytes = (const char *) samples;
+    call.m_buffer.insert(call.m_buffer.end(), bytes, bytes + nbSamples * sizeof(short));
+    call.m_bytes += nbSamples * sizeof(short);
+
+    if (call.m_buffer.size() >= m_bufferSize)
+    {
+        write(call.m_path + ".raw", call.m_buffer, true);
+        call.m_buffer.reserve(m_bufferSize);
     }
 }
 
+void CallRecorder::mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp)
+{
+    m_output.mbeFrame(slot, frame, nbBytes, mbeRate, timestamp);
+}
+
+void CallRecorder::callStart(const DSDcc::DSDDecoder::CallInfo& info)
+{
+    if (((m_slots >> info.m_slot) & 1) == 0) {
+        return;
+    }
+
+    Call& call = m_calls[info.m_slot];
+    call.m_startTime = time(0);
+    char startTime[32];
+    strftime(startTime, sizeof(startTime), "%Y%m%d-%H%M%S", localtime(&call.m_startTime));
+    char name[96];
+    snprintf(name, sizeof(name), "/%s_%06u_%s_s%d", startTime, ++m_nbCalls, DSDcc::DSDStatus::getProtocolName(info.m_protocol), info.m_slot + 1);
+    call.m_open = true;
+    call.m_path = m_dir + name;
+    call.m_bytes = 0;
+    write(call.m_path + ".raw", call.m_buffer, false); // created even if there is no audio (see -A)
+    call.m_buffer.reserve(m_bufferSize);
+}
+
+void CallRecorder::callEnd(const DSDcc::DSDDecoder::CallInfo& info)
+{
+    static const char *callEnds[] = {"none", "terminator", "timeout", "new call", "end of input"};
+    Call& call = m_calls[info.m_slot];
+
+    if (!call.m_open) {
+        return;
+    }
+
+    write(call.m_path + ".raw", call.m_buffer, true);
+    call.m_open = false;
+
+    char startTime[32];
+    strftime(startTime, sizeof(startTime), "%Y-%m-%d %H:%M:%S", localtime(&call.m_startTime));
+    char text[1024];
+    int size = snprintf(text, sizeof(text),
+            "protocol: %s\n"
+            "slot: %d\n"
+            "start: %.3f s\n"
+            "duration: %.3f s\n"
+            "decoded at: %s\n"
+            "started by: %s\n"
+            "ended by: %s\n"
+            "voice frames: %u\n"
+            "source id: %u\n"
+            "destination id: %u%s\n"
+            "color code: %d\n"
+            "source: %s\n"
+            "destination: %s\n"
+            "audio: %llu samples at %d S/s\n",
+            DSDcc::DSDStatus::getProtocolName(info.m_protocol),
+            info.m_slot + 1,
+            info.m_start / 48000.0,
+            (info.m_end - info.m_start) / 48000.0,
+            startTime,
+            info.m_header ? "header" : "voice (late entry)",
+            callEnds[info.m_callEnd],
+            info.m_nbVoiceFrames,
+            info.m_sourceId,
+            info.m_destinationId, info.m_group ? " (group)" : "",
+            info.m_colorCode,
+            info.m_source,
+            info.m_destination,
+            (unsigned long long) (call.m_bytes / sizeof(short)), m_audioRate);
+    std::vector<char> data(text, text + std::min(size, (int) sizeof(text) - 1));
+    write(call.m_path + ".txt", data, false);
+}
+
+/**
+ * Decoding of several files to an output directory (dsdccx [options] -O <dir> files...).
+ * Each worker thread keeps its decoder and resets it between files.
+ */
+struct BatchDecode
+{
+    BatchDecode() :
+        m_nextFile(0),
+        m_slots(1),
+        m_inputRate(48000),
+        m_lat(0.0f),
+        m_lon(0.0f),
+        m_printStats(false),
+        m_nbFailed(0)
+    {}
+
+    void work(); //!< worker thread
+    bool decodeFile(DSDcc::DSDDecoder& dsdDecoder, BatchOutput& output, const std::string& fileName);
+
+    std::vector<std::string> m_files;
+    std::atomic<unsigned int> m_nextFile;
+    std::string m_outputDir;
+    std::vector<DecoderOption> m_options;
+    int m_slots;
+    int m_inputRate;
+    float m_lat;
+    float m_lon;
+    bool m_printStats;    //!< writes the statistics of each file
+    AsyncFileWriter m_writer;
+    std::atomic<unsigned int> m_nbFailed;
+};
+
 static void usage ();
 static void sigfun (int sig);
+static bool configureDecoder(DSDcc::DSDDecoder& dsdDecoder, int c, const char *optarg);
+static void decodeBatch(BatchDecode& batchDecode, int nbThreads);
+
+void BatchDecode::work()
+{
+    DSDcc::DSDDecoder *dsdDecoder = new DSDcc::DSDDecoder();
+    BatchOutput output(m_writer);
+    unsigned int index;
+
+    while ((exitflag == 0) && ((index = m_nextFile.fetch_add(1)) < m_files.size()))
+    {
+        if (!decodeFile(*dsdDecoder, output, m_files[index])) {
+            m_nbFailed++;
+        }
+    }
+
+    delete dsdDecoder;
+}
+
+bool BatchDecode::decodeFile(DSDcc::DSDDecoder& dsdDecoder, BatchOutput& output, const std::string& fileName)
+{
+    std::string baseName = fileName.substr(fileName.find_last_of('/') + 1);
+    baseName = baseName.substr(0, baseName.find_last_of('.'));
+    std::string outputBase = m_outputDir + "/" + baseName;
+
+    int inputFd = open(fileName.c_str(), O_RDONLY);
+    struct stat inputStat;
+
+    if ((inputFd < 0) || (fstat(inputFd, &inputStat) != 0))
+    {
+        fprintf(stderr, "Cannot open %s for input\n", fileName.c_str());
+
+        if (inputFd >= 0) {
+            ::close(inputFd);
+        }
+
+        return false;
+    }
+
+    void *input = inputStat.st_size > 0 ? mmap(0, inputStat.st_size, PROT_READ, MAP_PRIVATE, inputFd, 0) : MAP_FAILED;
+    ::close(inputFd);
+
+    if (input == MAP_FAILED)
+    {
+        fprintf(stderr, "Cannot map %s\n", fileName.c_str());
+        return false;
+    }
+
+    int outputFd = open((outputBase + ".raw").c_str(), O_WRONLY|O_CREAT|O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+
+    if (outputFd < 0)
+    {
+        fprintf(stderr, "Cannot open %s.raw for output\n", outputBase.c_str());
+        munmap(input, inputStat.st_size);
+        return false;
+    }
+
+    // the log file is set first so that the messages of the previous file go to its log
+    dsdDecoder.setLogFile((outputBase + ".log").c_str());
+    dsdDecoder.reset();
+
+    for (std::vector<DecoderOption>::const_iterator it = m_options.begin(); it != m_options.end(); ++it) {
+        configureDecoder(dsdDecoder, it->first, it->second.c_str());
+    }
+
+    dsdDecoder.setMyPoint(m_lat, m_lon);
+
+    if (m_inputRate != 48000) {
+        dsdDecoder.setInputSampleRate(m_inputRate);
+    }
+
+    output.open(outputFd, m_slots);
+    dsdDecoder.setAudioSink(&output);
+
+    const short *samples = (const short *) input;
+    uint64_t nbSamples = inputStat.st_size / sizeof(short);
+
+    for (uint64_t i = 0; (i < nbSamples) && (exitflag == 0); i++) {
+        dsdDecoder.run(samples[i]);
+    }
+
+    munmap(input, inputStat.st_size);
+    dsdDecoder.setAudioSink(0);
+    output.close();
+
+    DSDcc::DSDStats::Snapshot stats;
+    dsdDecoder.getStats().getSnapshot(stats);
+
+    if (m_printStats)
+    {
+        char *text = 0;
+        size_t size = 0;
+        FILE *statsFile = open_memstream(&text, &size);
+
+        if (statsFile)
+        {
+            dsdDecoder.getStats().print(statsFile);
+            fclose(statsFile);
+            int statsFd = open((outputBase + ".stats").c_str(), O_WRONLY|O_CREAT|O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+
+            if (statsFd >= 0)
+            {
+                std::vector<char> data(text, text + size);
+                m_writer.write(statsFd, data);
+                m_writer.close(statsFd);
+            }
+
+            free(text);
+        }
+    }
+
+    fprintf(stderr, "%s: %llu samples %llu AMBE/IMBE frames\n",
+            fileName.c_str(),
+            (unsigned long long) nbSamples,
+            (unsigned long long) stats.m_mbeFrames);
+
+    return true;
+}
+
+void ParallelDecode::work()
+{
+    unsigned int index;
+
+    while ((index = m_nextPart.fetch_add(1)) < m_parts.size())
+    {
+        PartOutput& part = m_parts[index];
+
+        if (exitflag == 0)
+        {
+            DSDcc::DSDDecoder *dsdDecoder = new DSDcc::DSDDecoder();
+
+            for (std::vector<DecoderOption>::const_iterator it = m_options.begin(); it != m_options.end(); ++it) {
+                configureDecoder(*dsdDecoder, it->first, it->second.c_str());
+            }
+
+            dsdDecoder->setLogVerbosity(0); // messages of the parts would be interleaved
+            dsdDecoder->setMyPoint(m_lat, m_lon);
+            dsdDecoder->enableMbeDV(m_mbeDV);
+
+            if (!m_mbelib) {
+                dsdDecoder->enableMbelib(false);
+            }
+
+            dsdDecoder->setAudioSink(&part);
+            dsdDecoder->setSampleCount(part.m_start - part.m_warmup);
+
+            for (uint64_t i = part.m_start - part.m_warmup; i < part.m_end; i++) {
+                dsdDecoder->run(m_samples[i]);
+            }
+
+            part.m_stats.add(dsdDecoder->getStats());
+            delete dsdDecoder;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            part.m_done = true;
+        }
+
+        m_partDone.notify_all();
+    }
+}
 
 void usage()
 {
     fprintf(stderr, "\n");
     fprintf(stderr, "Usage:\n");
     fprintf(stderr, "  dsd [options] Live scanner mode\n");
+    fprintf(stderr, "  dsd [options] -O <dir> <files>... Decode files concurrently\n");
     fprintf(stderr, "  dsd -h        Show help\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Display Options:\n");
@@ -97,11 +930,13 @@ void usage()
     fprintf(stderr, "  -pt           Show P25 talkgroup info - not supported\n");
     fprintf(stderr, "  -q            Don't show Frame Info/errorbars\n");
     fprintf(stderr, "  -t            Show symbol timing during sync\n");
-    fprintf(stderr, "  -v <num>      Frame information Verbosity\n");
+    fprintf(stderr, "  -v <num>      Frame information Verbosity (0: none, 1: info, 2: info and debug)\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Input/Output options:\n");
     fprintf(stderr, "  -i <device>   Audio input device (default is /dev/audio, - for piped stdin)\n");
     fprintf(stderr, "  -o <device>   Audio output device (default is /dev/audio, - for stdout)\n");
+    fprintf(stderr, "  -I <format>   Input is complex baseband in cs16 or cf32 format instead of FM discriminator samples\n");
+    fprintf(stderr, "  -r <rate>     Input sample rate in S/s (default 48000)\n");
     fprintf(stderr, "  -g <num>      Audio output gain (default = 0 = auto, disable = -1)\n");
     fprintf(stderr, "  -U <num>      Audio output upsampling\n");
     fprintf(stderr, "                0: no upsampling (8k) default\n");
@@ -125,6 +960,7 @@ void usage()
     fprintf(stderr, "     1          4800 bauds (default)\n");
     fprintf(stderr, "     2          9800 bauds\n");
     fprintf(stderr, "  -fa           Auto-detect frame type (default)\n");
+    fprintf(stderr, "  -fA           Auto-detect frame type and data rate (2400, 4800 or 9600 baud)\n");
     fprintf(stderr, "  -fr           Decode only DMR/MOTOTRBO\n");
     fprintf(stderr, "  -fd           Decode only D-STAR\n");
     fprintf(stderr, "  -fm           Decode only DPMR Tier 1 or 2 (6.25 kHz)\n");
@@ -153,10 +989,195 @@ void usage()
     fprintf(stderr, "                This is useful when status messages (see -M option) contain geographical data\n");
     fprintf(stderr, "                Practically this is only applicable to D-Star\n");
     fprintf(stderr, "  -x            Disable symbol PLL lock\n");
+    fprintf(stderr, "  -G            Symbol timing recovery with Gardner detector at 2.5 to 4 samples per symbol\n");
+    fprintf(stderr, "  -z            Skip symbol recovery and sync search while the channel is idle\n");
+    fprintf(stderr, "  -s            Print decoding statistics (syncs, FEC, CRC, vocoder errors) on exit\n");
+    fprintf(stderr, "  -C <filename> Capture the decoded frames to a binary file (see dsdcc-capdump)\n");
+    fprintf(stderr, "  -A <filename> Record the AMBE/IMBE frames of the selected slots to a file (see dsdcc-vocode).\n");
+    fprintf(stderr, "                Without -o the audio is not decoded\n");
+    fprintf(stderr, "  -W <dir>      Write each call to its own files in <dir>: <date>-<time>_<number>_<protocol>_s<slot>.raw\n");
+    fprintf(stderr, "                audio as with -o and .txt with its IDs, callsigns, slot and duration (see Readme.md)\n");
+    fprintf(stderr, "  -S <filename> Capture the symbol stream to a binary file for replay with -Y\n");
+    fprintf(stderr, "  -Y            Input is a symbol capture (see -S) replayed instead of the samples.\n");
+    fprintf(stderr, "                Use the same decode options as for the capture\n");
+    fprintf(stderr, "  -j <num>      Pre-scan the input file then decode its transmissions with <num> threads.\n");
+    fprintf(stderr, "                Frame information is not shown (see Readme.md)\n");
+    fprintf(stderr, "                With input files number of files decoded concurrently (default one per core)\n");
+    fprintf(stderr, "  -O <dir>      Output directory of the input files given after the options (or glob patterns):\n");
+    fprintf(stderr, "                dsdccx [options] -O <dir> <files>...\n");
+    fprintf(stderr, "                Each file gives <dir>/<name>.raw audio, <dir>/<name>.log messages\n");
+    fprintf(stderr, "                and <dir>/<name>.stats statistics with -s\n");
     fprintf(stderr, "\n");
     exit(0);
 }
 
+/** Applies a command line option of the decoder. Returns false if this is not a decoder option */
+bool configureDecoder(DSDcc::DSDDecoder& dsdDecoder, int c, const char *optarg)
+{
+    switch (c)
+    {
+    case 'H':
+        dsdDecoder.useHPMbelib(true);
+        return true;
+    case 'e':
+        dsdDecoder.showErrorBars();
+        return true;
+    case 'p':
+        if (optarg[0] == 'e')
+        {
+            dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25EncryptionSyncBits, true);
+        }
+        else if (optarg[0] == 'l')
+        {
+            dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25LinkControlBits, true);
+        }
+        else if (optarg[0] == 's')
+        {
+            dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25EncryptionSyncBits, true);
+        }
+        else if (optarg[0] == 't')
+        {
+            dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25TalkGroupInfo, true);
+        }
+        else if (optarg[0] == 'u')
+        {
+            dsdDecoder.muteEncryptedP25(false);
+        }
+        return true;
+    case 'q':
+        dsdDecoder.setQuiet();
+        return true;
+    case 't':
+        dsdDecoder.showSymbolTiming();
+        return true;
+    case 'v':
+        int verbosity;
+        sscanf(optarg, "%d", &verbosity);
+        dsdDecoder.setLogVerbosity(verbosity);
+        return true;
+    case 'g':
+        float gain;
+        sscanf(optarg, "%f", &gain);
+        dsdDecoder.setAudioGain(gain);
+        return true;
+    case 'n':
+        dsdDecoder.enableAudioOut(false);
+        return true;
+    case 'R':
+        int resume;
+        sscanf(optarg, "%d", &resume);
+        dsdDecoder.enableScanResumeAfterTDULCFrames(resume);
+        return true;
+    case 'd':
+        int dataRateIndex;
+        sscanf(optarg, "%d", &dataRateIndex);
+        if ((dataRateIndex >= 0) && (dataRateIndex <= 2))
+        {
+            dsdDecoder.setDataRate((DSDcc::DSDDecoder::DSDRate) dataRateIndex);
+        }
+        return true;
+    case 'f':
+        dsdDecoder.enableMultiRateAuto(false);
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
+        if (optarg[0] == 'a') // auto detect
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeAuto, true);
+        }
+        else if (optarg[0] == 'A') // auto detect at all rates
+        {
+            dsdDecoder.enableMultiRateAuto(true);
+        }
+        else if (optarg[0] == 'r') // DMR/MOTOTRBO
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDMR, true);
+        }
+        else if (optarg[0] == 'd') // D-Star
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDStar, true);
+        }
+        else if (optarg[0] == 'x') // X2-TDMA
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeX2TDMA, true);
+        }
+        else if (optarg[0] == 'p') // ProVoice
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeProVoice, true);
+        }
+        else if (optarg[0] == '0') // P25 Phase 1
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeP25P1, true);
+        }
+        else if (optarg[0] == 'i') // NXDN48 IDAS
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN48, true);
+        }
+        else if (optarg[0] == 'n') // NXDN96
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN96, true);
+        }
+        else if (optarg[0] == 'm') // DPMR Tier 1 or 2
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDPMR, true);
+        }
+        else if (optarg[0] == 'y') // YSF
+        {
+            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeYSF, true);
+        }
+        return true;
+    case 'u':
+        int uvquality;
+        sscanf(optarg, "%i", &uvquality);
+        dsdDecoder.setUvQuality(uvquality);
+        return true;
+    case 'U':
+        int upsampling;
+        sscanf(optarg, "%d", &upsampling);
+        dsdDecoder.setUpsampling(upsampling);
+        return true;
+    case 'l':
+        dsdDecoder.enableCosineFiltering(false);
+        return true;
+    case 'x':
+        dsdDecoder.setSymbolPLLLock(false);
+        return true;
+    case 'z':
+        dsdDecoder.enableIdleGate(true);
+        return true;
+    case 'G':
+        dsdDecoder.setSymbolTimingRecovery(DSDcc::DSDSymbol::TimingGardner);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Decodes the files of a batch with nbThreads worker threads or one per core if 0 */
+void decodeBatch(BatchDecode& batchDecode, int nbThreads)
+{
+    if (nbThreads == 0) {
+        nbThreads = std::thread::hardware_concurrency();
+    }
+
+    nbThreads = nbThreads < 1 ? 1 : nbThreads > (int) batchDecode.m_files.size() ? batchDecode.m_files.size() : nbThreads;
+    fprintf(stderr, "Decoding %u files to %s with %d threads\n", (unsigned int) batchDecode.m_files.size(), batchDecode.m_outputDir.c_str(), nbThreads);
+
+    batchDecode.m_writer.start();
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < nbThreads; i++) {
+        workers.push_back(std::thread(&BatchDecode::work, &batchDecode));
+    }
+
+    for (std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); ++it) {
+        it->join();
+    }
+
+    batchDecode.m_writer.stop();
+    fprintf(stderr, "Decoded %u files (%u failed)\n",
+            (unsigned int) batchDecode.m_files.size() - batchDecode.m_nbFailed.load(),
+            batchDecode.m_nbFailed.load());
+}
+
 void sigfun(int sig __attribute__((unused)))
 {
     exitflag = 1;
@@ -167,14 +1188,16 @@ int main(int argc, char **argv)
 {
     int c;
     extern char *optarg;
-    extern int optind __attribute__((unused));
+    extern int optind;
     extern int optopt __attribute__((unused));
     extern int opterr;
     DSDcc::DSDDecoder dsdDecoder;
     DSDcc::DSDUpsampler upsamplingEngine;
     char in_file[1023];
+    in_file[0] = '\0';
     int  in_file_fd = -1;
     char out_file[1023];
+    out_file[0] = '\0';
     int  out_file_fd = -1;
     char log_file[1023];
     log_file[0] = '\0';
@@ -189,9 +1212,32 @@ int main(int argc, char **argv)
     std::string dvSerialDevice;
 #endif
     int slots = 1;
-    Mixer mixer;
+    AudioWriter audioWriter;
+    IQFormat iq_format = IQNone;
+    int input_rate = 48000;
+    DSDcc::DSDIQFrontEnd iqFrontEnd;
     float lat = 0.0f;
     float lon = 0.0f;
+    bool printStats = false;
+    char capture_file[1023];
+    capture_file[0] = '\0';
+    DSDcc::DSDCapture capture;
+    char symbol_capture_file[1023];
+    symbol_capture_file[0] = '\0';
+    DSDcc::DSDSymbolCapture symbolCapture;
+    bool symbolReplay = false;
+    char mbe_file[1023];
+    mbe_file[0] = '\0';
+    DSDcc::DSDMBEFile mbeFile;
+    DSDcc::DSDSymbolCapture::Reader symbolReader;
+    std::vector<DecoderOption> decoderOptions;
+    int nbThreads = 0;
+    ParallelDecode parallelDecode;
+    std::string outputDir;
+    std::vector<std::string> inputFiles;
+    std::string callDir;
+    AsyncFileWriter callWriter;
+    CallRecorder callRecorder(callWriter, audioWriter);
 
     fprintf(stderr, "Digital Speech Decoder DSDcc\n");
 
@@ -199,7 +1245,7 @@ int main(int argc, char **argv)
     signal(SIGINT, sigfun);
 
     while ((c = getopt(argc, argv,
-            "hHep:qtv:i:o:g:nR:f:u:U:lL:D:d:T:M:m:P:Q:x")) != -1)
+            "hHep:qtv:i:o:O:I:r:g:nR:f:u:U:lL:D:d:T:M:m:P:Q:xzGsC:S:YA:j:W:")) != -1)
     {
         opterr = 0;
         switch (c)
@@ -207,45 +1253,6 @@ int main(int argc, char **argv)
         case 'h':
             usage();
             exit(0);
-        case 'H':
-            dsdDecoder.useHPMbelib(true);
-            break;
-        case 'e':
-            dsdDecoder.showErrorBars();
-            break;
-        case 'p':
-            if (optarg[0] == 'e')
-            {
-                dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25EncryptionSyncBits, true);
-            }
-            else if (optarg[0] == 'l')
-            {
-                dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25LinkControlBits, true);
-            }
-            else if (optarg[0] == 's')
-            {
-                dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25EncryptionSyncBits, true);
-            }
-            else if (optarg[0] == 't')
-            {
-                dsdDecoder.setP25DisplayOptions(DSDcc::DSDDecoder::DSDShowP25TalkGroupInfo, true);
-            }
-            else if (optarg[0] == 'u')
-            {
-                dsdDecoder.muteEncryptedP25(false);
-            }
-            break;
-        case 'q':
-            dsdDecoder.setQuiet();
-            break;
-        case 't':
-            dsdDecoder.showSymbolTiming();
-            break;
-        case 'v':
-            int verbosity;
-            sscanf(optarg, "%d", &verbosity);
-            dsdDecoder.setLogVerbosity(verbosity);
-            break;
         case 'L':
             strncpy(log_file, (const char *) optarg, 1023);
             log_file[1022] = '\0';
@@ -269,6 +1276,22 @@ int main(int argc, char **argv)
             strncpy(out_file, (const char *) optarg, 1023);
             out_file[1022] = '\0';
             break;
+        case 'O':
+            outputDir = optarg;
+            break;
+        case 'I':
+            if (strcmp(optarg, "cf32") == 0) {
+                iq_format = IQFloat32;
+            } else if (strcmp(optarg, "cs16") == 0) {
+                iq_format = IQInt16;
+            } else {
+                fprintf(stderr, "Unknown IQ format %s\n", optarg);
+            }
+            break;
+        case 'r':
+            input_rate = atoi(optarg);
+            input_rate = input_rate < 8000 ? 48000 : input_rate;
+            break;
 #ifdef DSD_USE_SERIALDV
         case 'D':
             strncpy(serialDevice, (const char *) optarg, 16);
@@ -276,32 +1299,6 @@ int main(int argc, char **argv)
             dvSerialDevice = serialDevice;
             break;
 #endif
-        case 'g':
-            float gain;
-            sscanf(optarg, "%f", &gain);
-            dsdDecoder.setAudioGain(gain);
-#ifdef DSD_USE_SERIALDV
-            if (gain > 0) {
-                dvGain_dB = (int) (10.0f * log10f(gain));
-            }
-#endif
-            break;
-        case 'n':
-            dsdDecoder.enableAudioOut(false);
-            break;
-        case 'R':
-            int resume;
-            sscanf(optarg, "%d", &resume);
-            dsdDecoder.enableScanResumeAfterTDULCFrames(resume);
-            break;
-        case 'd':
-            int dataRateIndex;
-            sscanf(optarg, "%d", &dataRateIndex);
-            if ((dataRateIndex >= 0) && (dataRateIndex <= 2))
-            {
-                dsdDecoder.setDataRate((DSDcc::DSDDecoder::DSDRate) dataRateIndex);
-            }
-            break;
         case 'T':
             int tmpSlots;
             sscanf(optarg, "%d", &tmpSlots);
@@ -310,84 +1307,180 @@ int main(int argc, char **argv)
                 slots = tmpSlots;
             }
             break;
-        case 'f':
-            dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
-            if (optarg[0] == 'a') // auto detect
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeAuto, true);
-            }
-            else if (optarg[0] == 'r') // DMR/MOTOTRBO
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDMR, true);
-            }
-            else if (optarg[0] == 'd') // D-Star
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDStar, true);
-            }
-            else if (optarg[0] == 'x') // X2-TDMA
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeX2TDMA, true);
-            }
-            else if (optarg[0] == 'p') // ProVoice
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeProVoice, true);
-            }
-            else if (optarg[0] == '0') // P25 Phase 1
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeP25P1, true);
-            }
-            else if (optarg[0] == 'i') // NXDN48 IDAS
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN48, true);
-            }
-            else if (optarg[0] == 'n') // NXDN96
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN96, true);
-            }
-            else if (optarg[0] == 'm') // DPMR Tier 1 or 2
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDPMR, true);
-            }
-            else if (optarg[0] == 'y') // YSF
-            {
-                dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeYSF, true);
-            }
-            break;
-        case 'u':
-            int uvquality;
-            sscanf(optarg, "%i", &uvquality);
-            dsdDecoder.setUvQuality(uvquality);
-            break;
-        case 'U':
-            int upsampling;
-            sscanf(optarg, "%d", &upsampling);
-            dsdDecoder.setUpsampling(upsampling);
-            break;
-        case 'l':
-            dsdDecoder.enableCosineFiltering(false);
-            break;
         case 'P':
             sscanf(optarg, "%f", &lat);
             break;
         case 'Q':
             sscanf(optarg, "%f", &lon);
             break;
-        case 'x':
-            dsdDecoder.setSymbolPLLLock(false);
+        case 's':
+            printStats = true;
+            break;
+        case 'C':
+            strncpy(capture_file, (const char *) optarg, 1023);
+            capture_file[1022] = '\0';
+            break;
+        case 'S':
+            strncpy(symbol_capture_file, (const char *) optarg, 1023);
+            symbol_capture_file[1022] = '\0';
+            break;
+        case 'Y':
+            symbolReplay = true;
+            break;
+        case 'A':
+            strncpy(mbe_file, (const char *) optarg, 1023);
+            mbe_file[1022] = '\0';
+            break;
+        case 'j':
+            nbThreads = atoi(optarg);
+            nbThreads = nbThreads < 0 ? 0 : nbThreads;
+            break;
+        case 'W':
+            callDir = optarg;
             break;
         default:
-            usage();
-            exit(0);
+            if (!configureDecoder(dsdDecoder, c, optarg))
+            {
+                usage();
+                exit(0);
+            }
+
+            decoderOptions.push_back(DecoderOption(c, optarg ? optarg : ""));
+#ifdef DSD_USE_SERIALDV
+            if ((c == 'g') && (atof(optarg) > 0)) {
+                dvGain_dB = (int) (10.0f * log10f(atof(optarg)));
+            }
+#endif
+            break;
         }
     }
 
     dsdDecoder.setMyPoint(lat, lon);
 
+    for (int i = optind; i < argc; i++) // input files of a batch possibly as glob patterns
+    {
+        glob_t globResult;
+
+        if (glob(argv[i], GLOB_NOCHECK, 0, &globResult) == 0)
+        {
+            inputFiles.insert(inputFiles.end(), globResult.gl_pathv, globResult.gl_pathv + globResult.gl_pathc);
+            globfree(&globResult);
+        }
+    }
+
+    if (inputFiles.size() > 0)
+    {
+        if (outputDir.empty() || (iq_format != IQNone) || symbolReplay || (in_file[0] != '\0') || (out_file[0] != '\0')
+            || (log_file[0] != '\0') || (capture_file[0] != '\0') || (symbol_capture_file[0] != '\0')
+            || (formattext_file[0] != '\0') || (mbe_file[0] != '\0') || !callDir.empty()
+#ifdef DSD_USE_SERIALDV
+            || !dvSerialDevice.empty()
+#endif
+            )
+        {
+            fprintf(stderr, "Input files need -O and cannot be used with -i -o -I -Y -L -C -S -M -A -W or -D. Aborting\n");
+            return 0;
+        }
+
+        if (access(outputDir.c_str(), W_OK) != 0)
+        {
+            fprintf(stderr, "Cannot write decoded files to %s. Aborting\n", outputDir.c_str());
+            return 0;
+        }
+
+        BatchDecode batchDecode;
+        batchDecode.m_files = inputFiles;
+        batchDecode.m_outputDir = outputDir;
+        batchDecode.m_options = decoderOptions;
+        batchDecode.m_slots = slots;
+        batchDecode.m_inputRate = input_rate;
+        batchDecode.m_lat = lat;
+        batchDecode.m_lon = lon;
+        batchDecode.m_printStats = printStats;
+        decodeBatch(batchDecode, nbThreads);
+        return 0;
+    }
+
+    if ((nbThreads > 0)
+        && ((iq_format != IQNone) || (input_rate != 48000) || symbolReplay || (strncmp(in_file, "-", 1) == 0)
+            || (capture_file[0] != '\0') || (symbol_capture_file[0] != '\0') || (formattext_file[0] != '\0') || !callDir.empty()
+#ifdef DSD_USE_SERIALDV
+            || !dvSerialDevice.empty()
+#endif
+        ))
+    {
+        fprintf(stderr, "-j needs a file of FM discriminator samples at 48000 S/s as input and cannot be used with -C -S -M -W or -D. Aborting\n");
+        return 0;
+    }
+
+    if (!callDir.empty() && (access(callDir.c_str(), W_OK) != 0))
+    {
+        fprintf(stderr, "Cannot write calls to %s. Aborting\n", callDir.c_str());
+        return 0;
+    }
+
     if (strlen(log_file) > 0) {
         dsdDecoder.setLogFile(log_file);
     }
 
-    if (strncmp(in_file, (const char *) "-", 1) == 0)
+    if (strlen(capture_file) > 0)
+    {
+        if (capture.open(capture_file))
+        {
+            dsdDecoder.setCapture(&capture);
+            fprintf(stderr, "Opened %s for frame capture.\n", capture_file);
+        }
+        else
+        {
+            fprintf(stderr, "Cannot open %s for frame capture.\n", capture_file);
+        }
+    }
+
+    if (strlen(symbol_capture_file) > 0)
+    {
+        if (symbolCapture.open(symbol_capture_file))
+        {
+            dsdDecoder.setSymbolCapture(&symbolCapture);
+            fprintf(stderr, "Opened %s for symbol capture.\n", symbol_capture_file);
+        }
+        else
+        {
+            fprintf(stderr, "Cannot open %s for symbol capture.\n", symbol_capture_file);
+        }
+    }
+
+    if (strlen(mbe_file) > 0)
+    {
+        if (mbeFile.open(mbe_file))
+        {
+            dsdDecoder.enableMbeDV(true);
+            audioWriter.setMBEFile(&mbeFile);
+            fprintf(stderr, "Opened %s for AMBE/IMBE frames recording.\n", mbe_file);
+
+            if (out_file[0] == '\0')
+            {
+                dsdDecoder.enableMbelib(false); // record only
+                parallelDecode.m_mbelib = false;
+                strcpy(out_file, "/dev/null");
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Cannot open %s for AMBE/IMBE frames recording.\n", mbe_file);
+        }
+    }
+
+    if (symbolReplay)
+    {
+        if (!symbolReader.open(in_file))
+        {
+            fprintf(stderr, "Cannot open %s as a symbol capture. Aborting\n", in_file);
+            return 0;
+        }
+
+        in_file_fd = STDIN_FILENO; // not read
+    }
+    else if (strncmp(in_file, (const char *) "-", 1) == 0)
     {
         in_file_fd = STDIN_FILENO;
     }
@@ -425,6 +1518,8 @@ int main(int argc, char **argv)
             close(in_file_fd);
         }
 
+        symbolReader.close();
+
         fprintf(stderr, "Cannot open %s for output. Aborting\n", out_file);
         return 0;
     }
@@ -443,6 +1538,31 @@ int main(int argc, char **argv)
     }
 #endif
 
+    if (iq_format != IQNone)
+    {
+        iqFrontEnd.configure(input_rate);
+        fprintf(stderr, "Complex baseband input at %d S/s discriminator at %d S/s\n", input_rate, iqFrontEnd.getDiscriminatorRate());
+    }
+    else if (input_rate != 48000)
+    {
+        dsdDecoder.setInputSampleRate(input_rate);
+        fprintf(stderr, "Input at %d S/s\n", input_rate);
+    }
+
+    audioWriter.setOutput(out_file_fd);
+    audioWriter.setSlots(slots);
+    dsdDecoder.setAudioSink(&audioWriter);
+
+    if (!callDir.empty())
+    {
+        struct stat inputStat;
+        bool live = !symbolReplay && ((fstat(in_file_fd, &inputStat) != 0) || !S_ISREG(inputStat.st_mode)); // audio is dropped rather than waited for
+        callRecorder.open(callDir, slots, 8000 * (dsdDecoder.upsampling() ? dsdDecoder.upsampling() : 1), live);
+        callWriter.start();
+        dsdDecoder.setAudioSink(&callRecorder);
+        fprintf(stderr, "Writing calls to %s\n", callDir.c_str());
+    }
+
     int formattext_nsamples;
 
     if (formattext_file[0] == 0)
@@ -462,140 +1582,203 @@ int main(int argc, char **argv)
 
     int formattext_sample_count = 0;
 
-    while (exitflag == 0)
+    std::vector<short> samples;
+    std::vector<char> iqBuffer(iq_format == IQNone ? 0 : 960 * 2 * sizeof(float));
+    int iqBufferFill = 0;
+    int iqSampleBytes = iq_format == IQFloat32 ? 2 * sizeof(float) : 2 * sizeof(short);
+
+    if (symbolReplay)
     {
-        short sample;
-        int nbAudioSamples1 = 0, nbAudioSamples2 = 0;
-        short *audioSamples1, *audioSamples2;
+        DSDcc::DSDSymbolCapture::Symbol symbol;
 
-        int result = read(in_file_fd, (void *) &sample, sizeof(short));
+        while ((exitflag == 0) && symbolReader.next(symbol)) {
+            dsdDecoder.runSymbol(symbol);
+        }
+
+        symbolReader.close();
+        fprintf(stderr, "No more input\n");
+    }
+
+    if (nbThreads > 0)
+    {
+        struct stat inputStat;
+        void *input = MAP_FAILED;
+
+        if (fstat(in_file_fd, &inputStat) == 0) {
+            input = mmap(0, inputStat.st_size, PROT_READ, MAP_PRIVATE, in_file_fd, 0);
+        }
 
-        if (result == 0)
+        if (input == MAP_FAILED)
         {
-            fprintf(stderr, "No more input\n");
-            break;
+            fprintf(stderr, "Cannot map %s. Aborting\n", in_file);
+            return 0;
         }
 
-        dsdDecoder.run(sample);
+        uint64_t nbSamples = inputStat.st_size / sizeof(short);
+        parallelDecode.m_samples = (const short *) input;
 
-#ifdef DSD_USE_SERIALDV
-        if (dvController.isOpen())
+        // pre-scan: transmissions and their syncs
+        DSDcc::DSDSyncIndex syncIndex;
+        syncIndex.scan(parallelDecode.m_samples, nbSamples);
+        syncIndex.finish();
+        const std::vector<DSDcc::DSDSyncIndex::Region>& regions = syncIndex.getRegions();
+
+        for (unsigned int i = 0; i < regions.size(); i++)
         {
-            if (dsdDecoder.mbeDVReady1())
+            fprintf(stderr, "Region %u: %.2f - %.2f s", i, regions[i].m_start / 48000.0, regions[i].m_end / 48000.0);
+
+            if (regions[i].m_nbSyncs > 0)
             {
-                dvController.decode(dvAudioSamples, (const unsigned char *) dsdDecoder.getMbeDVFrame1(), (SerialDV::DVRate) dsdDecoder.getMbeRate(), dvGain_dB);
+                fprintf(stderr, " %u syncs from %.2f to %.2f s first sync type %d at %d baud\n",
+                        regions[i].m_nbSyncs,
+                        regions[i].m_firstSync / 48000.0,
+                        regions[i].m_lastSync / 48000.0,
+                        regions[i].m_syncType,
+                        2400 << regions[i].m_rate);
+            }
+            else
+            {
+                fprintf(stderr, " no sync\n");
+            }
+        }
 
-                if (dsdDecoder.upsampling())
-                {
-                    upsamplingEngine.upsample(dsdDecoder.upsampling(), dvAudioSamples, &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_SIZE);
-                    result = write(out_file_fd, (const void *) &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_BYTES * dsdDecoder.upsampling());
-                }
-                else
-                {
-                    result = write(out_file_fd, (const void *) dvAudioSamples, SerialDV::MBE_AUDIO_BLOCK_BYTES); // TODO: upsampling
-                }
+        std::vector<uint64_t> cuts;
+        syncIndex.getCuts(cuts, ParallelDecode::m_minPartSize, ParallelDecode::m_minGap);
+        cuts.push_back(nbSamples);
+        parallelDecode.m_parts = std::vector<PartOutput>(cuts.size());
 
-                dsdDecoder.resetMbeDV1();
-            }
+        for (unsigned int i = 0; i < cuts.size(); i++)
+        {
+            parallelDecode.m_parts[i].m_start = i == 0 ? 0 : cuts[i-1];
+            parallelDecode.m_parts[i].m_end = cuts[i];
+            parallelDecode.m_parts[i].m_warmup = i == 0 ? 0 : ParallelDecode::m_warmup;
+        }
 
-            if (dsdDecoder.mbeDVReady2())
-            {
-                dvController.decode(dvAudioSamples, (const unsigned char *) dsdDecoder.getMbeDVFrame2(), (SerialDV::DVRate) dsdDecoder.getMbeRate(), dvGain_dB);
+        fprintf(stderr, "Decoding %u parts with %d threads\n", (unsigned int) cuts.size(), nbThreads);
 
-                if (dsdDecoder.upsampling())
-                {
-                    upsamplingEngine.upsample(dsdDecoder.upsampling(), dvAudioSamples, &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_SIZE);
-                    result = write(out_file_fd, (const void *) &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_BYTES * dsdDecoder.upsampling());
-                }
-                else
-                {
-                    result = write(out_file_fd, (const void *) dvAudioSamples, SerialDV::MBE_AUDIO_BLOCK_BYTES); // TODO: upsampling
-                }
+        parallelDecode.m_options = decoderOptions;
+        parallelDecode.m_lat = lat;
+        parallelDecode.m_lon = lon;
+        parallelDecode.m_mbeDV = mbeFile.isOpen();
+        std::vector<std::thread> workers;
 
-                dsdDecoder.resetMbeDV2();
-            }
+        for (int i = 0; i < nbThreads; i++) {
+            workers.push_back(std::thread(&ParallelDecode::work, &parallelDecode));
         }
-        else
-#endif
+
+        // merge the parts in order
+        for (std::vector<PartOutput>::iterator it = parallelDecode.m_parts.begin(); it != parallelDecode.m_parts.end(); ++it)
         {
-            if (slots & 1)
             {
-                audioSamples1 = dsdDecoder.getAudio1(nbAudioSamples1);
+                std::unique_lock<std::mutex> lock(parallelDecode.m_mutex);
+                parallelDecode.m_partDone.wait(lock, [&it]() { return it->m_done; });
             }
 
-            if (slots & 2)
-            {
-                audioSamples2 = dsdDecoder.getAudio2(nbAudioSamples2);
-            }
+            it->replay(audioWriter);
+            it->clear();
+            parallelDecode.m_stats.add(it->m_stats);
+        }
 
-            if ((nbAudioSamples1 > 0) && (nbAudioSamples2 == 0))
-            {
-                result = write(out_file_fd, (const void *) audioSamples1, sizeof(short) * nbAudioSamples1);
+        for (std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); ++it) {
+            it->join();
+        }
 
-                if (result < 0)
-                {
-                    fprintf(stderr, "Error writing to output\n");
-                }
-                else if ((unsigned int) result != sizeof(short) * nbAudioSamples1)
-                {
-                    fprintf(stderr, "Written %d out of %d audio samples\n", result/2, nbAudioSamples1);
-                }
+        munmap(input, inputStat.st_size);
+        fprintf(stderr, "No more input\n");
+    }
 
-                dsdDecoder.resetAudio1();
-            }
+    while ((exitflag == 0) && !symbolReplay && (nbThreads == 0))
+    {
+        int result;
+
+        if (iq_format == IQNone)
+        {
+            short sample;
+            result = read(in_file_fd, (void *) &sample, sizeof(short));
+            samples.assign(1, sample);
+        }
+        else
+        {
+            result = read(in_file_fd, (void *) &iqBuffer[iqBufferFill], iqBuffer.size() - iqBufferFill);
 
-            if ((nbAudioSamples2 > 0) && (nbAudioSamples1 == 0))
+            if (result > 0)
             {
-                result = write(out_file_fd, (const void *) audioSamples2, sizeof(short) * nbAudioSamples2);
+                iqBufferFill += result;
+                int nbIQSamples = iqBufferFill / iqSampleBytes;
 
-                if (result < 0)
-                {
-                    fprintf(stderr, "Error writing to output\n");
-                }
-                else if ((unsigned int) result != sizeof(short) * nbAudioSamples2)
-                {
-                    fprintf(stderr, "Written %d out of %d audio samples\n", result/2, nbAudioSamples2);
+                if (iq_format == IQFloat32) {
+                    iqFrontEnd.process((const float *) iqBuffer.data(), nbIQSamples, samples);
+                } else {
+                    iqFrontEnd.process((const short *) iqBuffer.data(), nbIQSamples, samples);
                 }
 
-                dsdDecoder.resetAudio2();
+                iqBufferFill -= nbIQSamples * iqSampleBytes; // keep an incomplete sample for next time
+                std::copy(iqBuffer.begin() + nbIQSamples * iqSampleBytes, iqBuffer.begin() + nbIQSamples * iqSampleBytes + iqBufferFill, iqBuffer.begin());
             }
+        }
 
-            if ((nbAudioSamples1 > 0) && (nbAudioSamples2 > 0))
-            {
-                short *mix;
-                int mixSize;
-
-                mixer.mix(nbAudioSamples1, nbAudioSamples2, audioSamples1, audioSamples2);
-                mix = mixer.getMix(mixSize);
+        if (result <= 0)
+        {
+            fprintf(stderr, "No more input\n");
+            break;
+        }
 
-                result = write(out_file_fd, (const void *) mix, sizeof(short) * mixSize);
+        for (std::vector<short>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+        {
+            dsdDecoder.run(*it);
 
-                if (result < 0)
+#ifdef DSD_USE_SERIALDV
+            if (dvController.isOpen())
+            {
+                if (dsdDecoder.mbeDVReady1())
                 {
-                    fprintf(stderr, "Error writing to output\n");
+                    dvController.decode(dvAudioSamples, (const unsigned char *) dsdDecoder.getMbeDVFrame1(), (SerialDV::DVRate) dsdDecoder.getMbeRate(), dvGain_dB);
+
+                    if (dsdDecoder.upsampling())
+                    {
+                        upsamplingEngine.upsample(dsdDecoder.upsampling(), dvAudioSamples, &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_SIZE);
+                        result = write(out_file_fd, (const void *) &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_BYTES * dsdDecoder.upsampling());
+                    }
+                    else
+                    {
+                        result = write(out_file_fd, (const void *) dvAudioSamples, SerialDV::MBE_AUDIO_BLOCK_BYTES); // TODO: upsampling
+                    }
+
+                    dsdDecoder.resetMbeDV1();
                 }
-                else if ((unsigned int) result != sizeof(short) * mixSize)
+
+                if (dsdDecoder.mbeDVReady2())
                 {
-                    fprintf(stderr, "Written %d out of %d audio samples\n", result/2, mixSize);
-                }
+                    dvController.decode(dvAudioSamples, (const unsigned char *) dsdDecoder.getMbeDVFrame2(), (SerialDV::DVRate) dsdDecoder.getMbeRate(), dvGain_dB);
 
-                dsdDecoder.resetAudio1();
-                dsdDecoder.resetAudio2();
-            }
-        }
+                    if (dsdDecoder.upsampling())
+                    {
+                        upsamplingEngine.upsample(dsdDecoder.upsampling(), dvAudioSamples, &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_SIZE);
+                        result = write(out_file_fd, (const void *) &dvAudioSamples[SerialDV::MBE_AUDIO_BLOCK_SIZE], SerialDV::MBE_AUDIO_BLOCK_BYTES * dsdDecoder.upsampling());
+                    }
+                    else
+                    {
+                        result = write(out_file_fd, (const void *) dvAudioSamples, SerialDV::MBE_AUDIO_BLOCK_BYTES); // TODO: upsampling
+                    }
 
-        if (formattext_nsamples > 0)
-        {
-            if (formattext_sample_count < formattext_nsamples)
-            {
-                formattext_sample_count++;
+                    dsdDecoder.resetMbeDV2();
+                }
             }
-            else
+#endif
+
+            if (formattext_nsamples > 0)
             {
-                dsdDecoder.formatStatusText(formattext);
-                fputs(formattext, formattext_fp);
-                putc('\n', formattext_fp);
-                formattext_sample_count = 0;
+                if (formattext_sample_count < formattext_nsamples)
+                {
+                    formattext_sample_count++;
+                }
+                else
+                {
+                    dsdDecoder.formatStatusText(formattext);
+                    fputs(formattext, formattext_fp);
+                    putc('\n', formattext_fp);
+                    formattext_sample_count = 0;
+                }
             }
         }
     }
@@ -605,6 +1788,55 @@ int main(int argc, char **argv)
         fclose(formattext_fp);
     }
 
+    dsdDecoder.getLogger().flush();
+
+    if (!callDir.empty())
+    {
+        dsdDecoder.endCalls();
+        dsdDecoder.setAudioSink(&audioWriter);
+        callWriter.stop();
+        fprintf(stderr, "Recorded %u calls (%llu audio bytes dropped)\n",
+                callRecorder.getCallCount(),
+                (unsigned long long) callRecorder.getDroppedBytes());
+    }
+
+    if (capture.isOpen())
+    {
+        dsdDecoder.setCapture(0);
+        capture.close();
+        fprintf(stderr, "Captured %llu frames (%llu dropped)\n",
+                (unsigned long long) capture.getRecordCount(),
+                (unsigned long long) capture.getDropped());
+    }
+
+    if (mbeFile.isOpen())
+    {
+        audioWriter.setMBEFile(0);
+        mbeFile.close();
+        fprintf(stderr, "Recorded %llu AMBE/IMBE frames\n", (unsigned long long) mbeFile.getFrameCount());
+    }
+
+    if (symbolCapture.isOpen())
+    {
+        dsdDecoder.setSymbolCapture(0);
+        symbolCapture.close();
+        fprintf(stderr, "Captured %llu symbols\n", (unsigned long long) symbolCapture.getSymbolCount());
+    }
+
+    if (printStats)
+    {
+        if (nbThreads > 0) {
+            parallelDecode.m_stats.print(stderr);
+        } else {
+            dsdDecoder.getStats().print(stderr);
+        }
+    }
+
+    if (DSDcc::DSDProfile::isEnabled())
+    {
+        dsdDecoder.getProfile().print(stderr);
+    }
+
     fprintf(stderr, "End of process\n");
 
 #ifdef DSD_USE_SERIALDV
@@ -613,6 +1845,8 @@ int main(int argc, char **argv)
     }
 #endif
 
+    audioWriter.flush();
+
     if ((out_file_fd > -1) && (out_file_fd != STDOUT_FILENO)) {
         close(out_file_fd);
     }
@@ -18,6 +18,7 @@
 #include <math.h>
 #include "dsd_mbe.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 #ifdef DSD_USE_MBELIB
 #include "dsd_mbelib.h"
@@ -26,8 +27,9 @@
 namespace DSDcc
 {
 
-DSDMBEDecoder::DSDMBEDecoder(DSDDecoder *dsdDecoder) :
+DSDMBEDecoder::DSDMBEDecoder(DSDDecoder *dsdDecoder, int slot) :
         m_dsdDecoder(dsdDecoder),
+        m_slot(slot),
         m_upsamplerLastValue(0.0f),
         m_mbelibParms(0)
 {
@@ -41,8 +43,8 @@ DSDMBEDecoder::DSDMBEDecoder(DSDDecoder *dsdDecoder) :
     m_aout_max_buf_p = m_aout_max_buf;
     m_aout_max_buf_idx = 0;
 
-    memset(m_audio_out_buf, 0, sizeof(short) * 2 * 48000);
-    m_audio_out_buf_p = m_audio_out_buf;
+    m_audio_out_buf = 0;
+    m_audio_out_buf_p = 0;
     m_audio_out_nb_samples = 0;
     m_audio_out_buf_size = 48000; // given in number of unique samples
     m_audio_out_idx = 0;
@@ -66,6 +68,65 @@ DSDMBEDecoder::~DSDMBEDecoder()
 #ifdef DSD_USE_MBELIB
     delete m_mbelibParms;
 #endif
+    delete[] m_audio_out_buf;
+}
+
+void DSDMBEDecoder::reset()
+{
+    m_upsamplerLastValue = 0.0f;
+    m_audio_out_temp_buf_p = m_audio_out_temp_buf;
+    memset(m_audio_out_float_buf, 0, sizeof(float) * 1120);
+    m_audio_out_float_buf_p = m_audio_out_float_buf;
+    memset(m_aout_max_buf, 0, sizeof(float) * 200);
+    m_aout_max_buf_p = m_aout_max_buf;
+    m_aout_max_buf_idx = 0;
+
+    setAudioBufferSize(48000);
+
+    if (m_audio_out_buf) {
+        resetAudio();
+    }
+
+    m_audio_out_idx = 0;
+    m_audio_out_idx2 = 0;
+
+    m_aout_gain = 25;
+    m_volume = 1.0f;
+    m_auto_gain = true;
+    m_stereo = false;
+    m_channels = 3;
+    m_upsample = 0;
+    m_upsamplingFilter.reset();
+
+    initMbeParms();
+
+    memset(ambe_d, 0, 49);
+    memset(imbe_d, 0, 88);
+}
+
+void DSDMBEDecoder::setAudioBufferSize(int nbSamples)
+{
+    if (nbSamples <= 1120) {
+        nbSamples = 1121; // must hold a frame of 160 samples upsampled 7 times
+    }
+
+    if (nbSamples != m_audio_out_buf_size)
+    {
+        m_audio_out_buf_size = nbSamples;
+
+        if (m_audio_out_buf) // re-allocate only if already in use
+        {
+            delete[] m_audio_out_buf;
+            allocateAudioBuffer();
+        }
+    }
+}
+
+void DSDMBEDecoder::allocateAudioBuffer()
+{
+    m_audio_out_buf = new short[2*m_audio_out_buf_size];
+    memset(m_audio_out_buf, 0, sizeof(short) * 2 * m_audio_out_buf_size);
+    resetAudio();
 }
 
 void DSDMBEDecoder::initMbeParms()
@@ -83,12 +144,75 @@ void DSDMBEDecoder::initMbeParms()
     }
 }
 
+void DSDMBEDecoder::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeFloat(m_aout_gain);
+    buffer.writeU8(m_aout_max_buf_idx);
+
+    for (int i = 0; i < 25; i++) { // gain history of processAudio
+        buffer.writeFloat(m_aout_max_buf[i]);
+    }
+
+    buffer.writeFloat(m_upsamplerLastValue);
+#ifdef DSD_USE_MBELIB
+    // mbelib parameters are saved as is and restored only by a build with the same structure size
+    buffer.writeU16(sizeof(mbe_parms));
+    buffer.writeBytes(m_mbelibParms->m_cur_mp, sizeof(mbe_parms));
+    buffer.writeBytes(m_mbelibParms->m_prev_mp, sizeof(mbe_parms));
+    buffer.writeBytes(m_mbelibParms->m_prev_mp_enhanced, sizeof(mbe_parms));
+#else
+    buffer.writeU16(0);
+#endif
+}
+
+#ifdef DSD_USE_MBELIB
+// mbelib loops on the number of harmonics and bands over its parameter arrays
+static bool validMbeParms(const mbe_parms *parms)
+{
+    return (parms->L >= 0) && (parms->L <= 56) && (parms->K >= 0) && (parms->K <= 56);
+}
+#endif
+
+void DSDMBEDecoder::restoreState(DSDStateBuffer& buffer)
+{
+    float aoutGain = buffer.readFloat();
+
+    if (m_auto_gain) {
+        m_aout_gain = aoutGain;
+    }
+
+    m_aout_max_buf_idx = buffer.readU8(25 - 1);
+    m_aout_max_buf_p = m_aout_max_buf + m_aout_max_buf_idx;
+
+    for (int i = 0; i < 25; i++) {
+        m_aout_max_buf[i] = buffer.readFloat();
+    }
+
+    m_upsamplerLastValue = buffer.readFloat();
+    unsigned int parmsSize = buffer.readU16();
+#ifdef DSD_USE_MBELIB
+    if (parmsSize == sizeof(mbe_parms))
+    {
+        buffer.readBytes(m_mbelibParms->m_cur_mp, sizeof(mbe_parms));
+        buffer.readBytes(m_mbelibParms->m_prev_mp, sizeof(mbe_parms));
+        buffer.readBytes(m_mbelibParms->m_prev_mp_enhanced, sizeof(mbe_parms));
+
+        if (!validMbeParms(m_mbelibParms->m_cur_mp) || !validMbeParms(m_mbelibParms->m_prev_mp) || !validMbeParms(m_mbelibParms->m_prev_mp_enhanced)) {
+            buffer.reject();
+        }
+    }
+#else
+    (void) parmsSize;
+#endif
+}
+
 void DSDMBEDecoder::processFrame(char imbe_fr[8][23], char ambe_fr[4][24], char imbe7100_fr[7][24])
 {
     if (!m_dsdDecoder->m_mbelibEnable) {
         return;
     }
 #ifdef DSD_USE_MBELIB
+    DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageVocoder);
     memset((void *) imbe_d, 0, 88);
 
     if (m_dsdDecoder->m_mbeRate == DSDDecoder::DSDMBERate7200x4400)
@@ -117,6 +241,8 @@ void DSDMBEDecoder::processFrame(char imbe_fr[8][23], char ambe_fr[4][24], char
                 m_mbelibParms->m_prev_mp, m_mbelibParms->m_prev_mp_enhanced, m_dsdDecoder->m_opts.uvquality);
     }
 
+    m_dsdDecoder->m_stats.countVocoderFrame(m_errs2);
+
     if (m_dsdDecoder->m_opts.errorbars == 1)
     {
         m_dsdDecoder->getLogger().log("%s", m_err_str);
@@ -132,6 +258,8 @@ void DSDMBEDecoder::processData(char imbe_data[88], char ambe_data[49])
         return;
     }
 #ifdef DSD_USE_MBELIB
+    DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageVocoder);
+
     if (m_dsdDecoder->m_mbeRate == DSDDecoder::DSDMBERate4400)
     {
         mbe_processImbe4400Dataf(m_audio_out_temp_buf, &m_errs,
@@ -155,6 +283,8 @@ void DSDMBEDecoder::processData(char imbe_data[88], char ambe_data[49])
         return;
     }
 
+    m_dsdDecoder->m_stats.countVocoderFrame(m_errs2);
+
     if (m_dsdDecoder->m_opts.errorbars == 1)
     {
         m_dsdDecoder->getLogger().log("%s", m_err_str);
@@ -166,6 +296,7 @@ void DSDMBEDecoder::processData(char imbe_data[88], char ambe_data[49])
 
 void DSDMBEDecoder::processAudio()
 {
+    DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageAudio);
     int i, n;
     float aout_abs, max, gainfactor, gaindelta, maxbuf;
 
@@ -259,13 +390,24 @@ void DSDMBEDecoder::processAudio()
 
     // copy audio data to output buffer and upsample if necessary
     m_audio_out_temp_buf_p = m_audio_out_temp_buf;
+    DSDDecoder::AudioSink *audioSink = m_dsdDecoder->m_audioSink;
+
+    if (audioSink) // the frame is delivered on its own
+    {
+        m_audio_out_nb_samples = 0;
+        m_audio_out_buf_p = m_audio_frame_buf;
+    }
+    else if (!m_audio_out_buf)
+    {
+        allocateAudioBuffer();
+    }
 
     //if ((m_upsample == 6) || (m_upsample == 7)) // upsampling to 48k
     if (m_upsample >= 2)
     {
         int upsampling = m_upsample;
 
-        if (m_audio_out_nb_samples + (160*upsampling) >= m_audio_out_buf_size)
+        if (!audioSink && (m_audio_out_nb_samples + (160*upsampling) >= m_audio_out_buf_size))
         {
             resetAudio();
         }
@@ -326,7 +468,7 @@ void DSDMBEDecoder::processAudio()
     }
     else // leave at 8k
     {
-        if (m_audio_out_nb_samples + 160 >= m_audio_out_buf_size)
+        if (!audioSink && (m_audio_out_nb_samples + 160 >= m_audio_out_buf_size))
         {
             resetAudio();
         }
@@ -359,6 +501,13 @@ void DSDMBEDecoder::processAudio()
             m_audio_out_idx2++;
         }
     }
+
+    if (audioSink)
+    {
+        m_dsdDecoder->voiceFrame(m_slot); // the call starts before its first audio frame
+        audioSink->audioFrame(m_slot, m_audio_frame_buf, m_audio_out_nb_samples, m_dsdDecoder->m_sampleCount);
+        resetAudio();
+    }
 }
 
 void DSDMBEDecoder::upsample(int upsampling, float invalue)
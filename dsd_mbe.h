@@ -17,6 +17,8 @@
 #ifndef DSDCC_DSD_MBE_H_
 #define DSDCC_DSD_MBE_H_
 
+#include <stddef.h>
+
 #include "dsd_filters.h"
 #include "export.h"
 
@@ -24,15 +26,20 @@ namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 struct DSDmbelibParms;
 
 class DSDCC_API DSDMBEDecoder
 {
 public:
-    explicit DSDMBEDecoder(DSDDecoder *dsdDecoder);
+    DSDMBEDecoder(DSDDecoder *dsdDecoder, int slot);
     ~DSDMBEDecoder();
 
+    void reset(); //!< returns to the state of construction keeping the audio buffer if allocated
+
     void initMbeParms();
+    void saveState(DSDStateBuffer& buffer) const;    //!< vocoder parameters history and audio gain
+    void restoreState(DSDStateBuffer& buffer);
     void processFrame(char imbe_fr[8][23], char ambe_fr[4][24], char imbe7100_fr[7][24]);
     void processData(char imbe_data[88], char ambe_data[49]);
 
@@ -53,15 +60,20 @@ public:
     void setVolume(float volume) { m_volume = volume; }
     void setStereo(bool stereo) { m_stereo = stereo; }
     void setChannels(unsigned char channels) { m_channels = channels % 4; }
+    /** Size of the polled audio buffer in number of sample instants. At least one upsampled frame. */
+    void setAudioBufferSize(int nbSamples);
+    size_t getAllocatedSize() const { return m_audio_out_buf ? 2 * m_audio_out_buf_size * sizeof(short) : 0; }
     void setUpsamplingFactor(int upsample) { m_upsample = upsample; }
     int getUpsamplingFactor() const { return m_upsample; }
     void useHP(bool useHP) { m_upsamplingFilter.useHP(useHP); }
 
 private:
     void processAudio();
+    void allocateAudioBuffer();
     void upsample(int upsampling, float invalue);
 
     DSDDecoder *m_dsdDecoder;
+    int m_slot;                //!< TDMA slot index given to the audio sink
     char imbe_d[88];
     char ambe_d[49];
     float m_upsamplerLastValue;
@@ -81,7 +93,8 @@ private:
     float *m_aout_max_buf_p;
     int m_aout_max_buf_idx;
 
-    short m_audio_out_buf[2*48000];    //!< final result - 1s of L+R S16LE samples
+    short m_audio_frame_buf[2*1120];   //!< final result of the current frame when delivered to an audio sink
+    short *m_audio_out_buf;            //!< final result - 1s of L+R S16LE samples when polled. Allocated on first use
     short *m_audio_out_buf_p;
     int   m_audio_out_nb_samples;
     int   m_audio_out_buf_size;
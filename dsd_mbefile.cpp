@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "dsd_mbefile.h"
+
+namespace DSDcc
+{
+
+DSDMBEFile::DSDMBEFile() :
+    m_file(0),
+    m_timestamp(0),
+    m_frameCount(0)
+{}
+
+DSDMBEFile::~DSDMBEFile()
+{
+    close();
+}
+
+bool DSDMBEFile::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "wb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    static const unsigned char magic[8] = {'D', 'S', 'D', 'C', 'A', 'M', 'B', 1};
+    fwrite(magic, 1, 8, m_file);
+    m_timestamp = 0;
+    m_frameCount = 0;
+    return true;
+}
+
+void DSDMBEFile::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+}
+
+void DSDMBEFile::write(int slot, const unsigned char *frame, int nbBytes, int mbeRate, uint64_t timestamp)
+{
+    unsigned char header[12];
+    int size = 1;
+    uint64_t delta = timestamp - m_timestamp;
+
+    if (nbBytes > (int) sizeof(Frame::m_data)) {
+        nbBytes = sizeof(Frame::m_data);
+    }
+
+    header[0] = (mbeRate & 0x0f) + ((slot & 0x0f) << 4);
+
+    do
+    {
+        header[size++] = (delta & 0x7f) | (delta > 0x7f ? 0x80 : 0);
+        delta >>= 7;
+    } while (delta);
+
+    header[size++] = nbBytes;
+    fwrite(header, 1, size, m_file);
+    fwrite(frame, 1, nbBytes, m_file);
+    m_timestamp = timestamp;
+    m_frameCount++;
+}
+
+DSDMBEFile::Reader::Reader() :
+    m_file(0),
+    m_timestamp(0)
+{}
+
+DSDMBEFile::Reader::~Reader()
+{
+    close();
+}
+
+bool DSDMBEFile::Reader::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "rb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    unsigned char magic[8];
+
+    if ((fread(magic, 1, 8, m_file) != 8) || (memcmp(magic, "DSDCAMB", 7) != 0) || (magic[7] != 1))
+    {
+        close();
+        return false;
+    }
+
+    m_timestamp = 0;
+    return true;
+}
+
+void DSDMBEFile::Reader::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+}
+
+bool DSDMBEFile::Reader::next(Frame& frame)
+{
+    if (!m_file) {
+        return false;
+    }
+
+    int c = getc(m_file);
+
+    if (c == EOF) {
+        return false;
+    }
+
+    frame.m_mbeRate = c & 0x0f;
+    frame.m_slot = c >> 4;
+    uint64_t delta = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if ((c = getc(m_file)) == EOF) {
+            return false;
+        }
+
+        delta |= ((uint64_t) (c & 0x7f)) << shift;
+
+        if ((c & 0x80) == 0) {
+            break;
+        }
+    }
+
+    if (((c = getc(m_file)) == EOF) || (c > (int) sizeof(frame.m_data))) {
+        return false;
+    }
+
+    frame.m_nbBytes = c;
+
+    if (fread(frame.m_data, 1, frame.m_nbBytes, m_file) != (size_t) frame.m_nbBytes) {
+        return false;
+    }
+
+    m_timestamp += delta;
+    frame.m_timestamp = m_timestamp;
+    return true;
+}
+
+} // namespace DSDcc
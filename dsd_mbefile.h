@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_MBEFILE_H_
+#define DSDCC_DSD_MBEFILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Recording of the packed AMBE/IMBE frames given to the audio sink (see DSDDecoder::AudioSink::mbeFrame)
+ * to synthesize the audio later with DSDDecoder::vocodeDVFrame (dsdcc-vocode).
+ *
+ * The file starts with the 8 bytes "DSDCAMB" followed by the format version. Then each frame is:
+ *
+ *   - uint8  bits 0..3 DSDDecoder::DSDMBERate, bits 4..7 slot
+ *   - varint difference of the timestamp with the previous frame
+ *   - uint8  number of bytes of the frame
+ *   - frame bytes as given by the decoder (9 to 18)
+ */
+class DSDCC_API DSDMBEFile
+{
+public:
+    struct Frame
+    {
+        uint64_t m_timestamp;       //!< input sample count at 48 kS/s when the frame was completed
+        int m_slot;                 //!< TDMA slot index
+        int m_mbeRate;              //!< DSDDecoder::DSDMBERate
+        int m_nbBytes;
+        unsigned char m_data[18];
+
+        Frame() : m_timestamp(0), m_slot(0), m_mbeRate(0), m_nbBytes(0) {}
+    };
+
+    DSDMBEFile();
+    ~DSDMBEFile();
+
+    bool open(const char *filename);
+    void close();
+    bool isOpen() const { return m_file != 0; }
+    void write(int slot, const unsigned char *frame, int nbBytes, int mbeRate, uint64_t timestamp);
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+    /** Sequential reader of a frames file */
+    class DSDCC_API Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+        bool open(const char *filename); //!< false if the file cannot be opened or is not a frames file
+        void close();
+        bool next(Frame& frame); //!< false at the end of the file
+
+    private:
+        FILE *m_file;
+        uint64_t m_timestamp;
+    };
+
+private:
+    FILE *m_file;
+    uint64_t m_timestamp;           //!< of the previous frame
+    uint64_t m_frameCount;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_MBEFILE_H_ */
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "dsd_profile.h"
+
+namespace DSDcc
+{
+
+const char *DSDProfile::m_stageNames[DSDProfile::StageCount] = {
+    "run",
+    "matched filter",
+    "ringing filter/PLL",
+    "levels",
+    "digitize",
+    "sync search",
+    "DMR",
+    "D-Star",
+    "dPMR",
+    "YSF",
+    "NXDN",
+    "Hamming_7_4",
+    "Hamming_12_8",
+    "Hamming_16_11_4",
+    "Golay_20_8",
+    "Golay_24_12",
+    "QR_16_7_6",
+    "GolayMBE",
+    "HammingMBE",
+    "CRC",
+    "DStarCRC",
+    "CNXDNCRC",
+    "Viterbi3",
+    "Viterbi5",
+    "CNXDNConvolution",
+    "vocoder",
+    "audio"
+};
+
+void DSDProfile::reset()
+{
+    memset(m_counters, 0, sizeof(m_counters));
+}
+
+bool DSDProfile::isEnabled()
+{
+#ifdef DSD_USE_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *DSDProfile::getStageName(Stage stage)
+{
+    return m_stageNames[stage];
+}
+
+const char *DSDProfile::getTickUnit()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+void DSDProfile::print(FILE *file) const
+{
+    double runTicks = m_counters[StageRun].m_ticks;
+
+    fprintf(file, "%-20s %16s %12s %12s %7s\n", "stage", getTickUnit(), "calls", "per call", "% run");
+
+    for (int i = 0; i < StageCount; i++)
+    {
+        const Counter& counter = m_counters[i];
+
+        if (counter.m_calls == 0) {
+            continue;
+        }
+
+        fprintf(file, "%-20s %16llu %12llu %12.1f %7.2f\n",
+            m_stageNames[i],
+            (unsigned long long) counter.m_ticks,
+            (unsigned long long) counter.m_calls,
+            (double) counter.m_ticks / counter.m_calls,
+            runTicks > 0.0 ? (counter.m_ticks * 100.0) / runTicks : 0.0);
+    }
+}
+
+} // namespace DSDcc
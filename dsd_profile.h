@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_PROFILE_H_
+#define DSDCC_DSD_PROFILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Time and call counts spent in the processing stages of a decoder. The counters are
+ * only updated when the library is compiled with DSD_USE_PROFILE (CMake option USE_PROFILE)
+ * otherwise the instrumentation compiles to nothing and the counters stay at zero.
+ *
+ * Times are inclusive: the time of a FEC decoder is also counted in the protocol that
+ * calls it and all stages are included in StageRun. The unit is the TSC cycle on x86
+ * and the nanosecond elsewhere (see getTickUnit).
+ */
+struct DSDCC_API DSDProfile
+{
+    typedef enum
+    {
+        StageRun,               //!< DSDDecoder::run as a whole
+        StageMatchedFilter,     //!< matched (root raised cosine) filter
+        StageRingingPLL,        //!< ringing filter and PLL of the symbol clock recovery
+        StageLevels,            //!< running min/max and levels tracking
+        StageDigitize,          //!< symbol to dibit digitization
+        StageSyncSearch,        //!< DSDDecoder::getFrameSync
+        StageDMR,               //!< DSDDMR processing
+        StageDStar,             //!< DSDDstar processing
+        StageDPMR,              //!< DSDdPMR processing
+        StageYSF,               //!< DSDYSF processing
+        StageNXDN,              //!< DSDNXDN processing
+        StageHamming_7_4,
+        StageHamming_12_8,
+        StageHamming_16_11_4,
+        StageGolay_20_8,
+        StageGolay_24_12,
+        StageQR_16_7_6,
+        StageGolayMBE,
+        StageHammingMBE,
+        StageCRC,               //!< YSF CRC and dPMR CRC7/CRC8
+        StageDStarCRC,
+        StageCNXDNCRC,
+        StageViterbi3,
+        StageViterbi5,
+        StageCNXDNConvolution,
+        StageVocoder,           //!< mbelib synthesis including StageAudio
+        StageAudio,             //!< DSDMBEDecoder::processAudio
+        StageCount
+    } Stage;
+
+    struct Counter
+    {
+        uint64_t m_ticks;
+        uint64_t m_calls;
+    };
+
+    DSDProfile() { reset(); }
+    void reset();
+    const Counter& getCounter(Stage stage) const { return m_counters[stage]; }
+    /** Writes one line per stage called with ticks, calls, ticks per call and share of StageRun */
+    void print(FILE *file) const;
+
+    static bool isEnabled();
+    static const char *getStageName(Stage stage);
+    static const char *getTickUnit();
+
+    static inline uint64_t ticks()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    Counter m_counters[StageCount];
+
+private:
+    static const char *m_stageNames[StageCount];
+};
+
+/** Adds the time between its construction and destruction to a stage counter */
+class DSDProfileScope
+{
+public:
+    DSDProfileScope(DSDProfile& profile, DSDProfile::Stage stage) :
+        m_counter(profile.m_counters[stage]),
+        m_start(DSDProfile::ticks())
+    {}
+
+    ~DSDProfileScope()
+    {
+        m_counter.m_ticks += DSDProfile::ticks() - m_start;
+        m_counter.m_calls++;
+    }
+
+private:
+    DSDProfile::Counter& m_counter;
+    uint64_t m_start;
+};
+
+} // namespace DSDcc
+
+#define DSD_PROFILE_CONCAT2(a, b) a##b
+#define DSD_PROFILE_CONCAT(a, b) DSD_PROFILE_CONCAT2(a, b)
+
+#ifdef DSD_USE_PROFILE
+/** Profiles the rest of the enclosing block */
+#define DSD_PROFILE_SCOPE(profile, stage) DSDcc::DSDProfileScope DSD_PROFILE_CONCAT(dsdProfileScope, __LINE__)((profile), DSDcc::DSDProfile::stage)
+/** Profiles the evaluation of an expression and yields its value */
+#define DSD_PROFILE_CALL(profile, stage, expr) (DSDcc::DSDProfileScope((profile), DSDcc::DSDProfile::stage), (expr))
+#else
+#define DSD_PROFILE_SCOPE(profile, stage)
+#define DSD_PROFILE_CALL(profile, stage, expr) (expr)
+#endif
+
+#endif /* DSDCC_DSD_PROFILE_H_ */
@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <math.h>
+
+#include "dsd_ratedetector.h"
+#include "dsd_symbol.h"
+
+namespace DSDcc
+{
+
+const float DSDRateDetector::m_minAmplitude = 1000.0f;
+
+DSDRateDetector::DSDRateDetector() :
+        m_enabled(false),
+        m_filter2400(0),
+        m_filter4800(0),
+        m_history(0),
+        m_historyIndex(0),
+        m_skipRateIndex(-1)
+{
+    static const int samplesPerSymbol[m_nbRates] = {20, 10, 5};
+    static const int decimation[m_nbRates] = {5, 4, 2};
+
+    for (int i = 0; i < m_nbRates; i++)
+    {
+        m_trackers[i].m_samplesPerSymbol = samplesPerSymbol[i];
+        m_trackers[i].m_decimation = decimation[i];
+        m_trackers[i].m_halfPeriod = samplesPerSymbol[i] / (2.0f * decimation[i]);
+        m_trackers[i].m_nbPatterns = 0;
+        m_trackers[i].m_detections = 0;
+        m_trackers[i].m_syncType = -1;
+        resetTracker(m_trackers[i]);
+    }
+}
+
+DSDRateDetector::~DSDRateDetector()
+{
+    delete[] m_history;
+    delete m_filter4800;
+    delete m_filter2400;
+}
+
+void DSDRateDetector::setEnabled(bool enabled)
+{
+    if (enabled && !m_history)
+    {
+        m_history = new short[m_historySize];
+        memset(m_history, 0, m_historySize * sizeof(short));
+        m_filter2400 = new DSDMatchedFilter();
+        m_filter2400->setMode(4);
+        m_filter4800 = new DSDMatchedFilter();
+        m_filter4800->setMode(3);
+    }
+
+    m_enabled = enabled;
+}
+
+void DSDRateDetector::reset()
+{
+    m_enabled = false;
+    m_historyIndex = 0;
+    m_skipRateIndex = -1;
+
+    for (int i = 0; i < m_nbRates; i++)
+    {
+        m_trackers[i].m_detections = 0;
+        m_trackers[i].m_syncType = -1;
+        resetTracker(m_trackers[i]);
+    }
+
+    if (m_history)
+    {
+        memset(m_history, 0, m_historySize * sizeof(short));
+        m_filter2400->reset();
+        m_filter4800->reset();
+    }
+}
+
+void DSDRateDetector::addSyncPattern(int rateIndex, const unsigned char *syncDibits, int length, int syncType)
+{
+    Tracker& tracker = m_trackers[rateIndex];
+
+    if ((tracker.m_nbPatterns == m_maxPatterns) || (length > 32)) {
+        return;
+    }
+
+    SyncPattern& pattern = tracker.m_patterns[tracker.m_nbPatterns++];
+    pattern.m_bits = 0;
+    pattern.m_mask = length == 32 ? 0xFFFFFFFF : (1U << length) - 1;
+    pattern.m_syncType = syncType;
+
+    for (int i = 0; i < length; i++) { // oldest symbol first
+        pattern.m_bits = (pattern.m_bits << 1) | (syncDibits[i] == 1 ? 1 : 0);
+    }
+}
+
+int DSDRateDetector::getReplaySize(int rateIndex) const
+{
+    int replaySize = m_replaySymbols * m_trackers[rateIndex].m_samplesPerSymbol;
+    return replaySize < m_historySize ? replaySize : m_historySize;
+}
+
+void DSDRateDetector::resetTracker(Tracker& tracker)
+{
+    tracker.m_decimationCount = 0;
+
+    for (int i = 0; i < 4; i++) {
+        tracker.m_samples[i] = 0.0f;
+    }
+
+    tracker.m_nextStrobe = tracker.m_halfPeriod;
+    tracker.m_midStrobe = true;
+    tracker.m_midValue = 0.0f;
+    tracker.m_lastValue = 0.0f;
+    tracker.m_center = 0.0f;
+    tracker.m_amplitude = 0.0f;
+    tracker.m_syncBits = 0;
+    tracker.m_nbSymbols = 0;
+}
+
+int DSDRateDetector::push(short sample, int skipRateIndex)
+{
+    m_history[m_historyIndex] = sample;
+    m_historyIndex = (m_historyIndex + 1) % m_historySize;
+
+    if (skipRateIndex != m_skipRateIndex) // main chain changed rate or went in or out of sync search
+    {
+        for (int i = 0; i < m_nbRates; i++) {
+            resetTracker(m_trackers[i]);
+        }
+
+        m_skipRateIndex = skipRateIndex;
+    }
+
+    m_filter2400->push(sample);
+    m_filter4800->push(sample);
+
+    if (skipRateIndex < 0) {
+        return -1;
+    }
+
+    bool computed = false;
+    short filtered = 0;
+
+    for (int i = m_nbRates - 1; i >= 0; i--) // 9600 baud first so that its 12.5 kHz output is shared with 4800
+    {
+        Tracker& tracker = m_trackers[i];
+
+        if ((i == skipRateIndex) || (tracker.m_nbPatterns == 0)) {
+            continue;
+        }
+
+        if (++tracker.m_decimationCount < tracker.m_decimation) {
+            continue;
+        }
+
+        tracker.m_decimationCount = 0;
+
+        if (i == 0)
+        {
+            filtered = m_filter2400->filter();
+        }
+        else if (!computed)
+        {
+            filtered = m_filter4800->filter();
+            computed = true;
+        }
+
+        if (pushTracker(tracker, filtered))
+        {
+            tracker.m_detections++;
+
+            for (int j = 0; j < m_nbRates; j++) {
+                resetTracker(m_trackers[j]);
+            }
+
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool DSDRateDetector::pushTracker(Tracker& tracker, short sample)
+{
+    tracker.m_samples[0] = tracker.m_samples[1];
+    tracker.m_samples[1] = tracker.m_samples[2];
+    tracker.m_samples[2] = tracker.m_samples[3];
+    tracker.m_samples[3] = sample;
+    tracker.m_nextStrobe -= 1.0f;
+
+    if (tracker.m_nextStrobe >= 1.0f) {
+        return false;
+    }
+
+    float y = DSDSymbol::farrowInterpolate(tracker.m_samples, tracker.m_nextStrobe < 0.0f ? 0.0f : tracker.m_nextStrobe);
+
+    if (tracker.m_midStrobe)
+    {
+        tracker.m_midValue = y;
+        tracker.m_midStrobe = false;
+        tracker.m_nextStrobe += tracker.m_halfPeriod;
+        return false;
+    }
+
+    // on time strobe: Gardner error on transitions only (see DSDSymbol::pushSampleGardner)
+
+    float error = 0.0f;
+
+    if ((tracker.m_amplitude > 0.0f) && ((tracker.m_lastValue - tracker.m_center) * (y - tracker.m_center) < 0.0f))
+    {
+        error = (tracker.m_midValue - tracker.m_center) / tracker.m_amplitude;
+        error = tracker.m_lastValue > tracker.m_center ? error : -error;
+        error = error > 1.0f ? 1.0f : error < -1.0f ? -1.0f : error;
+    }
+
+    tracker.m_center += (y - tracker.m_center) / 64.0f;
+    tracker.m_amplitude += (fabsf(y - tracker.m_center) - tracker.m_amplitude) / 64.0f;
+    tracker.m_lastValue = y;
+    tracker.m_midStrobe = true;
+    tracker.m_nextStrobe += tracker.m_halfPeriod + 0.1f * error;
+
+    // sync correlation on the symbol signs like the main chain sync symbol buffer
+
+    tracker.m_syncBits = (tracker.m_syncBits << 1) | (y > 0.0f ? 1 : 0);
+
+    if (tracker.m_nbSymbols < m_warmupSymbols)
+    {
+        tracker.m_nbSymbols++;
+        return false;
+    }
+
+    if (tracker.m_amplitude < m_minAmplitude) {
+        return false;
+    }
+
+    for (int i = 0; i < tracker.m_nbPatterns; i++)
+    {
+        if ((tracker.m_syncBits & tracker.m_patterns[i].m_mask) == tracker.m_patterns[i].m_bits)
+        {
+            tracker.m_syncType = tracker.m_patterns[i].m_syncType;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace DSDcc
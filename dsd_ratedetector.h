@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_RATEDETECTOR_H_
+#define DSDCC_DSD_RATEDETECTOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "dsd_filters.h"
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Multi-rate sync scanner running next to the main symbol chain while it searches for sync.
+ *
+ * For each data rate not followed by the main chain (2400, 4800 or 9600 baud) a lightweight symbol
+ * tracker (decimated matched filter, Farrow interpolator and Gardner loop like DSDSymbol::TimingGardner)
+ * produces the sign of the symbols that is correlated against the sync words of this rate.
+ * The 4800 and 9600 baud trackers share the same 12.5 kHz matched filter.
+ *
+ * When a sync fires the decoder switches its main chain to this rate and replays the recent samples
+ * kept in the history ring so that the full decode chain catches the same sync.
+ */
+class DSDCC_API DSDRateDetector
+{
+public:
+    static const int m_nbRates = 3; //!< rate index is 0: 2400, 1: 4800, 2: 9600 baud as DSDDecoder::DSDRate
+
+    DSDRateDetector();
+    ~DSDRateDetector();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+    /** Returns to the disabled state of construction keeping the sync patterns and the buffers if allocated */
+    void reset();
+    /** Register a sync word given as sync dibits (1 for positive symbols, 3 for negative) for a rate with its DSDDecoder::DSDSyncType */
+    void addSyncPattern(int rateIndex, const unsigned char *syncDibits, int length, int syncType = -1);
+
+    /**
+     * Push a new sample. skipRateIndex is the rate followed by the main chain that is not scanned
+     * or -1 to only record history (frame in progress) or m_nbRates to scan all rates.
+     * Returns the index of the rate which sync fired or -1
+     */
+    int push(short sample, int skipRateIndex);
+
+    /** Number of history samples to replay for a rate and oldest first access to them */
+    int getReplaySize(int rateIndex) const;
+    short getReplaySample(int rateIndex, int i) const
+    {
+        return m_history[(m_historyIndex - getReplaySize(rateIndex) + i + m_historySize) % m_historySize];
+    }
+
+    unsigned long getDetections(int rateIndex) const { return m_trackers[rateIndex].m_detections; }
+    int getSyncType(int rateIndex) const { return m_trackers[rateIndex].m_syncType; } //!< of the last sync fired at this rate
+    size_t getAllocatedSize() const { return m_history ? m_historySize * sizeof(short) + 2 * sizeof(DSDMatchedFilter) : 0; }
+
+private:
+    static const int m_maxPatterns = 24;
+    static const int m_historySize = 4096;  //!< about 85 ms
+    static const int m_replaySymbols = 100; //!< symbols replayed on rate switch
+    static const int m_warmupSymbols = 32;
+    static const float m_minAmplitude;      //!< below this the tracker does not look for sync
+
+    struct SyncPattern
+    {
+        uint32_t m_bits;
+        uint32_t m_mask;
+        int m_syncType;
+    };
+
+    struct Tracker
+    {
+        int m_samplesPerSymbol;    //!< at 48 kS/s
+        int m_decimation;
+        int m_decimationCount;
+        float m_samples[4];        //!< Farrow interpolator input, oldest first
+        float m_halfPeriod;
+        float m_nextStrobe;
+        bool m_midStrobe;
+        float m_midValue;
+        float m_lastValue;
+        float m_center;            //!< running symbol mean
+        float m_amplitude;         //!< running mean of the symbol distance to the center
+        uint32_t m_syncBits;       //!< last symbols signs newest at bit 0 (1 for positive)
+        int m_nbSymbols;           //!< symbols since last reset up to 32
+        SyncPattern m_patterns[m_maxPatterns];
+        int m_nbPatterns;
+        unsigned long m_detections;
+        int m_syncType;            //!< of the last pattern fired
+    };
+
+    void resetTracker(Tracker& tracker);
+    bool pushTracker(Tracker& tracker, short sample); //!< returns true if a sync fired
+
+    bool m_enabled;
+    Tracker m_trackers[m_nbRates];
+    DSDMatchedFilter *m_filter2400;         //!< 6.25 kHz matched filter
+    DSDMatchedFilter *m_filter4800;         //!< 12.5 kHz matched filter shared by 4800 and 9600 baud
+    short *m_history;
+    int m_historyIndex;
+    int m_skipRateIndex;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_RATEDETECTOR_H_ */
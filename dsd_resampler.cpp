@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsd_resampler.h"
+#include "dsd_filters.h"
+
+namespace DSDcc
+{
+
+static int gcd(int a, int b)
+{
+    while (b != 0)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+DSDResampler::DSDResampler() :
+        m_interpolation(1),
+        m_decimation(1),
+        m_tapsPerPhase(1),
+        m_historyIndex(0),
+        m_phase(0)
+{
+    configure(48000, 48000, 1);
+}
+
+DSDResampler::~DSDResampler()
+{
+}
+
+void DSDResampler::configure(int inputRate, int outputRate, int tapsPerPhase)
+{
+    int d = gcd(inputRate, outputRate);
+    m_interpolation = outputRate / d;
+    m_decimation = inputRate / d;
+    m_tapsPerPhase = (m_interpolation == 1) && (m_decimation == 1) ? 1 : tapsPerPhase;
+
+    int nbTaps = m_interpolation * m_tapsPerPhase;
+    std::vector<float> prototype(nbTaps);
+
+    if (nbTaps == 1)
+    {
+        prototype[0] = 1.0f;
+    }
+    else
+    {
+        int maxFactor = m_interpolation > m_decimation ? m_interpolation : m_decimation;
+        DSDFilters::designLowpass(prototype.data(), nbTaps, 0.45f / maxFactor, m_interpolation);
+    }
+
+    m_branches.resize(nbTaps);
+
+    for (int phase = 0; phase < m_interpolation; phase++)
+    {
+        for (int j = 0; j < m_tapsPerPhase; j++) {
+            m_branches[phase * m_tapsPerPhase + j] = prototype[phase + (m_tapsPerPhase - 1 - j) * m_interpolation];
+        }
+    }
+
+    m_history.assign(2 * m_tapsPerPhase, 0.0f);
+    m_scratch.resize(m_interpolation / m_decimation + 1);
+    m_historyIndex = 0;
+    m_phase = 0;
+}
+
+int DSDResampler::process(const float *in, int nbIn, float *out)
+{
+    int nbOut = 0;
+
+    for (int i = 0; i < nbIn; i++) {
+        nbOut += push(in[i], &out[nbOut]);
+    }
+
+    return nbOut;
+}
+
+int DSDResampler::process(const short *in, int nbIn, short *out)
+{
+    int nbOut = 0;
+
+    for (int i = 0; i < nbIn; i++)
+    {
+        int n = push(in[i], m_scratch.data());
+
+        for (int j = 0; j < n; j++)
+        {
+            float v = m_scratch[j];
+            out[nbOut++] = v > 32767.0f ? 32767 : v < -32768.0f ? -32768 : (short) v;
+        }
+    }
+
+    return nbOut;
+}
+
+} // namespace DSDcc
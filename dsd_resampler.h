@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_RESAMPLER_H_
+#define DSDCC_DSD_RESAMPLER_H_
+
+#include <stddef.h>
+#include <vector>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Rational polyphase resampler. The rate ratio is reduced to L/M (interpolation by L then decimation
+ * by M) and only the output samples are computed using the L branches of the prototype lowpass filter.
+ */
+class DSDCC_API DSDResampler
+{
+public:
+    DSDResampler();
+    ~DSDResampler();
+
+    /** Configure for the given rates in S/s. tapsPerPhase sets the quality (length of each branch) */
+    void configure(int inputRate, int outputRate, int tapsPerPhase = 16);
+    int getInterpolation() const { return m_interpolation; }
+    int getDecimation() const { return m_decimation; }
+    bool isBypass() const { return (m_interpolation == 1) && (m_decimation == 1); }
+    /** Maximum number of output samples produced for the given number of input samples */
+    int getMaxOutput(int nbInput) const { return (nbInput * m_interpolation) / m_decimation + 1; }
+
+    size_t getAllocatedSize() const { return (m_branches.size() + m_history.size() + m_scratch.size()) * sizeof(float); }
+
+    /** Returns the number of output samples */
+    int process(const float *in, int nbIn, float *out);
+    int process(const short *in, int nbIn, short *out);
+
+    /** In flow version. Push one input sample and return the number (0 or more) of output samples */
+    int push(float sample, float *out)
+    {
+        m_history[m_historyIndex] = sample;
+        m_history[m_historyIndex + m_tapsPerPhase] = sample;
+        const float *window = &m_history[m_historyIndex + 1];
+        m_historyIndex = (m_historyIndex + 1) % m_tapsPerPhase;
+        int nbOut = 0;
+
+        while (m_phase < m_interpolation)
+        {
+            const float *branch = &m_branches[m_phase * m_tapsPerPhase];
+            float acc = 0.0f;
+
+            for (int j = 0; j < m_tapsPerPhase; j++) {
+                acc += branch[j] * window[j];
+            }
+
+            out[nbOut++] = acc;
+            m_phase += m_decimation;
+        }
+
+        m_phase -= m_interpolation;
+        return nbOut;
+    }
+
+private:
+    int m_interpolation;
+    int m_decimation;
+    int m_tapsPerPhase;
+    std::vector<float> m_branches; //!< L branches of tapsPerPhase coefficients in reverse order
+    std::vector<float> m_history;  //!< last tapsPerPhase input samples stored twice for contiguous access
+    int m_historyIndex;
+    int m_phase;
+    std::vector<float> m_scratch;  //!< output of one input sample for the short version
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_RESAMPLER_H_ */
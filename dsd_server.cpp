@@ -0,0 +1,582 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include "dsd_decoder.h"
+#include "dsd_channelpool.h"
+#include "dsd_channelizer.h"
+#include "dsd_symbolbatch.h"
+#include "timeutil.h"
+
+static std::atomic<int> exitflag(0);
+
+/** Writes the decoded audio frames of one channel to its output file */
+class ChannelWriter : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    ChannelWriter() : m_fp(0) {}
+    virtual ~ChannelWriter()
+    {
+        if (m_fp) {
+            fclose(m_fp);
+        }
+    }
+
+    bool open(const char *fileName)
+    {
+        m_fp = fopen(fileName, "wb");
+        return m_fp != 0;
+    }
+
+    virtual void audioFrame(int slot __attribute__((unused)), const short *samples, int nbSamples, uint64_t timestamp __attribute__((unused)))
+    {
+        if (m_fp) {
+            fwrite(samples, sizeof(short), nbSamples, m_fp);
+        }
+    }
+
+private:
+    FILE *m_fp;
+};
+
+/** An input file carrying one or more channels of interleaved S16LE samples at 48 kS/s */
+struct Input
+{
+    std::string m_fileName;
+    int m_sampleRate;
+    int m_nbChannels;
+    int m_firstChannel;
+};
+
+/** A wideband complex input split into channels by a polyphase channelizer */
+struct WidebandInput
+{
+    std::string m_fileName;
+    bool m_floatFormat;               //!< cf32 else cs16
+    int m_sampleRate;
+    int m_channelSpacing;
+    long m_centerFrequency;
+    std::vector<long> m_frequencies;  //!< absolute frequencies of the decoded channels
+    int m_firstChannel;
+};
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc-server [options] [-n <num>] -i <input> ... [-r <rate> -s <spacing> -c <freq>] -W <input> -C <freq> ...\n");
+    fprintf(stderr, "Hosts several DSDcc decoders on a pool of worker threads\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -n <num>      Number of interleaved channels in the next inputs (default 1)\n");
+    fprintf(stderr, "  -R <rate>     Sample rate of the next inputs in S/s (default 48000)\n");
+    fprintf(stderr, "  -i <file>     Add an input file or FIFO of S16LE FM discriminator samples (- for stdin)\n");
+    fprintf(stderr, "  -r <rate>     Sample rate of the next wideband IQ inputs in S/s (default 250000)\n");
+    fprintf(stderr, "  -s <spacing>  Channel spacing of the next wideband IQ inputs in Hz (default 12500)\n");
+    fprintf(stderr, "  -c <freq>     Center frequency of the next wideband IQ inputs in Hz (default 0)\n");
+    fprintf(stderr, "  -F <format>   Format of the next wideband IQ inputs: cs16 (default) or cf32\n");
+    fprintf(stderr, "  -W <file>     Add a wideband IQ input file or FIFO (- for stdin)\n");
+    fprintf(stderr, "  -C <freq>     Decode the channel at this frequency in Hz of the last wideband input\n");
+    fprintf(stderr, "  -o <pattern>  Audio output file name pattern with %%d replaced by the channel index (default none)\n");
+    fprintf(stderr, "  -f <mode>     Frame type for all channels as in dsdccx (default auto)\n");
+    fprintf(stderr, "  -w <num>      Number of worker threads (default number of CPUs)\n");
+    fprintf(stderr, "  -p            Pin worker threads to CPUs (Linux only)\n");
+    fprintf(stderr, "  -b <num>      Number of samples per block (default 960 = 20ms)\n");
+    fprintf(stderr, "  -z            Skip symbol recovery and sync search while the channel is idle\n");
+    fprintf(stderr, "  -S            Decode the channels of multi-channel 48 kS/s inputs by batches of 16 on the reader thread\n");
+    fprintf(stderr, "                with a vectorized symbol front end instead of the worker pool\n");
+    fprintf(stderr, "\n");
+}
+
+static void sigfun(int sig __attribute__((unused)))
+{
+    exitflag = 1;
+    signal(SIGINT, SIG_DFL);
+}
+
+static void setDecodeMode(DSDcc::DSDDecoder& dsdDecoder, char mode)
+{
+    dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
+
+    switch (mode)
+    {
+    case 'r':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDMR, true);
+        break;
+    case 'd':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDStar, true);
+        break;
+    case 'x':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeX2TDMA, true);
+        break;
+    case 'p':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeProVoice, true);
+        break;
+    case '0':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeP25P1, true);
+        break;
+    case 'i':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN48, true);
+        break;
+    case 'n':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNXDN96, true);
+        break;
+    case 'm':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeDPMR, true);
+        break;
+    case 'y':
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeYSF, true);
+        break;
+    case 'A':
+        dsdDecoder.enableMultiRateAuto(true);
+        break;
+    default:
+        dsdDecoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeAuto, true);
+        break;
+    }
+}
+
+/** Reads an input and dispatches its de-interleaved blocks to the channels */
+static void readInput(const Input& input, DSDcc::DSDChannelPool& pool, int blockSize)
+{
+    FILE *fp = (input.m_fileName == "-") ? stdin : fopen(input.m_fileName.c_str(), "rb");
+
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open %s for input\n", input.m_fileName.c_str());
+        return;
+    }
+
+    std::vector<short> interleaved(blockSize * input.m_nbChannels);
+    std::vector<short> block(blockSize);
+
+    while (!exitflag)
+    {
+        int nbFrames = fread(interleaved.data(), sizeof(short) * input.m_nbChannels, blockSize, fp);
+
+        if (nbFrames <= 0) {
+            break;
+        }
+
+        for (int c = 0; c < input.m_nbChannels; c++)
+        {
+            for (int i = 0; i < nbFrames; i++) {
+                block[i] = interleaved[i * input.m_nbChannels + c];
+            }
+
+            pool.push(input.m_firstChannel + c, block.data(), nbFrames);
+        }
+    }
+
+    if (fp != stdin) {
+        fclose(fp);
+    }
+}
+
+/**
+ * Reads a multi-channel input and decodes its channels in lockstep by batches of up to 16 channels
+ * sharing a vectorized symbol front end (DSDSymbolBatch). The CPU time of a batch is shared evenly by its channels
+ */
+static void readBatchedInput(const Input& input, DSDcc::DSDChannelPool& pool, int blockSize,
+        std::vector<uint64_t>& channelSamples, std::vector<uint64_t>& channelCpuUs)
+{
+    int nbBatches = (input.m_nbChannels + DSDcc::DSDSymbolBatch::m_maxLanes - 1) / DSDcc::DSDSymbolBatch::m_maxLanes;
+    std::vector<DSDcc::DSDSymbolBatch*> batches(nbBatches);
+
+    for (int c = 0; c < input.m_nbChannels; c++)
+    {
+        int b = c / DSDcc::DSDSymbolBatch::m_maxLanes;
+
+        if (!batches[b]) {
+            batches[b] = new DSDcc::DSDSymbolBatch();
+        }
+
+        if (batches[b]->addDecoder(&pool.getDecoder(input.m_firstChannel + c)) < 0)
+        {
+            fprintf(stderr, "Channel %d cannot be batched\n", input.m_firstChannel + c);
+            exitflag = 1;
+        }
+    }
+
+    FILE *fp = (input.m_fileName == "-") ? stdin : fopen(input.m_fileName.c_str(), "rb");
+
+    if (!fp) {
+        fprintf(stderr, "Cannot open %s for input\n", input.m_fileName.c_str());
+    }
+
+    std::vector<short> interleaved(blockSize * input.m_nbChannels);
+    std::vector<short> lanes(blockSize * DSDcc::DSDSymbolBatch::m_maxLanes);
+
+    while (fp && !exitflag)
+    {
+        int nbFrames = fread(interleaved.data(), sizeof(short) * input.m_nbChannels, blockSize, fp);
+
+        if (nbFrames <= 0) {
+            break;
+        }
+
+        for (int b = 0; b < nbBatches; b++)
+        {
+            int firstLane = b * DSDcc::DSDSymbolBatch::m_maxLanes;
+            int nbLanes = batches[b]->getNbLanes();
+            uint64_t startUs = DSDcc::TimeUtil::threadCpuUs();
+
+            for (int i = 0; i < nbFrames; i++)
+            {
+                for (int lane = 0; lane < nbLanes; lane++) {
+                    lanes[i * nbLanes + lane] = interleaved[i * input.m_nbChannels + firstLane + lane];
+                }
+            }
+
+            for (int i = 0; i < nbFrames;) {
+                i += batches[b]->run(&lanes[i * nbLanes], nbFrames - i);
+            }
+
+            uint64_t cpuUs = DSDcc::TimeUtil::threadCpuUs() - startUs;
+
+            for (int lane = 0; lane < nbLanes; lane++)
+            {
+                channelSamples[input.m_firstChannel + firstLane + lane] += nbFrames;
+                channelCpuUs[input.m_firstChannel + firstLane + lane] += cpuUs / nbLanes;
+            }
+        }
+    }
+
+    if (fp && (fp != stdin)) {
+        fclose(fp);
+    }
+
+    for (int b = 0; b < nbBatches; b++) {
+        delete batches[b];
+    }
+}
+
+/** Reads a wideband input, channelizes it and dispatches the discriminator samples to the channels */
+static void readWidebandInput(const WidebandInput& input, DSDcc::DSDChannelPool& pool, int blockSize)
+{
+    DSDcc::DSDChannelizer channelizer;
+
+    if (!channelizer.configure(input.m_sampleRate, input.m_channelSpacing))
+    {
+        fprintf(stderr, "Sample rate %d is not a multiple of channel spacing %d\n", input.m_sampleRate, input.m_channelSpacing);
+        return;
+    }
+
+    std::vector<int> channelIndexes;
+
+    for (std::vector<long>::const_iterator it = input.m_frequencies.begin(); it != input.m_frequencies.end(); ++it)
+    {
+        int index = channelizer.getChannelIndex(*it - input.m_centerFrequency);
+        channelIndexes.push_back(index);
+
+        if (index < 0) {
+            fprintf(stderr, "Frequency %ld out of band\n", *it);
+        } else {
+            channelizer.enableChannel(index, true);
+        }
+    }
+
+    FILE *fp = (input.m_fileName == "-") ? stdin : fopen(input.m_fileName.c_str(), "rb");
+
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open %s for input\n", input.m_fileName.c_str());
+        return;
+    }
+
+    // same duration as the blocks of discriminator samples
+    int nbSamples = (int) (((long) blockSize * input.m_sampleRate) / 48000);
+    std::vector<short> iq16(input.m_floatFormat ? 0 : 2 * nbSamples);
+    std::vector<float> iq32(input.m_floatFormat ? 2 * nbSamples : 0);
+
+    while (!exitflag)
+    {
+        int nbRead;
+
+        if (input.m_floatFormat)
+        {
+            nbRead = fread(iq32.data(), 2 * sizeof(float), nbSamples, fp);
+            channelizer.process(iq32.data(), nbRead > 0 ? nbRead : 0);
+        }
+        else
+        {
+            nbRead = fread(iq16.data(), 2 * sizeof(short), nbSamples, fp);
+            channelizer.process(iq16.data(), nbRead > 0 ? nbRead : 0);
+        }
+
+        if (nbRead <= 0) {
+            break;
+        }
+
+        for (unsigned int i = 0; i < channelIndexes.size(); i++)
+        {
+            if (channelIndexes[i] < 0) {
+                continue;
+            }
+
+            const std::vector<short>& output = channelizer.getChannelOutput(channelIndexes[i]);
+
+            if (output.size() > 0) {
+                pool.push(input.m_firstChannel + i, output.data(), output.size());
+            }
+        }
+    }
+
+    if (fp != stdin) {
+        fclose(fp);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    std::vector<Input> inputs;
+    std::vector<WidebandInput> widebandInputs;
+    int widebandRate = 250000;
+    int widebandSpacing = 12500;
+    long widebandCenter = 0;
+    bool widebandFloat = false;
+    int nbChannels = 0;
+    int inputChannels = 1;
+    int inputRate = 48000;
+    std::string outputPattern;
+    char mode = 'a';
+    int nbWorkers = 0;
+    bool pinWorkers = false;
+    int blockSize = 960;
+    bool idleGate = false;
+    bool batched = false;
+
+    fprintf(stderr, "Digital Speech Decoder DSDcc server\n");
+
+    while ((c = getopt(argc, argv, "hn:R:i:r:s:c:F:W:C:o:f:w:pb:zS")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'n':
+            inputChannels = atoi(optarg);
+            inputChannels = inputChannels < 1 ? 1 : inputChannels;
+            break;
+        case 'R':
+            inputRate = atoi(optarg);
+            inputRate = inputRate < 8000 ? 48000 : inputRate;
+            break;
+        case 'i':
+        {
+            Input input;
+            input.m_fileName = optarg;
+            input.m_sampleRate = inputRate;
+            input.m_nbChannels = inputChannels;
+            input.m_firstChannel = nbChannels;
+            inputs.push_back(input);
+            nbChannels += inputChannels;
+            break;
+        }
+        case 'r':
+            widebandRate = atoi(optarg);
+            break;
+        case 's':
+            widebandSpacing = atoi(optarg);
+            break;
+        case 'c':
+            widebandCenter = atol(optarg);
+            break;
+        case 'F':
+            widebandFloat = (strcmp(optarg, "cf32") == 0);
+            break;
+        case 'W':
+        {
+            WidebandInput input;
+            input.m_fileName = optarg;
+            input.m_floatFormat = widebandFloat;
+            input.m_sampleRate = widebandRate;
+            input.m_channelSpacing = widebandSpacing;
+            input.m_centerFrequency = widebandCenter;
+            widebandInputs.push_back(input);
+            break;
+        }
+        case 'C':
+            if (widebandInputs.size() == 0)
+            {
+                fprintf(stderr, "-C must follow a -W option\n");
+                return 1;
+            }
+            widebandInputs.back().m_frequencies.push_back(atol(optarg));
+            break;
+        case 'o':
+            outputPattern = optarg;
+            break;
+        case 'f':
+            mode = optarg[0];
+            break;
+        case 'w':
+            nbWorkers = atoi(optarg);
+            break;
+        case 'p':
+            pinWorkers = true;
+            break;
+        case 'b':
+            blockSize = atoi(optarg);
+            blockSize = blockSize < 1 ? 960 : blockSize;
+            break;
+        case 'z':
+            idleGate = true;
+            break;
+        case 'S':
+            batched = true;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    for (std::vector<WidebandInput>::iterator it = widebandInputs.begin(); it != widebandInputs.end(); ++it)
+    {
+        it->m_firstChannel = nbChannels;
+        nbChannels += it->m_frequencies.size();
+    }
+
+    if (nbChannels == 0)
+    {
+        usage();
+        return 1;
+    }
+
+    size_t channelPos = outputPattern.find("%d");
+
+    bool onlyChannelPos = (channelPos != std::string::npos) && (outputPattern.find('%') == channelPos)
+        && (outputPattern.find('%', channelPos + 2) == std::string::npos); // the pattern is not a printf format
+
+    if ((outputPattern.size() > 0) && !onlyChannelPos)
+    {
+        fprintf(stderr, "The output pattern must contain %%d once and no other %%. Aborting\n");
+        return 1;
+    }
+
+    DSDcc::DSDChannelPool pool(nbWorkers, pinWorkers);
+    std::vector<ChannelWriter> writers(nbChannels);
+
+    std::vector<int> channelRates(nbChannels, 48000);
+    std::vector<bool> channelBatched(nbChannels, false);
+    std::vector<uint64_t> batchedSamples(nbChannels, 0);
+    std::vector<uint64_t> batchedCpuUs(nbChannels, 0);
+
+    for (std::vector<Input>::const_iterator it = inputs.begin(); it != inputs.end(); ++it)
+    {
+        for (int i = 0; i < it->m_nbChannels; i++)
+        {
+            pool.addChannel();
+            pool.getDecoder(it->m_firstChannel + i).setInputSampleRate(it->m_sampleRate);
+            channelRates[it->m_firstChannel + i] = it->m_sampleRate;
+            channelBatched[it->m_firstChannel + i] = batched && !idleGate && (it->m_nbChannels > 1) && (it->m_sampleRate == 48000);
+        }
+    }
+
+    for (int i = 0; i < nbChannels; i++)
+    {
+        if (i >= pool.getNbChannels()) {
+            pool.addChannel();
+        }
+
+        DSDcc::DSDDecoder& dsdDecoder = pool.getDecoder(i);
+        dsdDecoder.setQuiet();
+        dsdDecoder.setLogVerbosity(0);
+        setDecodeMode(dsdDecoder, mode);
+        dsdDecoder.enableIdleGate(idleGate);
+
+        if (outputPattern.size() > 0)
+        {
+            std::string fileName = outputPattern.substr(0, channelPos) + std::to_string(i) + outputPattern.substr(channelPos + 2);
+
+            if (!writers[i].open(fileName.c_str())) {
+                fprintf(stderr, "Cannot open %s for output\n", fileName.c_str());
+            }
+        }
+
+        dsdDecoder.setAudioSink(&writers[i]);
+    }
+
+    fprintf(stderr, "%d channels on %d workers\n", nbChannels, pool.getNbWorkers());
+    signal(SIGINT, sigfun);
+
+    uint64_t startUs = DSDcc::TimeUtil::nowus();
+    pool.start();
+    std::vector<std::thread> readers;
+
+    for (std::vector<Input>::const_iterator it = inputs.begin(); it != inputs.end(); ++it)
+    {
+        if (channelBatched[it->m_firstChannel]) {
+            readers.push_back(std::thread(readBatchedInput, std::cref(*it), std::ref(pool), blockSize, std::ref(batchedSamples), std::ref(batchedCpuUs)));
+        } else {
+            readers.push_back(std::thread(readInput, std::cref(*it), std::ref(pool), blockSize));
+        }
+    }
+
+    for (std::vector<WidebandInput>::const_iterator it = widebandInputs.begin(); it != widebandInputs.end(); ++it) {
+        readers.push_back(std::thread(readWidebandInput, std::cref(*it), std::ref(pool), blockSize));
+    }
+
+    for (std::vector<std::thread>::iterator it = readers.begin(); it != readers.end(); ++it) {
+        it->join();
+    }
+
+    pool.stop();
+    double elapsed = (DSDcc::TimeUtil::nowus() - startUs) / 1e6;
+    double totalCpu = 0.0;
+
+    fprintf(stderr, "channel  samples   input(s)  cpu(ms)  cpu/input(%%)  frames\n");
+
+    for (int i = 0; i < nbChannels; i++)
+    {
+        uint64_t nbSamples = channelBatched[i] ? batchedSamples[i] : pool.getChannelSamples(i);
+        double inputSeconds = nbSamples / (double) channelRates[i];
+        double cpuSeconds = (channelBatched[i] ? batchedCpuUs[i] : pool.getChannelCpuUs(i)) / 1e6;
+        totalCpu += cpuSeconds;
+        DSDcc::DSDStats::Snapshot stats;
+        pool.getDecoder(i).getStats().getSnapshot(stats);
+        fprintf(stderr, "%7d %9lu %10.2f %8.1f %13.3f %7u\n",
+                i,
+                (unsigned long) nbSamples,
+                inputSeconds,
+                cpuSeconds * 1e3,
+                inputSeconds > 0.0 ? 100.0 * cpuSeconds / inputSeconds : 0.0,
+                (unsigned int) stats.m_mbeFrames);
+    }
+
+    for (int i = 0; i < pool.getNbWorkers(); i++) {
+        fprintf(stderr, "worker %d: %lu tasks %lu steals\n", i, (unsigned long) pool.getWorkerTasks(i), (unsigned long) pool.getWorkerSteals(i));
+    }
+
+    fprintf(stderr, "Total CPU %.3f s in %.3f s\n", totalCpu, elapsed);
+
+    for (int i = 0; i < nbChannels; i++) { // decoders are destroyed with the pool after the writers
+        pool.getDecoder(i).setAudioSink(0);
+    }
+
+    return 0;
+}
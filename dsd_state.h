@@ -21,7 +21,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "p25p1_heuristics.h"
 #include "export.h"
 
 namespace DSDcc
@@ -34,22 +33,15 @@ public:
     ~DSDState();
 
     int repeat;
-    int maxbuf[1024];
-    int minbuf[1024];
-    int midx;
     char fsubtype[16];
     char ftype[16];
     int symbolcnt;
     int lastp25type;
     int offset;
     int carrier;
-    char tg[25][16];
-    int tgcount;
     int lasttg;
     int lastsrc;
     int nac;
-    int mbe_file_type;
-    int optind;
     int numtdulc;
     int firstframe;
     char slot0light[27];
@@ -58,16 +50,6 @@ public:
     char algid[9];
     char keyid[17];
     int currentslot;
-    int p25kid;
-    DSDP25Heuristics::P25Heuristics p25_heuristics;     //!< Heuristics state data for +P5 signals
-    DSDP25Heuristics::P25Heuristics inv_p25_heuristics; //!< Heuristics state data for -P5 signals
-
-    short *output_buffer;
-    int output_offset;
-    float *output_samples;
-    int output_num_samples;
-    int output_length;
-    int output_finished;
 };
 
 } // namespace dsdcc
@@ -0,0 +1,382 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "dsd_statebuffer.h"
+
+namespace DSDcc
+{
+
+DSDStateBuffer::DSDStateBuffer(std::vector<unsigned char>& data) :
+    m_data(&data),
+    m_readData(0),
+    m_size(0),
+    m_readIndex(0),
+    m_sectionEnd(0),
+    m_inSection(false),
+    m_valid(true)
+{}
+
+DSDStateBuffer::DSDStateBuffer(const unsigned char *data, unsigned int size) :
+    m_data(0),
+    m_readData(data),
+    m_size(size),
+    m_readIndex(0),
+    m_sectionEnd(size),
+    m_inSection(false),
+    m_valid(true)
+{}
+
+void DSDStateBuffer::writeU8(uint8_t value)
+{
+    m_data->push_back(value);
+}
+
+void DSDStateBuffer::writeU16(uint16_t value)
+{
+    m_data->push_back(value & 0xff);
+    m_data->push_back(value >> 8);
+}
+
+void DSDStateBuffer::writeU32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++, value >>= 8) {
+        m_data->push_back(value & 0xff);
+    }
+}
+
+void DSDStateBuffer::writeU64(uint64_t value)
+{
+    for (int i = 0; i < 8; i++, value >>= 8) {
+        m_data->push_back(value & 0xff);
+    }
+}
+
+void DSDStateBuffer::writeFloat(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    writeU32(bits);
+}
+
+void DSDStateBuffer::writeBytes(const void *bytes, unsigned int size)
+{
+    const unsigned char *p = (const unsigned char *) bytes;
+    m_data->insert(m_data->end(), p, p + size);
+}
+
+void DSDStateBuffer::writeString(const char *text)
+{
+    unsigned int length = strlen(text);
+
+    if (length > 255) {
+        length = 255;
+    }
+
+    writeU8(length);
+    writeBytes(text, length);
+}
+
+void DSDStateBuffer::writeBits(const unsigned char *bits, unsigned int nbBits)
+{
+    for (unsigned int i = 0; i < nbBits; i += 8)
+    {
+        uint8_t byte = 0;
+
+        for (unsigned int j = 0; (j < 8) && (i + j < nbBits); j++) {
+            byte |= (bits[i + j] & 1) << j;
+        }
+
+        writeU8(byte);
+    }
+}
+
+void DSDStateBuffer::writeDibits(const unsigned char *dibits, unsigned int nbDibits)
+{
+    for (unsigned int i = 0; i < nbDibits; i += 4)
+    {
+        uint8_t byte = 0;
+
+        for (unsigned int j = 0; (j < 4) && (i + j < nbDibits); j++) {
+            byte |= (dibits[i + j] & 3) << (2*j);
+        }
+
+        writeU8(byte);
+    }
+}
+
+bool DSDStateBuffer::readable(unsigned int size)
+{
+    if (m_valid && (m_readIndex + size <= m_sectionEnd)) {
+        return true;
+    }
+
+    m_valid = false;
+    return false;
+}
+
+uint8_t DSDStateBuffer::readU8()
+{
+    return readable(1) ? m_readData[m_readIndex++] : 0;
+}
+
+uint8_t DSDStateBuffer::readU8(uint8_t maxValue)
+{
+    uint8_t value = readU8();
+
+    if (value > maxValue)
+    {
+        m_valid = false; // state of a later version or forged: the caller must not switch or index on it
+        return 0;
+    }
+
+    return value;
+}
+
+uint16_t DSDStateBuffer::readU16()
+{
+    if (!readable(2)) {
+        return 0;
+    }
+
+    uint16_t value = m_readData[m_readIndex] + (m_readData[m_readIndex+1] << 8);
+    m_readIndex += 2;
+    return value;
+}
+
+uint16_t DSDStateBuffer::readU16(uint16_t maxValue)
+{
+    uint16_t value = readU16();
+
+    if (value > maxValue)
+    {
+        m_valid = false;
+        return 0;
+    }
+
+    return value;
+}
+
+uint32_t DSDStateBuffer::readU32()
+{
+    if (!readable(4)) {
+        return 0;
+    }
+
+    uint32_t value = 0;
+
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) + m_readData[m_readIndex + i];
+    }
+
+    m_readIndex += 4;
+    return value;
+}
+
+uint64_t DSDStateBuffer::readU64()
+{
+    if (!readable(8)) {
+        return 0;
+    }
+
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) + m_readData[m_readIndex + i];
+    }
+
+    m_readIndex += 8;
+    return value;
+}
+
+float DSDStateBuffer::readFloat()
+{
+    uint32_t bits = readU32();
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+int DSDStateBuffer::readInt(int minValue, int maxValue)
+{
+    int value = readInt();
+
+    if ((value < minValue) || (value > maxValue))
+    {
+        m_valid = false;
+        return minValue;
+    }
+
+    return value;
+}
+
+float DSDStateBuffer::readFloat(float minValue, float maxValue)
+{
+    float value = readFloat();
+
+    if (!((value >= minValue) && (value <= maxValue))) // also true for a NaN
+    {
+        m_valid = false;
+        return minValue;
+    }
+
+    return value;
+}
+
+void DSDStateBuffer::readBytes(void *bytes, unsigned int size)
+{
+    if (readable(size))
+    {
+        memcpy(bytes, &m_readData[m_readIndex], size);
+        m_readIndex += size;
+    }
+    else
+    {
+        memset(bytes, 0, size);
+    }
+}
+
+void DSDStateBuffer::readString(char *text, unsigned int maxSize)
+{
+    unsigned int length = readU8();
+
+    if (!readable(length))
+    {
+        text[0] = '\0';
+        return;
+    }
+
+    unsigned int copied = length < maxSize - 1 ? length : maxSize - 1;
+    memcpy(text, &m_readData[m_readIndex], copied);
+    text[copied] = '\0';
+    m_readIndex += length;
+}
+
+void DSDStateBuffer::readBits(unsigned char *bits, unsigned int nbBits)
+{
+    for (unsigned int i = 0; i < nbBits; i += 8)
+    {
+        uint8_t byte = readU8();
+
+        for (unsigned int j = 0; (j < 8) && (i + j < nbBits); j++) {
+            bits[i + j] = (byte >> j) & 1;
+        }
+    }
+}
+
+void DSDStateBuffer::readDibits(unsigned char *dibits, unsigned int nbDibits)
+{
+    for (unsigned int i = 0; i < nbDibits; i += 4)
+    {
+        uint8_t byte = readU8();
+
+        for (unsigned int j = 0; (j < 4) && (i + j < nbDibits); j++) {
+            dibits[i + j] = (byte >> (2*j)) & 3;
+        }
+    }
+}
+
+unsigned int DSDStateBuffer::beginSection(Section section)
+{
+    writeU8((uint8_t) section);
+    unsigned int lengthPosition = m_data->size();
+    writeU16(0);
+    return lengthPosition;
+}
+
+void DSDStateBuffer::endSection(unsigned int lengthPosition)
+{
+    unsigned int length = m_data->size() - lengthPosition - 2;
+    (*m_data)[lengthPosition] = length & 0xff;
+    (*m_data)[lengthPosition+1] = (length >> 8) & 0xff;
+}
+
+bool DSDStateBuffer::nextSection(int& tag)
+{
+    if (!m_valid) {
+        return false;
+    }
+
+    if (m_inSection) {
+        m_readIndex = m_sectionEnd; // skips what was not read of the previous section
+    }
+
+    m_sectionEnd = m_size;
+    m_inSection = false;
+
+    if (atEnd()) {
+        return false;
+    }
+
+    tag = readU8();
+    unsigned int length = readU16();
+
+    if (!readable(length)) {
+        return false;
+    }
+
+    m_sectionEnd = m_readIndex + length;
+    m_inSection = true;
+    return true;
+}
+
+void DSDStateBuffer::writeEnd()
+{
+    uint32_t sum = checksum(m_data->data(), m_data->size());
+    unsigned int section = beginSection(SectionEnd);
+    writeU32(sum);
+    endSection(section);
+}
+
+bool DSDStateBuffer::checkEnd() const
+{
+    unsigned int index = m_readIndex;
+
+    while (index + 3 <= m_size)
+    {
+        int tag = m_readData[index];
+        unsigned int length = m_readData[index+1] + (m_readData[index+2] << 8);
+
+        if (index + 3 + length > m_size) {
+            return false;
+        }
+
+        if (tag == SectionEnd)
+        {
+            const unsigned char *p = &m_readData[index + 3];
+            uint32_t sum = p[0] + (p[1] << 8) + (p[2] << 16) + ((uint32_t) p[3] << 24);
+            return (length == 4) && (index + 3 + length == m_size) && (sum == checksum(m_readData, index));
+        }
+
+        index += 3 + length;
+    }
+
+    return false;
+}
+
+uint32_t DSDStateBuffer::checksum(const unsigned char *data, unsigned int size)
+{
+    uint32_t hash = 2166136261U;
+
+    for (unsigned int i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+
+    return hash;
+}
+
+} // namespace DSDcc
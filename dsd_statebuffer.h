@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_STATEBUFFER_H_
+#define DSDCC_DSD_STATEBUFFER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Serialization of the decoder tracking state (see DSDDecoder::saveState).
+ *
+ * Values are written little endian into sections made of a one byte tag and a 16 bit
+ * length so that a reader can skip the sections it does not know and the fields appended
+ * at the end of a section by a later version. A read past the end of the data or of the
+ * current section returns 0 and makes the buffer invalid: the caller checks isValid() once
+ * at the end instead of after each read. The bounded reads (enums, indexes, counts) do the
+ * same with a value out of their range and return their lower bound so that it can still be
+ * used safely until then. The last section holds a checksum of the data before it so that a
+ * truncated or damaged state can be rejected with checkEnd() before any of it is used. The
+ * range checks catch the states of later versions and forged ones that the checksum does not.
+ */
+class DSDCC_API DSDStateBuffer
+{
+public:
+    typedef enum
+    {
+        SectionDecoder = 1,
+        SectionSymbol,
+        SectionMBE1,
+        SectionMBE2,
+        SectionDMR,
+        SectionDStar,
+        SectionYSF,
+        SectionDPMR,
+        SectionNXDN,
+        SectionCalls,
+        SectionEnd = 0xFF //!< checksum of the state, always last
+    } Section;
+
+    explicit DSDStateBuffer(std::vector<unsigned char>& data);  //!< appends to data
+    DSDStateBuffer(const unsigned char *data, unsigned int size); //!< reads data
+
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeInt(int value) { writeU32((uint32_t) value); }
+    void writeBool(bool value) { writeU8(value ? 1 : 0); }
+    void writeFloat(float value);
+    void writeBytes(const void *bytes, unsigned int size);
+    void writeString(const char *text); //!< up to 255 characters
+    void writeBits(const unsigned char *bits, unsigned int nbBits);       //!< one bit per byte packed by 8
+    void writeDibits(const unsigned char *dibits, unsigned int nbDibits); //!< one dibit per byte packed by 4
+
+    uint8_t readU8();
+    uint16_t readU16();
+    uint32_t readU32();
+    uint64_t readU64();
+    int readInt() { return (int) readU32(); }
+    bool readBool() { return readU8() != 0; }
+    /** Enum stored in a byte. A value above lastValue makes the buffer invalid and reads as 0 */
+    uint8_t readEnum(uint8_t lastValue) { return readU8(lastValue); }
+    uint8_t readU8(uint8_t maxValue);             //!< index or count up to maxValue
+    uint16_t readU16(uint16_t maxValue);          //!< index or count up to maxValue
+    int readInt(int minValue, int maxValue);      //!< index or count in [minValue, maxValue]
+    float readFloat();
+    float readFloat(float minValue, float maxValue); //!< a NaN is out of range
+    void readBytes(void *bytes, unsigned int size);
+    void readString(char *text, unsigned int maxSize); //!< truncated to maxSize - 1 characters and null terminated
+    void readBits(unsigned char *bits, unsigned int nbBits);
+    void readDibits(unsigned char *dibits, unsigned int nbDibits);
+
+    /** Starts a section and returns the position of its length completed by endSection */
+    unsigned int beginSection(Section section);
+    void endSection(unsigned int lengthPosition);
+    /** Moves to the next section and gives its tag. False at the end of the data or if it is truncated */
+    bool nextSection(int& tag);
+    /** Closes the state with the end section holding the checksum of the data written before it */
+    void writeEnd();
+    /** Checks without reading that the sections from the read position are complete and end with a matching checksum */
+    bool checkEnd() const;
+
+    /** Makes the buffer invalid on a value that does not fit with the ones read before it */
+    void reject() { m_valid = false; }
+    bool isValid() const { return m_valid; }
+    bool atEnd() const { return m_readIndex >= m_size; }
+
+private:
+    bool readable(unsigned int size);
+    static uint32_t checksum(const unsigned char *data, unsigned int size); //!< FNV-1a
+
+    std::vector<unsigned char> *m_data;
+    const unsigned char *m_readData;
+    unsigned int m_size;
+    unsigned int m_readIndex;
+    unsigned int m_sectionEnd;
+    bool m_inSection;
+    bool m_valid;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_STATEBUFFER_H_ */
@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsd_stats.h"
+
+namespace DSDcc
+{
+
+const char *DSDStats::m_fecNames[DSDStats::FECCount] = {
+    "Hamming_7_4",
+    "Hamming_12_8",
+    "Hamming_16_11_4",
+    "Golay_20_8",
+    "Golay_24_12",
+    "QR_16_7_6",
+    "GolayMBE",
+    "HammingMBE"
+};
+
+const char *DSDStats::m_crcNames[DSDStats::CRCCount] = {
+    "D-Star",
+    "dPMR",
+    "YSF",
+    "NXDN"
+};
+
+DSDStats::DSDStats()
+{
+    reset();
+}
+
+void DSDStats::reset()
+{
+    for (int i = 0; i < NbSyncTypes; i++) {
+        m_syncs[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < FECCount; i++)
+    {
+        m_fecBlocks[i].store(0, std::memory_order_relaxed);
+        m_fecCorrected[i].store(0, std::memory_order_relaxed);
+        m_fecUncorrectable[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < CRCCount; i++)
+    {
+        m_crcPass[i].store(0, std::memory_order_relaxed);
+        m_crcFail[i].store(0, std::memory_order_relaxed);
+    }
+
+    m_syncTimeouts.store(0, std::memory_order_relaxed);
+    m_mbeFrames.store(0, std::memory_order_relaxed);
+    m_vocoderFrames.store(0, std::memory_order_relaxed);
+    m_vocoderErrors.store(0, std::memory_order_relaxed);
+}
+
+void DSDStats::getSnapshot(Snapshot& snapshot) const
+{
+    for (int i = 0; i < NbSyncTypes; i++) {
+        snapshot.m_syncs[i] = m_syncs[i].load(std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < FECCount; i++)
+    {
+        snapshot.m_fecBlocks[i] = m_fecBlocks[i].load(std::memory_order_relaxed);
+        snapshot.m_fecCorrected[i] = m_fecCorrected[i].load(std::memory_order_relaxed);
+        snapshot.m_fecUncorrectable[i] = m_fecUncorrectable[i].load(std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < CRCCount; i++)
+    {
+        snapshot.m_crcPass[i] = m_crcPass[i].load(std::memory_order_relaxed);
+        snapshot.m_crcFail[i] = m_crcFail[i].load(std::memory_order_relaxed);
+    }
+
+    snapshot.m_syncTimeouts = m_syncTimeouts.load(std::memory_order_relaxed);
+    snapshot.m_mbeFrames = m_mbeFrames.load(std::memory_order_relaxed);
+    snapshot.m_vocoderFrames = m_vocoderFrames.load(std::memory_order_relaxed);
+    snapshot.m_vocoderErrors = m_vocoderErrors.load(std::memory_order_relaxed);
+}
+
+void DSDStats::add(const DSDStats& stats)
+{
+    Snapshot snapshot;
+    stats.getSnapshot(snapshot);
+
+    for (int i = 0; i < NbSyncTypes; i++) {
+        add(m_syncs[i], snapshot.m_syncs[i]);
+    }
+
+    for (int i = 0; i < FECCount; i++)
+    {
+        add(m_fecBlocks[i], snapshot.m_fecBlocks[i]);
+        add(m_fecCorrected[i], snapshot.m_fecCorrected[i]);
+        add(m_fecUncorrectable[i], snapshot.m_fecUncorrectable[i]);
+    }
+
+    for (int i = 0; i < CRCCount; i++)
+    {
+        add(m_crcPass[i], snapshot.m_crcPass[i]);
+        add(m_crcFail[i], snapshot.m_crcFail[i]);
+    }
+
+    add(m_syncTimeouts, snapshot.m_syncTimeouts);
+    add(m_mbeFrames, snapshot.m_mbeFrames);
+    add(m_vocoderFrames, snapshot.m_vocoderFrames);
+    add(m_vocoderErrors, snapshot.m_vocoderErrors);
+}
+
+void DSDStats::print(FILE *file) const
+{
+    Snapshot snapshot;
+    getSnapshot(snapshot);
+
+    for (int i = 0; i < NbSyncTypes; i++)
+    {
+        if (snapshot.m_syncs[i] > 0) {
+            fprintf(file, "sync type %-2d        %12llu\n", i, (unsigned long long) snapshot.m_syncs[i]);
+        }
+    }
+
+    fprintf(file, "sync timeouts       %12llu\n", (unsigned long long) snapshot.m_syncTimeouts);
+    fprintf(file, "%-19s %12s %12s %12s\n", "FEC", "blocks", "corrected", "failed");
+
+    for (int i = 0; i < FECCount; i++)
+    {
+        if (snapshot.m_fecBlocks[i] > 0)
+        {
+            fprintf(file, "%-19s %12llu %12llu %12llu\n",
+                    m_fecNames[i],
+                    (unsigned long long) snapshot.m_fecBlocks[i],
+                    (unsigned long long) snapshot.m_fecCorrected[i],
+                    (unsigned long long) snapshot.m_fecUncorrectable[i]);
+        }
+    }
+
+    fprintf(file, "%-19s %12s %12s\n", "CRC", "pass", "fail");
+
+    for (int i = 0; i < CRCCount; i++)
+    {
+        if (snapshot.m_crcPass[i] + snapshot.m_crcFail[i] > 0)
+        {
+            fprintf(file, "%-19s %12llu %12llu\n",
+                    m_crcNames[i],
+                    (unsigned long long) snapshot.m_crcPass[i],
+                    (unsigned long long) snapshot.m_crcFail[i]);
+        }
+    }
+
+    fprintf(file, "MBE frames          %12llu\n", (unsigned long long) snapshot.m_mbeFrames);
+    fprintf(file, "vocoder frames      %12llu\n", (unsigned long long) snapshot.m_vocoderFrames);
+    fprintf(file, "vocoder errors      %12llu\n", (unsigned long long) snapshot.m_vocoderErrors);
+}
+
+const char *DSDStats::getFECName(FEC fec)
+{
+    return m_fecNames[fec];
+}
+
+const char *DSDStats::getCRCName(CRC crc)
+{
+    return m_crcNames[crc];
+}
+
+} // namespace DSDcc
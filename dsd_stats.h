@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_STATS_H_
+#define DSDCC_DSD_STATS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Decoding statistics of a decoder: syncs, FEC and CRC outcomes and vocoder errors.
+ *
+ * Counters are only written by the thread running the decoder. Each one is a relaxed
+ * atomic updated with a plain load and store so counting costs no more than a non atomic
+ * increment. Another thread may take a snapshot at any time without locking: every counter
+ * in the snapshot is a value it actually had but counters are not sampled at the same instant.
+ */
+class DSDCC_API DSDStats
+{
+public:
+    static const int NbSyncTypes = 25; //!< DSDDecoder::DSDSyncNone
+
+    typedef enum
+    {
+        FECHamming_7_4,         //!< DMR CACH
+        FECHamming_12_8,        //!< dPMR header and CCH
+        FECHamming_16_11_4,     //!< DMR embedded signalling
+        FECGolay_20_8,          //!< DMR slot type
+        FECGolay_24_12,         //!< YSF FICH
+        FECQR_16_7_6,           //!< DMR EMB
+        FECGolayMBE,            //!< YSF V/D mode 2 voice
+        FECHammingMBE,          //!< YSF V/D mode 2 voice
+        FECCount
+    } FEC;
+
+    typedef enum
+    {
+        CRCDStar,               //!< D-Star header
+        CRCDPMR,                //!< dPMR header CRC8 and CCH CRC7
+        CRCYSF,                 //!< YSF FICH and data channels CRC16
+        CRCNXDN,                //!< NXDN channels
+        CRCCount
+    } CRC;
+
+    struct Snapshot
+    {
+        uint64_t m_syncs[NbSyncTypes];       //!< good syncs found by sync search per DSDDecoder::DSDSyncType
+        uint64_t m_syncTimeouts;             //!< sync searches given up after 1800 symbols without a sync (carrier dropped)
+        uint64_t m_fecBlocks[FECCount];      //!< decode calls
+        uint64_t m_fecCorrected[FECCount];   //!< bits corrected
+        uint64_t m_fecUncorrectable[FECCount]; //!< decode calls reporting an uncorrectable error
+        uint64_t m_crcPass[CRCCount];
+        uint64_t m_crcFail[CRCCount];
+        uint64_t m_mbeFrames;                //!< AMBE/IMBE frames made available to the audio sink or serialDV
+        uint64_t m_vocoderFrames;            //!< frames synthesized by mbelib
+        uint64_t m_vocoderErrors;            //!< bit errors reported by mbelib (errs2)
+    };
+
+    DSDStats();
+    /** Zeroes all counters. Must be called from the decoding thread */
+    void reset();
+    /** Copies the counters. May be called from any thread */
+    void getSnapshot(Snapshot& snapshot) const;
+    /** Adds the counters of another decoder e.g. of a part of a recording. Must be called from the decoding thread */
+    void add(const DSDStats& stats);
+    uint64_t getSyncCount(int syncType) const { return m_syncs[syncType].load(std::memory_order_relaxed); }
+    /** Writes the non zero counters of a snapshot one per line */
+    void print(FILE *file) const;
+
+    void countSync(int syncType) { add(m_syncs[syncType], 1); }
+    void countSyncTimeout() { add(m_syncTimeouts, 1); }
+
+    void countFEC(FEC fec, bool correctable, unsigned int nbCorrected)
+    {
+        add(m_fecBlocks[fec], 1);
+        add(m_fecCorrected[fec], nbCorrected);
+
+        if (!correctable) {
+            add(m_fecUncorrectable[fec], 1);
+        }
+    }
+
+    /** Counts a CRC check and returns its result */
+    bool countCRC(CRC crc, bool ok)
+    {
+        add(ok ? m_crcPass[crc] : m_crcFail[crc], 1);
+        return ok;
+    }
+
+    void countMbeFrame() { add(m_mbeFrames, 1); }
+
+    void countVocoderFrame(int nbErrors)
+    {
+        add(m_vocoderFrames, 1);
+        add(m_vocoderErrors, nbErrors);
+    }
+
+    static const char *getFECName(FEC fec);
+    static const char *getCRCName(CRC crc);
+
+private:
+    typedef std::atomic<uint64_t> Counter;
+
+    static void add(Counter& counter, uint64_t n)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); // single writer
+    }
+
+    Counter m_syncs[NbSyncTypes];
+    Counter m_syncTimeouts;
+    Counter m_fecBlocks[FECCount];
+    Counter m_fecCorrected[FECCount];
+    Counter m_fecUncorrectable[FECCount];
+    Counter m_crcPass[CRCCount];
+    Counter m_crcFail[CRCCount];
+    Counter m_mbeFrames;
+    Counter m_vocoderFrames;
+    Counter m_vocoderErrors;
+
+    static const char *m_fecNames[FECCount];
+    static const char *m_crcNames[CRCCount];
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_STATS_H_ */
@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_STATUS_H_
+#define DSDCC_DSD_STATUS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Decoder status published by the decoding thread (see DSDDecoder::getStatus). Only the
+ * section of the current protocol is refreshed, the others keep their last values.
+ * Strings are null terminated.
+ */
+struct DSDCC_API DSDStatus
+{
+    typedef enum
+    {
+        ProtocolNone,
+        ProtocolDMR,
+        ProtocolDStar,
+        ProtocolDPMR,
+        ProtocolYSF,
+        ProtocolNXDN
+    } Protocol;
+
+    uint32_t m_version;         //!< number of publications so far
+    uint64_t m_sampleCount;     //!< decoder input samples at publication
+    int m_syncType;             //!< DSDDecoder::DSDSyncType of the last sync
+    Protocol m_protocol;
+    int m_stationType;          //!< DSDDecoder::DSDStationType
+    int m_inLevel;              //!< input level in %
+    int m_symbolSyncQuality;
+    bool m_pllLocked;
+    bool m_voice1On;
+    bool m_voice2On;
+
+    struct DMR
+    {
+        char m_slot0Text[26+1];
+        char m_slot1Text[26+1];
+        int  m_colorCode;
+    } m_dmr;
+
+    struct DStar
+    {
+        char  m_mySign[13+1];
+        char  m_yourSign[8+1];
+        char  m_rpt1[8+1];
+        char  m_rpt2[8+1];
+        char  m_infoText[20+1];
+        char  m_locator[6+1];
+        int   m_bearing;
+        float m_distance;
+    } m_dstar;
+
+    struct DPMR
+    {
+        int m_frameType;            //!< DSDdPMR::DPMRFrameType
+        int m_colorCode;
+        unsigned int m_ownId;
+        unsigned int m_calledId;
+    } m_dpmr;
+
+    struct YSF
+    {
+        int  m_fichError;           //!< DSDYSF::FICHError
+        int  m_frameInformation;    //!< DSDYSF::FrameInformation
+        int  m_dataType;            //!< DSDYSF::DataType
+        int  m_callMode;            //!< DSDYSF::CallMode
+        int  m_blockTotal;
+        int  m_frameTotal;
+        bool m_narrowMode;
+        bool m_internetPath;
+        bool m_squelchCodeEnabled;
+        int  m_squelchCode;
+        bool m_radioIdMode;
+        char m_dest[10+1];
+        char m_src[10+1];
+        char m_downlink[10+1];
+        char m_uplink[10+1];
+        char m_rem4[5+1];
+        char m_destId[5+1];
+        char m_srcId[5+1];
+    } m_ysf;
+
+    struct NXDN
+    {
+        int  m_rfChannel;           //!< DSDNXDN::NXDNRFChannel
+        char m_rfChannelStr[2+1];
+        bool m_fullRate;
+        bool m_idle;
+        int  m_ran;
+        unsigned char m_messageType;
+        unsigned short m_sourceId;
+        unsigned short m_destinationId;
+        bool m_groupCall;
+        unsigned int m_locationId;
+        unsigned int m_servicesFlag;
+    } m_nxdn;
+
+    DSDStatus() { memset(this, 0, sizeof(DSDStatus)); }
+
+    static const char *getProtocolName(Protocol protocol)
+    {
+        static const char *names[] = {"None", "DMR", "DStar", "dPMR", "YSF", "NXDN"};
+        return ((int) protocol >= 0) && ((int) protocol <= (int) ProtocolNXDN) ? names[protocol] : "None";
+    }
+
+    /** Copies a string into a fixed size field with truncation */
+    static void copyText(char *field, unsigned int fieldSize, const char *text)
+    {
+        unsigned int n = 0;
+
+        for (; (n < fieldSize - 1) && text[n]; n++) {
+            field[n] = text[n];
+        }
+
+        field[n] = '\0';
+    }
+};
+
+/**
+ * Sequence lock for one writer and any number of readers on other threads. The writer never
+ * waits. Readers copy the value and retry if a publication happened during the copy.
+ * T must be trivially copyable.
+ */
+template<typename T>
+class DSDSeqLock
+{
+public:
+    DSDSeqLock() : m_sequence(0) {}
+
+    void write(const T& value)
+    {
+        uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy((void *) &m_value, (const void *) &value, sizeof(T));
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void read(T& value) const
+    {
+        while (true)
+        {
+            uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+
+            if (sequence & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            memcpy((void *) &value, (const void *) &m_value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::atomic<uint32_t> m_sequence;
+    T m_value;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_STATUS_H_ */
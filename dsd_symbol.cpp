@@ -17,9 +17,12 @@
 #include <iostream>
 #include <stdlib.h>
 #include <assert.h>
+#include <vector>
+#include <algorithm>
 
 #include "dsd_symbol.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -28,6 +31,8 @@ namespace DSDcc
 const int DSDSymbol::m_zeroCrossingCorrectionProfile2400[11] = { 0, 1, 1, 1, 2, 2, 3, 3, 4, 4, 4}; // base: /2
 const int DSDSymbol::m_zeroCrossingCorrectionProfile4800[11] = { 0, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2}; // base: /2
 const int DSDSymbol::m_zeroCrossingCorrectionProfile9600[11] = { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}; // base: /1
+const float DSDSymbol::m_gardnerKp = 0.1f;
+const float DSDSymbol::m_gardnerKi = 0.001f;
 
 DSDSymbol::DSDSymbol(DSDDecoder *dsdDecoder) :
         m_dsdDecoder(dsdDecoder),
@@ -36,13 +41,17 @@ DSDSymbol::DSDSymbol(DSDDecoder *dsdDecoder) :
         m_noSignal(false),
         m_zeroCrossingSlopeDivisor(232), // for 10 samples per symbol
         m_lmmidx(0),
+        m_levelsSnapped(false),
+        m_snapMin(0),
+        m_snapMax(0),
         m_pllLock(true),
         m_lmmSamples(10*24),
         m_ringingFilter(48000.0, 4800.0, 0.99),
         m_pll(0.1, 0.003, 0.25),
         m_binSymbolBuffer(1024),
         m_syncSymbolBuffer(64),
-		m_nonInvertedSyncSymbolBuffer(64)
+		m_nonInvertedSyncSymbolBuffer(64),
+        m_timingRecovery(TimingZeroCrossing)
 {
     noCarrier();
     m_umid = 0;
@@ -56,12 +65,185 @@ DSDSymbol::DSDSymbol(DSDDecoder *dsdDecoder) :
     m_symbolSyncQuality = 0;
     m_symbolSyncQualityCounter = 0;
     memcpy(m_zeroCrossingCorrectionProfile, m_zeroCrossingCorrectionProfile4800, 5*sizeof(int));
+    configureGardner();
 }
 
 DSDSymbol::~DSDSymbol()
 {
 }
 
+void DSDSymbol::reset()
+{
+    m_symbol = 0;
+    m_noSignal = false;
+    m_lmmidx = 0;
+    m_levelsSnapped = false;
+    m_snapMin = 0;
+    m_snapMax = 0;
+    m_pllLock = true;
+    m_umid = 0;
+    m_lmid = 0;
+    m_nbFSKSymbols = 2;
+    m_invertedFSK = false;
+    m_lastsample = 0;
+    m_symbolSyncSample = 0;
+    m_numflips = 0;
+    m_symbolSyncQuality = 0;
+    m_symbolSyncQualityCounter = 0;
+
+    if ((m_samplesPerSymbol != 10) || (m_timingRecovery != TimingZeroCrossing))
+    {
+        m_timingRecovery = TimingZeroCrossing;
+        setSamplesPerSymbol(10); // configures the front end as at construction
+    }
+
+    m_dsdFilters.reset();
+    m_lmmSamples.reset();
+    m_ringingFilter.reset();
+    m_pll.reset();
+    resetGardner();
+    m_binSymbolBuffer.reset();
+    m_syncSymbolBuffer.reset();
+    m_nonInvertedSyncSymbolBuffer.reset();
+    noCarrier();
+}
+
+void DSDSymbol::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeInt(m_min);
+    buffer.writeInt(m_max);
+    buffer.writeInt(m_center);
+    buffer.writeInt(m_umid);
+    buffer.writeInt(m_lmid);
+    buffer.writeU8(m_nbFSKSymbols);
+    buffer.writeBool(m_invertedFSK);
+    buffer.writeInt(m_numflips);
+    buffer.writeInt(m_symbolSyncQuality);
+    buffer.writeInt(m_symbolSyncQualityCounter);
+    // symbol timing: only valid with the same samples per symbol and timing recovery
+    buffer.writeU8(m_samplesPerSymbol);
+    buffer.writeU8((uint8_t) m_timingRecovery);
+    buffer.writeInt(m_sampleIndex);
+    buffer.writeInt(m_sum);
+    buffer.writeInt(m_count);
+    buffer.writeInt(m_zeroCrossing);
+    buffer.writeBool(m_zeroCrossingInCycle);
+    buffer.writeInt(m_zeroCrossingPos);
+    buffer.writeU16(m_lastsample);
+    buffer.writeU16(m_symbolSyncSample);
+    buffer.writeU16(m_filteredSample);
+    buffer.writeInt(m_decimationCount);
+
+    for (int i = 0; i < 4; i++) {
+        buffer.writeFloat(m_gardnerSamples[i]);
+    }
+
+    buffer.writeFloat(m_periodCorrection);
+    buffer.writeFloat(m_nextStrobe);
+    buffer.writeBool(m_midStrobe);
+    buffer.writeFloat(m_midValue);
+    buffer.writeFloat(m_lastSymbolValue);
+    m_pll.saveState(buffer);
+    // input filters and levels window
+    m_dsdFilters.saveState(buffer);
+    m_matchedFilter.saveState(buffer);
+    m_ringingFilter.saveState(buffer);
+    m_lmmSamples.saveState(buffer);
+    buffer.writeU8(m_lmmidx);
+
+    for (int i = 0; i < 32*2; i++) {
+        buffer.writeInt(m_lbuf[i]);
+    }
+
+    buffer.writeBool(m_levelsSnapped);
+    buffer.writeInt(m_snapMin);
+    buffer.writeInt(m_snapMax);
+    // symbols history read back by the sync search and the frame decoders
+    buffer.writeU16(m_binSymbolBuffer.getSize());
+    buffer.writeDibits(m_binSymbolBuffer.getOldest(), m_binSymbolBuffer.getSize());
+    buffer.writeDibits(m_syncSymbolBuffer.getOldest(), m_syncSymbolBuffer.getSize());
+    buffer.writeDibits(m_nonInvertedSyncSymbolBuffer.getOldest(), m_nonInvertedSyncSymbolBuffer.getSize());
+    buffer.writeInt(m_symbol);
+}
+
+void DSDSymbol::restoreState(DSDStateBuffer& buffer)
+{
+    const int maxLevel = 65536; // short samples with room for the interpolator overshoot
+    m_min = buffer.readInt(-maxLevel, maxLevel);
+    m_max = buffer.readInt(-maxLevel, maxLevel);
+    m_center = buffer.readInt(-maxLevel, maxLevel);
+    m_umid = buffer.readInt(-maxLevel, maxLevel);
+    m_lmid = buffer.readInt(-maxLevel, maxLevel);
+    m_nbFSKSymbols = buffer.readU8();
+    m_invertedFSK = buffer.readBool();
+    m_numflips = buffer.readInt();
+    m_symbolSyncQuality = buffer.readInt();
+    m_symbolSyncQualityCounter = buffer.readInt(0, 99);
+    int samplesPerSymbol = buffer.readU8();
+    TimingRecovery timingRecovery = (TimingRecovery) buffer.readEnum(TimingGardner);
+
+    if ((samplesPerSymbol != m_samplesPerSymbol) || (timingRecovery != m_timingRecovery)) {
+        return; // the front end is configured differently: it acquires the symbol timing again
+    }
+
+    // the zero crossing indexes the correction profile and the timing moves the sample index by at most half a symbol
+    int halfSymbol = std::min(m_samplesPerSymbol / 2, 10);
+    m_sampleIndex = buffer.readInt(-halfSymbol, m_samplesPerSymbol - 1);
+    m_sum = buffer.readInt(-maxLevel * m_samplesPerSymbol, maxLevel * m_samplesPerSymbol);
+    m_count = buffer.readInt(0, m_samplesPerSymbol);
+    m_zeroCrossing = buffer.readInt(-halfSymbol, halfSymbol);
+    m_zeroCrossingInCycle = buffer.readBool();
+    m_zeroCrossingPos = buffer.readInt(-m_samplesPerSymbol, m_samplesPerSymbol);
+    m_lastsample = (short) buffer.readU16();
+    m_symbolSyncSample = (short) buffer.readU16();
+    m_filteredSample = (short) buffer.readU16();
+    m_decimationCount = buffer.readInt(0, m_decimation);
+
+    for (int i = 0; i < 4; i++) {
+        m_gardnerSamples[i] = buffer.readFloat((float) -maxLevel, (float) maxLevel);
+    }
+
+    m_periodCorrection = buffer.readFloat(-m_halfPeriod / 1000.0f, m_halfPeriod / 1000.0f);
+    m_nextStrobe = buffer.readFloat(-2.0f, 2.0f * m_halfPeriod + 2.0f);
+    m_midStrobe = buffer.readBool();
+    m_midValue = buffer.readFloat((float) -maxLevel, (float) maxLevel);
+    m_lastSymbolValue = buffer.readFloat((float) -maxLevel, (float) maxLevel);
+    m_pll.restoreState(buffer);
+    m_dsdFilters.restoreState(buffer);
+    m_matchedFilter.restoreState(buffer);
+    m_ringingFilter.restoreState(buffer);
+    m_lmmSamples.restoreState(buffer);
+    m_lmmidx = buffer.readU8(25 - 1);
+
+    for (int i = 0; i < 32*2; i++) {
+        m_lbuf[i] = buffer.readInt(-maxLevel, maxLevel);
+    }
+
+    m_levelsSnapped = buffer.readBool();
+    m_snapMin = buffer.readInt(-maxLevel, maxLevel);
+    m_snapMax = buffer.readInt(-maxLevel, maxLevel);
+
+    if (buffer.readU16() != m_binSymbolBuffer.getSize()) {
+        return;
+    }
+
+    restoreSymbols(buffer, m_binSymbolBuffer);
+    restoreSymbols(buffer, m_syncSymbolBuffer);
+    restoreSymbols(buffer, m_nonInvertedSyncSymbolBuffer);
+    m_symbol = buffer.readInt(-maxLevel, maxLevel);
+}
+
+void DSDSymbol::restoreSymbols(DSDStateBuffer& buffer, DoubleBuffer<unsigned char>& symbols)
+{
+    std::vector<unsigned char> history(symbols.getSize());
+    buffer.readDibits(history.data(), history.size());
+    symbols.reset();
+
+    for (unsigned int i = 0; i < history.size(); i++) {
+        symbols.push(history[i]);
+    }
+}
+
 void DSDSymbol::noCarrier()
 {
     resetSymbol();
@@ -90,6 +272,47 @@ void DSDSymbol::resetZeroCrossing()
     m_zeroCrossingPos = 0;
 }
 
+void DSDSymbol::resetGardner()
+{
+    m_matchedFilter.reset();
+    m_decimationCount = 0;
+
+    for (int i = 0; i < 4; i++) {
+        m_gardnerSamples[i] = 0.0f;
+    }
+
+    m_periodCorrection = 0.0f;
+    m_nextStrobe = m_halfPeriod;
+    m_midStrobe = true;
+    m_midValue = 0.0f;
+    m_lastSymbolValue = 0.0f;
+}
+
+/**
+ * The matched filter is decimated to 2.5 samples per symbol at 4800 and 9600 baud
+ * and 4 samples per symbol at 2400 baud
+ */
+void DSDSymbol::configureGardner()
+{
+    if (m_samplesPerSymbol == 5) {
+        m_decimation = 2;
+    } else if (m_samplesPerSymbol == 20) {
+        m_decimation = 5;
+    } else {
+        m_decimation = 4;
+    }
+
+    m_matchedFilter.setMode(m_samplesPerSymbol == 20 ? 4 : 3);
+    m_halfPeriod = m_samplesPerSymbol / (2.0f * m_decimation);
+    resetGardner();
+}
+
+void DSDSymbol::setTimingRecovery(TimingRecovery timingRecovery)
+{
+    m_timingRecovery = timingRecovery;
+    setSamplesPerSymbol(m_samplesPerSymbol); // min/max window depends on the recovery rate
+}
+
 /**
  * Squares the output of the match filter and passes it through a narrow bandpass filter centered on the
  * Symbol rate frequency. Inspired by: http://www.ece.umd.edu/~tretter/commlab/c6713slides/FSKSlides.pdf
@@ -98,10 +321,16 @@ void DSDSymbol::resetZeroCrossing()
  */
 bool DSDSymbol::pushSample(short sample)
 {
+    if (m_timingRecovery == TimingGardner) {
+        return pushSampleGardner(sample);
+    }
+
     // matched filter
 
     if (m_dsdDecoder->m_opts.use_cosine_filter)
     {
+        DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageMatchedFilter);
+
         if (m_samplesPerSymbol == 20) {
             sample = m_dsdFilters.nxdn_filter(sample); // 6.25 kHz for 2400 baud
         } else {
@@ -109,22 +338,43 @@ bool DSDSymbol::pushSample(short sample)
         }
     }
 
-    m_filteredSample = sample;
+    short sampleRinging = 0;
+    short pllSample = 0;
 
     if (!m_noSignal)
     {
-        m_lmmSamples.update(sample); // store for running min/max calculation
-
+        DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageRingingPLL);
         // ringing filter
         short sampleSq = ((((int) sample)- m_center) * (((int) sample)- m_center)) >> 15;
-        short sampleRinging = m_ringingFilter.run(sampleSq);
+        sampleRinging = m_ringingFilter.run(sampleSq);
 
         if (m_pllLock)
         {
             float pllOut[2];
             float pllIn = sampleRinging / 32768.0f;
             m_pll.process(pllIn, pllOut);
-            m_symbolSyncSample = pllOut[0] * 16384.0f;
+            pllSample = pllOut[0] * 16384.0f;
+        }
+    }
+
+    return pushFrontEndOutput(sample, sampleRinging, pllSample);
+}
+
+/**
+ * Second part of the zero crossing symbol recovery from the outputs of the matched filter, ringing filter and PLL
+ * that can be computed elsewhere (see DSDSymbolBatch). Ringing filter and PLL outputs are ignored without signal.
+ */
+bool DSDSymbol::pushFrontEndOutput(short sample, short sampleRinging, short pllSample)
+{
+    m_filteredSample = sample;
+
+    if (!m_noSignal)
+    {
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageLevels, m_lmmSamples.update(sample)); // store for running min/max calculation
+
+        if (m_pllLock)
+        {
+            m_symbolSyncSample = pllSample;
 
             // process with PLL
             if ((m_symbolSyncSample > 0) && (m_lastsample < 0))
@@ -269,44 +519,150 @@ bool DSDSymbol::pushSample(short sample)
         }
 
         m_symbol = m_sum / m_count;
-        m_dsdDecoder->m_state.symbolcnt++;
-
-        digitizeIntoBinaryBuffer();
         resetSymbol();
+        concludeSymbol();
 
-        // moved here what was done at symbol retrieval in the decoder
+        return true; // new symbol available
+    }
+    else
+    {
+        m_sampleIndex++; // wait for next sample
+        return false;
+    }
+}
 
-        // symbol synchronization quality metric
+/**
+ * Low oversampling alternative: the matched filter output is only computed every m_decimation samples.
+ * A cubic Farrow interpolator strobes the mid-symbol and on-time points and the Gardner timing error
+ * drives a proportional-integral loop on the strobe position. Only symbol transitions through the center
+ * contribute (sign of previous - current) x mid: on the 4 symbols period preambles of dPMR and NXDN the
+ * plain product of non transitions cancels out the transitions and the loop would not pull in.
+ * The ringing filter and PLL are not used.
+ */
+bool DSDSymbol::pushSampleGardner(short sample)
+{
+    bool matchedFilter = m_dsdDecoder->m_opts.use_cosine_filter;
 
-        if (m_symbolSyncQualityCounter < 99)
-        {
-            m_symbolSyncQualityCounter++;
-        }
-        else
+    if (matchedFilter) {
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageMatchedFilter, m_matchedFilter.push(sample));
+    }
+
+    if (++m_decimationCount < m_decimation) {
+        return false;
+    }
+
+    m_decimationCount = 0;
+
+    if (matchedFilter) {
+        sample = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageMatchedFilter, m_matchedFilter.filter());
+    }
+
+    m_filteredSample = sample;
+    m_symbolSyncSample = m_min;
+
+    if (!m_noSignal) {
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageLevels, m_lmmSamples.update(sample));
+    }
+
+    m_gardnerSamples[0] = m_gardnerSamples[1];
+    m_gardnerSamples[1] = m_gardnerSamples[2];
+    m_gardnerSamples[2] = m_gardnerSamples[3];
+    m_gardnerSamples[3] = sample;
+    m_nextStrobe -= 1.0f;
+
+    if (m_nextStrobe >= 1.0f) { // strobe not between samples #1 and #2 yet
+        return false;
+    }
+
+    float mu = m_nextStrobe < 0.0f ? 0.0f : m_nextStrobe;
+    float y = farrowInterpolate(m_gardnerSamples, mu);
+
+    if (m_midStrobe)
+    {
+        m_midValue = y;
+        m_midStrobe = false;
+        m_nextStrobe += m_halfPeriod + m_periodCorrection;
+        return false;
+    }
+
+    // on time strobe: timing error detection
+
+    float correction = 0.0f;
+    float amplitude = (m_max - m_min) / 2.0f;
+
+    if (!m_noSignal && (amplitude > 0.0f))
+    {
+        float error = 0.0f;
+
+        if ((m_lastSymbolValue - m_center) * (y - m_center) < 0.0f) // transition
         {
-            m_symbolSyncQuality = m_numflips;
-            m_symbolSyncQualityCounter = 0;
-            m_numflips = 0;
+            error = (m_midValue - m_center) / amplitude;
+            error = m_lastSymbolValue > m_center ? error : -error;
+            m_numflips++;
         }
 
-        // min/max calculation
+        if (error > 1.0f) {
+            error = 1.0f;
+        } else if (error < -1.0f) {
+            error = -1.0f;
+        }
 
-        if (m_lmmidx < 24)
-        {
-            m_lmmidx++;
+        if (m_dsdDecoder->m_fsmState != DSDDecoder::DSDLookForSync) { // integrate only on a synchronized signal
+            m_periodCorrection += m_gardnerKi * error;
         }
-        else
-        {
-            m_lmmidx = 0;
-            snapMinMax();
+
+        if (m_periodCorrection > m_halfPeriod / 1000.0f) { // +/- 0.1% symbol rate offset
+            m_periodCorrection = m_halfPeriod / 1000.0f;
+        } else if (m_periodCorrection < -m_halfPeriod / 1000.0f) {
+            m_periodCorrection = -m_halfPeriod / 1000.0f;
         }
 
-        return true; // new symbol available
+        correction = m_gardnerKp * error;
+    }
+
+    m_zeroCrossingPos = (int) (mu * m_decimation);
+    m_lastSymbolValue = y;
+    m_midStrobe = true;
+    m_nextStrobe += m_halfPeriod + m_periodCorrection + correction;
+    m_symbolSyncSample = m_max;
+
+    m_symbol = (int) y;
+    concludeSymbol();
+
+    return true;
+}
+
+void DSDSymbol::concludeSymbol()
+{
+    m_levelsSnapped = false;
+    m_dsdDecoder->m_state.symbolcnt++;
+    DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageDigitize, digitizeIntoBinaryBuffer());
+
+    // moved here what was done at symbol retrieval in the decoder
+
+    // symbol synchronization quality metric
+
+    if (m_symbolSyncQualityCounter < 99)
+    {
+        m_symbolSyncQualityCounter++;
     }
     else
     {
-        m_sampleIndex++; // wait for next sample
-        return false;
+        m_symbolSyncQuality = m_numflips;
+        m_symbolSyncQualityCounter = 0;
+        m_numflips = 0;
+    }
+
+    // min/max calculation
+
+    if (m_lmmidx < 24)
+    {
+        m_lmmidx++;
+    }
+    else
+    {
+        m_lmmidx = 0;
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageLevels, snapMinMax(m_lmmSamples.min(), m_lmmSamples.max()));
     }
 }
 
@@ -326,10 +682,25 @@ void DSDSymbol::snapLevels(int nbSymbols)
     m_lmid = (((m_min) - m_center) / 2) + m_center;
 }
 
-void DSDSymbol::snapMinMax()
+void DSDSymbol::pushSymbol(int symbol, bool snapLevels, int sampleMin, int sampleMax)
 {
-    m_max = m_max + (m_lmmSamples.max() - m_max) / 4; // alpha = 0.25
-    m_min = m_min + (m_lmmSamples.min() - m_min) / 4; // alpha = 0.25
+    m_symbol = symbol;
+    m_levelsSnapped = false;
+    m_dsdDecoder->m_state.symbolcnt++;
+    digitizeIntoBinaryBuffer();
+
+    if (snapLevels) {
+        snapMinMax(sampleMin, sampleMax);
+    }
+}
+
+void DSDSymbol::snapMinMax(int sampleMin, int sampleMax)
+{
+    m_levelsSnapped = true;
+    m_snapMin = sampleMin;
+    m_snapMax = sampleMax;
+    m_max = m_max + (sampleMax - m_max) / 4; // alpha = 0.25
+    m_min = m_min + (sampleMin - m_min) / 4; // alpha = 0.25
     // recalibrate center/umid/lmid
     m_center = ((m_max) + (m_min)) / 2;
     m_umid = (((m_max) - m_center) / 2) + m_center;
@@ -363,36 +734,66 @@ void DSDSymbol::setSamplesPerSymbol(int samplesPerSymbol)
         memcpy(m_zeroCrossingCorrectionProfile, m_zeroCrossingCorrectionProfile9600, 11*sizeof(int));
         m_zeroCrossingSlopeDivisor = 164;
         m_lmmSamples.resize(5*24);
-        m_ringingFilter.setFrequencies(48000.0, 9600.0);
-        m_ringingFilter.setR(0.99);
-        m_pll.configure(0.2, 0.003, 0.25);
     }
     else if (m_samplesPerSymbol == 10)
     {
         memcpy(m_zeroCrossingCorrectionProfile, m_zeroCrossingCorrectionProfile4800, 11*sizeof(int));
         m_zeroCrossingSlopeDivisor = 232;
         m_lmmSamples.resize(10*24);
-        m_ringingFilter.setFrequencies(48000.0, 4800.0);
-        m_ringingFilter.setR(0.99);
-        m_pll.configure(0.1, 0.003, 0.25);
     }
     else if (m_samplesPerSymbol == 20)
     {
         memcpy(m_zeroCrossingCorrectionProfile, m_zeroCrossingCorrectionProfile2400, 11*sizeof(int));
         m_zeroCrossingSlopeDivisor = 328;
         m_lmmSamples.resize(20*24);
-        m_ringingFilter.setFrequencies(48000.0, 2400.0);
-        m_ringingFilter.setR(0.996);
-        m_pll.configure(0.05, 0.003, 0.25);
     }
     else
     {
         memcpy(m_zeroCrossingCorrectionProfile, m_zeroCrossingCorrectionProfile4800, 11*sizeof(int));
         m_zeroCrossingSlopeDivisor = 232;
         m_lmmSamples.resize(10*24);
-        m_ringingFilter.setFrequencies(48000.0, 4800.0);
-        m_ringingFilter.setR(0.99);
-        m_pll.configure(0.1, 0.003, 0.25);
+    }
+
+    float ringingFrequency, ringingR, pllFrequency, pllBandwidth, pllMinSignal;
+    getFrontEndParameters(m_samplesPerSymbol, ringingFrequency, ringingR, pllFrequency, pllBandwidth, pllMinSignal);
+    m_ringingFilter.setFrequencies(48000.0, ringingFrequency);
+    m_ringingFilter.setR(ringingR);
+    m_pll.configure(pllFrequency, pllBandwidth, pllMinSignal);
+
+    configureGardner();
+
+    if (m_timingRecovery == TimingGardner) { // min/max over 24 symbols at the decimated rate
+        m_lmmSamples.resize((24 * m_samplesPerSymbol) / m_decimation);
+    }
+}
+
+void DSDSymbol::getFrontEndParameters(int samplesPerSymbol,
+        float& ringingFrequency,
+        float& ringingR,
+        float& pllFrequency,
+        float& pllBandwidth,
+        float& pllMinSignal)
+{
+    pllBandwidth = 0.003;
+    pllMinSignal = 0.25;
+
+    if (samplesPerSymbol == 5)
+    {
+        ringingFrequency = 9600.0;
+        ringingR = 0.99;
+        pllFrequency = 0.2;
+    }
+    else if (samplesPerSymbol == 20)
+    {
+        ringingFrequency = 2400.0;
+        ringingR = 0.996;
+        pllFrequency = 0.05;
+    }
+    else
+    {
+        ringingFrequency = 4800.0;
+        ringingR = 0.99;
+        pllFrequency = 0.1;
     }
 }
 
@@ -27,14 +27,25 @@ namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDSymbol
 {
+    friend class DSDSymbolBatch;
 public:
+    enum TimingRecovery
+    {
+        TimingZeroCrossing, //!< full rate matched filter with ringing filter zero crossing detection (default)
+        TimingGardner       //!< decimated matched filter with Farrow interpolator and Gardner timing error detector
+    };
+
     explicit DSDSymbol(DSDDecoder *dsdDecoder);
     ~DSDSymbol();
 
+    void reset(); //!< returns to the state of construction without re-allocating the buffers
     void noCarrier();
+    void saveState(DSDStateBuffer& buffer) const;    //!< levels, symbol timing and PLL
+    void restoreState(DSDStateBuffer& buffer);
     void resetFrameSync();
 
     void snapLevels(int nbSymbols); //!< take snapshot for min/max over a number of symbols
@@ -42,6 +53,24 @@ public:
     void setFSK(unsigned int nbSymbols, bool inverted=false);
     void setNoSignal(bool noSignal) { m_noSignal = noSignal; }
     bool pushSample(short sample); //!< push a new sample into the decoder. Returns true if a new symbol is available
+    bool pushFrontEndOutput(short sample, short sampleRinging, short pllSample); //!< same from the front end outputs (matched filter, ringing filter, PLL)
+    /** Symbol from a symbol capture instead of the samples with the levels refreshed at this symbol if snapLevels (see DSDDecoder::runSymbol) */
+    void pushSymbol(int symbol, bool snapLevels, int sampleMin, int sampleMax);
+    /** True if the levels were refreshed at the last symbol from these running min and max of the samples */
+    bool getLevelsSnap(int& sampleMin, int& sampleMax) const
+    {
+        sampleMin = m_snapMin;
+        sampleMax = m_snapMax;
+        return m_levelsSnapped;
+    }
+
+    /** Ringing filter (at 48 kHz) and symbol clock PLL parameters for a recovery rate */
+    static void getFrontEndParameters(int samplesPerSymbol,
+            float& ringingFrequency,
+            float& ringingR,
+            float& pllFrequency,
+            float& pllBandwidth,
+            float& pllMinSignal);
 
     int getSymbol() const { return m_symbol; }
     int getDibit(); //!< from the last retrieved symbol Returns either the bit (0,1) or the dibit value (0,1,2,3)
@@ -59,6 +88,8 @@ public:
     int getSamplesPerSymbol() const { return m_samplesPerSymbol; }
     bool getPLLLocked() const { return m_pllLock && m_pll.locked(); }
     void setPLLLock(bool pllLock) { m_pllLock = pllLock; }
+    void setTimingRecovery(TimingRecovery timingRecovery);
+    TimingRecovery getTimingRecovery() const { return m_timingRecovery; }
 
     static void compressBits(const char *bitArray, unsigned char *byteArray, int nbBytes)
     {
@@ -75,14 +106,28 @@ public:
         }
     }
 
+    /** Cubic Lagrange interpolation in Farrow form between x[1] and x[2] at fractional position mu */
+    static float farrowInterpolate(const float *x, float mu)
+    {
+        float c1 = -x[0]/3.0f - x[1]/2.0f + x[2] - x[3]/6.0f;
+        float c2 = (x[0] + x[2])/2.0f - x[1];
+        float c3 = (x[3] - x[0])/6.0f + (x[1] - x[2])/2.0f;
+        return ((c3*mu + c2)*mu + c1)*mu + x[1];
+    }
+
 private:
     void resetSymbol();
     void resetZeroCrossing();
+    void resetGardner();
+    static void restoreSymbols(DSDStateBuffer& buffer, DoubleBuffer<unsigned char>& symbols);
+    void configureGardner();
+    bool pushSampleGardner(short sample);
+    void concludeSymbol();
     int get_dibit();
 //    void use_symbol(int symbol);
     unsigned char digitize(int symbol);
     void digitizeIntoBinaryBuffer();
-    void snapMinMax();
+    void snapMinMax(int sampleMin, int sampleMax);
     static int comp(const void *a, const void *b);
     static int compShort(const void *a, const void *b);
 
@@ -106,6 +151,8 @@ private:
     int m_min, m_max;
     int m_center;
     int m_umid, m_lmid;
+    bool m_levelsSnapped;          //!< levels refreshed at the last symbol
+    int m_snapMin, m_snapMax;      //!< samples min/max of the last refresh
     int m_numflips;
     int m_symbolSyncQuality;
     int m_symbolSyncQualityCounter;
@@ -123,9 +170,23 @@ private:
     DoubleBuffer<unsigned char> m_syncSymbolBuffer;   //!< symbol digitized for synchronization: positive is 1, negative is 3
     DoubleBuffer<unsigned char> m_nonInvertedSyncSymbolBuffer; //!< same but resetting to positive sync
 
+    TimingRecovery m_timingRecovery;
+    DSDMatchedFilter m_matchedFilter;  //!< matched filter evaluated at the decimated rate
+    int m_decimation;                  //!< input samples per Gardner sample
+    int m_decimationCount;
+    float m_gardnerSamples[4];         //!< Farrow interpolator input, oldest first
+    float m_halfPeriod;                //!< nominal half symbol period in decimated samples
+    float m_periodCorrection;          //!< loop integrator (symbol rate offset)
+    float m_nextStrobe;                //!< next strobe position from the second interpolator sample
+    bool m_midStrobe;                  //!< next strobe is the mid-symbol one
+    float m_midValue;                  //!< interpolated mid-symbol value
+    float m_lastSymbolValue;           //!< interpolated value of the previous symbol
+
     static const int m_zeroCrossingCorrectionProfile2400[11];
     static const int m_zeroCrossingCorrectionProfile4800[11];
     static const int m_zeroCrossingCorrectionProfile9600[11];
+    static const float m_gardnerKp; //!< Gardner loop proportional gain (decimated samples per unit error)
+    static const float m_gardnerKi; //!< Gardner loop integral gain
 };
 
 } // namespace DSDcc
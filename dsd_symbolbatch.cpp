@@ -0,0 +1,328 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "dsd_symbolbatch.h"
+#include "dsd_decoder.h"
+
+namespace DSDcc
+{
+
+DSDSymbolBatch::DSDSymbolBatch() :
+        m_nbLanes(0),
+        m_nbLanesPadded(0),
+        m_nbActiveTaps(1),
+        m_delayIndex(0)
+{
+    memset(m_decoders, 0, sizeof(m_decoders));
+    memset(m_coeffs, 0, sizeof(m_coeffs));
+    memset(m_delay, 0, sizeof(m_delay));
+
+    for (int lane = 0; lane < m_maxLanes; lane++)
+    {
+        m_samplesPerSymbol[lane] = 0;
+        m_filterMode[lane] = 0;
+        m_gain[lane] = 1.0f;
+        m_input[lane] = 0.0f;
+        m_center[lane] = 0;
+        m_active[lane] = 0;
+        m_pllEnabled[lane] = 0;
+        m_filtered[lane] = 0;
+        m_ringing[lane] = 0;
+        m_pllOut[lane] = 0;
+        m_ringingA1[lane] = 0.0f;
+        m_ringingA2[lane] = 0.0f;
+        m_ringingB0[lane] = 0.0f;
+        m_pllMinFreq[lane] = 0.0f;
+        m_pllMaxFreq[lane] = 0.0f;
+        m_pllMinSignal[lane] = 0.0f;
+        m_pllPhasorB0[lane] = 0.0f;
+        m_pllPhasorA1[lane] = 0.0f;
+        m_pllPhasorA2[lane] = 0.0f;
+        m_pllLoopFilterB0[lane] = 0.0f;
+        m_pllLoopFilterB1[lane] = 0.0f;
+        m_pllLockDelay[lane] = 1;
+        resetLaneFrontEnd(lane);
+    }
+}
+
+DSDSymbolBatch::~DSDSymbolBatch()
+{
+}
+
+int DSDSymbolBatch::addDecoder(DSDDecoder *dsdDecoder)
+{
+    if (m_nbLanes == m_maxLanes) {
+        return -1;
+    }
+
+    if ((dsdDecoder->m_dsdSymbol.getTimingRecovery() != DSDSymbol::TimingZeroCrossing)
+        || dsdDecoder->m_inputResampler
+        || dsdDecoder->m_idleGate.isEnabled()
+        || dsdDecoder->m_rateDetector.isEnabled())
+    {
+        return -1;
+    }
+
+    int lane = m_nbLanes;
+    m_decoders[lane] = dsdDecoder;
+    m_samplesPerSymbol[lane] = 0; // forces configuration
+    m_nbLanes++;
+    m_nbLanesPadded = ((m_nbLanes + 7) / 8) * 8;
+    configureLanes();
+
+    return lane;
+}
+
+bool DSDSymbolBatch::getPLLLocked(int lane) const
+{
+    return m_decoders[lane]->m_dsdSymbol.m_pllLock && (m_pllLockCount[lane] >= m_pllLockDelay[lane]);
+}
+
+void DSDSymbolBatch::configureLanes()
+{
+    m_nbActiveTaps = 1;
+
+    for (int lane = 0; lane < m_nbLanes; lane++)
+    {
+        const DSDSymbol& dsdSymbol = m_decoders[lane]->m_dsdSymbol;
+        int filterMode = m_decoders[lane]->m_opts.use_cosine_filter ? (dsdSymbol.m_samplesPerSymbol == 20 ? 4 : 3) : 0;
+
+        if ((dsdSymbol.m_samplesPerSymbol != m_samplesPerSymbol[lane]) || (filterMode != m_filterMode[lane]))
+        {
+            m_samplesPerSymbol[lane] = dsdSymbol.m_samplesPerSymbol;
+            m_filterMode[lane] = filterMode;
+            configureLane(lane);
+        }
+
+        int nbTaps = m_filterMode[lane] == 4 ? NXZEROS+1 : m_filterMode[lane] == 3 ? NZEROS+1 : 1;
+
+        if (nbTaps > m_nbActiveTaps) {
+            m_nbActiveTaps = nbTaps;
+        }
+    }
+}
+
+void DSDSymbolBatch::configureLane(int lane)
+{
+    // matched filter coefficients by sample age like DSDFilters::dsd_input_filter
+    const float *coeffs;
+    int zeros;
+
+    for (int k = 0; k < m_nbTaps; k++) {
+        m_coeffs[k][lane] = 0.0f;
+    }
+
+    if (m_filterMode[lane] == 4)
+    {
+        coeffs = DSDFilters::dpmrcoeffs;
+        zeros = NXZEROS;
+        m_gain[lane] = DSDFilters::dpmrgain;
+    }
+    else if (m_filterMode[lane] == 3)
+    {
+        coeffs = DSDFilters::dmrcoeffs;
+        zeros = NZEROS;
+        m_gain[lane] = DSDFilters::dmrgain;
+    }
+    else
+    {
+        coeffs = 0;
+        zeros = 0;
+        m_gain[lane] = 1.0f;
+        m_coeffs[0][lane] = 1.0f;
+    }
+
+    if (coeffs)
+    {
+        for (int k = 0; k <= zeros; k++) {
+            m_coeffs[k][lane] = coeffs[zeros - k];
+        }
+    }
+
+    // ringing filter and PLL as in DSDSymbol::setSamplesPerSymbol
+    float ringingFrequency, ringingR, pllFrequency, pllBandwidth, pllMinSignal;
+    DSDSymbol::getFrontEndParameters(m_samplesPerSymbol[lane], ringingFrequency, ringingR, pllFrequency, pllBandwidth, pllMinSignal);
+
+    m_ringingA1[lane] = 2.0f * ringingR * cos(2.0 * M_PI * (ringingFrequency / 48000.0f));
+    m_ringingA2[lane] = ringingR * ringingR;
+    m_ringingB0[lane] = 1.0f - ringingR;
+
+    m_pllMinFreq[lane] = (pllFrequency - pllBandwidth) * 2.0 * M_PI;
+    m_pllMaxFreq[lane] = (pllFrequency + pllBandwidth) * 2.0 * M_PI;
+    m_pllMinSignal[lane] = pllMinSignal;
+    m_pllLockDelay[lane] = int(1.0 / pllBandwidth);
+    double p1 = exp(-1.146 * pllBandwidth * 2.0 * M_PI);
+    double p2 = exp(-5.331 * pllBandwidth * 2.0 * M_PI);
+    m_pllPhasorA1[lane] = - p1 - p2;
+    m_pllPhasorA2[lane] = p1 * p2;
+    m_pllPhasorB0[lane] = 1 + m_pllPhasorA1[lane] + m_pllPhasorA2[lane];
+    double q1 = exp(-0.1153 * pllBandwidth * 2.0 * M_PI);
+    m_pllLoopFilterB0[lane] = 0.62 * pllBandwidth * 2.0 * M_PI;
+    m_pllLoopFilterB1[lane] = - m_pllLoopFilterB0[lane] * q1;
+
+    resetLaneFrontEnd(lane);
+    m_pllFreq[lane] = pllFrequency * 2.0 * M_PI;
+}
+
+void DSDSymbolBatch::resetLaneFrontEnd(int lane)
+{
+    for (int k = 0; k < 2*m_nbTaps; k++) {
+        m_delay[k][lane] = 0.0f;
+    }
+
+    m_ringingV1[lane] = 0.0f;
+    m_ringingV2[lane] = 0.0f;
+    m_pllPhase[lane] = 0.0f;
+    m_pllFreq[lane] = 0.0f;
+    m_pllPhasorI1[lane] = 0.0f;
+    m_pllPhasorI2[lane] = 0.0f;
+    m_pllPhasorQ1[lane] = 0.0f;
+    m_pllPhasorQ2[lane] = 0.0f;
+    m_pllLoopFilterX1[lane] = 0.0f;
+    m_pllLockCount[lane] = 0;
+}
+
+int DSDSymbolBatch::run(const short *samples, int nbTicks)
+{
+    const float pi = M_PI;
+    const float halfPi = M_PI / 2.0;
+    configureLanes();
+
+    for (int lane = 0; lane < m_nbLanes; lane++) // the caller had its chance to collect the frames of the last run
+    {
+        m_decoders[lane]->resetMbeDV1();
+        m_decoders[lane]->resetMbeDV2();
+    }
+
+    for (int tick = 0; tick < nbTicks; tick++)
+    {
+        const short *tickSamples = &samples[tick * m_nbLanes];
+
+        // gather the lane inputs and the state that the symbol recovery may have changed
+        for (int lane = 0; lane < m_nbLanes; lane++)
+        {
+            const DSDSymbol& dsdSymbol = m_decoders[lane]->m_dsdSymbol;
+            m_input[lane] = tickSamples[lane];
+            m_center[lane] = dsdSymbol.m_center;
+            m_active[lane] = !dsdSymbol.m_noSignal;
+            m_pllEnabled[lane] = dsdSymbol.m_pllLock;
+        }
+
+        // matched filter
+        m_delayIndex = (m_delayIndex == 0 ? m_nbTaps - 1 : m_delayIndex - 1);
+
+        for (int lane = 0; lane < m_nbLanesPadded; lane++)
+        {
+            m_delay[m_delayIndex][lane] = m_input[lane];
+            m_delay[m_delayIndex + m_nbTaps][lane] = m_input[lane];
+        }
+
+        float sum[m_maxLanes];
+
+        for (int lane = 0; lane < m_nbLanesPadded; lane++) {
+            sum[lane] = 0.0f;
+        }
+
+        for (int k = m_nbActiveTaps - 1; k >= 0; k--) // oldest first like DSDFilters
+        {
+            const float *coeffs = m_coeffs[k];
+            const float *delay = m_delay[m_delayIndex + k];
+
+            for (int lane = 0; lane < m_nbLanesPadded; lane++) {
+                sum[lane] += coeffs[lane] * delay[lane];
+            }
+        }
+
+        // ringing filter and PLL. The state of lanes without signal is kept.
+        for (int lane = 0; lane < m_nbLanesPadded; lane++)
+        {
+            short filtered = (short) (sum[lane] / m_gain[lane]);
+            m_filtered[lane] = filtered;
+
+            int delta = (int) filtered - m_center[lane];
+            short sampleSq = (delta * delta) >> 15;
+            float v0 = m_ringingB0[lane] * sampleSq + m_ringingA1[lane] * m_ringingV1[lane] - m_ringingA2[lane] * m_ringingV2[lane];
+            short ringing = (short) (v0 - m_ringingV2[lane]);
+            int active = m_active[lane];
+            m_ringingV2[lane] = active ? m_ringingV1[lane] : m_ringingV2[lane];
+            m_ringingV1[lane] = active ? v0 : m_ringingV1[lane];
+            m_ringing[lane] = active ? ringing : 0;
+
+            // locked tone: sin and cos of the phase in [0, 2pi] from its [-pi/2, pi/2] reduction
+            float x = m_pllPhase[lane] - pi; // sin(phase) = -sin(x), cos(phase) = -cos(x)
+            float ax = fabsf(x);
+            int folded = ax > halfPi;
+            float ay = folded ? pi - ax : ax;
+            float y = x < 0.0f ? -ay : ay;
+            float cosSign = folded ? 1.0f : -1.0f;
+            float y2 = y * y;
+            float psin = -y * (1.0f + y2 * (-1.0f/6.0f + y2 * (1.0f/120.0f + y2 * (-1.0f/5040.0f + y2 * (1.0f/362880.0f)))));
+            float pcos = cosSign * (1.0f + y2 * (-1.0f/2.0f + y2 * (1.0f/24.0f + y2 * (-1.0f/720.0f + y2 * (1.0f/40320.0f - y2 * (1.0f/3628800.0f))))));
+
+            // multiply locked tone with input and run IQ phase error through low-pass filter
+            float pllIn = ringing / 32768.0f;
+            float phasorI = m_pllPhasorB0[lane] * psin * pllIn - m_pllPhasorA1[lane] * m_pllPhasorI1[lane] - m_pllPhasorA2[lane] * m_pllPhasorI2[lane];
+            float phasorQ = m_pllPhasorB0[lane] * pcos * pllIn - m_pllPhasorA1[lane] * m_pllPhasorQ1[lane] - m_pllPhasorA2[lane] * m_pllPhasorQ2[lane];
+
+            // phase error with linear arctan approximation within +/- 45 degrees
+            int inRange = phasorI > fabsf(phasorQ);
+            float ratio = phasorQ / (inRange ? phasorI : 1.0f);
+            float saturated = phasorQ > 0.0f ? 1.0f : -1.0f;
+            float phaseErr = inRange ? ratio : saturated;
+            int lockCount = m_pllLockCount[lane] + (fabsf(phaseErr) < m_pllMinSignal[lane] ? 1 : -1);
+            lockCount = std::max(0, std::min(2*m_pllLockDelay[lane], lockCount));
+
+            // loop filter, frequency and phase update
+            float freq = m_pllFreq[lane] + m_pllLoopFilterB0[lane] * phaseErr + m_pllLoopFilterB1[lane] * m_pllLoopFilterX1[lane];
+            freq = std::max(m_pllMinFreq[lane], std::min(m_pllMaxFreq[lane], freq));
+            float phase = m_pllPhase[lane] + freq;
+            phase = phase > 2.0f * pi ? phase - 2.0f * pi : phase;
+
+            int pllRun = active & m_pllEnabled[lane];
+            m_pllPhasorI2[lane] = pllRun ? m_pllPhasorI1[lane] : m_pllPhasorI2[lane];
+            m_pllPhasorI1[lane] = pllRun ? phasorI : m_pllPhasorI1[lane];
+            m_pllPhasorQ2[lane] = pllRun ? m_pllPhasorQ1[lane] : m_pllPhasorQ2[lane];
+            m_pllPhasorQ1[lane] = pllRun ? phasorQ : m_pllPhasorQ1[lane];
+            m_pllLockCount[lane] = pllRun ? lockCount : m_pllLockCount[lane];
+            m_pllLoopFilterX1[lane] = pllRun ? phaseErr : m_pllLoopFilterX1[lane];
+            m_pllFreq[lane] = pllRun ? freq : m_pllFreq[lane];
+            m_pllPhase[lane] = pllRun ? phase : m_pllPhase[lane];
+            m_pllOut[lane] = pllRun ? (short) (psin * 16384.0f) : 0;
+        }
+
+        // scalar symbol recovery and FSM of each channel
+        bool dvReady = false;
+
+        for (int lane = 0; lane < m_nbLanes; lane++)
+        {
+            DSDDecoder *dsdDecoder = m_decoders[lane];
+            dsdDecoder->runFrontEndOutput(tickSamples[lane], m_filtered[lane], m_ringing[lane], m_pllOut[lane]);
+            dvReady |= !dsdDecoder->m_audioSink && (dsdDecoder->m_mbeDVReady1 || dsdDecoder->m_mbeDVReady2); // sinks already have them
+        }
+
+        if (dvReady) {
+            return tick + 1;
+        }
+    }
+
+    return nbTicks;
+}
+
+} // namespace DSDcc
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_SYMBOLBATCH_H_
+#define DSDCC_DSD_SYMBOLBATCH_H_
+
+#include <stddef.h>
+
+#include "dsd_filters.h"
+#include "export.h"
+
+namespace DSDcc
+{
+
+class DSDDecoder;
+
+/**
+ * Symbol front end of up to 16 decoders (channels) processed together.
+ *
+ * The per sample part of the zero crossing symbol recovery (matched filter, ringing filter
+ * and symbol clock PLL) of all channels is kept in structure of arrays layout with one lane
+ * per channel so that each processing step is a plain loop across lanes that the compiler
+ * vectorizes (build with EXTRA_FLAGS=-mavx2 on x86_64 for 8 lanes per instruction, NEON
+ * gives 4 lanes on aarch64). The front end outputs are then passed to the scalar symbol
+ * recovery and FSM of each channel decoder.
+ *
+ * Decoders must run at 48 kS/s input with the default zero crossing timing recovery and without
+ * idle gate nor multi-rate auto detection. The data rate and matched filter options of each decoder
+ * are taken into account at the start of each run() call.
+ */
+class DSDCC_API DSDSymbolBatch
+{
+public:
+    static const int m_maxLanes = 16;
+
+    DSDSymbolBatch();
+    ~DSDSymbolBatch();
+
+    /** Add a decoder as a new lane. Returns the lane index or -1 if full or the decoder configuration is not supported */
+    int addDecoder(DSDDecoder *dsdDecoder);
+    int getNbLanes() const { return m_nbLanes; }
+    DSDDecoder *getDecoder(int lane) { return m_decoders[lane]; }
+
+    /**
+     * Process a block of samples. The samples are interleaved by lanes i.e. all lanes of the first
+     * sample tick come first: samples[tick*getNbLanes() + lane]
+     * Returns the number of ticks processed which is less than nbTicks if a lane decoder without
+     * audio sink has an AMBE/IMBE frame ready (see DSDDecoder::mbeDVReady1) so that the caller
+     * collects it before resuming. The ready flags of all lanes are cleared when run() is called again.
+     */
+    int run(const short *samples, int nbTicks);
+
+    bool getPLLLocked(int lane) const; //!< replaces DSDDecoder::getSymbolPLLLocked for the lanes
+    size_t getAllocatedSize() const { return sizeof(DSDSymbolBatch); }
+
+private:
+    static const int m_nbTaps = NXZEROS+1;
+
+    void configureLanes();
+    void configureLane(int lane);
+    void resetLaneFrontEnd(int lane);
+
+    DSDDecoder *m_decoders[m_maxLanes];
+    int m_nbLanes;
+    int m_nbLanesPadded;           //!< lanes processed by the vector loops (multiple of 8)
+    int m_samplesPerSymbol[m_maxLanes];
+    int m_filterMode[m_maxLanes];  //!< matched filter mode as in DSDFilters: 3 for 12.5 kHz, 4 for 6.25 kHz, 0 for none
+    int m_nbActiveTaps;            //!< largest matched filter length among lanes
+
+    // matched filter
+    float m_coeffs[m_nbTaps][m_maxLanes];   //!< by age of the sample (newest first) and zero padded
+    float m_delay[2*m_nbTaps][m_maxLanes];  //!< doubled newest first delay line
+    float m_gain[m_maxLanes];
+    int m_delayIndex;
+
+    // lane inputs and outputs of a sample tick
+    float m_input[m_maxLanes];
+    int m_center[m_maxLanes];
+    int m_active[m_maxLanes];      //!< lane has signal (DSDSymbol no signal flag cleared)
+    int m_pllEnabled[m_maxLanes];  //!< lane uses the PLL for the symbol clock
+    short m_filtered[m_maxLanes];
+    short m_ringing[m_maxLanes];
+    short m_pllOut[m_maxLanes];
+
+    // ringing filter
+    float m_ringingA1[m_maxLanes]; //!< 2 r cos(2 pi f)
+    float m_ringingA2[m_maxLanes]; //!< r^2
+    float m_ringingB0[m_maxLanes]; //!< 1 - r
+    float m_ringingV1[m_maxLanes];
+    float m_ringingV2[m_maxLanes];
+
+    // symbol clock PLL as in PhaseLock
+    float m_pllPhase[m_maxLanes];
+    float m_pllFreq[m_maxLanes];
+    float m_pllMinFreq[m_maxLanes];
+    float m_pllMaxFreq[m_maxLanes];
+    float m_pllMinSignal[m_maxLanes];
+    float m_pllPhasorB0[m_maxLanes];
+    float m_pllPhasorA1[m_maxLanes];
+    float m_pllPhasorA2[m_maxLanes];
+    float m_pllPhasorI1[m_maxLanes];
+    float m_pllPhasorI2[m_maxLanes];
+    float m_pllPhasorQ1[m_maxLanes];
+    float m_pllPhasorQ2[m_maxLanes];
+    float m_pllLoopFilterB0[m_maxLanes];
+    float m_pllLoopFilterB1[m_maxLanes];
+    float m_pllLoopFilterX1[m_maxLanes];
+    int m_pllLockDelay[m_maxLanes];
+    int m_pllLockCount[m_maxLanes];
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_SYMBOLBATCH_H_ */
@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "dsd_symbolcapture.h"
+
+namespace DSDcc
+{
+
+DSDSymbolCapture::DSDSymbolCapture() :
+    m_file(0),
+    m_buffer(0),
+    m_sampleCount(0),
+    m_symbolCount(0)
+{}
+
+DSDSymbolCapture::~DSDSymbolCapture()
+{
+    close();
+}
+
+bool DSDSymbolCapture::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "wb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    m_buffer = new char[m_bufferSize];
+    setvbuf(m_file, m_buffer, _IOFBF, m_bufferSize);
+
+    static const unsigned char magic[8] = {'D', 'S', 'D', 'C', 'S', 'Y', 'M', 1};
+    fwrite(magic, 1, 8, m_file);
+    m_sampleCount = 0;
+    m_symbolCount = 0;
+    return true;
+}
+
+void DSDSymbolCapture::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+
+    delete[] m_buffer;
+    m_buffer = 0;
+}
+
+void DSDSymbolCapture::write(const Symbol& symbol)
+{
+    unsigned char record[16];
+    int size = 1;
+    int64_t delta = (int64_t) (symbol.m_sampleCount - m_sampleCount);
+    uint64_t zigzag = (((uint64_t) delta) << 1) ^ (uint64_t) (delta >> 63);
+
+    record[0] = (symbol.m_levelsSnap ? 1 : 0)
+        + (symbol.m_squelchReset ? 2 : 0)
+        + (symbol.m_dataRate >= 0 ? 4 : 0)
+        + (symbol.m_rateSwitch ? 8 : 0)
+        + ((symbol.m_dibit & 3) << 6);
+
+    do
+    {
+        record[size++] = (zigzag & 0x7f) | (zigzag > 0x7f ? 0x80 : 0);
+        zigzag >>= 7;
+    } while (zigzag);
+
+    record[size++] = symbol.m_value & 0xff;
+    record[size++] = (symbol.m_value >> 8) & 0xff;
+
+    if (symbol.m_levelsSnap)
+    {
+        record[size++] = symbol.m_sampleMin & 0xff;
+        record[size++] = (symbol.m_sampleMin >> 8) & 0xff;
+        record[size++] = symbol.m_sampleMax & 0xff;
+        record[size++] = (symbol.m_sampleMax >> 8) & 0xff;
+    }
+
+    if (symbol.m_dataRate >= 0) {
+        record[size++] = symbol.m_dataRate;
+    }
+
+    fwrite(record, 1, size, m_file);
+    m_sampleCount = symbol.m_sampleCount;
+    m_symbolCount++;
+}
+
+DSDSymbolCapture::Reader::Reader() :
+    m_file(0),
+    m_sampleCount(0),
+    m_buffer(0)
+{}
+
+DSDSymbolCapture::Reader::~Reader()
+{
+    close();
+}
+
+bool DSDSymbolCapture::Reader::open(const char *filename)
+{
+    close();
+    m_file = fopen(filename, "rb");
+
+    if (!m_file) {
+        return false;
+    }
+
+    m_buffer = new char[m_bufferSize];
+    setvbuf(m_file, m_buffer, _IOFBF, m_bufferSize);
+    unsigned char magic[8];
+
+    if ((fread(magic, 1, 8, m_file) != 8) || (memcmp(magic, "DSDCSYM", 7) != 0) || (magic[7] != 1))
+    {
+        close();
+        return false;
+    }
+
+    m_sampleCount = 0;
+    return true;
+}
+
+void DSDSymbolCapture::Reader::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+
+    delete[] m_buffer;
+    m_buffer = 0;
+}
+
+bool DSDSymbolCapture::Reader::next(Symbol& symbol)
+{
+    if (!m_file) {
+        return false;
+    }
+
+    int c = getc(m_file);
+
+    if (c == EOF) {
+        return false;
+    }
+
+    unsigned char flags = c;
+    uint64_t zigzag = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if ((c = getc(m_file)) == EOF) {
+            return false;
+        }
+
+        zigzag |= ((uint64_t) (c & 0x7f)) << shift;
+
+        if ((c & 0x80) == 0) {
+            break;
+        }
+    }
+
+    unsigned char data[7];
+    int size = 2 + ((flags & 1) ? 4 : 0) + ((flags & 0xc) ? 1 : 0);
+
+    if (fread(data, 1, size, m_file) != (size_t) size) {
+        return false;
+    }
+
+    m_sampleCount += (uint64_t) ((int64_t) (zigzag >> 1) ^ -((int64_t) (zigzag & 1)));
+    symbol.m_sampleCount = m_sampleCount;
+    symbol.m_value = (short) (data[0] + (data[1] << 8));
+    symbol.m_dibit = flags >> 6;
+    symbol.m_levelsSnap = (flags & 1) != 0;
+    symbol.m_squelchReset = (flags & 2) != 0;
+    symbol.m_rateSwitch = (flags & 8) != 0;
+    int i = 2;
+
+    if (symbol.m_levelsSnap)
+    {
+        symbol.m_sampleMin = (short) (data[2] + (data[3] << 8));
+        symbol.m_sampleMax = (short) (data[4] + (data[5] << 8));
+        i += 4;
+    }
+
+    symbol.m_dataRate = (flags & 0xc) ? data[i] : -1;
+    return true;
+}
+
+} // namespace DSDcc
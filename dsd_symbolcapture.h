@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_SYMBOLCAPTURE_H_
+#define DSDCC_DSD_SYMBOLCAPTURE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Capture of the symbol stream produced by DSDSymbol (see DSDDecoder::setSymbolCapture) that
+ * can be replayed into the sync search and protocol decoders with DSDDecoder::runSymbol
+ * without running the per sample processing again.
+ *
+ * The file starts with the 8 bytes "DSDCSYM" followed by the format version. Then each symbol is:
+ *
+ *   - uint8  flags: bit 0 levels refreshed, bit 1 squelch time out, bit 2 data rate set,
+ *            bit 3 data rate switched by auto detection, bits 6..7 hard dibit at capture
+ *   - varint zigzag encoded difference of the sample count with the previous symbol
+ *   - int16  symbol value (little endian)
+ *   - int16  min and max of the samples if the levels were refreshed
+ *   - uint8  DSDDecoder::DSDRate if the data rate was set or switched
+ *
+ * A symbol takes 4 bytes most of the time. Data is written through a large stdio buffer.
+ */
+class DSDCC_API DSDSymbolCapture
+{
+public:
+    struct Symbol
+    {
+        uint64_t m_sampleCount;     //!< input sample count at 48 kS/s when the symbol was concluded
+        short m_value;              //!< symbol value before digitizing
+        unsigned char m_dibit;      //!< hard decision at capture time (replay decides again)
+        bool m_levelsSnap;          //!< levels refreshed at this symbol
+        short m_sampleMin;          //!< running min of the samples at the refresh
+        short m_sampleMax;          //!< running max of the samples at the refresh
+        bool m_squelchReset;        //!< the squelch time out reset the sync search before this symbol
+        int m_dataRate;             //!< DSDDecoder::DSDRate set before this symbol or -1
+        bool m_rateSwitch;          //!< the data rate was switched by the rate auto detection
+
+        Symbol() :
+            m_sampleCount(0),
+            m_value(0),
+            m_dibit(0),
+            m_levelsSnap(false),
+            m_sampleMin(0),
+            m_sampleMax(0),
+            m_squelchReset(false),
+            m_dataRate(-1),
+            m_rateSwitch(false)
+        {}
+    };
+
+    DSDSymbolCapture();
+    ~DSDSymbolCapture();
+
+    bool open(const char *filename);
+    void close();
+    bool isOpen() const { return m_file != 0; }
+    void write(const Symbol& symbol);
+    uint64_t getSymbolCount() const { return m_symbolCount; }
+
+    /** Sequential reader of a symbol capture file */
+    class DSDCC_API Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+        bool open(const char *filename); //!< false if the file cannot be opened or is not a symbol capture
+        void close();
+        bool next(Symbol& symbol); //!< false at the end of the file
+
+    private:
+        FILE *m_file;
+        uint64_t m_sampleCount;
+        char *m_buffer;
+    };
+
+    static const unsigned int m_bufferSize = 1<<16;
+
+private:
+    FILE *m_file;
+    char *m_buffer;
+    uint64_t m_sampleCount;         //!< of the previous symbol
+    uint64_t m_symbolCount;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_SYMBOLCAPTURE_H_ */
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsd_syncindex.h"
+#include "dsd_decoder.h"
+
+namespace DSDcc
+{
+
+DSDSyncIndex::DSDSyncIndex() :
+    m_active(true),
+    m_sampleCount(0)
+{
+    m_idleGate.setEnabled(true);
+    m_rateDetector.setEnabled(true);
+    DSDDecoder::addRateSyncPatterns(m_rateDetector);
+
+    m_region.m_start = 0;
+    m_region.m_end = 0;
+    m_region.m_firstSync = 0;
+    m_region.m_lastSync = 0;
+    m_region.m_nbSyncs = 0;
+    m_region.m_rate = -1;
+    m_region.m_syncType = -1;
+}
+
+DSDSyncIndex::~DSDSyncIndex()
+{}
+
+void DSDSyncIndex::scan(const short *samples, unsigned int nbSamples)
+{
+    for (unsigned int i = 0; i < nbSamples; i++, m_sampleCount++)
+    {
+        switch (m_idleGate.push(samples[i], true))
+        {
+        case DSDIdleGate::GateParked:
+            if (m_active)
+            {
+                m_region.m_end = m_sampleCount;
+                m_regions.push_back(m_region);
+                m_active = false;
+                m_rateDetector.push(samples[i], -1); // trackers are reset when scanning again
+            }
+            break;
+        case DSDIdleGate::GateWake:
+        {
+            // the history of the parked period including this sample belongs to the new region
+            int replaySize = m_idleGate.getReplaySize();
+            m_region.m_start = m_sampleCount + 1 - replaySize;
+            m_region.m_nbSyncs = 0;
+            m_region.m_rate = -1;
+            m_region.m_syncType = -1;
+            m_active = true;
+            uint64_t sampleCount = m_sampleCount;
+
+            for (int j = 0; j < replaySize; j++)
+            {
+                m_sampleCount = sampleCount + 1 - replaySize + j;
+                pushActive(m_idleGate.getReplaySample(j));
+            }
+
+            m_sampleCount = sampleCount;
+            break;
+        }
+        default:
+            pushActive(samples[i]);
+            break;
+        }
+    }
+}
+
+void DSDSyncIndex::pushActive(short sample)
+{
+    int rateIndex = m_rateDetector.push(sample, DSDRateDetector::m_nbRates);
+
+    if (rateIndex < 0) {
+        return;
+    }
+
+    if (m_region.m_nbSyncs == 0)
+    {
+        m_region.m_firstSync = m_sampleCount;
+        m_region.m_rate = rateIndex;
+        m_region.m_syncType = m_rateDetector.getSyncType(rateIndex);
+    }
+
+    m_region.m_lastSync = m_sampleCount;
+    m_region.m_nbSyncs++;
+}
+
+void DSDSyncIndex::finish()
+{
+    if (m_active)
+    {
+        m_region.m_end = m_sampleCount;
+        m_regions.push_back(m_region);
+        m_active = false;
+    }
+}
+
+void DSDSyncIndex::getCuts(std::vector<uint64_t>& cuts, uint64_t minPartSize, uint64_t minGap) const
+{
+    cuts.clear();
+    uint64_t lastCut = 0;
+
+    for (unsigned int i = 1; i < m_regions.size(); i++)
+    {
+        uint64_t gapStart = m_regions[i-1].m_end;
+        uint64_t gapEnd = m_regions[i].m_start;
+
+        if (gapEnd < gapStart + minGap) {
+            continue;
+        }
+
+        uint64_t cut = gapStart + (gapEnd - gapStart) / 2;
+
+        if (cut >= lastCut + minPartSize)
+        {
+            cuts.push_back(cut);
+            lastCut = cut;
+        }
+    }
+}
+
+} // namespace DSDcc
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DSDCC_DSD_SYNCINDEX_H_
+#define DSDCC_DSD_SYNCINDEX_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "dsd_idlegate.h"
+#include "dsd_ratedetector.h"
+#include "export.h"
+
+namespace DSDcc
+{
+
+/**
+ * Fast pre-scan of a discriminator recording at 48 kS/s building an index of the transmissions.
+ *
+ * Only the idle gate energy test (see DSDIdleGate) runs on every sample. While the channel is
+ * active the multi-rate sync trackers (see DSDRateDetector) look for the sync words of all
+ * protocols at all rates. A region is an active period with the syncs found in it.
+ *
+ * The index is used to split the recording in parts at the gaps between transmissions so that
+ * the parts can be decoded independently (see getCuts).
+ */
+class DSDCC_API DSDSyncIndex
+{
+public:
+    struct Region
+    {
+        uint64_t m_start;       //!< first sample of the active period (including the idle gate history)
+        uint64_t m_end;         //!< sample following the active period
+        uint64_t m_firstSync;   //!< sample at which the first sync fired if any
+        uint64_t m_lastSync;    //!< sample at which the last sync fired if any
+        unsigned int m_nbSyncs;
+        int m_rate;             //!< DSDDecoder::DSDRate of the first sync or -1
+        int m_syncType;         //!< DSDDecoder::DSDSyncType of the first sync or -1
+    };
+
+    DSDSyncIndex();
+    ~DSDSyncIndex();
+
+    /** Scans the next samples of the recording */
+    void scan(const short *samples, unsigned int nbSamples);
+    /** Closes the region in progress at the end of the recording */
+    void finish();
+    const std::vector<Region>& getRegions() const { return m_regions; }
+    uint64_t getSampleCount() const { return m_sampleCount; }
+
+    /**
+     * Cut points splitting the recording in parts of at least minPartSize samples. Cuts are placed
+     * in the middle of the gaps between regions at least minGap samples long and are in ascending order.
+     */
+    void getCuts(std::vector<uint64_t>& cuts, uint64_t minPartSize, uint64_t minGap) const;
+
+private:
+    void pushActive(short sample);
+
+    DSDIdleGate m_idleGate;
+    DSDRateDetector m_rateDetector;
+    std::vector<Region> m_regions;
+    Region m_region;                //!< region in progress
+    bool m_active;
+    uint64_t m_sampleCount;
+};
+
+} // namespace DSDcc
+
+#endif /* DSDCC_DSD_SYNCINDEX_H_ */
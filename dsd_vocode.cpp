@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dsd_decoder.h"
+#include "dsd_mbefile.h"
+
+struct VocodeOptions
+{
+    VocodeOptions() :
+        m_gain(0.0f),
+        m_upsampling(0),
+        m_uvQuality(3),
+        m_useHP(false)
+    {}
+
+    std::string m_outDir;
+    float m_gain;
+    int m_upsampling;
+    int m_uvQuality;
+    bool m_useHP;
+};
+
+struct VocodeResult
+{
+    VocodeResult() :
+        m_ok(false),
+        m_frames(0),
+        m_unsupported(0),
+        m_samples(0)
+    {}
+
+    bool m_ok;
+    uint64_t m_frames;
+    uint64_t m_unsupported;   //!< frames of a rate that cannot be synthesized
+    uint64_t m_samples;       //!< audio samples written (all slots)
+};
+
+/** Writes the audio of each slot to its own file created on the first audio frame */
+class VocodeWriter : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    VocodeWriter(const std::string& baseName) :
+        m_baseName(baseName),
+        m_samples(0)
+    {
+        m_files[0] = 0;
+        m_files[1] = 0;
+    }
+
+    virtual ~VocodeWriter()
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (m_files[i]) {
+                fclose(m_files[i]);
+            }
+        }
+    }
+
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp __attribute__((unused)))
+    {
+        slot = slot & 1;
+
+        if (!m_files[slot])
+        {
+            std::string fileName = m_baseName + (slot ? ".slot2.raw" : ".raw");
+            m_files[slot] = fopen(fileName.c_str(), "wb");
+
+            if (!m_files[slot])
+            {
+                fprintf(stderr, "Cannot open %s for output\n", fileName.c_str());
+                return;
+            }
+        }
+
+        fwrite(samples, sizeof(short), nbSamples, m_files[slot]);
+        m_samples += nbSamples;
+    }
+
+    uint64_t getSamples() const { return m_samples; }
+
+private:
+    std::string m_baseName;
+    FILE *m_files[2];
+    uint64_t m_samples;
+};
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc-vocode [options] <frames file> [<frames file>...]\n");
+    fprintf(stderr, "Synthesizes the AMBE/IMBE frames recorded by dsdccx -A to 8 kS/s S16LE audio with mbelib.\n");
+    fprintf(stderr, "The audio of <name>.amb is written to <name>.raw and <name>.slot2.raw for the second TDMA slot.\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -j <num>      Number of files synthesized in parallel (default is the number of cores)\n");
+    fprintf(stderr, "  -o <dir>      Output directory (default is the directory of each input file)\n");
+    fprintf(stderr, "  -g <num>      Audio output gain (default = 0 = auto)\n");
+    fprintf(stderr, "  -U <num>      Audio upsampling factor 2 to 7 (6 gives 48 kS/s)\n");
+    fprintf(stderr, "  -u <num>      Unvoiced speech quality (default=3)\n");
+    fprintf(stderr, "  -H            Use high-pass filter on audio\n");
+}
+
+static std::string outputBaseName(const VocodeOptions& options, const std::string& inFileName)
+{
+    size_t slash = inFileName.find_last_of('/');
+    std::string baseName = inFileName;
+
+    if (options.m_outDir.size() > 0) {
+        baseName = options.m_outDir + "/" + (slash == std::string::npos ? inFileName : inFileName.substr(slash + 1));
+    }
+
+    size_t dot = baseName.find_last_of('.');
+    slash = baseName.find_last_of('/');
+
+    if ((dot != std::string::npos) && ((slash == std::string::npos) || (dot > slash))) {
+        baseName.erase(dot);
+    }
+
+    return baseName;
+}
+
+static void vocodeFile(const VocodeOptions& options, const std::string& inFileName, VocodeResult& result)
+{
+    DSDcc::DSDMBEFile::Reader reader;
+
+    if (!reader.open(inFileName.c_str()))
+    {
+        fprintf(stderr, "Cannot open %s as an AMBE/IMBE frames file\n", inFileName.c_str());
+        return;
+    }
+
+    DSDcc::DSDDecoder dsdDecoder;
+    VocodeWriter writer(outputBaseName(options, inFileName));
+
+    dsdDecoder.setQuiet();
+    dsdDecoder.setAudioGain(options.m_gain);
+    dsdDecoder.setUpsampling(options.m_upsampling);
+    dsdDecoder.setUvQuality(options.m_uvQuality);
+    dsdDecoder.useHPMbelib(options.m_useHP);
+    dsdDecoder.setAudioSink(&writer);
+
+    DSDcc::DSDMBEFile::Frame frame;
+
+    while (reader.next(frame))
+    {
+        result.m_frames++;
+
+        if (!dsdDecoder.vocodeDVFrame(frame.m_slot, frame.m_data, (DSDcc::DSDDecoder::DSDMBERate) frame.m_mbeRate, frame.m_timestamp)) {
+            result.m_unsupported++;
+        }
+    }
+
+    result.m_samples = writer.getSamples();
+    result.m_ok = true;
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    extern int optind;
+    VocodeOptions options;
+    unsigned int nbThreads = std::thread::hardware_concurrency();
+
+    while ((c = getopt(argc, argv, "hj:o:g:U:u:H")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'j':
+            nbThreads = atoi(optarg);
+            break;
+        case 'o':
+            options.m_outDir = optarg;
+            break;
+        case 'g':
+            options.m_gain = atof(optarg);
+            break;
+        case 'U':
+            options.m_upsampling = atoi(optarg);
+            break;
+        case 'u':
+            options.m_uvQuality = atoi(optarg);
+            break;
+        case 'H':
+            options.m_useHP = true;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        usage();
+        return 1;
+    }
+
+#ifndef DSD_USE_MBELIB
+    fprintf(stderr, "Warning: DSDcc is built without mbelib support. No audio will be produced.\n");
+#endif
+
+    std::vector<std::string> inFileNames(argv + optind, argv + argc);
+    std::vector<VocodeResult> results(inFileNames.size());
+    std::atomic<unsigned int> nextFile(0);
+
+    if (nbThreads < 1) {
+        nbThreads = 1;
+    }
+
+    if (nbThreads > inFileNames.size()) {
+        nbThreads = inFileNames.size();
+    }
+
+    // each worker takes the next file to synthesize with its own decoder
+    std::vector<std::thread> workers;
+
+    for (unsigned int i = 0; i < nbThreads; i++)
+    {
+        workers.push_back(std::thread([&]() {
+            unsigned int fileIndex;
+
+            while ((fileIndex = nextFile.fetch_add(1)) < inFileNames.size()) {
+                vocodeFile(options, inFileNames[fileIndex], results[fileIndex]);
+            }
+        }));
+    }
+
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+
+    int nbFailed = 0;
+
+    for (unsigned int i = 0; i < inFileNames.size(); i++)
+    {
+        if (!results[i].m_ok)
+        {
+            nbFailed++;
+            continue;
+        }
+
+        fprintf(stderr, "%s: %llu frames (%llu not supported) %llu audio samples\n",
+                inFileNames[i].c_str(),
+                (unsigned long long) results[i].m_frames,
+                (unsigned long long) results[i].m_unsupported,
+                (unsigned long long) results[i].m_samples);
+    }
+
+    return nbFailed > 0 ? 1 : 0;
+}
@@ -18,6 +18,7 @@
 #include <math.h>
 
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 #include "descramble.h"
 #include "dstar.h"
 
@@ -155,6 +156,109 @@ DSDDstar::~DSDDstar()
 {
 }
 
+void DSDDstar::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU8(m_voiceFrameCount);
+    buffer.writeU8(m_frameType);
+    buffer.writeU16(m_symbolIndex);
+    buffer.writeU16(m_symbolIndexHD);
+    buffer.writeBytes(nullBytes, 4);
+    buffer.writeBytes(slowdata, 4);
+    buffer.writeU8(slowdataIx);
+    buffer.writeU8(w ? w - dW : 0xFF); // w and x move together in the AMBE frame interleave
+    buffer.writeString(m_header.m_rpt1.c_str());
+    buffer.writeString(m_header.m_rpt2.c_str());
+    buffer.writeString(m_header.m_yourSign.c_str());
+    buffer.writeString(m_header.m_mySign.c_str());
+    buffer.writeBool(m_header.m_rpt1FromHD);
+    buffer.writeBool(m_header.m_rpt2FromHD);
+    buffer.writeBool(m_header.m_yourSignFromHD);
+    buffer.writeBool(m_header.m_mySignFromHD);
+    buffer.writeInt(m_slowData.counter);
+    buffer.writeBytes(m_slowData.radioHeader, 41);
+    buffer.writeU8(m_slowData.radioHeaderIndex);
+    buffer.writeBytes(m_slowData.text, 20);
+    buffer.writeU8(m_slowData.textFrameIndex);
+    buffer.writeU16(m_slowData.gpsIndex);
+    buffer.writeBytes(m_slowData.gpsNMEA, m_slowData.gpsIndex < 256 ? m_slowData.gpsIndex : 256);
+    buffer.writeBool(m_slowData.gpsStart);
+    buffer.writeBytes(m_slowData.locator, 6);
+    buffer.writeInt(m_slowData.bearing);
+    buffer.writeFloat(m_slowData.distance);
+    buffer.writeU8(m_slowData.currentDataType);
+    buffer.writeFloat(m_dprs.m_lat);
+    buffer.writeFloat(m_dprs.m_lon);
+    buffer.writeFloat(m_dprs.m_locPoint.latitude());
+    buffer.writeFloat(m_dprs.m_locPoint.longitude());
+}
+
+void DSDDstar::restoreState(DSDStateBuffer& buffer)
+{
+    char text[256];
+    m_voiceFrameCount = buffer.readU8(20);
+    m_frameType = (DStarFrameTYpe) buffer.readEnum(DStarSyncFrame);
+    // a data frame is 24 bits and its slow data index advances every 8 bits
+    m_symbolIndex = buffer.readU16(m_frameType == DStarDataFrame ? 24 - 1 : m_frameType == DStarVoiceFrame ? 72 - 1 : 72);
+    m_symbolIndexHD = buffer.readU16(660 - 1);
+    buffer.readBytes(nullBytes, 4);
+    buffer.readBytes(slowdata, 4);
+    slowdataIx = buffer.readU8((m_frameType == DStarDataFrame) && (m_symbolIndex > 0) ? (m_symbolIndex - 1) / 8 : 3);
+    int interleaveIndex = buffer.readU8();
+    w = interleaveIndex <= 72 ? dW + interleaveIndex : 0;
+    x = interleaveIndex <= 72 ? dX + interleaveIndex : 0;
+    buffer.readString(text, sizeof(text));
+    m_header.m_rpt1 = text;
+    buffer.readString(text, sizeof(text));
+    m_header.m_rpt2 = text;
+    buffer.readString(text, sizeof(text));
+    m_header.m_yourSign = text;
+    buffer.readString(text, sizeof(text));
+    m_header.m_mySign = text;
+    m_header.m_rpt1FromHD = buffer.readBool();
+    m_header.m_rpt2FromHD = buffer.readBool();
+    m_header.m_yourSignFromHD = buffer.readBool();
+    m_header.m_mySignFromHD = buffer.readBool();
+    m_slowData.counter = buffer.readInt(0, 15);
+    buffer.readBytes(m_slowData.radioHeader, 41);
+    m_slowData.radioHeaderIndex = buffer.readU8(41);
+    buffer.readBytes(m_slowData.text, 20);
+    m_slowData.textFrameIndex = buffer.readU8(3);
+    m_slowData.gpsIndex = buffer.readU16(256 - 1);
+    memset(m_slowData.gpsNMEA, 0, 256);
+    buffer.readBytes(m_slowData.gpsNMEA, m_slowData.gpsIndex);
+    m_slowData.gpsStart = buffer.readBool();
+    buffer.readBytes(m_slowData.locator, 6);
+    m_slowData.bearing = buffer.readInt();
+    m_slowData.distance = buffer.readFloat();
+    m_slowData.currentDataType = (DStarSlowDataType) buffer.readEnum(DStarSlowDataNone);
+
+    if ((m_slowData.currentDataType == DStarSlowDataText) && (m_slowData.counter > 5)) { // text is by 5 bytes
+        buffer.reject();
+    }
+
+    m_dprs.m_lat = buffer.readFloat();
+    m_dprs.m_lon = buffer.readFloat();
+    float latitude = buffer.readFloat();
+    m_dprs.m_locPoint.setLatLon(latitude, buffer.readFloat());
+}
+
+void DSDDstar::reset()
+{
+    m_voiceFrameCount = 0;
+    m_frameType = DStarVoiceFrame;
+    m_symbolIndex = 0;
+    m_symbolIndexHD = 0;
+    slowdataIx = 0;
+    w = 0;
+    x = 0;
+    m_header.clear();
+    m_dprs = DPRS();
+    reset_header_strings();
+    m_slowData.init();
+    memset(nullBytes, 0, 4);
+    memset(slowdata, 0, 4);
+}
+
 void DSDDstar::init(bool header)
 {
     //fprintf(stderr, "DSDDstar::init: symbol %d (%d)\n", m_dsdDecoder->m_state.symbolcnt, m_dsdDecoder->m_dsdSymbol.getSymbol());
@@ -193,7 +297,7 @@ void DSDDstar::initDataFrame()
 
 void DSDDstar::reset_header_strings()
 {
-    std::cerr << "DSDDstar::reset_header_strings" << std::endl;
+    m_dsdDecoder->getLogger().debug("DSDDstar::reset_header_strings\n");
     m_header.clear();
 }
 
@@ -221,9 +325,12 @@ void DSDDstar::processVoice()
         initVoiceFrame();
     }
 
-    m_dsdDecoder->ambe_fr[*w][*x] = (1 & bit);
-    w++;
-    x++;
+    if (w && (w < dW + 72)) // a restored interleave position may be out of step with the frame
+    {
+        m_dsdDecoder->ambe_fr[*w][*x] = (1 & bit);
+        w++;
+        x++;
+    }
 
     storeSymbolDV(m_symbolIndex, (1 & bit)); // store bits in order in DVSI frame
 
@@ -236,7 +343,7 @@ void DSDDstar::processVoice()
         }
 
         m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 
         m_symbolIndex = 0;
 
@@ -404,8 +511,11 @@ void DSDDstar::processSlowDataByte(unsigned char byte)
         m_slowData.text[5*m_slowData.textFrameIndex + 5 -m_slowData.counter] = byte < 32 || byte > 127 ? 46 : byte;
         break;
     case DStarSlowDataGPS:
-        m_slowData.gpsNMEA[m_slowData.gpsIndex] = byte;
-        m_slowData.gpsIndex++;
+        if (m_slowData.gpsIndex < 256 - 1) // room for the terminating null
+        {
+            m_slowData.gpsNMEA[m_slowData.gpsIndex] = byte;
+            m_slowData.gpsIndex++;
+        }
         break;
     default:
         break;
@@ -419,7 +529,16 @@ void DSDDstar::processSlowDataGroup()
     case DStarSlowDataHeader:
         if (m_slowData.radioHeaderIndex == 41) // last byte
         {
-            if (m_crcDStar.check_crc((unsigned char *) m_slowData.radioHeader, 41))
+            bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCDStar, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageDStarCRC, m_crcDStar.check_crc((unsigned char *) m_slowData.radioHeader, 41)));
+
+            if (m_dsdDecoder->m_capture)
+            {
+                DSDCapture::Frame frame(DSDCapture::FrameDStarSlowHeader);
+                frame.setCRC(crcOK);
+                m_dsdDecoder->captureBytes(frame, (const unsigned char *) m_slowData.radioHeader, 41*8);
+            }
+
+            if (crcOK)
         	{
 //                std::cerr << "DSDDstar::processSlowDataGroup: DStarSlowDataHeader OK" << std::endl;
                 m_header.setRpt2((const char *) &m_slowData.radioHeader[3], false);
@@ -474,6 +593,7 @@ void DSDDstar::processSync()
         {
 //            std::cerr << "DSDDstar::processSync: TERMINATE" << std::endl;
 
+            m_dsdDecoder->endCall(0, DSDDecoder::CallInfo::CallEndTerminator);
             m_dsdDecoder->m_voice1On = false;
             reset_header_strings();
             m_slowData.init();
@@ -492,6 +612,7 @@ void DSDDstar::processHD()
         reset_header_strings();
         m_slowData.init();
         dstar_header_decode();
+        m_dsdDecoder->startCall(0, DSDStatus::ProtocolDStar);
         init(); // init for DSTAR
         m_frameType = DStarVoiceFrame; // we start on a voice frame
         m_voiceFrameCount = 20;        // we start at one frame before sync
@@ -514,7 +635,7 @@ void DSDDstar::dstar_header_decode()
     Descramble::scramble(m_dsdDecoder->m_dsdSymbol.getDibitBack(660), radioheaderbuffer2);
     Descramble::deinterleave(radioheaderbuffer2, radioheaderbuffer3);
 //    Descramble::FECdecoder(radioheaderbuffer3, radioheaderbuffer2);
-    m_viterbi.decodeFromBits(radioheaderbuffer2, radioheaderbuffer3, 660, 0);
+    DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi3, m_viterbi.decodeFromBits(radioheaderbuffer2, radioheaderbuffer3, 660, 0));
     memset(radioheader, 0, 41);
 
     // note we receive 330 bits, but we only use 328 of them (41 octets)
@@ -539,6 +660,13 @@ void DSDDstar::dstar_header_decode()
         }
     }
 
+    if (m_dsdDecoder->m_capture)
+    {
+        DSDCapture::Frame frame(DSDCapture::FrameDStarHeader);
+        frame.setCRC(m_crcDStar.check_crc(radioheader, 41));
+        m_dsdDecoder->captureBits(frame, radioheaderbuffer2, 328);
+    }
+
     m_dsdDecoder->getLogger().log("\nDSTAR HEADER: ");
 
     m_header.setRpt2((const char *) &radioheader[3], true);
@@ -566,6 +694,15 @@ void DSDDstar::storeSymbolDV(int bitindex, unsigned char bit, bool lsbFirst)
     }
 }
 
+void DSDDstar::unpackDVFrame(const unsigned char *dvFrame, char ambe_fr[4][24])
+{
+    memset(ambe_fr, 0, 4*24);
+
+    for (int i = 0; i < 72; i++) {
+        ambe_fr[dW[i]][dX[i]] = (dvFrame[i/8] >> (i%8)) & 1; // LSB first
+    }
+}
+
 void DSDDstar::processDPRS()
 {
     m_slowData.gpsNMEA[m_slowData.gpsIndex] = '\0';
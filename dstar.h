@@ -27,12 +27,16 @@ namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDDstar
 {
 public:
 	explicit DSDDstar(DSDDecoder *dsdDecoder);
    ~DSDDstar();
+   void reset(); //!< back to the state after construction keeping the FEC and interleaving tables
+   void saveState(DSDStateBuffer& buffer) const;    //!< frame in progress, header and slow data
+   void restoreState(DSDStateBuffer& buffer);
 
    void init(bool header = false);
    void process();
@@ -47,6 +51,9 @@ public:
    int getBearing() const { return m_slowData.bearing; }
    float getDistance() const { return m_slowData.distance; }
 
+   /** AMBE 3600x2400 frame bits from a DVSI frame of bits */
+   static void unpackDVFrame(const unsigned char *dvFrame, char ambe_fr[4][24]);
+
 private:
    typedef enum
    {
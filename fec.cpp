@@ -278,7 +278,8 @@ const unsigned char QR_16_7_6::m_H[16*9] = {
 
 // ========================================================================================
 
-Hamming_7_4::Hamming_7_4()
+Hamming_7_4::Hamming_7_4() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -308,6 +309,7 @@ void Hamming_7_4::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Hamming_7_4::decode(unsigned char *rxBits) // corrects in place
 {
+    m_nbCorrected = 0;
     unsigned int syndromeI = 0; // syndrome index
 
     for (int is = 0; is < 3; is++)
@@ -330,6 +332,7 @@ bool Hamming_7_4::decode(unsigned char *rxBits) // corrects in place
         else
         {
             rxBits[m_corr[syndromeI]] ^= 1; // flip bit
+            m_nbCorrected++;
         }
     }
 
@@ -338,7 +341,8 @@ bool Hamming_7_4::decode(unsigned char *rxBits) // corrects in place
 
 // ========================================================================================
 
-Hamming_12_8::Hamming_12_8()
+Hamming_12_8::Hamming_12_8() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -368,6 +372,7 @@ void Hamming_12_8::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Hamming_12_8::decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords)
 {
+    m_nbCorrected = 0;
     bool correctable = true;
 
     for (int ic = 0; ic < nbCodewords; ic++)
@@ -403,6 +408,7 @@ bool Hamming_12_8::decode(unsigned char *rxBits, unsigned char *decodedBits, int
             else
             {
                 rxBits[m_corr[syndromeI]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -415,7 +421,8 @@ bool Hamming_12_8::decode(unsigned char *rxBits, unsigned char *decodedBits, int
 
 // ========================================================================================
 
-Hamming_16_11_4::Hamming_16_11_4()
+Hamming_16_11_4::Hamming_16_11_4() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -445,6 +452,7 @@ void Hamming_16_11_4::encode(unsigned char *origBits, unsigned char *encodedBits
 
 bool Hamming_16_11_4::decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords)
 {
+    m_nbCorrected = 0;
     bool correctable = true;
 
     for (int ic = 0; ic < nbCodewords; ic++)
@@ -485,6 +493,7 @@ bool Hamming_16_11_4::decode(unsigned char *rxBits, unsigned char *decodedBits,
             else
             {
                 rxBits[m_corr[syndromeI]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -500,7 +509,8 @@ bool Hamming_16_11_4::decode(unsigned char *rxBits, unsigned char *decodedBits,
 
 // ========================================================================================
 
-Hamming_15_11::Hamming_15_11()
+Hamming_15_11::Hamming_15_11() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -530,6 +540,7 @@ void Hamming_15_11::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Hamming_15_11::decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords)
 {
+    m_nbCorrected = 0;
     bool correctable = true;
 
     for (int ic = 0; ic < nbCodewords; ic++)
@@ -569,6 +580,7 @@ bool Hamming_15_11::decode(unsigned char *rxBits, unsigned char *decodedBits, in
             else
             {
                 rxBits[m_corr[syndromeI]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -584,7 +596,8 @@ bool Hamming_15_11::decode(unsigned char *rxBits, unsigned char *decodedBits, in
 
 // ========================================================================================
 
-Golay_20_8::Golay_20_8()
+Golay_20_8::Golay_20_8() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -661,6 +674,7 @@ void Golay_20_8::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Golay_20_8::decode(unsigned char *rxBits)
 {
+    m_nbCorrected = 0;
     unsigned int syndromeI = 0; // syndrome index
 
     for (int is = 0; is < 12; is++)
@@ -700,6 +714,7 @@ bool Golay_20_8::decode(unsigned char *rxBits)
             else
             {
                 rxBits[m_corr[syndromeI][i]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -714,7 +729,8 @@ bool Golay_20_8::decode(unsigned char *rxBits)
 
 // ========================================================================================
 
-Golay_23_12::Golay_23_12()
+Golay_23_12::Golay_23_12() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -791,6 +807,7 @@ void Golay_23_12::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Golay_23_12::decode(unsigned char *rxBits)
 {
+    m_nbCorrected = 0;
     unsigned int syndromeI = 0; // syndrome index
 
     for (int is = 0; is < 11; is++)
@@ -833,6 +850,7 @@ bool Golay_23_12::decode(unsigned char *rxBits)
             else
             {
                 rxBits[m_corr[syndromeI][i]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -847,7 +865,8 @@ bool Golay_23_12::decode(unsigned char *rxBits)
 
 // ========================================================================================
 
-Golay_24_12::Golay_24_12()
+Golay_24_12::Golay_24_12() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -924,6 +943,7 @@ void Golay_24_12::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool Golay_24_12::decode(unsigned char *rxBits)
 {
+    m_nbCorrected = 0;
     unsigned int syndromeI = 0; // syndrome index
 
     for (int is = 0; is < 12; is++)
@@ -967,6 +987,7 @@ bool Golay_24_12::decode(unsigned char *rxBits)
             else
             {
                 rxBits[m_corr[syndromeI][i]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -981,7 +1002,8 @@ bool Golay_24_12::decode(unsigned char *rxBits)
 
 // ========================================================================================
 
-QR_16_7_6::QR_16_7_6()
+QR_16_7_6::QR_16_7_6() :
+        m_nbCorrected(0)
 {
     init();
 }
@@ -1043,6 +1065,7 @@ void QR_16_7_6::encode(unsigned char *origBits, unsigned char *encodedBits)
 
 bool QR_16_7_6::decode(unsigned char *rxBits)
 {
+    m_nbCorrected = 0;
     unsigned int syndromeI = 0; // syndrome index
 
     for (int is = 0; is < 9; is++)
@@ -1078,6 +1101,7 @@ bool QR_16_7_6::decode(unsigned char *rxBits)
             else
             {
                 rxBits[m_corr[syndromeI][i]] ^= 1; // flip bit
+                m_nbCorrected++;
             }
         }
 
@@ -31,8 +31,10 @@ public:
 	void init();
 	void encode(unsigned char *origBits, unsigned char *encodedBits);
 	bool decode(unsigned char *rxBits);
+	unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+	unsigned int m_nbCorrected;          //!< bits corrected by the last decode
 	unsigned char m_corr[8];             //!< single bit error correction by syndrome index
     static const unsigned char m_G[7*4]; //!< Generator matrix of bits
 	static const unsigned char m_H[7*3]; //!< Parity check matrix of bits
@@ -47,8 +49,10 @@ public:
     void init();
 	void encode(unsigned char *origBits, unsigned char *encodedBits);
     bool decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords);
+    unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+    unsigned int m_nbCorrected;           //!< bits corrected by the last decode
     unsigned char m_corr[16];             //!< single bit error correction by syndrome index
     static const unsigned char m_G[12*8]; //!< Generator matrix of bits
     static const unsigned char m_H[12*4]; //!< Parity check matrix of bits
@@ -63,8 +67,10 @@ public:
     void init();
     void encode(unsigned char *origBits, unsigned char *encodedBits);
     bool decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords);
+    unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+    unsigned int m_nbCorrected;            //!< bits corrected by the last decode
     unsigned char m_corr[16];              //!< single bit error correction by syndrome index
     static const unsigned char m_G[15*11]; //!< Generator matrix of bits
     static const unsigned char m_H[15*4];  //!< Parity check matrix of bits
@@ -79,8 +85,10 @@ public:
     void init();
     void encode(unsigned char *origBits, unsigned char *encodedBits);
     bool decode(unsigned char *rxBits, unsigned char *decodedBits, int nbCodewords);
+    unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+    unsigned int m_nbCorrected;            //!< bits corrected by the last decode
     unsigned char m_corr[32];              //!< single bit error correction by syndrome index
     static const unsigned char m_G[16*11]; //!< Generator matrix of bits
     static const unsigned char m_H[16*5];  //!< Parity check matrix of bits
@@ -95,8 +103,10 @@ public:
 	void init();
 	void encode(unsigned char *origBits, unsigned char *encodedBits);
 	bool decode(unsigned char *rxBits);
+	unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+	unsigned int m_nbCorrected;            //!< bits corrected by the last decode
 	unsigned char m_corr[4096][3];         //!< up to 3 bit error correction by syndrome index
     static const unsigned char m_G[20*8];  //!< Generator matrix of bits
     static const unsigned char m_H[20*12]; //!< Parity check matrix of bits
@@ -111,8 +121,10 @@ public:
     void init();
     void encode(unsigned char *origBits, unsigned char *encodedBits);
     bool decode(unsigned char *rxBits);
+    unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+    unsigned int m_nbCorrected;            //!< bits corrected by the last decode
     unsigned char m_corr[2048][3];         //!< up to 3 bit error correction by syndrome index
     static const unsigned char m_G[23*12]; //!< Generator matrix of bits
     static const unsigned char m_H[23*11]; //!< Parity check matrix of bits
@@ -127,8 +139,10 @@ public:
     void init();
     void encode(unsigned char *origBits, unsigned char *encodedBits);
     bool decode(unsigned char *rxBits);
+    unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+    unsigned int m_nbCorrected;            //!< bits corrected by the last decode
     unsigned char m_corr[4096][3];         //!< up to 3 bit error correction by syndrome index
     static const unsigned char m_G[24*12]; //!< Generator matrix of bits
     static const unsigned char m_H[24*12]; //!< Parity check matrix of bits
@@ -143,8 +157,10 @@ public:
 	void init();
 	void encode(unsigned char *origBits, unsigned char *encodedBits);
 	bool decode(unsigned char *rxBits);
+	unsigned int getNbCorrected() const { return m_nbCorrected; } //!< bits corrected by the last decode
 
 private:
+	unsigned int m_nbCorrected;            //!< bits corrected by the last decode
 	unsigned char m_corr[512][2];          //!< up to 2 bit error correction by syndrome index
     static const unsigned char m_G[16*7];  //!< Generator matrix of bits
 	static const unsigned char m_H[16*9];  //!< Parity check matrix of bits
@@ -36,6 +36,7 @@ public:
     IIRFilter(const Type *a, const Type *b);
     ~IIRFilter();
     void setCoeffs(const Type *a, const Type *b);
+    void reset(); //!< clears the filter memory
     Type run(const Type& sample);
 
 private:
@@ -51,6 +52,7 @@ public:
     IIRFilter(const Type *a, const Type *b);
     ~IIRFilter();
     void setCoeffs(const Type *a, const Type *b);
+    void reset(); //!< clears the filter memory
     Type run(const Type& sample);
 
 private:
@@ -87,7 +89,12 @@ void IIRFilter<Type, Order>::setCoeffs(const Type *a, const Type *b)
 {
     memcpy(m_a, b, (Order+1)*sizeof(Type));
     memcpy(m_b, a, (Order+1)*sizeof(Type));
+    reset();
+}
 
+template <typename Type, uint32_t Order>
+void IIRFilter<Type, Order>::reset()
+{
     for (uint32_t i = 0; i < Order; i++)
     {
         m_x[i] = 0;
@@ -140,6 +147,12 @@ void IIRFilter<Type, 2>::setCoeffs(const Type *a, const Type *b)
     m_b[0] = b[0];
     m_b[1] = b[1];
     m_b[2] = b[2];
+    reset();
+}
+
+template <typename Type>
+void IIRFilter<Type, 2>::reset()
+{
     m_x[0] = 0;
     m_x[1] = 0;
     m_y[0] = 0;
@@ -19,6 +19,7 @@
 #include "nxdnconvolution.h"
 #include "nxdncrc.h"
 #include "dsd_decoder.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -256,7 +257,7 @@ DSDNXDN::DSDNXDN(DSDDecoder *dsdDecoder) :
         y(0),
         z(0)
 {
-    memset(m_syncBuffer, 0, 11);
+    memset(m_syncBuffer, 0, 10);
     memset(m_lichBuffer, 0, 8);
 
     m_rfChannel = NXDNRFCHUnknown;
@@ -273,17 +274,170 @@ DSDNXDN::DSDNXDN(DSDDecoder *dsdDecoder) :
     m_fullRate = false;
 
     m_rfChannelStr[0] = '\0';
+
+    m_cac.setDecoder(m_dsdDecoder);
+    m_cacShort.setDecoder(m_dsdDecoder);
+    m_cacLong.setDecoder(m_dsdDecoder);
+    m_sacch.setDecoder(m_dsdDecoder);
+    m_facch1.setDecoder(m_dsdDecoder);
+    m_udch.setDecoder(m_dsdDecoder);
 }
 
 DSDNXDN::~DSDNXDN()
 {
 }
 
+void DSDNXDN::reset()
+{
+    m_state = NXDNFrame;
+    m_lich = NXDNLICH();
+    m_inSync = false;
+    m_lichEvenParity = 0;
+    m_symbolIndex = 0;
+    m_swallowCount = 0;
+    w = 0;
+    x = 0;
+    y = 0;
+    z = 0;
+
+    memset(m_syncBuffer, 0, 10);
+    memset(m_lichBuffer, 0, 8);
+
+    m_rfChannel = NXDNRFCHUnknown;
+    m_frameStructure = NXDNFSReserved;
+    m_steal = NXDNStealReserved;
+    m_ran = 0;
+    m_idle = true;
+    m_sourceId = 0;
+    m_destinationId = 0;
+    m_group = false;
+    m_messageType = 0;
+    m_locationId = 0;
+    m_services = 0;
+    m_fullRate = false;
+
+    m_rfChannelStr[0] = '\0';
+
+    m_cac.reset();
+    m_cacShort.reset();
+    m_cacLong.reset();
+    m_sacch.resetMessage();
+    m_facch1.reset();
+    m_udch.reset();
+    m_currentMessage.reset();
+    resetAdjacentSites();
+}
+
+void DSDNXDN::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU8(m_state);
+    buffer.writeU8(m_lich.rfChannelCode);
+    buffer.writeU8(m_lich.fnChannelCode);
+    buffer.writeU8(m_lich.optionCode);
+    buffer.writeU8(m_lich.direction);
+    buffer.writeU8(m_lich.parity);
+    buffer.writeBool(m_inSync);
+    buffer.writeDibits(m_syncBuffer, 10);
+    buffer.writeBits(m_lichBuffer, 8);
+    buffer.writeInt(m_lichEvenParity);
+    buffer.writeU16(m_symbolIndex);
+    buffer.writeInt(m_swallowCount);
+    buffer.writeU8(m_rfChannel);
+    buffer.writeU8(m_frameStructure);
+    buffer.writeU8(m_steal);
+    buffer.writeU8(m_messageType);
+    buffer.writeInt(m_ran);
+    buffer.writeBool(m_idle);
+    buffer.writeU16(m_sourceId);
+    buffer.writeU16(m_destinationId);
+    buffer.writeBool(m_group);
+    buffer.writeU32(m_locationId);
+    buffer.writeU16(m_services);
+    buffer.writeBool(m_fullRate);
+    m_cac.saveState(buffer);
+    m_cacShort.saveState(buffer);
+    m_cacLong.saveState(buffer);
+    m_sacch.saveState(buffer);
+    m_facch1.saveState(buffer);
+    m_udch.saveState(buffer);
+    m_currentMessage.saveState(buffer);
+
+    for (int i = 0; i < 16; i++)
+    {
+        buffer.writeU8(m_adjacentSites[i].m_siteNumber);
+        buffer.writeU32(m_adjacentSites[i].m_locationId);
+        buffer.writeU16(m_adjacentSites[i].m_channelNumber);
+    }
+
+    buffer.writeString(m_rfChannelStr);
+    buffer.writeU8(w ? w - rW : 0xFF); // the four pointers move together in the AMBE frame interleave
+}
+
+void DSDNXDN::restoreState(DSDStateBuffer& buffer)
+{
+    m_state = (NXDNState) buffer.readEnum(NXDNSwallow);
+    m_lich.rfChannelCode = buffer.readU8();
+    m_lich.fnChannelCode = buffer.readU8();
+    m_lich.optionCode = buffer.readU8();
+    m_lich.direction = buffer.readU8();
+    m_lich.parity = buffer.readU8();
+    m_inSync = buffer.readBool();
+    buffer.readDibits(m_syncBuffer, 10);
+    buffer.readBits(m_lichBuffer, 8);
+    m_lichEvenParity = buffer.readInt();
+    m_symbolIndex = buffer.readU16(m_state == NXDNPostFrame ? 10 : 8 + 174); // indexes the sync buffer after a frame
+    m_swallowCount = buffer.readInt(0, 2);
+    m_rfChannel = (NXDNRFChannel) buffer.readEnum(NXDNRFCHUnknown);
+    m_frameStructure = (NXDNFrameStructure) buffer.readEnum(NXDNFSUDCH);
+    m_steal = (NXDNSteal) buffer.readEnum(NXDNStealReserved);
+    m_messageType = buffer.readU8();
+    m_ran = buffer.readInt();
+    m_idle = buffer.readBool();
+    m_sourceId = buffer.readU16();
+    m_destinationId = buffer.readU16();
+    m_group = buffer.readBool();
+    m_locationId = buffer.readU32();
+    m_services = buffer.readU16();
+    m_fullRate = buffer.readBool();
+    m_cac.restoreState(buffer);
+    m_cacShort.restoreState(buffer);
+    m_cacLong.restoreState(buffer);
+    m_sacch.restoreState(buffer);
+    m_facch1.restoreState(buffer);
+    m_udch.restoreState(buffer);
+    m_currentMessage.restoreState(buffer);
+
+    for (int i = 0; i < 16; i++)
+    {
+        m_adjacentSites[i].m_siteNumber = buffer.readU8();
+        m_adjacentSites[i].m_locationId = buffer.readU32();
+        m_adjacentSites[i].m_channelNumber = buffer.readU16();
+    }
+
+    buffer.readString(m_rfChannelStr, 2+1);
+    int interleaveIndex = buffer.readU8();
+
+    if (interleaveIndex <= 36)
+    {
+        w = rW + interleaveIndex;
+        x = rX + interleaveIndex;
+        y = rY + interleaveIndex;
+        z = rZ + interleaveIndex;
+    }
+    else
+    {
+        w = 0;
+        x = 0;
+        y = 0;
+        z = 0;
+    }
+}
+
 void DSDNXDN::init()
 {
     if (!m_inSync)
     {
-        std::cerr << "DSDNXDN::init: entering sync state" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::init: entering sync state\n");
         m_currentMessage.reset();
         m_inSync = true;
         m_fullRate = false;
@@ -309,7 +463,7 @@ void DSDNXDN::process()
         processSwallow();
         break;
     default:
-        std::cerr << "DSDNXDN::process: unsupported state (end)" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::process: unsupported state (end)\n");
         m_dsdDecoder->m_voice1On = false;
         m_dsdDecoder->resetFrameSync(); // end
         m_inSync = false;
@@ -392,7 +546,7 @@ void DSDNXDN::processPostFrame()
 	}
 	else // out of sync => terminate
 	{
-        std::cerr << "DSDNXDN::processPostFrame: out of sync (end)" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processPostFrame: out of sync (end)\n");
         m_dsdDecoder->m_voice1On = false;
 		m_dsdDecoder->resetFrameSync(); // end
 		m_inSync = false;
@@ -415,7 +569,7 @@ void DSDNXDN::processFSW()
         fsw = DSDDecoder::m_syncNXDNRDCHFSWInv;
     } else
     {
-        std::cerr << "DSDNXDN::processFSW: sync inconsistent (end)" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: sync inconsistent (end)\n");
         m_dsdDecoder->m_voice1On = false;
         m_dsdDecoder->resetFrameSync(); // end
         m_inSync = false;
@@ -447,13 +601,13 @@ void DSDNXDN::processFSW()
     }
     else if (match_earl1 >= 6)
     {
-        std::cerr << "DSDNXDN::processFSW: match early -1" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: match early -1\n");
         m_swallowCount = 1;
         m_state = NXDNSwallow;
     }
     else if (match_late1 >= 6)
     {
-        std::cerr << "DSDNXDN::processFSW: match late +1" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: match late +1\n");
         m_symbolIndex = 0;
         m_lichEvenParity = 0;
         acquireLICH(unscrambleDibit(m_syncBuffer[9])); // re-introduce last symbol
@@ -462,13 +616,13 @@ void DSDNXDN::processFSW()
     }
     else if (match_earl2 >= 5)
     {
-        std::cerr << "DSDNXDN::processFSW: match early -2" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: match early -2\n");
         m_swallowCount = 2;
         m_state = NXDNSwallow;
     }
     else if (match_late2 >= 5)
     {
-        std::cerr << "DSDNXDN::processFSW: match late +2" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: match late +2\n");
         m_symbolIndex = 0;
         m_lichEvenParity = 0;
         acquireLICH(unscrambleDibit(m_syncBuffer[8])); // re-introduce symbol before last symbol
@@ -479,7 +633,7 @@ void DSDNXDN::processFSW()
     }
     else
     {
-        std::cerr << "DSDNXDN::processFSW: sync lost (end)" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processFSW: sync lost (end)\n");
         m_dsdDecoder->m_voice1On = false;
         m_dsdDecoder->resetFrameSync(); // end
         m_inSync = false;
@@ -520,14 +674,9 @@ void DSDNXDN::processLICH()
         m_rfChannel = NXDNRFCHUnknown;
         strcpy(m_rfChannelStr, "XX");
         m_dsdDecoder->m_voice1On = false;
-        std::cerr << "DSDNXDN::processLICH: parity error" << std::endl;
-        std::cerr << "DSDNXDN::processLICH:"
-                << " rfChannelCode: " << m_lich.rfChannelCode
-                << " fnChannelCode: " << m_lich.fnChannelCode
-                << " optionCode: " << m_lich.optionCode
-                << " direction: " << m_lich.direction
-                << " parity: " << m_lich.parity
-                << " m_lichEvenParity: " << m_lichEvenParity << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processLICH: parity error\n");
+        m_dsdDecoder->getLogger().debug("DSDNXDN::processLICH: rfChannelCode: %d fnChannelCode: %d optionCode: %d direction: %d parity: %d m_lichEvenParity: %d\n",
+                m_lich.rfChannelCode, m_lich.fnChannelCode, m_lich.optionCode, m_lich.direction, m_lich.parity, m_lichEvenParity);
     }
     else
     {
@@ -751,6 +900,7 @@ void DSDNXDN::processRTDCH(int index, unsigned char dibit)
                     m_currentMessage.getSourceUnitId(m_sourceId);
                     m_currentMessage.getDestinationGroupId(m_destinationId);
                     m_currentMessage.isGroupCall(m_group);
+                    processCallMessage();
 
                     if (m_currentMessage.isFullRate(m_fullRate)) {
                         m_dsdDecoder->setMbeRate(isFullRate() ? DSDDecoder::DSDMBERate7200x4400 : DSDDecoder::DSDMBERate3600x2450);
@@ -831,6 +981,7 @@ void DSDNXDN::processRTDCH(int index, unsigned char dibit)
                 m_currentMessage.getSourceUnitId(m_sourceId);
                 m_currentMessage.getDestinationGroupId(m_destinationId);
                 m_currentMessage.isGroupCall(m_group);
+                processCallMessage();
 
                 if (m_currentMessage.isFullRate(m_fullRate)) {
                     m_dsdDecoder->setMbeRate(isFullRate() ? DSDDecoder::DSDMBERate7200x4400 : DSDDecoder::DSDMBERate3600x2450);
@@ -848,6 +999,25 @@ void DSDNXDN::processRTDCH(int index, unsigned char dibit)
     // Do nothing if SACCH with idle status
 }
 
+void DSDNXDN::processCallMessage()
+{
+    if (m_messageType == Message::NXDN_MESSAGE_TYPE_VCALL) // repeated in the SACCH of each superframe
+    {
+        const DSDDecoder::CallInfo& call = m_dsdDecoder->m_calls[0];
+
+        if (!m_dsdDecoder->m_callActive[0]
+            || (call.m_protocol != DSDStatus::ProtocolNXDN)
+            || ((m_sourceId != 0) && (call.m_sourceId != 0) && (m_sourceId != call.m_sourceId)))
+        {
+            m_dsdDecoder->startCall(0, DSDStatus::ProtocolNXDN);
+        }
+    }
+    else if (m_messageType == Message::NXDN_MESSAGE_TYPE_TX_REL)
+    {
+        m_dsdDecoder->endCall(0, DSDDecoder::CallInfo::CallEndTerminator);
+    }
+}
+
 void DSDNXDN::processFACCH1(int index, unsigned char dibit)
 {
     if (index == 0) {
@@ -869,6 +1039,7 @@ void DSDNXDN::processFACCH1(int index, unsigned char dibit)
             m_currentMessage.getSourceUnitId(m_sourceId);
             m_currentMessage.getDestinationGroupId(m_destinationId);
             m_currentMessage.isGroupCall(m_group);
+            processCallMessage();
 
             if (m_currentMessage.isFullRate(m_fullRate)) {
                 m_dsdDecoder->setMbeRate(isFullRate() ? DSDDecoder::DSDMBERate7200x4400 : DSDDecoder::DSDMBERate3600x2450);
@@ -884,6 +1055,7 @@ void DSDNXDN::processFACCH1(int index, unsigned char dibit)
 }
 
 DSDNXDN::FnChannel::FnChannel() :
+    m_dsdDecoder(0),
     m_nbPuncture(0),
     m_rawSize(0),
     m_bufRaw(0),
@@ -897,13 +1069,59 @@ DSDNXDN::FnChannel::FnChannel() :
 DSDNXDN::FnChannel::~FnChannel()
 {}
 
+void DSDNXDN::FnChannel::capture(DSDCapture::FrameType frameType, const unsigned char *data, unsigned int nbBits, bool crcOK, int ran)
+{
+    DSDCapture::Frame frame(frameType);
+    frame.setCRC(crcOK);
+
+    if (ran >= 0) {
+        frame.addField(ran);
+    }
+
+    m_dsdDecoder->captureBytes(frame, data, nbBits);
+}
+
+void DSDNXDN::FnChannel::deconvolve(unsigned char *data, unsigned int nbSteps, unsigned int nbBits)
+{
+    DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageCNXDNConvolution);
+    CNXDNConvolution conv;
+    conv.start();
+    int n = 0;
+
+    for (unsigned int i = 0U; i < nbSteps; i++)
+    {
+        uint8_t s0 = m_bufTmp[n++];
+        uint8_t s1 = m_bufTmp[n++];
+
+        conv.decode(s0, s1);
+    }
+
+    conv.chainback(data, nbBits);
+}
+
 void DSDNXDN::FnChannel::reset()
 {
     m_index = 0;
 }
 
+void DSDNXDN::FnChannel::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU16(m_index);
+    buffer.writeBits(m_bufRaw, m_rawSize);
+}
+
+void DSDNXDN::FnChannel::restoreState(DSDStateBuffer& buffer)
+{
+    m_index = buffer.readU16(m_rawSize);
+    buffer.readBits(m_bufRaw, m_rawSize);
+}
+
 void DSDNXDN::FnChannel::pushDibit(unsigned char dibit)
 {
+    if (m_index > m_rawSize - 2) { // full: the index of a restored state may be ahead of the frame
+        return;
+    }
+
     m_bufRaw[m_interleave[m_index++]] = (dibit&2)>>1;
     m_bufRaw[m_interleave[m_index++]] = dibit&1;
 }
@@ -947,25 +1165,40 @@ DSDNXDN::SACCH::SACCH()
 DSDNXDN::SACCH::~SACCH()
 {}
 
+void DSDNXDN::SACCH::resetMessage()
+{
+    reset();
+    m_message.reset();
+    m_decodeCount = 0;
+}
+
+void DSDNXDN::SACCH::saveState(DSDStateBuffer& buffer) const
+{
+    FnChannel::saveState(buffer);
+    m_message.saveState(buffer);
+    buffer.writeInt(m_decodeCount);
+}
+
+void DSDNXDN::SACCH::restoreState(DSDStateBuffer& buffer)
+{
+    FnChannel::restoreState(buffer);
+    m_message.restoreState(buffer);
+    m_decodeCount = buffer.readInt(-1, 3);
+}
+
 bool DSDNXDN::SACCH::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 40U, 36U);
 
-    for (unsigned int i = 0U; i < 40U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC6(m_data, 26U)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNSACCH, m_data, 36U, crcOK, (crcOK ? getRAN() : -1));
     }
 
-    conv.chainback(m_data, 36U);
-
-    if (!CNXDNCRC::checkCRC6(m_data, 26U))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::SACCH::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::SACCH::decode: bad CRC\n");
 
         if (m_decodeCount >= 0) {
             m_decodeCount = -1;
@@ -1012,23 +1245,17 @@ DSDNXDN::CACOutbound::~CACOutbound()
 
 bool DSDNXDN::CACOutbound::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 179U, 175U);
 
-    for (unsigned int i = 0U; i < 179U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC16(m_data, 155)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNCACOutbound, m_data, 175U, crcOK, (crcOK ? getRAN() : -1));
     }
 
-    conv.chainback(m_data, 175U);
-
-    if (!CNXDNCRC::checkCRC16(m_data, 155))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::CACOutbound::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::CACOutbound::decode: bad CRC\n");
         return false;
     }
     else
@@ -1072,28 +1299,22 @@ DSDNXDN::CACLong::~CACLong()
 
 bool DSDNXDN::CACLong::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 160U, 156U);
 
-    for (unsigned int i = 0U; i < 160U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC16(m_data, 136)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNCACLong, m_data, 156U, crcOK, (crcOK ? getRAN() : -1));
     }
 
-    conv.chainback(m_data, 156U);
-
-    if (!CNXDNCRC::checkCRC16(m_data, 136))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::CACLong::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::CACLong::decode: bad CRC\n");
         return false;
     }
     else
     {
-        std::cerr << "DSDNXDN::CACLong::decode: CRC OK" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::CACLong::decode: CRC OK\n");
         return true;
     }
 }
@@ -1117,28 +1338,22 @@ DSDNXDN::CACShort::~CACShort()
 
 bool DSDNXDN::CACShort::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 130U, 126U);
 
-    for (unsigned int i = 0U; i < 130U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC16(m_data, 106)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNCACShort, m_data, 126U, crcOK, (crcOK ? getRAN() : -1));
     }
 
-    conv.chainback(m_data, 126U);
-
-    if (!CNXDNCRC::checkCRC16(m_data, 106))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::CACShort::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::CACShort::decode: bad CRC\n");
         return false;
     }
     else
     {
-        std::cerr << "DSDNXDN::CACShort::decode: CRC OK" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::CACShort::decode: CRC OK\n");
         return true;
     }
 }
@@ -1163,23 +1378,17 @@ DSDNXDN::FACCH1::~FACCH1()
 
 bool DSDNXDN::FACCH1::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 100U, 96U);
 
-    for (unsigned int i = 0U; i < 100U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC12(m_data, 80)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNFACCH1, m_data, 96U, crcOK, -1);
     }
 
-    conv.chainback(m_data, 96U);
-
-    if (!CNXDNCRC::checkCRC12(m_data, 80))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::FACCH1::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::FACCH1::decode: bad CRC\n");
         return false;
     }
     else
@@ -1203,23 +1412,17 @@ DSDNXDN::UDCH::~UDCH()
 
 bool DSDNXDN::UDCH::decode()
 {
-    CNXDNConvolution conv;
-    conv.start();
-    int n = 0;
+    deconvolve(m_data, 207U, 203U);
 
-    for (unsigned int i = 0U; i < 207U; i++)
-    {
-        uint8_t s0 = m_temp[n++];
-        uint8_t s1 = m_temp[n++];
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCNXDN, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageCNXDNCRC, CNXDNCRC::checkCRC15(m_data, 184)));
 
-        conv.decode(s0, s1);
+    if (m_dsdDecoder->m_capture) {
+        capture(DSDCapture::FrameNXDNUDCH, m_data, 203U, crcOK, (crcOK ? getRAN() : -1));
     }
 
-    conv.chainback(m_data, 203U);
-
-    if (!CNXDNCRC::checkCRC15(m_data, 184))
+    if (!crcOK)
     {
-        std::cerr << "DSDNXDN::UDCH::decode: bad CRC" << std::endl;
+        m_dsdDecoder->getLogger().debug("DSDNXDN::UDCH::decode: bad CRC\n");
         return false;
     }
     else
@@ -1263,19 +1466,22 @@ void DSDNXDN::processVoiceFrameEHR(int symbolIndex, int dibit)
         memset((void *) m_dsdDecoder->m_mbeDVFrame1, 0, 9); // initialize DVSI frame
     }
 
-    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-    w++;
-    x++;
-    y++;
-    z++;
+    if (w && (w < rW + 36)) // a restored interleave position may be out of step with the frame
+    {
+        m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+        m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+        w++;
+        x++;
+        y++;
+        z++;
+    }
 
     storeSymbolDV(symbolIndex % 36, dibit); // store dibit for DVSI hardware decoder
 
     if (symbolIndex % 36 == 35)
     {
         m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 
         if (m_dsdDecoder->m_opts.errorbars == 1)
         {
@@ -1295,7 +1501,7 @@ void DSDNXDN::processVoiceFrameEFR(int symbolIndex, int dibit)
 
     if (symbolIndex % 72 == 71)
     {
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 
         if (m_dsdDecoder->m_opts.errorbars == 1)
         {
@@ -1306,7 +1512,7 @@ void DSDNXDN::processVoiceFrameEFR(int symbolIndex, int dibit)
 
 void DSDNXDN::storeSymbolDV(int dibitindex, unsigned char dibit, bool invertDibit)
 {
-    if (m_dsdDecoder->m_mbelibEnable)
+    if (!m_dsdDecoder->mbeDVEnabled())
     {
         return;
     }
@@ -1337,10 +1543,10 @@ void DSDNXDN::printAdjacentSites()
             continue;
         }
 
-        std::cerr << "DSDNXDN::printAdjacentSites:"
-            << " site: " << (unsigned int) m_adjacentSites[i].m_siteNumber
-            << " channel: " << m_adjacentSites[i].m_channelNumber
-            << " location: " << std::hex << m_adjacentSites[i].m_locationId << std::endl;
+        m_dsdDecoder->getLogger().log("DSDNXDN::printAdjacentSites: site: %u channel: %u location: %x\n",
+                (unsigned int) m_adjacentSites[i].m_siteNumber,
+                (unsigned int) m_adjacentSites[i].m_channelNumber,
+                m_adjacentSites[i].m_locationId);
     }
 }
 
@@ -20,12 +20,14 @@
 #include "pn.h"
 #include "viterbi5.h"
 #include "nxdnmessage.h"
+#include "dsd_capture.h"
 #include "export.h"
 
 namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDNXDN
 {
@@ -69,6 +71,9 @@ public:
 
 	explicit DSDNXDN(DSDDecoder *dsdDecoder);
 	~DSDNXDN();
+	void reset(); //!< back to the state after construction keeping the FEC and interleaving tables
+    void saveState(DSDStateBuffer& buffer) const;    //!< frame in progress, channels and last message
+    void restoreState(DSDStateBuffer& buffer);
 
     void init();
     void process();
@@ -111,10 +116,16 @@ private:
         FnChannel();
         virtual ~FnChannel();
         void reset();
+        virtual void saveState(DSDStateBuffer& buffer) const;    //!< bits received so far
+        virtual void restoreState(DSDStateBuffer& buffer);
         void pushDibit(unsigned char dibit);
         void unpuncture();
         virtual bool decode() = 0;
+        void setDecoder(DSDDecoder *dsdDecoder) { m_dsdDecoder = dsdDecoder; }
     protected:
+        void deconvolve(unsigned char *data, unsigned int nbSteps, unsigned int nbBits); //!< Viterbi decoding of the unpunctured bits
+        void capture(DSDCapture::FrameType frameType, const unsigned char *data, unsigned int nbBits, bool crcOK, int ran); //!< ran < 0 if not available
+        DSDDecoder *m_dsdDecoder;
         int m_index;
         int m_nbPuncture;
         int m_rawSize;
@@ -132,6 +143,9 @@ private:
         virtual bool decode();
         unsigned char getRAN() const;
         unsigned char getCountdown() const;  //!< get SACCH block countdown in a superframe structure
+        void resetMessage(); //!< reset with the superframe message
+        virtual void saveState(DSDStateBuffer& buffer) const;    //!< also the superframe message
+        virtual void restoreState(DSDStateBuffer& buffer);
         int getDecodeCount() const { return m_decodeCount; }
         const Message& getMessage() const { return m_message; }
         static const int m_Interleave[60];   //!< SACCH bits interleaving matrix
@@ -235,6 +249,7 @@ private:
     void processRCCH(int index, unsigned char dibit);
     void processRTDCH(int index, unsigned char dibit);
     void processFACCH1(int index, unsigned char dibit);
+    void processCallMessage(); //!< calls start with a VCALL message and end with TX_REL
 
     void processVoiceTest(int symbolIndex);
     void processVoiceFrameEHR(int symbolIndex, int dibit);
@@ -170,7 +170,7 @@ void CNXDNCRC::encodeCRC16(unsigned char* in, unsigned int length)
     temp[1U] = (crc >> 0) & 0xFFU;
 
     unsigned int n = length;
-    for (unsigned int i = 1U; i < 16U; i++, n++) {
+    for (unsigned int i = 0U; i < 16U; i++, n++) {
         bool b = READ_BIT1(temp, i);
         WRITE_BIT1(in, n, b);
     }
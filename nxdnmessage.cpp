@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include "nxdnmessage.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -61,6 +62,18 @@ void Message::reset()
     memset(m_data, 0, 22);
 }
 
+void Message::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeBytes(m_data, 22);
+    buffer.writeU8(m_shift);
+}
+
+void Message::restoreState(DSDStateBuffer& buffer)
+{
+    buffer.readBytes(m_data, 22);
+    m_shift = buffer.readU8() < 9 ? 0 : 9;
+}
+
 void Message::setMessageIndex(unsigned int index)
 {
     if (index < 2) {
@@ -22,6 +22,8 @@
 namespace DSDcc
 {
 
+class DSDStateBuffer;
+
 struct DSDCC_API AdjacentSiteInformation
 {
     unsigned char m_siteNumber;      // 1 to 16
@@ -33,7 +35,10 @@ struct DSDCC_API AdjacentSiteInformation
 struct DSDCC_API Message
 {
 public:
+    Message() : m_shift(0) { reset(); }
     void reset();
+    void saveState(DSDStateBuffer& buffer) const;
+    void restoreState(DSDStateBuffer& buffer);
     void setMessageIndex(unsigned int index); //!< sets the message index in dual message case
     void setFromSACCH(int index, const unsigned char *data);
     void setFromFACCH1(const unsigned char *data);
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <float.h>
 #include "phaselock.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -148,6 +149,50 @@ void PhaseLock::configure(float freq, float bandwidth, float minsignal)
 }
 
 
+void PhaseLock::reset()
+{
+    m_lock_cnt = 0;
+    m_psin = 0.0;
+    m_pcos = 1.0;
+    m_freq = (m_minfreq + m_maxfreq) / 2.0;
+    m_phase = 0;
+    m_phasor_i1 = 0;
+    m_phasor_i2 = 0;
+    m_phasor_q1 = 0;
+    m_phasor_q2 = 0;
+    m_loopfilter_x1 = 0;
+    m_sample_cnt = 0;
+}
+
+void PhaseLock::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeFloat(m_freq);
+    buffer.writeFloat(m_phase);
+    buffer.writeFloat(m_psin);
+    buffer.writeFloat(m_pcos);
+    buffer.writeFloat(m_phasor_i1);
+    buffer.writeFloat(m_phasor_i2);
+    buffer.writeFloat(m_phasor_q1);
+    buffer.writeFloat(m_phasor_q2);
+    buffer.writeFloat(m_loopfilter_x1);
+    buffer.writeInt(m_lock_cnt);
+}
+
+void PhaseLock::restoreState(DSDStateBuffer& buffer)
+{
+    m_freq = buffer.readFloat();
+    m_phase = buffer.readFloat();
+    m_psin = buffer.readFloat();
+    m_pcos = buffer.readFloat();
+    m_phasor_i1 = buffer.readFloat();
+    m_phasor_i2 = buffer.readFloat();
+    m_phasor_q1 = buffer.readFloat();
+    m_phasor_q2 = buffer.readFloat();
+    m_loopfilter_x1 = buffer.readFloat();
+    m_lock_cnt = buffer.readInt();
+    m_freq = std::min(std::max(m_freq, m_minfreq), m_maxfreq); // in case the loop was configured differently
+}
+
 // Process samples. Bufferized version
 void PhaseLock::process(const std::vector<float>& samples_in, std::vector<float>& samples_out)
 {
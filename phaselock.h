@@ -23,6 +23,8 @@
 namespace DSDcc
 {
 
+class DSDStateBuffer;
+
 /** Phase-locked loop. */
 class DSDCC_API PhaseLock
 {
@@ -49,6 +51,12 @@ public:
      */
     void configure(float freq, float bandwidth, float minsignal);
 
+    /** Returns the loop to its initial state at the center frequency keeping the configuration */
+    void reset();
+
+    void saveState(DSDStateBuffer& buffer) const;    //!< frequency, phase and loop filters
+    void restoreState(DSDStateBuffer& buffer);
+
     /**
      * Process samples and track a pilot tone. Generate samples for single or multiple phase-locked
      * signals. Implement the processPhase virtual method to produce the output samples.
@@ -66,6 +66,15 @@ public:
         init(&lo, ww);
     }
 
+    void reset() //!< empties the window keeping its width
+    {
+        up.head = 0;
+        up.tail = 0;
+        lo.head = 0;
+        lo.tail = 0;
+        n = 0;
+    }
+
     void update(valuetype value)
     {
         if (nonempty(&up) != 0)
@@ -110,6 +119,29 @@ public:
         return headvalue(&lo);
     }
 
+    /** Writes the window contents with a DSDStateBuffer like buffer */
+    template<typename Buffer>
+    void saveState(Buffer& buffer) const
+    {
+        buffer.writeU32(n);
+        saveQueue(buffer, up);
+        saveQueue(buffer, lo);
+    }
+
+    /** Reads the window contents. Returns false and empties the window if they do not fit its width */
+    template<typename Buffer>
+    bool restoreState(Buffer& buffer)
+    {
+        n = buffer.readU32();
+
+        if (restoreQueue(buffer, up) && restoreQueue(buffer, lo)) {
+            return true;
+        }
+
+        reset();
+        return false;
+    }
+
 private:
     struct valuenode
     {
@@ -182,6 +214,41 @@ private:
         return static_cast<int>(q->tail != q->head);
     }
 
+    template<typename Buffer>
+    void saveQueue(Buffer& buffer, const valuesqueue& q) const
+    {
+        uint32_t nbNodes = (q.tail - q.head) & q.mask;
+        buffer.writeU32(nbNodes);
+
+        for (uint32_t i = 0; i < nbNodes; i++)
+        {
+            const valuenode& node = q.nodes[(q.head + i) & q.mask];
+            buffer.writeU32(node.index);
+            buffer.writeInt(node.value);
+        }
+    }
+
+    template<typename Buffer>
+    bool restoreQueue(Buffer& buffer, valuesqueue& q)
+    {
+        uint32_t nbNodes = buffer.readU32();
+
+        if (nbNodes > q.mask) {
+            return false;
+        }
+
+        q.head = 0;
+        q.tail = nbNodes;
+
+        for (uint32_t i = 0; i < nbNodes; i++)
+        {
+            q.nodes[i].index = buffer.readU32();
+            q.nodes[i].value = (valuetype) buffer.readInt();
+        }
+
+        return true;
+    }
+
     valuesqueue up;
     valuesqueue lo;
     uint32_t n;
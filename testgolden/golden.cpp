@@ -0,0 +1,619 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2026 Edouard Griffiths, F4EXB.                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Golden regression test of the decoder output.
+ *
+ * A discriminator samples file is decoded with options deduced from its name and
+ * the decoder output is written as a list of records one per line:
+ *
+ *   S <timestamp> <sync type> <frame type text>       change of the last sync type
+ *   I <timestamp> <text>                              change of slot texts and decoded IDs (checked every 20 ms)
+ *   M <timestamp> <slot> <rate> <hex bytes>           AMBE frame as given by getMbeDVFrame1/2
+ *   A <timestamp> <slot> <nb samples> <hash> <rms>    audio frame with FNV-1a hash of the PCM samples
+ *   C <timestamp> <slot> <protocol> start|end ...     call start and end with its end reason, voice frames and identities
+ *   T <sync type> <count>                             total of syncs found by type at the end
+ *
+ * Timestamps are in input samples. Lines starting with # are comments. The records
+ * are compared to the golden file either exactly or with tolerance (-t) for DSP changes
+ * that are not bit exact. Audio frames exist only when mbelib is used so they are not
+ * compared if the golden file was made with a different mbelib support than this build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "dsd_decoder.h"
+#include "dsd_decoderpool.h"
+
+/** Collects the output records of the decoder */
+class GoldenRecorder : public DSDcc::DSDDecoder::AudioSink
+{
+public:
+    virtual void audioFrame(int slot, const short *samples, int nbSamples, uint64_t timestamp)
+    {
+        uint64_t hash = 14695981039346656037ULL; // FNV-1a
+        double power = 0.0;
+
+        for (int i = 0; i < nbSamples; i++)
+        {
+            unsigned short sample = (unsigned short) samples[i];
+            hash = (hash ^ (sample & 0xff)) * 1099511628211ULL;
+            hash = (hash ^ (sample >> 8)) * 1099511628211ULL;
+            power += (double) samples[i] * samples[i];
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "A %llu %d %d %016llx %d",
+            (unsigned long long) timestamp, slot, nbSamples, (unsigned long long) hash,
+            nbSamples > 0 ? (int) sqrt(power / nbSamples) : 0);
+        m_records.push_back(line);
+    }
+
+    virtual void mbeFrame(int slot, const unsigned char *frame, int nbBytes, DSDcc::DSDDecoder::DSDMBERate mbeRate, uint64_t timestamp)
+    {
+        char line[128];
+        int n = snprintf(line, sizeof(line), "M %llu %d %d ", (unsigned long long) timestamp, slot, (int) mbeRate);
+
+        for (int i = 0; (i < nbBytes) && (n < (int) sizeof(line) - 3); i++) {
+            n += snprintf(&line[n], sizeof(line) - n, "%02x", frame[i]);
+        }
+
+        m_records.push_back(line);
+    }
+
+    virtual void callStart(const DSDcc::DSDDecoder::CallInfo& call)
+    {
+        char line[128];
+        snprintf(line, sizeof(line), "C %llu %d %s start %s", (unsigned long long) call.m_start, call.m_slot,
+            DSDcc::DSDStatus::getProtocolName(call.m_protocol), call.m_header ? "header" : "voice");
+        m_records.push_back(line);
+    }
+
+    virtual void callEnd(const DSDcc::DSDDecoder::CallInfo& call)
+    {
+        static const char *callEnds[] = {"none", "terminator", "timeout", "newcall", "flush"};
+        char line[256];
+        snprintf(line, sizeof(line), "C %llu %d %s end %s %u %llu %u %u %d %d [%s|%s]", (unsigned long long) call.m_end, call.m_slot,
+            DSDcc::DSDStatus::getProtocolName(call.m_protocol), callEnds[call.m_callEnd], call.m_nbVoiceFrames,
+            (unsigned long long) (call.m_end - call.m_start), call.m_sourceId, call.m_destinationId, call.m_group ? 1 : 0,
+            call.m_colorCode, call.m_source, call.m_destination);
+        m_records.push_back(line);
+    }
+
+    std::vector<std::string> m_records;
+};
+
+/** Frame type from the name of the samples file as in dsdcc_bench */
+static DSDcc::DSDDecoder::DSDDecodeMode getFileMode(const std::string& path)
+{
+    static const struct
+    {
+        const char *m_prefix;
+        DSDcc::DSDDecoder::DSDDecodeMode m_mode;
+    } modes[] = {
+        {"dpmr",   DSDcc::DSDDecoder::DSDDecodeDPMR},
+        {"dmr",    DSDcc::DSDDecoder::DSDDecodeDMR},
+        {"dstar",  DSDcc::DSDDecoder::DSDDecodeDStar},
+        {"ysf",    DSDcc::DSDDecoder::DSDDecodeYSF},
+        {"nxdn48", DSDcc::DSDDecoder::DSDDecodeNXDN48},
+        {"nxdn96", DSDcc::DSDDecoder::DSDDecodeNXDN96},
+        {"p25",    DSDcc::DSDDecoder::DSDDecodeP25P1}
+    };
+
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    for (unsigned int i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        if (name.compare(0, strlen(modes[i].m_prefix), modes[i].m_prefix) == 0) {
+            return modes[i].m_mode;
+        }
+    }
+
+    return DSDcc::DSDDecoder::DSDDecodeAuto;
+}
+
+/** Slot texts and decoded IDs of the frame types enabled */
+static std::string getIdentityText(const DSDcc::DSDDecoder& decoder, DSDcc::DSDDecoder::DSDDecodeMode mode)
+{
+    bool all = mode == DSDcc::DSDDecoder::DSDDecodeAuto;
+    std::string text;
+    char buffer[256];
+
+    if (all || (mode == DSDcc::DSDDecoder::DSDDecodeDMR))
+    {
+        snprintf(buffer, sizeof(buffer), "DMR[%s|%s|%u]", decoder.getDMRDecoder().getSlot0Text(),
+            decoder.getDMRDecoder().getSlot1Text(), (unsigned int) decoder.getDMRDecoder().getColorCode());
+        text += buffer;
+    }
+
+    if (all || (mode == DSDcc::DSDDecoder::DSDDecodeDStar))
+    {
+        const DSDcc::DSDDstar& dstar = decoder.getDStarDecoder();
+        snprintf(buffer, sizeof(buffer), "DStar[%s|%s|%s|%s|%s|%s]", dstar.getMySign().c_str(), dstar.getYourSign().c_str(),
+            dstar.getRpt1().c_str(), dstar.getRpt2().c_str(), dstar.getInfoText(), dstar.getLocator());
+        text += buffer;
+    }
+
+    if (all || (mode == DSDcc::DSDDecoder::DSDDecodeDPMR))
+    {
+        const DSDcc::DSDdPMR& dpmr = decoder.getDPMRDecoder();
+        snprintf(buffer, sizeof(buffer), "dPMR[%d|%u|%u]", dpmr.getColorCode(), dpmr.getOwnId(), dpmr.getCalledId());
+        text += buffer;
+    }
+
+    if (all || (mode == DSDcc::DSDDecoder::DSDDecodeYSF))
+    {
+        const DSDcc::DSDYSF& ysf = decoder.getYSFDecoder();
+        snprintf(buffer, sizeof(buffer), "YSF[%s|%s|%s|%s]", ysf.getSrc(), ysf.getDest(), ysf.getUplink(), ysf.getDownlink());
+        text += buffer;
+    }
+
+    if (all || (mode == DSDcc::DSDDecoder::DSDDecodeNXDN48) || (mode == DSDcc::DSDDecoder::DSDDecodeNXDN96))
+    {
+        const DSDcc::DSDNXDN& nxdn = decoder.getNXDNDecoder();
+        snprintf(buffer, sizeof(buffer), "NXDN[%d|%u|%u]", nxdn.getRAN(), (unsigned int) nxdn.getSourceId(),
+            (unsigned int) nxdn.getDestinationId());
+        text += buffer;
+    }
+
+    for (std::string::iterator it = text.begin(); it != text.end(); ++it) // one line per record
+    {
+        if ((*it == '\n') || (*it == '\r')) {
+            *it = ' ';
+        }
+    }
+
+    return text;
+}
+
+static void setupDecoder(DSDcc::DSDDecoder& decoder, DSDcc::DSDDecoder::DSDDecodeMode mode, GoldenRecorder *recorder)
+{
+    decoder.setQuiet();
+    decoder.setLogVerbosity(0);
+    decoder.setDecodeMode(DSDcc::DSDDecoder::DSDDecodeNone, true);
+    decoder.setDecodeMode(mode, true);
+    decoder.enableMbeDV(true); // the AMBE frames are stored by all protocol decoders even with mbelib
+    decoder.setAudioSink(recorder);
+}
+
+/** Decodes the file. If a standby decoder is given the state is moved to it at the checkpoint sample and it goes on with the decoding */
+static bool decodeFile(const std::string& path, DSDcc::DSDDecoder& decoder, std::vector<std::string>& records,
+        DSDcc::DSDDecoder *standby = 0, uint64_t checkpoint = 0)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    DSDcc::DSDDecoder::DSDDecodeMode mode = getFileMode(path);
+    GoldenRecorder recorder;
+    DSDcc::DSDDecoder *current = &decoder;
+    setupDecoder(decoder, mode, &recorder);
+
+    DSDcc::DSDDecoder::DSDSyncType lastSyncType = decoder.getSyncType();
+    std::string lastIdentity = getIdentityText(decoder, mode);
+    unsigned int syncCounts[DSDcc::DSDDecoder::DSDSyncNone] = {0}; // statistics are not part of the state
+    short buffer[4096];
+    size_t nbRead;
+    uint64_t sampleIndex = 0;
+    char line[512];
+
+    while ((nbRead = fread(buffer, sizeof(short), 4096, fp)) > 0)
+    {
+        for (size_t i = 0; i < nbRead; i++, sampleIndex++)
+        {
+            if (standby && (sampleIndex == checkpoint))
+            {
+                std::vector<unsigned char> state;
+                current->saveState(state);
+                current->setAudioSink(0);
+
+                for (int t = 0; t < (int) DSDcc::DSDDecoder::DSDSyncNone; t++) {
+                    syncCounts[t] = current->getSyncCount((DSDcc::DSDDecoder::DSDSyncType) t);
+                }
+
+                setupDecoder(*standby, mode, &recorder);
+
+                if (!standby->restoreState(state)) {
+                    fprintf(stderr, "Cannot restore the state saved at sample %llu\n", (unsigned long long) sampleIndex);
+                }
+
+                current = standby;
+            }
+
+            current->run(buffer[i]);
+
+            if (current->getSyncType() != lastSyncType)
+            {
+                lastSyncType = current->getSyncType();
+                snprintf(line, sizeof(line), "S %llu %d %s", (unsigned long long) current->getSampleCount(),
+                    (int) lastSyncType, current->getFrameTypeText());
+                recorder.m_records.push_back(line);
+            }
+
+            if (sampleIndex % 960 == 959)
+            {
+                std::string identity = getIdentityText(*current, mode);
+
+                if (identity != lastIdentity)
+                {
+                    lastIdentity = identity;
+                    recorder.m_records.push_back("I " + std::to_string((unsigned long long) current->getSampleCount()) + " " + identity);
+                }
+            }
+        }
+    }
+
+    fclose(fp);
+    current->endCalls();
+    current->setAudioSink(0);
+
+    for (int i = 0; i < (int) DSDcc::DSDDecoder::DSDSyncNone; i++)
+    {
+        snprintf(line, sizeof(line), "T %d %u", i, syncCounts[i] + current->getSyncCount((DSDcc::DSDDecoder::DSDSyncType) i));
+        recorder.m_records.push_back(line);
+    }
+
+    records.swap(recorder.m_records);
+    return true;
+}
+
+static bool readGolden(const std::string& path, std::vector<std::string>& records)
+{
+    FILE *fp = fopen(path.c_str(), "r");
+
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot open golden file %s\n", path.c_str());
+        return false;
+    }
+
+    char line[1024];
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        size_t len = strlen(line);
+
+        while ((len > 0) && ((line[len-1] == '\n') || (line[len-1] == '\r'))) {
+            line[--len] = '\0';
+        }
+
+        if ((len > 0) && (line[0] != '#')) {
+            records.push_back(line);
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static bool writeGolden(const std::string& path, const std::string& samplesPath, const std::vector<std::string>& records)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+
+    if (!fp)
+    {
+        fprintf(stderr, "Cannot write golden file %s\n", path.c_str());
+        return false;
+    }
+
+    size_t slash = samplesPath.find_last_of('/');
+    fprintf(fp, "# dsdcc golden v1 %s\n", slash == std::string::npos ? samplesPath.c_str() : samplesPath.c_str() + slash + 1);
+
+    for (std::vector<std::string>::const_iterator it = records.begin(); it != records.end(); ++it) {
+        fprintf(fp, "%s\n", it->c_str());
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static bool compareExact(const std::vector<std::string>& golden, const std::vector<std::string>& records)
+{
+    size_t n = std::min(golden.size(), records.size());
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (golden[i] != records[i])
+        {
+            fprintf(stderr, "First difference at record %lu:\n  golden: %s\n  output: %s\n", i + 1, golden[i].c_str(), records[i].c_str());
+            return false;
+        }
+    }
+
+    if (golden.size() != records.size())
+    {
+        fprintf(stderr, "Number of records differ: golden %lu output %lu\n", golden.size(), records.size());
+        return false;
+    }
+
+    return true;
+}
+
+/** A record split into timestamp and contents for comparison with tolerance */
+struct GoldenRecord
+{
+    uint64_t m_timestamp;
+    std::string m_key;   //!< compared exactly
+    int m_level;         //!< audio RMS compared with tolerance
+    bool m_matched;
+};
+
+/** Tolerance settings */
+struct GoldenTolerance
+{
+    GoldenTolerance() : m_timestamp(480), m_level(0.1), m_ratio(0.02) {}
+    uint64_t m_timestamp; //!< maximum timestamp difference in samples
+    double m_level;       //!< maximum relative audio RMS difference
+    double m_ratio;       //!< maximum ratio of unmatched records of each kind
+};
+
+static void splitRecords(const std::vector<std::string>& records, char kind, std::vector<GoldenRecord>& split)
+{
+    for (std::vector<std::string>::const_iterator it = records.begin(); it != records.end(); ++it)
+    {
+        if ((*it)[0] != kind) {
+            continue;
+        }
+
+        GoldenRecord record;
+        const char *s = it->c_str() + 2;
+        char *end;
+        record.m_timestamp = strtoull(s, &end, 10);
+        record.m_key = end;
+        record.m_level = 0;
+        record.m_matched = false;
+
+        if (kind == 'A') // slot and size are compared, the hash is ignored and the RMS compared with tolerance
+        {
+            int slot, nbSamples, level;
+            char hash[32];
+
+            if (sscanf(end, "%d %d %31s %d", &slot, &nbSamples, hash, &level) == 4)
+            {
+                record.m_key = std::to_string((long long) slot) + " " + std::to_string((long long) nbSamples);
+                record.m_level = level;
+            }
+        }
+
+        split.push_back(record);
+    }
+}
+
+static bool levelMatches(int golden, int output, double tolerance)
+{
+    return fabs((double) (output - golden)) <= tolerance * std::max(golden, 1) + 1.0;
+}
+
+/** Matches the records of a kind in timestamp order. Returns the number of golden records not matched */
+static unsigned int matchRecords(std::vector<GoldenRecord>& golden, std::vector<GoldenRecord>& output, const GoldenTolerance& tolerance)
+{
+    unsigned int nbUnmatched = 0;
+    size_t start = 0;
+
+    for (std::vector<GoldenRecord>::iterator g = golden.begin(); g != golden.end(); ++g)
+    {
+        while ((start < output.size()) && (output[start].m_timestamp + tolerance.m_timestamp < g->m_timestamp)) {
+            start++;
+        }
+
+        for (size_t i = start; (i < output.size()) && (output[i].m_timestamp <= g->m_timestamp + tolerance.m_timestamp); i++)
+        {
+            if (!output[i].m_matched && (output[i].m_key == g->m_key) && levelMatches(g->m_level, output[i].m_level, tolerance.m_level))
+            {
+                output[i].m_matched = true;
+                g->m_matched = true;
+                break;
+            }
+        }
+
+        if (!g->m_matched) {
+            nbUnmatched++;
+        }
+    }
+
+    return nbUnmatched;
+}
+
+static bool compareTolerant(const std::vector<std::string>& golden, const std::vector<std::string>& records, const GoldenTolerance& tolerance)
+{
+    static const struct
+    {
+        char m_kind;
+        const char *m_name;
+    } kinds[] = {
+        {'S', "sync changes"},
+        {'I', "identity changes"},
+        {'M', "AMBE frames"},
+        {'C', "calls"},
+        {'A', "audio frames"}
+    };
+
+    bool ok = true;
+
+    for (unsigned int k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+    {
+        std::vector<GoldenRecord> goldenSplit, outputSplit;
+        splitRecords(golden, kinds[k].m_kind, goldenSplit);
+        splitRecords(records, kinds[k].m_kind, outputSplit);
+        unsigned int nbUnmatched = matchRecords(goldenSplit, outputSplit, tolerance);
+        unsigned int nbExtra = 0;
+
+        for (std::vector<GoldenRecord>::const_iterator it = outputSplit.begin(); it != outputSplit.end(); ++it) {
+            nbExtra += it->m_matched ? 0 : 1;
+        }
+
+        double maxMismatches = tolerance.m_ratio * goldenSplit.size();
+        bool kindOK = (nbUnmatched <= maxMismatches) && (nbExtra <= maxMismatches);
+        fprintf(stderr, "%-17s golden %6lu output %6lu missing %5u extra %5u %s\n", kinds[k].m_name,
+            goldenSplit.size(), outputSplit.size(), nbUnmatched, nbExtra, kindOK ? "ok" : "FAIL");
+        ok = ok && kindOK;
+    }
+
+    return ok;
+}
+
+static bool isAudioRecord(const std::string& record)
+{
+    return record[0] == 'A';
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dsdcc_golden [options] <samples.dis> <file.golden>\n");
+    fprintf(stderr, "Decodes a discriminator samples file and compares the output with the golden file\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -h            Print this help and exit\n");
+    fprintf(stderr, "  -u            Write the golden file from the current output instead of comparing\n");
+    fprintf(stderr, "  -o <file>     Also write the current output to this file\n");
+    fprintf(stderr, "  -t            Compare with tolerance instead of exactly (ignores PCM hashes)\n");
+    fprintf(stderr, "  -s <samples>  Tolerance on timestamps in samples (default 480)\n");
+    fprintf(stderr, "  -l <ratio>    Tolerance on the audio RMS level (default 0.1)\n");
+    fprintf(stderr, "  -r <ratio>    Maximum ratio of missing or extra records of each kind (default 0.02)\n");
+    fprintf(stderr, "  -w <file>     Decode this samples file first and reuse the decoder after its reset\n");
+    fprintf(stderr, "  -c <sample>   Save the decoder state at this sample and go on with another decoder that restores it\n");
+}
+
+int main(int argc, char **argv)
+{
+    int c;
+    extern char *optarg;
+    extern int optind;
+    bool update = false;
+    bool tolerant = false;
+    std::string outputFileName;
+    std::string warmupPath;
+    uint64_t checkpoint = 0;
+    bool withCheckpoint = false;
+    GoldenTolerance tolerance;
+
+    while ((c = getopt(argc, argv, "huo:ts:l:r:w:c:")) != -1)
+    {
+        switch (c)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'u':
+            update = true;
+            break;
+        case 'o':
+            outputFileName = optarg;
+            break;
+        case 't':
+            tolerant = true;
+            break;
+        case 's':
+            tolerance.m_timestamp = strtoull(optarg, 0, 10);
+            break;
+        case 'l':
+            tolerance.m_level = atof(optarg);
+            break;
+        case 'r':
+            tolerance.m_ratio = atof(optarg);
+            break;
+        case 'w':
+            warmupPath = optarg;
+            break;
+        case 'c':
+            checkpoint = strtoull(optarg, 0, 10);
+            withCheckpoint = true;
+            break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+
+    if (argc - optind != 2)
+    {
+        usage();
+        return 2;
+    }
+
+    std::string samplesPath = argv[optind];
+    std::string goldenPath = argv[optind + 1];
+    std::vector<std::string> records;
+    DSDcc::DSDDecoderPool pool;
+    DSDcc::DSDDecoder *decoder = pool.acquire();
+
+    if (warmupPath.size() > 0)
+    {
+        // the decoder released to the pool is reset and handed out again
+        if (!decodeFile(warmupPath, *decoder, records)) {
+            return 2;
+        }
+
+        records.clear();
+        pool.release(decoder);
+        decoder = pool.acquire();
+    }
+
+    DSDcc::DSDDecoder *standby = withCheckpoint ? pool.acquire() : 0;
+    bool decoded = decodeFile(samplesPath, *decoder, records, standby, checkpoint);
+    pool.release(decoder);
+
+    if (standby) {
+        pool.release(standby);
+    }
+
+    if (!decoded) {
+        return 2;
+    }
+
+    if (outputFileName.size() > 0) {
+        writeGolden(outputFileName, samplesPath, records);
+    }
+
+    if (update) {
+        return writeGolden(goldenPath, samplesPath, records) ? 0 : 2;
+    }
+
+    std::vector<std::string> golden;
+
+    if (!readGolden(goldenPath, golden)) {
+        return 2;
+    }
+
+#ifdef DSD_USE_MBELIB
+    bool withAudio = true;
+#else
+    bool withAudio = false;
+#endif
+    bool goldenAudio = std::find_if(golden.begin(), golden.end(), isAudioRecord) != golden.end();
+
+    if (goldenAudio != withAudio)
+    {
+        fprintf(stderr, "Golden file made %s mbelib: audio frames are not compared\n", goldenAudio ? "with" : "without");
+        golden.erase(std::remove_if(golden.begin(), golden.end(), isAudioRecord), golden.end());
+        records.erase(std::remove_if(records.begin(), records.end(), isAudioRecord), records.end());
+    }
+
+    bool ok = tolerant ? compareTolerant(golden, records, tolerance) : compareExact(golden, records);
+    fprintf(stderr, "%s: %lu records %s\n", samplesPath.c_str(), records.size(), ok ? "match" : "DO NOT MATCH");
+    return ok ? 0 : 1;
+}
@@ -14,6 +14,10 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
 #include "timeutil.h"
 
 namespace DSDcc
@@ -39,4 +43,16 @@ uint64_t TimeUtil::nowus()
     return value.count();
 }
 
+uint64_t TimeUtil::threadCpuUs()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((uint64_t) ts.tv_sec) * 1000000UL + ts.tv_nsec / 1000;
+#else
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+#endif
+}
+
 } // namespace DSDcc
@@ -27,6 +27,7 @@ class DSDCC_API TimeUtil
 public:
     static uint64_t nowms(); //!< returns the current epoch in milliseconds
     static uint64_t nowus(); //!< returns the current epoch in microseconds
+    static uint64_t threadCpuUs(); //!< returns the CPU time consumed by the calling thread in microseconds (wall clock if not available)
 };
 
 } // namespace DSDcc
@@ -17,6 +17,7 @@
 #include "ysf.h"
 #include "dsd_decoder.h"
 #include "mbefec.h"
+#include "dsd_statebuffer.h"
 
 namespace DSDcc
 {
@@ -228,6 +229,116 @@ DSDYSF::~DSDYSF()
 {
 }
 
+void DSDYSF::reset()
+{
+    m_symbolIndex = 0;
+    m_fich = FICH();
+    m_fichError = FICHNoError;
+    memset(m_fichRaw, 0, 100);
+    memset(m_fichGolay, 0, 100);
+    memset(m_fichBits, 0, 48);
+    memset(m_dch1Raw, 0, 180);
+    memset(m_dch1Bits, 0, 180);
+    memset(m_dch2Raw, 0, 180);
+    memset(m_dch2Bits, 0, 180);
+    memset(m_vd2BitsRaw, 0, 104);
+    memset(m_vd2MBEBits, 0, 72);
+    memset(m_vfrBitsRaw, 0, 144);
+    memset(m_vfrBits, 0, 88);
+    memset(m_bitWork, 0, 48);
+    memset(m_dest, 0, 10+1);
+    memset(m_src, 0, 10+1);
+    memset(m_downlink, 0, 10+1);
+    memset(m_uplink, 0, 10+1);
+    memset(m_rem1, 0, 5+1);
+    memset(m_rem2, 0, 5+1);
+    memset(m_rem3, 0, 5+1);
+    memset(m_rem4, 0, 5+1);
+    memset(m_destId, 0, 5+1);
+    memset(m_srcId, 0, 5+1);
+
+    w = 0;
+    x = 0;
+    y = 0;
+    z = 0;
+    m_vfrStart = false;
+}
+
+void DSDYSF::saveState(DSDStateBuffer& buffer) const
+{
+    buffer.writeU16(m_symbolIndex);
+    buffer.writeBits((const unsigned char *) &m_fich, 32);
+    buffer.writeU8(m_fichError);
+    buffer.writeDibits(m_fichRaw, 100);
+    buffer.writeBits(m_fichGolay, 100);
+    buffer.writeBits(m_fichBits, 48);
+    buffer.writeDibits(m_dch1Raw, 180);
+    buffer.writeBits(m_dch1Bits, 180);
+    buffer.writeDibits(m_dch2Raw, 180);
+    buffer.writeBits(m_dch2Bits, 180);
+    buffer.writeBits(m_vd2BitsRaw, 104);
+    buffer.writeBits(m_vd2MBEBits, 72);
+    buffer.writeBits(m_vfrBitsRaw, 144);
+    buffer.writeBits(m_vfrBits, 88);
+    buffer.writeBool(m_vfrStart);
+    buffer.writeString(m_dest);
+    buffer.writeString(m_src);
+    buffer.writeString(m_downlink);
+    buffer.writeString(m_uplink);
+    buffer.writeString(m_rem1);
+    buffer.writeString(m_rem2);
+    buffer.writeString(m_rem3);
+    buffer.writeString(m_rem4);
+    buffer.writeString(m_destId);
+    buffer.writeString(m_srcId);
+    buffer.writeU8(w ? w - rW : 0xFF); // the four pointers move together in the AMBE frame interleave
+}
+
+void DSDYSF::restoreState(DSDStateBuffer& buffer)
+{
+    m_symbolIndex = buffer.readU16(480 - 20);
+    buffer.readBits((unsigned char *) &m_fich, 32);
+    m_fichError = (FICHError) buffer.readEnum(FICHErrorCRC);
+    buffer.readDibits(m_fichRaw, 100);
+    buffer.readBits(m_fichGolay, 100);
+    buffer.readBits(m_fichBits, 48);
+    buffer.readDibits(m_dch1Raw, 180);
+    buffer.readBits(m_dch1Bits, 180);
+    buffer.readDibits(m_dch2Raw, 180);
+    buffer.readBits(m_dch2Bits, 180);
+    buffer.readBits(m_vd2BitsRaw, 104);
+    buffer.readBits(m_vd2MBEBits, 72);
+    buffer.readBits(m_vfrBitsRaw, 144);
+    buffer.readBits(m_vfrBits, 88);
+    m_vfrStart = buffer.readBool();
+    buffer.readString(m_dest, 10+1);
+    buffer.readString(m_src, 10+1);
+    buffer.readString(m_downlink, 10+1);
+    buffer.readString(m_uplink, 10+1);
+    buffer.readString(m_rem1, 5+1);
+    buffer.readString(m_rem2, 5+1);
+    buffer.readString(m_rem3, 5+1);
+    buffer.readString(m_rem4, 5+1);
+    buffer.readString(m_destId, 5+1);
+    buffer.readString(m_srcId, 5+1);
+    int interleaveIndex = buffer.readU8();
+
+    if (interleaveIndex <= 36)
+    {
+        w = rW + interleaveIndex;
+        x = rX + interleaveIndex;
+        y = rY + interleaveIndex;
+        z = rZ + interleaveIndex;
+    }
+    else
+    {
+        w = 0;
+        x = 0;
+        y = 0;
+        z = 0;
+    }
+}
+
 void DSDYSF::init()
 {
     m_symbolIndex = 0;
@@ -265,6 +376,15 @@ void DSDYSF::process() // just pass the frames for now
             {
                 m_dsdDecoder->m_voice1On = false;
             }
+
+            if (m_fichError == FICHNoError)
+            {
+                if (m_fich.getFrameInformation() == FIHeader) {
+                    m_dsdDecoder->startCall(0, DSDStatus::ProtocolYSF);
+                } else if (m_fich.getFrameInformation() == FITerminator) {
+                    m_dsdDecoder->endCall(0, DSDDecoder::CallInfo::CallEndTerminator);
+                }
+            }
         }
     }
     else if (m_symbolIndex < 480 - 20) // frame is 480 dibits and sync is 20 dibits
@@ -316,18 +436,23 @@ void DSDYSF::processFICH(int symbolIndex, unsigned char dibit)
 
     if (symbolIndex == 100-1)
     {
-        m_viterbiFICH.decodeFromSymbols(m_fichGolay, m_fichRaw, 100, 0);
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_fichGolay, m_fichRaw, 100, 0));
         int i = 0;
+        unsigned int nbCorrected = 0;
 
         for (; i < 4; i++)
         {
-            if (m_golay_24_12.decode(&m_fichGolay[24*i]))
+            bool golayOK = DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolay_24_12, m_golay_24_12.decode(&m_fichGolay[24*i]));
+            m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolay_24_12, golayOK, m_golay_24_12.getNbCorrected());
+            nbCorrected += m_golay_24_12.getNbCorrected();
+
+            if (golayOK)
             {
                 memcpy(&m_fichBits[12*i], &m_fichGolay[24*i], 12);
             }
             else
             {
-                std::cerr << "DSDYSF::processFICH: Golay KO #" << i << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDYSF::processFICH: Golay KO #%d\n", i);
                 m_fichError = FICHErrorGolay;
                 break;
             }
@@ -343,10 +468,33 @@ void DSDYSF::processFICH(int symbolIndex, unsigned char dibit)
             }
             else
             {
-                std::cerr << "DSDYSF::processFICH: CRC KO" << std::endl;
+                m_dsdDecoder->getLogger().debug("DSDYSF::processFICH: CRC KO\n");
                 m_fichError = FICHErrorCRC;
             }
         }
+
+        if (m_dsdDecoder->m_capture)
+        {
+            DSDCapture::Frame frame(DSDCapture::FrameYSFFICH);
+            frame.setFEC(i == 4, nbCorrected);
+
+            if (i == 4) {
+                frame.setCRC(m_fichError == FICHNoError);
+            }
+
+            if (m_fichError == FICHNoError)
+            {
+                frame.addField((uint32_t) m_fich.getFrameInformation());
+                frame.addField((uint32_t) m_fich.getCallMode());
+                frame.addField(m_fich.getBlockNumber());
+                frame.addField(m_fich.getBlockTotal());
+                frame.addField(m_fich.getFrameNumber());
+                frame.addField(m_fich.getFrameTotal());
+                frame.addField((uint32_t) m_fich.getDataType());
+            }
+
+            m_dsdDecoder->captureBits(frame, m_fichBits, 12*i); // codewords decoded
+        }
     }
 }
 
@@ -397,8 +545,8 @@ void DSDYSF::processHeader(int symbolIndex, unsigned char dibit)
     {
         unsigned char bytes[22];
 
-        m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0);
-        m_viterbiFICH.decodeFromSymbols(m_dch2Bits, m_dch2Raw, 180, 0);
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0));
+        DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_dch2Bits, m_dch2Raw, 180, 0));
 
         if (checkCRC16(m_dch1Bits, 20, bytes)) // CSD1
         {
@@ -406,7 +554,7 @@ void DSDYSF::processHeader(int symbolIndex, unsigned char dibit)
         }
         else
         {
-            std::cerr << "DSDYSF::processHeader: DCH1 CRC KO" << std::endl;
+            m_dsdDecoder->getLogger().debug("DSDYSF::processHeader: DCH1 CRC KO\n");
         }
 
         if (checkCRC16(m_dch2Bits, 20, bytes)) // CSD2
@@ -415,7 +563,7 @@ void DSDYSF::processHeader(int symbolIndex, unsigned char dibit)
         }
         else
         {
-            std::cerr << "DSDYSF::processHeader: DCH2 CRC KO" << std::endl;
+            m_dsdDecoder->getLogger().debug("DSDYSF::processHeader: DCH2 CRC KO\n");
         }
 
         m_vfrStart = m_fich.getFrameInformation() == FIHeader;
@@ -512,7 +660,7 @@ void DSDYSF::processVD1(int symbolIndex, unsigned char dibit)
         {
             unsigned char bytes[22];
 
-            m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0);
+            DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0));
 
             if (checkCRC16(m_dch1Bits, 20, bytes)) // CSD
             {
@@ -582,7 +730,7 @@ void DSDYSF::processVD2(int symbolIndex, unsigned char dibit)
         {
             unsigned char bytes[12];
 
-            m_viterbiFICH.decodeFromSymbols(m_fichGolay, m_fichRaw, 100, 0); // reuse FICH
+            DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_fichGolay, m_fichRaw, 100, 0)); // reuse FICH
 
             if (checkCRC16(m_fichGolay, 10, bytes))
             {
@@ -653,7 +801,7 @@ void DSDYSF::processVD2Voice(int mbeIndex, unsigned char dibit)
         unsigned int bit;
 
         if (m_vd2BitsRaw[103] != 0) {
-            std::cerr << "DSDYSF::processVD2Voice: error bit 103" << std::endl;
+            m_dsdDecoder->getLogger().debug("DSDYSF::processVD2Voice: error bit 103\n");
         }
 
         for (int i = 0; i < 103; i++)
@@ -678,7 +826,7 @@ void DSDYSF::processVD2Voice(int mbeIndex, unsigned char dibit)
         }
 
         m_dsdDecoder->m_mbeDecoder1.processData(0, (char *) m_vd2MBEBits);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
     }
 }
 
@@ -706,7 +854,7 @@ void DSDYSF::processVFRSubHeader(int symbolIndex, unsigned char dibit)
 
             unsigned char bytes[22];
 
-            m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0);
+            DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageViterbi5, m_viterbiFICH.decodeFromSymbols(m_dch1Bits, m_dch1Raw, 180, 0));
 
             if (checkCRC16(m_dch1Bits, 20, bytes)) // CSD3
             {
@@ -770,19 +918,22 @@ void DSDYSF::processAMBE(int mbeIndex, unsigned char dibit)
         memset((void *) m_dsdDecoder->m_mbeDVFrame1, 0, 9); // initialize DVSI frame
 	}
 
-	m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
-	m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
-	w++;
-	x++;
-	y++;
-	z++;
+	if (w && (w < rW + 36)) // a restored interleave position may be out of step with the frame
+	{
+	    m_dsdDecoder->ambe_fr[*w][*x] = (1 & (dibit >> 1)); // bit 1
+	    m_dsdDecoder->ambe_fr[*y][*z] = (1 & dibit);        // bit 0
+	    w++;
+	    x++;
+	    y++;
+	    z++;
+	}
 
 	storeSymbolDV(m_dsdDecoder->m_mbeDVFrame1, mbeIndex, dibit); // store dibit for DVSI hardware decoder
 
 	if (mbeIndex == 36-1) // finalize
 	{
         m_dsdDecoder->m_mbeDecoder1.processFrame(0, m_dsdDecoder->ambe_fr, 0);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 	}
 }
 
@@ -808,31 +959,31 @@ void DSDYSF::procesVFRFrame(int mbeIndex, unsigned char dibit)
         scrambleVFR(m_vfrBitsRaw+23, m_vfrBitsRaw+23, 144-23-7, seed, 4);
 
         // u0
-        GolayMBE::mbe_golay2312(m_vfrBitsRaw, m_vfrBits);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolayMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolayMBE, GolayMBE::mbe_golay2312(m_vfrBitsRaw, m_vfrBits)));
 //        memcpy(m_vfrBits, m_vfrBitsRaw, 12);
 
         // u1
-        GolayMBE::mbe_golay2312(&m_vfrBitsRaw[23], &m_vfrBits[12]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolayMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolayMBE, GolayMBE::mbe_golay2312(&m_vfrBitsRaw[23], &m_vfrBits[12])));
 //        memcpy(&m_vfrBits[12], &m_vfrBitsRaw[23], 12);
 
         // u2
-        GolayMBE::mbe_golay2312(&m_vfrBitsRaw[46], &m_vfrBits[24]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolayMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolayMBE, GolayMBE::mbe_golay2312(&m_vfrBitsRaw[46], &m_vfrBits[24])));
 //        memcpy(&m_vfrBits[24], &m_vfrBitsRaw[46], 12);
 
         // u3
-        GolayMBE::mbe_golay2312(&m_vfrBitsRaw[69], &m_vfrBits[36]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECGolayMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageGolayMBE, GolayMBE::mbe_golay2312(&m_vfrBitsRaw[69], &m_vfrBits[36])));
 //        memcpy(&m_vfrBits[36], &m_vfrBitsRaw[69], 12);
 
         // u4
-        HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[92], &m_vfrBits[48]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHammingMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHammingMBE, HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[92], &m_vfrBits[48])));
 //        memcpy(&m_vfrBits[48], &m_vfrBitsRaw[92], 11);
 
         // u5
-        HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[107], &m_vfrBits[59]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHammingMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHammingMBE, HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[107], &m_vfrBits[59])));
 //        memcpy(&m_vfrBits[59], &m_vfrBitsRaw[107], 11);
 
         // u6
-        HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[122], &m_vfrBits[70]);
+        m_dsdDecoder->m_stats.countFEC(DSDStats::FECHammingMBE, true, DSD_PROFILE_CALL(m_dsdDecoder->m_profile, StageHammingMBE, HammingMBE::mbe_hamming1511(&m_vfrBitsRaw[122], &m_vfrBits[70])));
 //        memcpy(&m_vfrBits[70], &m_vfrBitsRaw[122], 11);
 
         // u7
@@ -844,13 +995,13 @@ void DSDYSF::procesVFRFrame(int mbeIndex, unsigned char dibit)
         }
 
         m_dsdDecoder->m_mbeDecoder1.processData((char *) m_vfrBits, 0);
-        m_dsdDecoder->m_mbeDVReady1 = true; // Indicate that a DVSI frame is available
+        m_dsdDecoder->setMbeDVReady1(); // Indicate that a DVSI frame is available
 	}
 }
 
 void DSDYSF::storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned char dibit, bool invertDibit)
 {
-    if (m_dsdDecoder->m_mbelibEnable)
+    if (!m_dsdDecoder->mbeDVEnabled())
     {
         return;
     }
@@ -863,8 +1014,25 @@ void DSDYSF::storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned cha
     mbeFrame[dibitindex/4] |= (dibit << (6 - 2*(dibitindex % 4)));
 }
 
+void DSDYSF::unpackVD2DVFrame(const unsigned char *dvFrame, char ambe_d[49])
+{
+    for (int i = 0; i < 49; i++)
+    {
+        int mbeIndex = m_vd2DVSIInterleave[i];
+        ambe_d[i] = (dvFrame[mbeIndex/8] >> (7-(mbeIndex%8))) & 1;
+    }
+}
+
+void DSDYSF::unpackVFRDVFrame(const unsigned char *dvFrame, char imbe_d[88])
+{
+    for (int i = 0; i < 88; i++) {
+        imbe_d[i] = (dvFrame[i/8] >> (7-(i%8))) & 1;
+    }
+}
+
 bool DSDYSF::checkCRC16(unsigned char *bits,  unsigned long nbBytes, unsigned char *xoredBytes)
 {
+    DSD_PROFILE_SCOPE(m_dsdDecoder->m_profile, StageCRC);
     unsigned char bytes[22];
 //    std::cerr << "DSDYSF::checkCRC16: value: ";
 
@@ -890,7 +1058,17 @@ bool DSDYSF::checkCRC16(unsigned char *bits,  unsigned long nbBytes, unsigned ch
 
 //    std::cerr << "crc: " << std::hex << crc << std::endl;
 
-    return m_crc.crctablefast(bytes, nbBytes) == crc;
+    bool crcOK = m_dsdDecoder->m_stats.countCRC(DSDStats::CRCYSF, m_crc.crctablefast(bytes, nbBytes) == crc);
+
+    if (xoredBytes && m_dsdDecoder->m_capture) // data channel
+    {
+        DSDCapture::Frame frame(DSDCapture::FrameYSFDCH);
+        frame.setCRC(crcOK);
+        frame.addField(m_fich.getFrameNumber());
+        m_dsdDecoder->captureBits(frame, bits, 8*(nbBytes + 2));
+    }
+
+    return crcOK;
 }
 
 void DSDYSF::scrambleVFR(uint8_t out[], uint8_t in[], uint16_t n, uint32_t seed, uint8_t shift)
@@ -31,6 +31,7 @@ namespace DSDcc
 {
 
 class DSDDecoder;
+class DSDStateBuffer;
 
 class DSDCC_API DSDYSF
 {
@@ -184,6 +185,9 @@ public:
 
     explicit DSDYSF(DSDDecoder *dsdDecoder);
     ~DSDYSF();
+    void reset(); //!< back to the state after construction keeping the FEC and interleaving tables
+    void saveState(DSDStateBuffer& buffer) const;    //!< frame in progress, FICH and callsigns
+    void restoreState(DSDStateBuffer& buffer);
 
     void init();
     void process();
@@ -203,6 +207,11 @@ public:
     static const char *ysfDataTypeText[4];
     static const char *ysfCallModeText[4];
 
+    /** AMBE 2450 data bits of V/D type 2 from a DVSI frame */
+    static void unpackVD2DVFrame(const unsigned char *dvFrame, char ambe_d[49]);
+    /** IMBE 4400 data bits of voice full rate from a DVSI frame */
+    static void unpackVFRDVFrame(const unsigned char *dvFrame, char imbe_d[88]);
+
 private:
 
     void processFICH(int symbolIndex, unsigned char dibit);
@@ -221,7 +230,7 @@ private:
     void procesVFRFrame(int mbeIndex, unsigned char dibit);
     void storeSymbolDV(unsigned char *mbeFrame, int dibitindex, unsigned char dibit, bool invertDibit = false);
 
-    bool checkCRC16(unsigned char *bits, unsigned long nbBytes, unsigned char *xoredBytes = 0);
+    bool checkCRC16(unsigned char *bits, unsigned long nbBytes, unsigned char *xoredBytes = 0); //!< blocks with descrambled output are data channels and are captured
     void scrambleVFR(uint8_t out[], uint8_t in[], uint16_t n, uint32_t seed, uint8_t shift);
 
     DSDDecoder *m_dsdDecoder;